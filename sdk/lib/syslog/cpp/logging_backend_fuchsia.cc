@@ -522,7 +522,7 @@ void SetInterestChangedListener(void (*callback)(void* context, syslog::LogSever
 
 void BeginRecordInternal(LogBuffer* buffer, syslog::LogSeverity severity, const char* file_name,
                          unsigned int line, const char* msg, const char* condition, bool is_printf,
-                         zx_handle_t socket) {
+                         zx_handle_t socket, zx_time_t time, zx_koid_t thread_koid) {
   // Ensure we have log state
   GlobalStateLock log_state;
   cpp17::optional<int8_t> raw_severity;
@@ -552,7 +552,6 @@ void BeginRecordInternal(LogBuffer* buffer, syslog::LogSeverity severity, const
     raw_severity = severity;
     severity = syslog::LOG_DEBUG;
   }
-  zx_time_t time = zx_clock_get_monotonic();
   auto* state = RecordState::CreatePtr(buffer);
   RecordState& record = *state;
   // Invoke the constructor of RecordState to construct a valid RecordState
@@ -575,7 +574,7 @@ void BeginRecordInternal(LogBuffer* buffer, syslog::LogSeverity severity, const
   encoder.AppendArgumentKey(record, SliceFromArray(kPidFieldName));
   encoder.AppendArgumentValue(record, static_cast<uint64_t>(pid));
   encoder.AppendArgumentKey(record, SliceFromArray(kTidFieldName));
-  encoder.AppendArgumentValue(record, static_cast<uint64_t>(tid));
+  encoder.AppendArgumentValue(record, static_cast<uint64_t>(thread_koid));
 
   auto dropped_count = GetAndResetDropped();
   record.dropped_count = dropped_count;
@@ -606,20 +605,27 @@ void BeginRecordInternal(LogBuffer* buffer, syslog::LogSeverity severity, const
 void BeginRecordPrintf(LogBuffer* buffer, syslog::LogSeverity severity, const char* file_name,
                        unsigned int line, const char* msg) {
   BeginRecordInternal(buffer, severity, file_name, line, msg, nullptr, true /* is_printf */,
-                      ZX_HANDLE_INVALID);
+                      ZX_HANDLE_INVALID, zx_clock_get_monotonic(), tid);
 }
 
 void BeginRecord(LogBuffer* buffer, syslog::LogSeverity severity, const char* file_name,
                  unsigned int line, const char* msg, const char* condition) {
   BeginRecordInternal(buffer, severity, file_name, line, msg, condition, false /* is_printf */,
-                      ZX_HANDLE_INVALID);
+                      ZX_HANDLE_INVALID, zx_clock_get_monotonic(), tid);
 }
 
 void BeginRecordWithSocket(LogBuffer* buffer, syslog::LogSeverity severity, const char* file_name,
                            unsigned int line, const char* msg, const char* condition,
                            zx_handle_t socket) {
   BeginRecordInternal(buffer, severity, file_name, line, msg, condition, false /* is_printf */,
-                      socket);
+                      socket, zx_clock_get_monotonic(), tid);
+}
+
+void BeginRecordWithSocket(LogBuffer* buffer, syslog::LogSeverity severity, const char* file_name,
+                           unsigned int line, const char* msg, const char* condition,
+                           zx_handle_t socket, zx_time_t time, zx_koid_t thread_koid) {
+  BeginRecordInternal(buffer, severity, file_name, line, msg, condition, false /* is_printf */,
+                      socket, time, thread_koid);
 }
 
 void WriteKeyValue(LogBuffer* buffer, const char* key, const char* value) {
@@ -27,6 +27,11 @@ struct LogBuffer;
 WEAK void BeginRecordWithSocket(LogBuffer* buffer, syslog::LogSeverity severity,
                                 const char* file_name, unsigned int line, const char* msg,
                                 const char* condition, zx_handle_t socket);
+// Like the above, but for a record logged earlier, at |time| by the thread |thread_koid|.
+WEAK void BeginRecordWithSocket(LogBuffer* buffer, syslog::LogSeverity severity,
+                                const char* file_name, unsigned int line, const char* msg,
+                                const char* condition, zx_handle_t socket, zx_time_t time,
+                                zx_koid_t thread_koid);
 WEAK void SetInterestChangedListener(void (*callback)(void* context, syslog::LogSeverity severity),
                                      void* context);
 #endif
@@ -10,6 +10,7 @@
 #include <lib/syslog/structured_backend/fuchsia_syslog.h>
 #include <lib/zx/channel.h>
 #include <lib/zx/socket.h>
+#include <lib/zx/time.h>
 #include <stdint.h>
 
 namespace fuchsia_syslog {
@@ -74,6 +75,20 @@ class LogBuffer final {
                                      dropped_count, pid, tid);
   }
 
+  // Like the above, but for a message that was logged earlier and is only now
+  // being encoded.
+
+  // time -- The monotonic time at which the message was logged.
+  void BeginRecord(FuchsiaLogSeverity severity, cpp17::optional<cpp17::string_view> file_name,
+                   unsigned int line, cpp17::optional<cpp17::string_view> message, bool is_printf,
+                   zx::unowned_socket socket, uint32_t dropped_count, zx_koid_t pid, zx_koid_t tid,
+                   zx::time time) {
+    syslog_begin_record_with_time(&data_, severity, StringViewToCStr(file_name),
+                                  StringViewLength(file_name), line, StringViewToCStr(message),
+                                  StringViewLength(message), is_printf, socket->get(),
+                                  dropped_count, pid, tid, time.get());
+  }
+
   // Writes a key/value pair to the buffer.
   void WriteKeyValue(cpp17::string_view key, cpp17::string_view value) {
     syslog_write_key_value_string(&data_, StringViewToCStr(key), StringViewLength(key),
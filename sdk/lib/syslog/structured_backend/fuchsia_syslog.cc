@@ -482,7 +482,7 @@ void BeginRecordInternal(fuchsia_syslog_log_buffer_t* buffer, FuchsiaLogSeverity
                          cpp17::optional<cpp17::string_view> msg,
                          cpp17::optional<cpp17::string_view> condition, bool is_printf,
                          zx::unowned_socket socket, uint32_t dropped_count, zx_koid_t pid,
-                         zx_koid_t tid) {
+                         zx_koid_t tid, zx::time time) {
   cpp17::optional<int8_t> raw_severity;
   // Validate that the severity matches the FIDL definition in
   // sdk/fidl/fuchsia.diagnostics/severity.fidl.
@@ -491,7 +491,6 @@ void BeginRecordInternal(fuchsia_syslog_log_buffer_t* buffer, FuchsiaLogSeverity
     severity = FUCHSIA_LOG_DEBUG;
   }
   // Initialize the encoder targeting the passed buffer, and begin the record.
-  auto time = zx::clock::get_monotonic();
   auto* state = RecordState::CreatePtr(buffer);
   RecordState& record = *state;
   // Invoke the constructor of RecordState to construct a valid RecordState
@@ -540,9 +539,10 @@ void BeginRecord(fuchsia_syslog_log_buffer_t* buffer, FuchsiaLogSeverity severit
                  cpp17::optional<cpp17::string_view> file_name, unsigned int line,
                  cpp17::optional<cpp17::string_view> message,
                  cpp17::optional<cpp17::string_view> condition, bool is_printf,
-                 zx::unowned_socket socket, uint32_t dropped_count, zx_koid_t pid, zx_koid_t tid) {
+                 zx::unowned_socket socket, uint32_t dropped_count, zx_koid_t pid, zx_koid_t tid,
+                 zx::time time) {
   BeginRecordInternal(buffer, severity, file_name, line, message, condition, is_printf,
-                      std::move(socket), dropped_count, pid, tid);
+                      std::move(socket), dropped_count, pid, tid, time);
 }
 
 void WriteKeyValue(fuchsia_syslog_log_buffer_t* buffer, cpp17::string_view key,
@@ -641,7 +641,20 @@ void syslog_begin_record_transitional(fuchsia_syslog_log_buffer_t* buffer,
                                       zx_koid_t tid) {
   fuchsia_syslog::BeginRecord(buffer, severity, CStringToStringView(file_name, file_name_length),
                               line, CStringToStringView(message, message_length), cpp17::nullopt,
-                              is_printf, zx::unowned_socket(socket), dropped_count, pid, tid);
+                              is_printf, zx::unowned_socket(socket), dropped_count, pid, tid,
+                              zx::clock::get_monotonic());
+}
+
+void syslog_begin_record_with_time(fuchsia_syslog_log_buffer_t* buffer,
+                                   FuchsiaLogSeverity severity, const char* file_name,
+                                   size_t file_name_length, unsigned int line, const char* message,
+                                   size_t message_length, bool is_printf, zx_handle_t socket,
+                                   uint32_t dropped_count, zx_koid_t pid, zx_koid_t tid,
+                                   zx_time_t time) {
+  fuchsia_syslog::BeginRecord(buffer, severity, CStringToStringView(file_name, file_name_length),
+                              line, CStringToStringView(message, message_length), cpp17::nullopt,
+                              is_printf, zx::unowned_socket(socket), dropped_count, pid, tid,
+                              zx::time(time));
 }
 
 __BEGIN_CDECLS
@@ -653,7 +666,8 @@ void syslog_begin_record(fuchsia_syslog_log_buffer_t* buffer, FuchsiaLogSeverity
   fuchsia_syslog::BeginRecord(buffer, severity, CStringToStringView(file_name, file_name_length),
                               line, CStringToStringView(message, message_length),
                               CStringToStringView(condition, condition_length), is_printf,
-                              zx::unowned_socket(socket), dropped_count, pid, tid);
+                              zx::unowned_socket(socket), dropped_count, pid, tid,
+                              zx::clock::get_monotonic());
 }
 
 // Writes a key/value pair to the buffer.
@@ -109,6 +109,17 @@ void syslog_begin_record_transitional(fuchsia_syslog_log_buffer_t* buffer,
                                       zx_handle_t socket, uint32_t dropped_count, zx_koid_t pid,
                                       zx_koid_t tid);
 
+// Like syslog_begin_record_transitional, but for a message that was logged
+// earlier and is only now being encoded.
+
+// time -- The monotonic time at which the message was logged.
+void syslog_begin_record_with_time(fuchsia_syslog_log_buffer_t* buffer,
+                                   FuchsiaLogSeverity severity, const char* file_name,
+                                   size_t file_name_length, unsigned int line, const char* message,
+                                   size_t message_length, bool is_printf, zx_handle_t socket,
+                                   uint32_t dropped_count, zx_koid_t pid, zx_koid_t tid,
+                                   zx_time_t time);
+
 // Writes a key/value pair to the buffer.
 void syslog_write_key_value_string(fuchsia_syslog_log_buffer_t* buffer, const char* key,
                                    size_t key_length, const char* value, size_t value_length);
@@ -527,6 +527,13 @@ void DebugAgent::OnSaveMinidump(const debug_ipc::SaveMinidumpRequest& request,
   proc->OnSaveMinidump(request, reply);
 }
 
+void DebugAgent::OnReadMemoryBatch(const debug_ipc::ReadMemoryBatchRequest& request,
+                                   debug_ipc::ReadMemoryBatchReply* reply) {
+  DebuggedProcess* proc = GetDebuggedProcess(request.process_koid);
+  if (proc)
+    proc->OnReadMemoryBatch(request, reply);
+}
+
 DebuggedProcess* DebugAgent::GetDebuggedProcess(zx_koid_t koid) {
   auto found = procs_.find(koid);
   if (found == procs_.end())
@@ -126,6 +126,8 @@ class DebugAgent : public RemoteAPI, public Breakpoint::ProcessDelegate, public
                               debug_ipc::UpdateGlobalSettingsReply* reply) override;
   void OnSaveMinidump(const debug_ipc::SaveMinidumpRequest& request,
                       debug_ipc::SaveMinidumpReply* reply) override;
+  void OnReadMemoryBatch(const debug_ipc::ReadMemoryBatchRequest& request,
+                         debug_ipc::ReadMemoryBatchReply* reply) override;
 
   // Implements |LogBackend|.
   void WriteLog(debug::LogSeverity severity, const debug::FileLineFunction& location,
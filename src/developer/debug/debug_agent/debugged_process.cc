@@ -9,6 +9,8 @@
 #include <lib/syslog/cpp/macros.h>
 #include <zircon/syscalls/exception.h>
 
+#include <algorithm>
+#include <limits>
 #include <utility>
 
 #include "src/developer/debug/debug_agent/align.h"
@@ -83,7 +85,13 @@ DebuggedProcessCreateInfo::DebuggedProcessCreateInfo(std::unique_ptr<ProcessHand
 
 // DebuggedProcess ---------------------------------------------------------------------------------
 
-DebuggedProcess::DebuggedProcess(DebugAgent* debug_agent) : debug_agent_(debug_agent) {}
+DebuggedProcess::DebuggedProcess(DebugAgent* debug_agent)
+    : debug_agent_(debug_agent),
+      memory_cache_(
+          [this](uint64_t address, uint32_t size) {
+            return ReadUncachedMemoryBlocks(address, size);
+          },
+          [this]() { return process_handle_->GetPrivateMemoryRanges(); }) {}
 
 DebuggedProcess::~DebuggedProcess() {
   if (process_handle_) {
@@ -164,22 +172,25 @@ void DebuggedProcess::OnResume(const debug_ipc::ResumeRequest& request) {
 
 void DebuggedProcess::OnReadMemory(const debug_ipc::ReadMemoryRequest& request,
                                    debug_ipc::ReadMemoryReply* reply) {
-  reply->blocks = process_handle_->ReadMemoryBlocks(request.address, request.size);
+  reply->blocks = ReadMemoryBlocks(request.address, request.size);
+}
 
-  // Remove any breakpoint instructions we've inserted.
-  //
-  // If there are a lot of ProcessBreakpoints this will get slow. If we find we have 100's of
-  // breakpoints an auxiliary data structure could be added to find overlapping breakpoints faster.
-  for (const auto& [addr, bp] : software_breakpoints_) {
-    // Generally there will be only one block. If we start reading many megabytes that cross
-    // mapped memory boundaries, a top-level range check would be a good idea to avoid unnecessary
-    // iteration.
-    for (auto& block : reply->blocks) {
-      bp->FixupMemoryBlock(&block);
-    }
+void DebuggedProcess::OnReadMemoryBatch(const debug_ipc::ReadMemoryBatchRequest& request,
+                                        debug_ipc::ReadMemoryBatchReply* reply) {
+  reply->blocks.reserve(request.ranges.size());
+  for (const debug::AddressRange& range : request.ranges) {
+    // Ranges are limited to the size of a single ReadMemoryRequest.
+    uint32_t size = static_cast<uint32_t>(
+        std::min<uint64_t>(range.size(), std::numeric_limits<uint32_t>::max()));
+    reply->blocks.push_back(ReadMemoryBlocks(range.begin(), size));
   }
 }
 
+std::vector<debug_ipc::MemoryBlock> DebuggedProcess::ReadMemoryBlocks(uint64_t address,
+                                                                      uint32_t size) {
+  return memory_cache_.ReadMemoryBlocks(address, size, AreAllThreadsStopped());
+}
+
 void DebuggedProcess::OnKill(const debug_ipc::KillRequest& request, debug_ipc::KillReply* reply) {
   // Stop observing before killing the process to avoid getting exceptions after we stopped
   // listening to them.
@@ -524,6 +535,8 @@ void DebuggedProcess::OnModules(debug_ipc::ModulesReply* reply) {
 
 void DebuggedProcess::OnWriteMemory(const debug_ipc::WriteMemoryRequest& request,
                                     debug_ipc::WriteMemoryReply* reply) {
+  InvalidateMemoryCache();
+
   size_t actual = 0;
 
   // TODO(brettw) replace reply with a serialized Status.
@@ -609,6 +622,34 @@ void DebuggedProcess::SetStderr(OwnedStdioHandle handle) {
   }
 }
 
+bool DebuggedProcess::AreAllThreadsStopped() const {
+  for (const auto& [koid, thread] : threads_) {
+    if (!thread->in_exception() && !thread->is_client_suspended())
+      return false;
+  }
+  return true;
+}
+
+std::vector<debug_ipc::MemoryBlock> DebuggedProcess::ReadUncachedMemoryBlocks(
+    uint64_t address, uint32_t size) const {
+  std::vector<debug_ipc::MemoryBlock> blocks = process_handle_->ReadMemoryBlocks(address, size);
+
+  // Remove any breakpoint instructions we've inserted. This is done before the memory is cached so
+  // the cache stays correct when breakpoints are installed or removed.
+  //
+  // If there are a lot of ProcessBreakpoints this will get slow. If we find we have 100's of
+  // breakpoints an auxiliary data structure could be added to find overlapping breakpoints faster.
+  for (const auto& [addr, bp] : software_breakpoints_) {
+    // Generally there will be only one block. If we start reading many megabytes that cross
+    // mapped memory boundaries, a top-level range check would be a good idea to avoid unnecessary
+    // iteration.
+    for (auto& block : blocks) {
+      bp->FixupMemoryBlock(&block);
+    }
+  }
+  return blocks;
+}
+
 void DebuggedProcess::OnStdout(bool close) {
   FX_DCHECK(stdout_ && stdout_->IsValid());
   if (close) {
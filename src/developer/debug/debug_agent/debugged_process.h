@@ -12,6 +12,7 @@
 #include <fbl/unique_fd.h>
 
 #include "src/developer/debug/debug_agent/debugged_thread.h"
+#include "src/developer/debug/debug_agent/memory_cache.h"
 #include "src/developer/debug/debug_agent/module_list.h"
 #include "src/developer/debug/debug_agent/process_handle.h"
 #include "src/developer/debug/debug_agent/process_handle_observer.h"
@@ -73,6 +74,8 @@ class DebuggedProcess : public ProcessHandleObserver {
   // IPC handlers.
   void OnResume(const debug_ipc::ResumeRequest& request);
   void OnReadMemory(const debug_ipc::ReadMemoryRequest& request, debug_ipc::ReadMemoryReply* reply);
+  void OnReadMemoryBatch(const debug_ipc::ReadMemoryBatchRequest& request,
+                         debug_ipc::ReadMemoryBatchReply* reply);
   void OnKill(const debug_ipc::KillRequest& request, debug_ipc::KillReply* reply);
   void OnAddressSpace(const debug_ipc::AddressSpaceRequest& request,
                       debug_ipc::AddressSpaceReply* reply);
@@ -97,6 +100,16 @@ class DebuggedProcess : public ProcessHandleObserver {
   std::vector<debug_ipc::ProcessThreadId> ClientSuspendAllThreads(
       zx_koid_t except_thread = ZX_KOID_INVALID);
 
+  // Reads the memory of the process with any breakpoint instructions we've inserted removed. The
+  // memory private to the process is cached while all threads are stopped, see MemoryCache and
+  // InvalidateMemoryCache().
+  std::vector<debug_ipc::MemoryBlock> ReadMemoryBlocks(uint64_t address, uint32_t size);
+
+  // Drops all cached memory. This must be called whenever a thread may run or the memory of the
+  // process is modified by the agent.
+  void InvalidateMemoryCache() { memory_cache_.Clear(); }
+  const MemoryCache& memory_cache() const { return memory_cache_; }
+
   // Returns the thread or null if there is no known thread for this koid.
   DebuggedThread* GetThread(zx_koid_t thread_koid) const;
   std::vector<DebuggedThread*> GetThreads() const;
@@ -196,6 +209,14 @@ class DebuggedProcess : public ProcessHandleObserver {
   void OnThreadExiting(std::unique_ptr<ExceptionHandle> exception) override;
   void OnException(std::unique_ptr<ExceptionHandle> exception) override;
 
+  // Returns true if every thread is stopped from the perspective of the client, which means the
+  // memory of the process can't change behind our back.
+  bool AreAllThreadsStopped() const;
+
+  // Reads the process memory bypassing the cache, with the breakpoint instructions removed.
+  std::vector<debug_ipc::MemoryBlock> ReadUncachedMemoryBlocks(uint64_t address,
+                                                               uint32_t size) const;
+
   void OnStdout(bool close);
   void OnStderr(bool close);
 
@@ -234,6 +255,10 @@ class DebuggedProcess : public ProcessHandleObserver {
 
   std::deque<StepOverTicket> step_over_queue_;
 
+  // Memory read while all threads are stopped. The client reads the same few pages over and over
+  // when the user is looking at a stopped thread.
+  MemoryCache memory_cache_;
+
   // Non-null only if the corresponding stream is hooked up.
   std::unique_ptr<BufferedStdioHandle> stdout_;
   std::unique_ptr<BufferedStdioHandle> stderr_;
@@ -256,5 +256,77 @@ TEST(DebuggedProcess, DetachFromProcess) {
   ASSERT_TRUE(thread->running());
 }
 
+TEST(DebuggedProcess, ReadMemoryCache) {
+  MockProcess process(nullptr, kProcessKoid, kProcessName);
+  process.AddThread(2);
+
+  constexpr uint64_t kPageAddress = 0x10000;
+  process.mock_process_handle().mock_memory().AddMemory(
+      kPageAddress, std::vector<uint8_t>(MemoryCache::kPageSize, 1));
+
+  debug_ipc::ReadMemoryRequest request;
+  request.process_koid = kProcessKoid;
+  request.address = kPageAddress + 8;
+  request.size = 4;
+
+  // The memory isn't cached while the thread is running.
+  debug_ipc::ReadMemoryReply reply;
+  process.OnReadMemory(request, &reply);
+  ASSERT_EQ(1u, reply.blocks.size());
+  EXPECT_EQ(std::vector<uint8_t>(4, 1), reply.blocks[0].data);
+  EXPECT_EQ(0u, process.memory_cache().page_count());
+
+  process.ClientSuspendAllThreads();
+  process.OnReadMemory(request, &reply);
+  EXPECT_EQ(1u, process.memory_cache().page_count());
+
+  // Changes behind the agent's back aren't seen while the process is stopped.
+  process.mock_process_handle().mock_memory().AddMemory(
+      kPageAddress, std::vector<uint8_t>(MemoryCache::kPageSize, 2));
+  process.OnReadMemory(request, &reply);
+  ASSERT_EQ(1u, reply.blocks.size());
+  EXPECT_EQ(std::vector<uint8_t>(4, 1), reply.blocks[0].data);
+
+  // Batched reads return the blocks of each range, from the same cache.
+  debug_ipc::ReadMemoryBatchRequest batch_request;
+  batch_request.process_koid = kProcessKoid;
+  batch_request.ranges.emplace_back(kPageAddress, kPageAddress + 2);
+  batch_request.ranges.emplace_back(kPageAddress + 16, kPageAddress + 17);
+  debug_ipc::ReadMemoryBatchReply batch_reply;
+  process.OnReadMemoryBatch(batch_request, &batch_reply);
+  ASSERT_EQ(2u, batch_reply.blocks.size());
+  ASSERT_EQ(1u, batch_reply.blocks[0].size());
+  EXPECT_EQ(kPageAddress, batch_reply.blocks[0][0].address);
+  EXPECT_EQ(std::vector<uint8_t>(2, 1), batch_reply.blocks[0][0].data);
+  ASSERT_EQ(1u, batch_reply.blocks[1].size());
+  EXPECT_EQ(kPageAddress + 16, batch_reply.blocks[1][0].address);
+  EXPECT_EQ(std::vector<uint8_t>(1, 1), batch_reply.blocks[1][0].data);
+
+  // Writing memory drops the cache.
+  debug_ipc::WriteMemoryRequest write_request;
+  write_request.process_koid = kProcessKoid;
+  write_request.address = kPageAddress;
+  write_request.data = std::vector<uint8_t>(MemoryCache::kPageSize, 3);
+  debug_ipc::WriteMemoryReply write_reply;
+  process.OnWriteMemory(write_request, &write_reply);
+  EXPECT_EQ(0u, process.memory_cache().page_count());
+  process.OnReadMemory(request, &reply);
+  ASSERT_EQ(1u, reply.blocks.size());
+  EXPECT_EQ(std::vector<uint8_t>(4, 3), reply.blocks[0].data);
+
+  // And so does resuming.
+  EXPECT_EQ(1u, process.memory_cache().page_count());
+  process.OnResume(debug_ipc::ResumeRequest());
+  EXPECT_EQ(0u, process.memory_cache().page_count());
+
+  // Memory shared with other processes is never cached.
+  process.mock_process_handle().set_private_memory_ranges({});
+  process.ClientSuspendAllThreads();
+  process.OnReadMemory(request, &reply);
+  ASSERT_EQ(1u, reply.blocks.size());
+  EXPECT_EQ(std::vector<uint8_t>(4, 3), reply.blocks[0].data);
+  EXPECT_EQ(0u, process.memory_cache().page_count());
+}
+
 }  // namespace
 }  // namespace debug_agent
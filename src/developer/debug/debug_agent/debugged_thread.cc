@@ -359,6 +359,9 @@ void DebuggedThread::ClientResume(const debug_ipc::ResumeRequest& request) {
                     << ", Count: " << request.count << ", Range: [" << request.range_begin << ", "
                     << request.range_end << ").";
 
+  // Whatever memory the process had while this thread was stopped may be about to change.
+  process_->InvalidateMemoryCache();
+
   run_mode_ = request.how;
   step_count_ = request.count;
   step_in_range_begin_ = request.range_begin;
@@ -381,6 +384,7 @@ void DebuggedThread::InternalResumeException() {
     return;
   }
 
+  process_->InvalidateMemoryCache();
   SetSingleStepForRunMode();
 
   if (run_mode_ == debug_ipc::ResumeRequest::How::kForwardAndContinue) {
@@ -0,0 +1,121 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/developer/debug/debug_agent/memory_cache.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace debug_agent {
+
+MemoryCache::MemoryCache(ReadBlocksFn read_blocks, PrivateRangesFn private_ranges)
+    : read_blocks_(std::move(read_blocks)), get_private_ranges_(std::move(private_ranges)) {}
+
+std::vector<debug_ipc::MemoryBlock> MemoryCache::ReadMemoryBlocks(uint64_t address, uint32_t size,
+                                                                  bool use_cache) {
+  if (!use_cache) {
+    Clear();
+    return read_blocks_(address, size);
+  }
+
+  // Big reads and reads that would wrap when rounded to pages aren't worth caching.
+  if (size == 0 || size > kMaxCachedReadSize ||
+      address > std::numeric_limits<uint64_t>::max() - size - kPageSize)
+    return read_blocks_(address, size);
+
+  uint64_t end = address + size;
+  uint64_t first_page = address & ~(kPageSize - 1);
+  uint64_t last_page = (end + kPageSize - 1) & ~(kPageSize - 1);
+
+  // Memory that another process can change isn't cached.
+  if (!IsPrivate(first_page, last_page))
+    return read_blocks_(address, size);
+
+  if (pages_.size() + (last_page - first_page) / kPageSize > kMaxPages)
+    Clear();
+
+  // Fill in all the missing pages, reading each contiguous run of them at once.
+  uint64_t missing_begin = last_page;
+  for (uint64_t page = first_page; page < last_page; page += kPageSize) {
+    if (pages_.find(page) == pages_.end()) {
+      if (missing_begin == last_page)
+        missing_begin = page;
+    } else if (missing_begin != last_page) {
+      FillPages(missing_begin, page);
+      missing_begin = last_page;
+    }
+  }
+  if (missing_begin != last_page)
+    FillPages(missing_begin, last_page);
+
+  // Generate the blocks, merging adjacent pages that have the same validity.
+  std::vector<debug_ipc::MemoryBlock> blocks;
+  for (uint64_t page = first_page; page < last_page; page += kPageSize) {
+    auto found = pages_.find(page);
+    if (found == pages_.end()) {
+      // Some page couldn't be cached, fall back to the uncached read.
+      return read_blocks_(address, size);
+    }
+    const Page& cached = found->second;
+
+    uint64_t begin = std::max(page, address);
+    uint64_t page_end = std::min(page + kPageSize, end);
+
+    if (blocks.empty() || blocks.back().valid != cached.valid) {
+      debug_ipc::MemoryBlock& block = blocks.emplace_back();
+      block.address = begin;
+      block.valid = cached.valid;
+    }
+    debug_ipc::MemoryBlock& block = blocks.back();
+    block.size += static_cast<uint32_t>(page_end - begin);
+    if (cached.valid) {
+      block.data.insert(block.data.end(), cached.data.begin() + (begin - page),
+                        cached.data.begin() + (page_end - page));
+    }
+  }
+  return blocks;
+}
+
+bool MemoryCache::IsPrivate(uint64_t begin, uint64_t end) {
+  if (!private_ranges_)
+    private_ranges_ = get_private_ranges_();
+
+  // Find the last range beginning at or before |begin|.
+  auto found = std::upper_bound(
+      private_ranges_->begin(), private_ranges_->end(), begin,
+      [](uint64_t address, const debug::AddressRange& range) { return address < range.begin(); });
+  if (found == private_ranges_->begin())
+    return false;
+  --found;
+  return found->Contains(debug::AddressRange(begin, end));
+}
+
+void MemoryCache::FillPages(uint64_t begin, uint64_t end) {
+  std::vector<debug_ipc::MemoryBlock> blocks =
+      read_blocks_(begin, static_cast<uint32_t>(end - begin));
+
+  auto block = blocks.begin();
+  for (uint64_t page = begin; page < end; page += kPageSize) {
+    while (block != blocks.end() && block->address + block->size <= page)
+      ++block;
+    if (block == blocks.end())
+      return;
+
+    // Only cache pages completely covered by one block. Mappings are page-aligned so this should
+    // always be the case, but it's not worth trying to handle anything else.
+    if (block->address > page || block->address + block->size < page + kPageSize)
+      continue;
+    if (block->valid && block->data.size() != block->size)
+      continue;
+
+    Page& cached = pages_[page];
+    cached.valid = block->valid;
+    if (block->valid) {
+      auto src = block->data.begin() + (page - block->address);
+      cached.data.assign(src, src + kPageSize);
+    }
+  }
+}
+
+}  // namespace debug_agent
@@ -0,0 +1,91 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SRC_DEVELOPER_DEBUG_DEBUG_AGENT_MEMORY_CACHE_H_
+#define SRC_DEVELOPER_DEBUG_DEBUG_AGENT_MEMORY_CACHE_H_
+
+#include <lib/fit/function.h>
+
+#include <map>
+#include <optional>
+#include <vector>
+
+#include "src/developer/debug/ipc/records.h"
+#include "src/developer/debug/shared/address_range.h"
+#include "src/lib/fxl/macros.h"
+
+namespace debug_agent {
+
+// Page-granular cache of the memory of a stopped process.
+//
+// While a thread is stopped the client issues a lot of small reads of the same few pages (stack
+// walks, variable formatting, disassembly). This cache reads whole pages from the process on the
+// first access so the later reads don't need to go to the kernel.
+//
+// The cache has no idea when the memory changes. The owner must call Clear() whenever the process
+// may have run or its memory was written to. Memory that other processes can access (shared VMOs,
+// and unmapped addresses that another process could map something into) can change even while
+// every thread of this process is stopped, so only the ranges reported as private are cached.
+class MemoryCache {
+ public:
+  // Reads memory from the process. This has the same semantics as ProcessHandle::ReadMemoryBlocks.
+  using ReadBlocksFn = fit::function<std::vector<debug_ipc::MemoryBlock>(uint64_t, uint32_t)>;
+
+  // Returns the sorted, non-overlapping ranges of memory that only the process can modify. This
+  // has the same semantics as ProcessHandle::GetPrivateMemoryRanges. It is called at most once
+  // between two calls to Clear().
+  using PrivateRangesFn = fit::function<std::vector<debug::AddressRange>()>;
+
+  static constexpr uint64_t kPageSize = 4096;
+
+  // Requests larger than this are forwarded directly to the process without being cached.
+  static constexpr uint32_t kMaxCachedReadSize = 64 * kPageSize;
+
+  // When more than this number of pages is cached, the cache is flushed.
+  static constexpr size_t kMaxPages = 1024;
+
+  MemoryCache(ReadBlocksFn read_blocks, PrivateRangesFn private_ranges);
+
+  // Reads the given memory, going through the cache when |use_cache| is set. When it is not set,
+  // the cache is also cleared since the caller is saying the memory can't be trusted any more.
+  //
+  // The result is in the same format as ProcessHandle::ReadMemoryBlocks().
+  std::vector<debug_ipc::MemoryBlock> ReadMemoryBlocks(uint64_t address, uint32_t size,
+                                                       bool use_cache);
+
+  void Clear() {
+    pages_.clear();
+    private_ranges_.reset();
+  }
+
+  size_t page_count() const { return pages_.size(); }
+
+ private:
+  struct Page {
+    bool valid = false;
+    std::vector<uint8_t> data;  // kPageSize bytes when valid, empty otherwise.
+  };
+
+  // Returns true if the pages [begin, end) are all private to the process.
+  bool IsPrivate(uint64_t begin, uint64_t end);
+
+  // Reads the contiguous range of pages [begin, end) from the process and adds them to the cache.
+  // Pages that the process returns with mixed validity are not cached.
+  void FillPages(uint64_t begin, uint64_t end);
+
+  ReadBlocksFn read_blocks_;
+  PrivateRangesFn get_private_ranges_;
+
+  // Lazily fetched from |get_private_ranges_| after each Clear().
+  std::optional<std::vector<debug::AddressRange>> private_ranges_;
+
+  // Indexed by page address.
+  std::map<uint64_t, Page> pages_;
+
+  FXL_DISALLOW_COPY_ASSIGN_AND_MOVE(MemoryCache);
+};
+
+}  // namespace debug_agent
+
+#endif  // SRC_DEVELOPER_DEBUG_DEBUG_AGENT_MEMORY_CACHE_H_
@@ -0,0 +1,186 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/developer/debug/debug_agent/memory_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+namespace debug_agent {
+
+namespace {
+
+constexpr uint64_t kPageSize = MemoryCache::kPageSize;
+
+// Backs the cache with a process that has two valid pages at kValidBegin with an unmapped hole
+// before them. The value of each valid byte is the low byte of its address. All memory is private
+// unless the test says otherwise.
+constexpr uint64_t kValidBegin = 0x10000;
+constexpr uint64_t kValidEnd = kValidBegin + 2 * kPageSize;
+
+class MemoryCacheTest : public testing::Test {
+ public:
+  MemoryCacheTest()
+      : cache_([this](uint64_t address, uint32_t size) { return Read(address, size); },
+               [this]() {
+                 private_ranges_count_++;
+                 return private_ranges_;
+               }) {}
+
+  MemoryCache& cache() { return cache_; }
+  int read_count() const { return read_count_; }
+  int private_ranges_count() const { return private_ranges_count_; }
+
+  void set_private_ranges(std::vector<debug::AddressRange> ranges) {
+    private_ranges_ = std::move(ranges);
+  }
+
+ private:
+  std::vector<debug_ipc::MemoryBlock> Read(uint64_t address, uint32_t size) {
+    read_count_++;
+
+    std::vector<debug_ipc::MemoryBlock> blocks;
+    uint64_t end = address + size;
+    if (address < kValidBegin) {
+      auto& block = blocks.emplace_back();
+      block.address = address;
+      block.valid = false;
+      block.size = static_cast<uint32_t>(std::min(end, kValidBegin) - address);
+    }
+    if (end > kValidBegin && address < kValidEnd) {
+      auto& block = blocks.emplace_back();
+      block.address = std::max(address, kValidBegin);
+      block.valid = true;
+      block.size = static_cast<uint32_t>(std::min(end, kValidEnd) - block.address);
+      for (uint64_t i = block.address; i < block.address + block.size; i++)
+        block.data.push_back(static_cast<uint8_t>(i));
+    }
+    if (end > kValidEnd) {
+      auto& block = blocks.emplace_back();
+      block.address = std::max(address, kValidEnd);
+      block.valid = false;
+      block.size = static_cast<uint32_t>(end - block.address);
+    }
+    return blocks;
+  }
+
+  int read_count_ = 0;
+  int private_ranges_count_ = 0;
+  std::vector<debug::AddressRange> private_ranges_ = {debug::AddressRange::Everything()};
+  MemoryCache cache_;
+};
+
+}  // namespace
+
+TEST_F(MemoryCacheTest, ReadsWholePages) {
+  auto blocks = cache().ReadMemoryBlocks(kValidBegin + 16, 8, true);
+  ASSERT_EQ(1u, blocks.size());
+  EXPECT_EQ(kValidBegin + 16, blocks[0].address);
+  EXPECT_TRUE(blocks[0].valid);
+  EXPECT_EQ(8u, blocks[0].size);
+  EXPECT_EQ((std::vector<uint8_t>{16, 17, 18, 19, 20, 21, 22, 23}), blocks[0].data);
+  EXPECT_EQ(1, read_count());
+  EXPECT_EQ(1u, cache().page_count());
+
+  // Other reads on the same page are served from the cache.
+  blocks = cache().ReadMemoryBlocks(kValidBegin + kPageSize - 4, 4, true);
+  ASSERT_EQ(1u, blocks.size());
+  EXPECT_EQ((std::vector<uint8_t>{0xfc, 0xfd, 0xfe, 0xff}), blocks[0].data);
+  EXPECT_EQ(1, read_count());
+
+  // A read straddling into the next page only reads that page.
+  blocks = cache().ReadMemoryBlocks(kValidBegin + kPageSize - 2, 4, true);
+  ASSERT_EQ(1u, blocks.size());
+  EXPECT_EQ((std::vector<uint8_t>{0xfe, 0xff, 0x00, 0x01}), blocks[0].data);
+  EXPECT_EQ(2, read_count());
+  EXPECT_EQ(2u, cache().page_count());
+}
+
+TEST_F(MemoryCacheTest, InvalidPages) {
+  // Spans an invalid page, the two valid ones, and another invalid one, all read at once.
+  uint64_t address = kValidBegin - 8;
+  uint32_t size = 2 * kPageSize + 16;
+  auto blocks = cache().ReadMemoryBlocks(address, size, true);
+  EXPECT_EQ(1, read_count());
+  EXPECT_EQ(4u, cache().page_count());
+
+  ASSERT_EQ(3u, blocks.size());
+  EXPECT_EQ(address, blocks[0].address);
+  EXPECT_FALSE(blocks[0].valid);
+  EXPECT_EQ(8u, blocks[0].size);
+  EXPECT_TRUE(blocks[0].data.empty());
+
+  EXPECT_EQ(kValidBegin, blocks[1].address);
+  EXPECT_TRUE(blocks[1].valid);
+  EXPECT_EQ(2 * kPageSize, blocks[1].size);
+  ASSERT_EQ(2 * kPageSize, blocks[1].data.size());
+  EXPECT_EQ(0u, blocks[1].data[0]);
+  EXPECT_EQ(0xffu, blocks[1].data[2 * kPageSize - 1]);
+
+  EXPECT_EQ(kValidEnd, blocks[2].address);
+  EXPECT_FALSE(blocks[2].valid);
+  EXPECT_EQ(8u, blocks[2].size);
+
+  // The invalid pages are cached too.
+  blocks = cache().ReadMemoryBlocks(kValidBegin - 4, 4, true);
+  ASSERT_EQ(1u, blocks.size());
+  EXPECT_FALSE(blocks[0].valid);
+  EXPECT_EQ(4u, blocks[0].size);
+  EXPECT_EQ(1, read_count());
+}
+
+TEST_F(MemoryCacheTest, Bypass) {
+  cache().ReadMemoryBlocks(kValidBegin, 4, true);
+  EXPECT_EQ(1u, cache().page_count());
+
+  // Uncached reads go to the process and drop everything that was cached.
+  auto blocks = cache().ReadMemoryBlocks(kValidBegin, 4, false);
+  ASSERT_EQ(1u, blocks.size());
+  EXPECT_EQ(4u, blocks[0].data.size());
+  EXPECT_EQ(2, read_count());
+  EXPECT_EQ(0u, cache().page_count());
+
+  // Big reads aren't cached.
+  cache().ReadMemoryBlocks(kValidBegin, MemoryCache::kMaxCachedReadSize + 1, true);
+  EXPECT_EQ(3, read_count());
+  EXPECT_EQ(0u, cache().page_count());
+
+  cache().ReadMemoryBlocks(kValidBegin, 4, true);
+  EXPECT_EQ(1u, cache().page_count());
+  cache().Clear();
+  EXPECT_EQ(0u, cache().page_count());
+}
+
+TEST_F(MemoryCacheTest, SharedPages) {
+  // Only the first valid page is private, the second one is shared with another process.
+  set_private_ranges({debug::AddressRange(kValidBegin, kValidBegin + kPageSize)});
+
+  cache().ReadMemoryBlocks(kValidBegin, 4, true);
+  EXPECT_EQ(1, read_count());
+  EXPECT_EQ(1u, cache().page_count());
+
+  // Every read of the shared page goes to the process.
+  auto blocks = cache().ReadMemoryBlocks(kValidBegin + kPageSize, 4, true);
+  ASSERT_EQ(1u, blocks.size());
+  EXPECT_EQ((std::vector<uint8_t>{0x00, 0x01, 0x02, 0x03}), blocks[0].data);
+  EXPECT_EQ(2, read_count());
+  cache().ReadMemoryBlocks(kValidBegin + kPageSize, 4, true);
+  EXPECT_EQ(3, read_count());
+
+  // So does a read straddling the private and the shared pages.
+  blocks = cache().ReadMemoryBlocks(kValidBegin + kPageSize - 2, 4, true);
+  ASSERT_EQ(1u, blocks.size());
+  EXPECT_EQ((std::vector<uint8_t>{0xfe, 0xff, 0x00, 0x01}), blocks[0].data);
+  EXPECT_EQ(4, read_count());
+  EXPECT_EQ(1u, cache().page_count());
+
+  // The private ranges are only queried again once the cache is cleared.
+  EXPECT_EQ(1, private_ranges_count());
+  cache().Clear();
+  cache().ReadMemoryBlocks(kValidBegin, 4, true);
+  EXPECT_EQ(2, private_ranges_count());
+}
+
+}  // namespace debug_agent
@@ -39,6 +39,11 @@ class MockProcessHandle final : public ProcessHandle {
   debug::MockMemory& mock_memory() { return mock_memory_; }
   std::vector<MemoryWrite>& memory_writes() { return memory_writes_; }
 
+  // Value to return from GetPrivateMemoryRanges(). By default all memory is private.
+  void set_private_memory_ranges(std::vector<debug::AddressRange> ranges) {
+    private_memory_ranges_ = std::move(ranges);
+  }
+
   // Value to return from Kill().
   void set_kill_status(debug::Status s) { kill_status_ = std::move(s); }
 
@@ -57,6 +62,9 @@ class MockProcessHandle final : public ProcessHandle {
   void Detach() override;
   uint64_t GetLoaderBreakpointAddress() override;
   std::vector<debug_ipc::AddressRegion> GetAddressSpace(uint64_t address) const override;
+  std::vector<debug::AddressRange> GetPrivateMemoryRanges() const override {
+    return private_memory_ranges_;
+  }
   std::vector<debug_ipc::Module> GetModules() const override;
   fit::result<debug::Status, std::vector<debug_ipc::InfoHandle>> GetHandles() const override;
   debug::Status ReadMemory(uintptr_t address, void* buffer, size_t len,
@@ -85,6 +93,7 @@ class MockProcessHandle final : public ProcessHandle {
   std::vector<MemoryWrite> memory_writes_;
 
   debug::Status kill_status_;
+  std::vector<debug::AddressRange> private_memory_ranges_ = {debug::AddressRange::Everything()};
 };
 
 }  // namespace debug_agent
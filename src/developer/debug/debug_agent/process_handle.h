@@ -13,6 +13,7 @@
 #include <memory>
 #include <vector>
 
+#include "src/developer/debug/shared/address_range.h"
 #include "src/developer/debug/shared/status.h"
 
 namespace debug_ipc {
@@ -104,6 +105,11 @@ class ProcessHandle {
   // that address will be returned. Otherwise all regions will be returned.
   virtual std::vector<debug_ipc::AddressRegion> GetAddressSpace(uint64_t address) const = 0;
 
+  // Returns the sorted, non-overlapping ranges of the address space mapped from VMOs that no other
+  // process can access. Adjacent ranges are merged. Memory outside of these ranges can change even
+  // while all threads of the process are stopped.
+  virtual std::vector<debug::AddressRange> GetPrivateMemoryRanges() const = 0;
+
   // Returns the modules (shared libraries and the main binary) for the process. Will be empty on
   // failure.
   //
@@ -35,6 +35,10 @@ using ModuleVector = std::vector<debug_ipc::Module>;
 // Default unwinder type to use.
 UnwinderType unwinder_type = UnwinderType::kFuchsia;
 
+// How much of the stack, starting from the stack pointer, to read up-front when unwinding with the
+// Fuchsia unwinder. Most stacks being looked at fit in this.
+constexpr uint64_t kStackPrefetchSize = 64 * 1024;
+
 // The general registers include thread-specific information (fsbase/gsbase on x64, and tpidr on
 // ARM64). The unwinders don't deal with these registers because unwinding shouldn't affect them.
 // This function copies the current platform's thread-specific registers to the stack frame record
@@ -306,7 +310,12 @@ zx_status_t UnwindStackFuchsia(const ProcessHandle& process, const ModuleList& m
                                const ThreadHandle& thread, const GeneralRegisters& regs,
                                size_t max_depth, std::vector<debug_ipc::StackFrame>* stack) {
   // Prepare arguments for unwinder::Unwind.
-  unwinder::FuchsiaMemory memory(process.GetNativeHandle().get());
+  //
+  // The unwinder reads the stack a word at a time, so fetch the top of the stack in bulk and serve
+  // those reads (and the ones of the unwind tables) from a cache instead of one syscall each.
+  unwinder::FuchsiaMemory fuchsia_memory(process.GetNativeHandle().get());
+  unwinder::CachedMemory memory(&fuchsia_memory);
+  memory.Prefetch(regs.sp(), kStackPrefetchSize);
   std::vector<uint64_t> module_bases;
   module_bases.reserve(modules.modules().size());
   for (const auto& module : modules.modules()) {
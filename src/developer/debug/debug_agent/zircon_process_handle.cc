@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <set>
 
 #include "src/developer/debug/debug_agent/debugged_thread.h"
 #include "src/developer/debug/debug_agent/elf_utils.h"
@@ -165,6 +166,48 @@ std::vector<debug_ipc::AddressRegion> ZirconProcessHandle::GetAddressSpace(uint6
   return regions;
 }
 
+std::vector<debug::AddressRange> ZirconProcessHandle::GetPrivateMemoryRanges() const {
+  // Collect the VMOs whose contents can change without this process running.
+  size_t vmo_actual = 0;
+  size_t vmo_avail = 0;
+  if (process_.get_info(ZX_INFO_PROCESS_VMOS, nullptr, 0, &vmo_actual, &vmo_avail) != ZX_OK)
+    return {};
+  vmo_avail += 64;  // The process could map or open more VMOs in between the two queries.
+
+  std::vector<zx_info_vmo_t> vmos(vmo_avail);
+  if (process_.get_info(ZX_INFO_PROCESS_VMOS, vmos.data(), vmo_avail * sizeof(zx_info_vmo_t),
+                        &vmo_actual, &vmo_avail) != ZX_OK || vmo_actual < vmo_avail)
+    return {};  // Missing VMOs could be shared ones, so report nothing as private.
+  vmos.resize(vmo_actual);
+
+  std::set<zx_koid_t> shared_vmos;
+  for (const auto& vmo : vmos) {
+    // Besides VMOs mapped by other processes, a handle held by this process could have been sent
+    // to another one, slices share their pages with their parent, and physical and contiguous
+    // VMOs can be written by devices.
+    bool is_slice = vmo.parent_koid != ZX_KOID_INVALID && !(vmo.flags & ZX_INFO_VMO_IS_COW_CLONE);
+    if (vmo.share_count > 1 || (vmo.flags & ZX_INFO_VMO_VIA_HANDLE) || is_slice ||
+        ZX_INFO_VMO_TYPE(vmo.flags) != ZX_INFO_VMO_TYPE_PAGED ||
+        (vmo.flags & ZX_INFO_VMO_CONTIGUOUS))
+      shared_vmos.insert(vmo.koid);
+  }
+
+  // The maps are sorted by address.
+  std::vector<debug::AddressRange> ranges;
+  for (const auto& entry : GetMaps()) {
+    if (entry.type != ZX_INFO_MAPS_TYPE_MAPPING ||
+        shared_vmos.find(entry.u.mapping.vmo_koid) != shared_vmos.end())
+      continue;
+
+    if (!ranges.empty() && ranges.back().end() == entry.base) {
+      ranges.back() = debug::AddressRange(ranges.back().begin(), entry.base + entry.size);
+    } else {
+      ranges.emplace_back(entry.base, entry.base + entry.size);
+    }
+  }
+  return ranges;
+}
+
 std::vector<debug_ipc::Module> ZirconProcessHandle::GetModules() const {
   uintptr_t dl_debug_addr;
   FX_CHECK(process_.get_property(ZX_PROP_PROCESS_DEBUG_ADDR, &dl_debug_addr,
@@ -28,6 +28,7 @@ class ZirconProcessHandle final : public ProcessHandle, public debug::ZirconExce
   void Detach() override;
   uint64_t GetLoaderBreakpointAddress() override;
   std::vector<debug_ipc::AddressRegion> GetAddressSpace(uint64_t address) const override;
+  std::vector<debug::AddressRange> GetPrivateMemoryRanges() const override;
   std::vector<debug_ipc::Module> GetModules() const override;
   fit::result<debug::Status, std::vector<debug_ipc::InfoHandle>> GetHandles() const override;
   debug::Status ReadMemory(uintptr_t address, void* buffer, size_t len,
@@ -34,7 +34,7 @@ namespace debug_ipc {
 // CURRENT_SUPPORTED_API_LEVEL is equal to FUCHSIA_API_LEVEL specified in platform_version.json.
 // If not, continue reading the comments below.
 
-constexpr uint32_t kCurrentProtocolVersion = 54;
+constexpr uint32_t kCurrentProtocolVersion = 55;
 
 // How to decide kMinimumProtocolVersion
 // -------------------------------------
@@ -109,7 +109,8 @@ static_assert(static_cast<int>(debug::Arch::kArm64) == 2);
   FN(WriteMemory)                 \
   FN(LoadInfoHandleTable)         \
   FN(UpdateGlobalSettings)        \
-  FN(SaveMinidump)
+  FN(SaveMinidump)                \
+  FN(ReadMemoryBatch)
 
 // The "notify" messages are sent unrequested from the agent to the client.
 //
@@ -160,6 +161,7 @@ struct MsgHeader {
     kLoadInfoHandleTable = 22,
     kUpdateGlobalSettings = 23,
     kSaveMinidump = 24,
+    kReadMemoryBatch = 25,
 
     kNotifyException = 101,
     kNotifyIO = 102,
@@ -395,6 +397,23 @@ struct ReadMemoryReply {
   void Serialize(Serializer& ser, uint32_t ver) { ser | blocks; }
 };
 
+// Reads several ranges of memory in one round trip. Each range is limited to the same size as a
+// single ReadMemoryRequest. The reply contains one list of blocks for each requested range, in the
+// same order, each having the same format as a ReadMemoryReply.
+struct ReadMemoryBatchRequest {
+  static constexpr uint32_t kSupportedSinceVersion = 55;
+
+  uint64_t process_koid = 0;
+  std::vector<debug::AddressRange> ranges;
+
+  void Serialize(Serializer& ser, uint32_t ver) { ser | process_koid | ranges; }
+};
+struct ReadMemoryBatchReply {
+  std::vector<std::vector<MemoryBlock>> blocks;
+
+  void Serialize(Serializer& ser, uint32_t ver) { ser | blocks; }
+};
+
 struct AddOrChangeBreakpointRequest {
   BreakpointSettings breakpoint;
 
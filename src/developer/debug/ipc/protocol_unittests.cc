@@ -405,6 +405,58 @@ TEST(Protocol, ReadMemoryReply) {
   EXPECT_TRUE(second.blocks[1].data.empty());
 }
 
+TEST(Protocol, ReadMemoryBatchRequest) {
+  ReadMemoryBatchRequest initial;
+  initial.process_koid = 91823765;
+  initial.ranges.emplace_back(0x1000, 0x1010);
+  initial.ranges.emplace_back(0x8000, 0x9000);
+
+  ReadMemoryBatchRequest second;
+  ASSERT_TRUE(SerializeDeserialize(initial, &second));
+  EXPECT_EQ(initial.process_koid, second.process_koid);
+  ASSERT_EQ(2u, second.ranges.size());
+  EXPECT_EQ(initial.ranges[0], second.ranges[0]);
+  EXPECT_EQ(initial.ranges[1], second.ranges[1]);
+
+  // Older agents don't know about this message so it must not be sent.
+  EXPECT_TRUE(Serialize(initial, 1, ReadMemoryBatchRequest::kSupportedSinceVersion - 1).empty());
+}
+
+TEST(Protocol, ReadMemoryBatchReply) {
+  ReadMemoryBatchReply initial;
+  initial.blocks.resize(2);
+  initial.blocks[0].resize(1);
+  initial.blocks[0][0].address = 0x1000;
+  initial.blocks[0][0].valid = true;
+  initial.blocks[0][0].size = 4;
+  initial.blocks[0][0].data = {1, 2, 3, 4};
+
+  initial.blocks[1].resize(2);
+  initial.blocks[1][0].address = 0x8000;
+  initial.blocks[1][0].valid = false;
+  initial.blocks[1][0].size = 0x800;
+  initial.blocks[1][1].address = 0x8800;
+  initial.blocks[1][1].valid = true;
+  initial.blocks[1][1].size = 1;
+  initial.blocks[1][1].data = {99};
+
+  ReadMemoryBatchReply second;
+  ASSERT_TRUE(SerializeDeserialize(initial, &second));
+
+  ASSERT_EQ(2u, second.blocks.size());
+  ASSERT_EQ(1u, second.blocks[0].size());
+  EXPECT_EQ(0x1000u, second.blocks[0][0].address);
+  EXPECT_TRUE(second.blocks[0][0].valid);
+  EXPECT_EQ(initial.blocks[0][0].data, second.blocks[0][0].data);
+
+  ASSERT_EQ(2u, second.blocks[1].size());
+  EXPECT_FALSE(second.blocks[1][0].valid);
+  EXPECT_EQ(0x800u, second.blocks[1][0].size);
+  EXPECT_TRUE(second.blocks[1][0].data.empty());
+  EXPECT_EQ(0x8800u, second.blocks[1][1].address);
+  EXPECT_EQ(initial.blocks[1][1].data, second.blocks[1][1].data);
+}
+
 // AddOrChangeBreakpoint ---------------------------------------------------------------------------
 
 TEST(Protocol, AddOrChangeBreakpointRequest) {
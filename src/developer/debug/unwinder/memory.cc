@@ -4,7 +4,9 @@
 
 #include "src/developer/debug/unwinder/memory.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <limits>
 
 #include "src/developer/debug/unwinder/error.h"
 
@@ -172,4 +174,54 @@ Error BoundedLocalMemory::ReadBytes(uint64_t addr, uint64_t size, void* dst) {
   return Error("out of boundry");
 }
 
+void CachedMemory::Prefetch(uint64_t addr, uint64_t size) {
+  uint64_t begin = addr & ~(kPageSize - 1);
+  uint64_t end = std::numeric_limits<uint64_t>::max() & ~(kPageSize - 1);
+  if (addr + size >= addr && addr + size <= end)
+    end = (addr + size + kPageSize - 1) & ~(kPageSize - 1);
+
+  // The end of the range is probably not mapped, e.g., the stack is smaller than |size|. Keep
+  // halving the range until a read succeeds.
+  while (end > begin && !FetchPages(begin, end)) {
+    uint64_t pages = (end - begin) / kPageSize;
+    if (pages <= 1)
+      break;
+    end = begin + (pages / 2) * kPageSize;
+  }
+}
+
+Error CachedMemory::ReadBytes(uint64_t addr, uint64_t size, void* dst) {
+  uint64_t end = addr + size;
+  if (size == 0 || end < addr || end > (std::numeric_limits<uint64_t>::max() & ~(kPageSize - 1)))
+    return backing_->ReadBytes(addr, size, dst);
+
+  auto* out = static_cast<uint8_t*>(dst);
+  for (uint64_t cur = addr; cur < end;) {
+    uint64_t page = cur & ~(kPageSize - 1);
+    auto found = pages_.find(page);
+    if (found == pages_.end()) {
+      if (!FetchPages(page, page + kPageSize)) {
+        // Let the backing memory generate the error or handle partially mapped pages.
+        return backing_->ReadBytes(addr, size, dst);
+      }
+      found = pages_.find(page);
+    }
+    uint64_t copy_end = std::min(end, page + kPageSize);
+    memcpy(out + (cur - addr), found->second.data() + (cur - page), copy_end - cur);
+    cur = copy_end;
+  }
+  return Success();
+}
+
+bool CachedMemory::FetchPages(uint64_t begin, uint64_t end) {
+  std::vector<uint8_t> data(end - begin);
+  if (backing_->ReadBytes(begin, data.size(), data.data()).has_err())
+    return false;
+  for (uint64_t page = begin; page < end; page += kPageSize) {
+    auto src = data.begin() + (page - begin);
+    pages_[page].assign(src, src + kPageSize);
+  }
+  return true;
+}
+
 }  // namespace unwinder
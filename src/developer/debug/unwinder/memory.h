@@ -8,6 +8,7 @@
 #include <cstdint>
 #include <cstring>
 #include <map>
+#include <vector>
 
 #include "src/developer/debug/unwinder/error.h"
 
@@ -61,6 +62,34 @@ class BoundedLocalMemory : public LocalMemory {
   std::map<uint64_t, uint64_t> regions_;
 };
 
+// Caches another Memory in pages. The unwinder reads the stack and the unwind tables a few bytes
+// at a time, which is slow when each read is a syscall.
+//
+// The backing memory must not change while this object is in use.
+class CachedMemory : public Memory {
+ public:
+  static constexpr uint64_t kPageSize = 4096;
+
+  // The ownership of the backing memory is not taken. It must outlast this object.
+  explicit CachedMemory(Memory* backing) : backing_(backing) {}
+
+  // Reads as much as possible of [addr, addr + size) from the backing memory, in as few reads as
+  // possible. Used to fetch e.g. the top of the stack in bulk before unwinding.
+  void Prefetch(uint64_t addr, uint64_t size);
+
+  // |Memory| implementation.
+  Error ReadBytes(uint64_t addr, uint64_t size, void* dst) override;
+
+  size_t page_count() const { return pages_.size(); }
+
+ private:
+  // Tries to read and cache the pages in [begin, end), which must be page-aligned.
+  bool FetchPages(uint64_t begin, uint64_t end);
+
+  Memory* backing_;
+  std::map<uint64_t, std::vector<uint8_t>> pages_;  // Indexed by page address.
+};
+
 }  // namespace unwinder
 
 #endif  // SRC_DEVELOPER_DEBUG_UNWINDER_MEMORY_H_
@@ -90,4 +90,48 @@ TEST(BoundedLocalMemory, Read) {
   ASSERT_TRUE(mem.Read(p, res).has_err());
 }
 
+TEST(CachedMemory, Read) {
+  // Counts the reads of the backing memory.
+  class CountingMemory : public BoundedLocalMemory {
+   public:
+    Error ReadBytes(uint64_t addr, uint64_t size, void* dst) override {
+      reads++;
+      return BoundedLocalMemory::ReadBytes(addr, size, dst);
+    }
+    int reads = 0;
+  };
+
+  // Four pages of which only the first three are readable.
+  alignas(CachedMemory::kPageSize) static uint8_t data[4 * CachedMemory::kPageSize];
+  for (size_t i = 0; i < sizeof(data); i++)
+    data[i] = static_cast<uint8_t>(i);
+  auto p = reinterpret_cast<uint64_t>(data);
+
+  CountingMemory backing;
+  backing.AddRegion(p, 3 * CachedMemory::kPageSize);
+  CachedMemory mem(&backing);
+
+  // The prefetch fails for the whole range and falls back to the first two pages.
+  mem.Prefetch(p, sizeof(data));
+  ASSERT_EQ(2u, mem.page_count());
+  ASSERT_EQ(2, backing.reads);
+
+  // Reads in the prefetched range don't touch the backing memory, even across pages.
+  uint32_t u32;
+  ASSERT_TRUE(mem.Read(p + CachedMemory::kPageSize - 2, u32).ok());
+  ASSERT_EQ(0x0100FFFEu, u32);
+  ASSERT_EQ(2, backing.reads);
+
+  // Reading the third page fetches it.
+  uint8_t u8;
+  ASSERT_TRUE(mem.Read(p + 2 * CachedMemory::kPageSize + 5, u8).ok());
+  ASSERT_EQ(5, u8);
+  ASSERT_EQ(3u, mem.page_count());
+  ASSERT_EQ(3, backing.reads);
+
+  // The fourth page is not readable.
+  ASSERT_TRUE(mem.Read(p + 3 * CachedMemory::kPageSize, u8).has_err());
+  ASSERT_EQ(3u, mem.page_count());
+}
+
 }  // namespace unwinder
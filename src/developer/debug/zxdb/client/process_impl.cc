@@ -39,6 +39,14 @@ ProcessImpl::ProcessImpl(TargetImpl* target, uint64_t koid, const std::string& n
       weak_factory_(this) {}
 
 ProcessImpl::~ProcessImpl() {
+  // Reads that were waiting to be batched will never be sent.
+  for (auto& read : pending_reads_) {
+    debug::MessageLoop::Current()->PostTask(
+        FROM_HERE, [callback = std::move(read.callback)]() mutable {
+          callback(Err("Process went away while reading memory."), MemoryDump());
+        });
+  }
+
   // Send notifications for all destroyed threads.
   for (const auto& thread : threads_) {
     for (auto& observer : session()->thread_observers())
@@ -55,6 +63,8 @@ ThreadImpl* ProcessImpl::GetThreadImplFromKoid(uint64_t koid) {
 
 void ProcessImpl::GetModules(
     fit::callback<void(const Err&, std::vector<debug_ipc::Module>)> callback) {
+  FlushPendingReads();
+
   debug_ipc::ModulesRequest request;
   request.process_koid = koid_;
   session()->remote_api()->Modules(
@@ -94,6 +104,8 @@ std::vector<Thread*> ProcessImpl::GetThreads() const {
 Thread* ProcessImpl::GetThreadFromKoid(uint64_t koid) { return GetThreadImplFromKoid(koid); }
 
 void ProcessImpl::SyncThreads(fit::callback<void()> callback) {
+  FlushPendingReads();
+
   debug_ipc::ThreadsRequest request;
   request.process_koid = koid_;
   session()->remote_api()->Threads(
@@ -108,6 +120,8 @@ void ProcessImpl::SyncThreads(fit::callback<void()> callback) {
 }
 
 void ProcessImpl::Pause(fit::callback<void()> on_paused) {
+  FlushPendingReads();
+
   debug_ipc::PauseRequest request;
   request.ids.push_back({.process = koid_, .thread = 0});
   session()->remote_api()->Pause(
@@ -199,6 +213,25 @@ void ProcessImpl::ReadMemory(uint64_t address, uint32_t size,
       }
     }
   }
+
+  if (session()->ipc_version() < debug_ipc::ReadMemoryBatchRequest::kSupportedSinceVersion) {
+    SendReadMemory(address, size, std::move(callback));
+    return;
+  }
+
+  // Formatting a structure or a stack issues many independent reads at once. Queue them and send
+  // them together when the current task is done to save the round trips.
+  if (pending_reads_.empty()) {
+    debug::MessageLoop::Current()->PostTask(FROM_HERE, [weak_this = GetWeakPtr()]() {
+      if (weak_this)
+        weak_this->FlushPendingReads();
+    });
+  }
+  pending_reads_.push_back({address, size, std::move(callback)});
+}
+
+void ProcessImpl::SendReadMemory(uint64_t address, uint32_t size,
+                                 fit::callback<void(const Err&, MemoryDump)> callback) {
   debug_ipc::ReadMemoryRequest request;
   request.process_koid = koid_;
   request.address = address;
@@ -210,8 +243,46 @@ void ProcessImpl::ReadMemory(uint64_t address, uint32_t size,
       });
 }
 
+void ProcessImpl::FlushPendingReads() {
+  if (!pending_reads_.empty())
+    SendPendingReads();
+}
+
+void ProcessImpl::SendPendingReads() {
+  std::vector<PendingRead> reads = std::move(pending_reads_);
+  pending_reads_.clear();
+
+  if (reads.size() == 1) {
+    SendReadMemory(reads[0].address, reads[0].size, std::move(reads[0].callback));
+    return;
+  }
+
+  debug_ipc::ReadMemoryBatchRequest request;
+  request.process_koid = koid_;
+  request.ranges.reserve(reads.size());
+  for (const auto& read : reads)
+    request.ranges.emplace_back(read.address, read.address + read.size);
+
+  session()->remote_api()->ReadMemoryBatch(
+      request, [reads = std::move(reads)](const Err& err,
+                                          debug_ipc::ReadMemoryBatchReply reply) mutable {
+        for (size_t i = 0; i < reads.size(); i++) {
+          if (err.has_error()) {
+            reads[i].callback(err, MemoryDump());
+          } else if (i >= reply.blocks.size()) {
+            reads[i].callback(Err("Missing memory in the reply from the debug agent."),
+                              MemoryDump());
+          } else {
+            reads[i].callback(Err(), MemoryDump(std::move(reply.blocks[i])));
+          }
+        }
+      });
+}
+
 void ProcessImpl::WriteMemory(uint64_t address, std::vector<uint8_t> data,
                               fit::callback<void(const Err&)> callback) {
+  FlushPendingReads();
+
   debug_ipc::WriteMemoryRequest request;
   request.process_koid = koid_;
   request.address = address;
@@ -234,6 +305,8 @@ void ProcessImpl::WriteMemory(uint64_t address, std::vector<uint8_t> data,
 
 void ProcessImpl::LoadInfoHandleTable(
     fit::callback<void(ErrOr<std::vector<debug_ipc::InfoHandle>> handles)> callback) {
+  FlushPendingReads();
+
   debug_ipc::LoadInfoHandleTableRequest request;
   request.process_koid = koid_;
   session()->remote_api()->LoadInfoHandleTable(
@@ -282,6 +355,7 @@ void ProcessImpl::OnThreadExiting(const debug_ipc::ThreadRecord& record) {
 void ProcessImpl::OnModules(std::vector<debug_ipc::Module> modules) {
   FixupEmptyModuleNames(modules);
   symbols_.SetModules(modules);
+  FlushPendingReads();
 
   // The process is stopped so we have time to load symbols and enable any pending breakpoints.
   // Now that the notification is complete, resume the process.
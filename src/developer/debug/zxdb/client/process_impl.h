@@ -10,6 +10,7 @@
 
 #include "src/developer/debug/ipc/protocol.h"
 #include "src/developer/debug/ipc/records.h"
+#include "src/developer/debug/zxdb/client/memory_dump.h"
 #include "src/developer/debug/zxdb/client/process.h"
 #include "src/developer/debug/zxdb/client/target_impl.h"
 #include "src/developer/debug/zxdb/symbols/process_symbols.h"
@@ -72,6 +73,11 @@ class ProcessImpl : public Process, public ProcessSymbols::Notifications {
   // Returns true if the caller should show the output. False means silence.
   bool HandleIO(const debug_ipc::NotifyIO&);
 
+  // Sends the reads queued by ReadMemory() now instead of at the end of the current task. This must
+  // be called before sending any other request about this process so that the agent handles the
+  // reads first: they must not see the effect of a later write or resume.
+  void FlushPendingReads();
+
   // ProcessSymbols::Notifications implementation (public portion):
   void OnSymbolLoadFailure(const Err& err) override;
 
@@ -105,6 +111,13 @@ class ProcessImpl : public Process, public ProcessSymbols::Notifications {
   // Load the TLS helpers.
   void LoadTLSHelpers();
 
+  // Sends a single ReadMemory request to the agent.
+  void SendReadMemory(uint64_t address, uint32_t size,
+                      fit::callback<void(const Err&, MemoryDump)> callback);
+
+  // Sends all the reads queued by ReadMemory() as one ReadMemoryBatch request.
+  void SendPendingReads();
+
   // Updates modules with empty names to reflect the name of the process binary. By convention,
   // the dynamic loader will set the main binary to have a blank name.
   void FixupEmptyModuleNames(std::vector<debug_ipc::Module>& modules) const;
@@ -128,6 +141,14 @@ class ProcessImpl : public Process, public ProcessSymbols::Notifications {
   // Lazily-populated.
   mutable fxl::RefPtr<ProcessSymbolDataProvider> symbol_data_provider_;
 
+  // Memory reads waiting to be sent by SendPendingReads().
+  struct PendingRead {
+    uint64_t address = 0;
+    uint32_t size = 0;
+    fit::callback<void(const Err&, MemoryDump)> callback;
+  };
+  std::vector<PendingRead> pending_reads_;
+
   fxl::WeakPtrFactory<ProcessImpl> weak_factory_;
 
   FXL_DISALLOW_COPY_AND_ASSIGN(ProcessImpl);
@@ -42,11 +42,39 @@ class ProcessSink : public MockRemoteAPI {
 
   bool thread_request_made() const { return thread_request_made_; }
 
+  // The names of the memory requests, in the order they were sent.
+  const std::vector<std::string>& memory_requests() const { return memory_requests_; }
+
+  void ReadMemoryBatch(
+      const debug_ipc::ReadMemoryBatchRequest& request,
+      fit::callback<void(const Err&, debug_ipc::ReadMemoryBatchReply)> cb) override {
+    memory_requests_.push_back("ReadMemoryBatch");
+    debug_ipc::ReadMemoryBatchReply reply;
+    for (const auto& range : request.ranges) {
+      reply.blocks.push_back({{.address = range.begin(),
+                               .valid = false,
+                               .size = static_cast<uint32_t>(range.size())}});
+    }
+    debug::MessageLoop::Current()->PostTask(
+        FROM_HERE, [cb = std::move(cb), reply = std::move(reply)]() mutable {
+          cb(Err(), std::move(reply));
+        });
+  }
+
+  void WriteMemory(const debug_ipc::WriteMemoryRequest& request,
+                   fit::callback<void(const Err&, debug_ipc::WriteMemoryReply)> cb) override {
+    memory_requests_.push_back("WriteMemory");
+    debug::MessageLoop::Current()->PostTask(
+        FROM_HERE, [cb = std::move(cb)]() mutable { cb(Err(), debug_ipc::WriteMemoryReply()); });
+  }
+
  private:
   debug_ipc::ResumeRequest resume_request_;
   int resume_count_ = 0;
 
   bool thread_request_made_ = false;
+
+  std::vector<std::string> memory_requests_;
 };
 
 class ProcessImplTest : public RemoteAPITest {
@@ -342,4 +370,36 @@ TEST_F(ProcessImplTest, ReadMemoryAutomation) {
   loop().RunUntilNoTasks();
 }
 
+// Reads are batched until the end of the current task, but must still reach the agent before any
+// later request that could change the memory.
+TEST_F(ProcessImplTest, ReadMemoryBatchedBeforeWrite) {
+  constexpr uint64_t kProcessKoid = 1234;
+  session().set_ipc_version(debug_ipc::ReadMemoryBatchRequest::kSupportedSinceVersion);
+  Process* process = InjectProcess(kProcessKoid);
+  ASSERT_TRUE(process);
+
+  int read_count = 0;
+  auto read_callback = [&read_count](const Err& err, MemoryDump dump) {
+    EXPECT_TRUE(err.ok());
+    read_count++;
+  };
+  process->ReadMemory(0x1000, 8, read_callback);
+  process->ReadMemory(0x2000, 8, read_callback);
+  EXPECT_TRUE(sink()->memory_requests().empty());
+
+  bool write_done = false;
+  process->WriteMemory(0x1000, {1, 2, 3, 4}, [&write_done](const Err& err) {
+    EXPECT_TRUE(err.ok());
+    write_done = true;
+  });
+  EXPECT_EQ((std::vector<std::string>{"ReadMemoryBatch", "WriteMemory"}),
+            sink()->memory_requests());
+
+  // The reads aren't sent a second time at the end of the task.
+  loop().RunUntilNoTasks();
+  EXPECT_EQ(2u, sink()->memory_requests().size());
+  EXPECT_EQ(2, read_count);
+  EXPECT_TRUE(write_done);
+}
+
 }  // namespace zxdb
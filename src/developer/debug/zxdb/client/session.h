@@ -80,6 +80,9 @@ class Session : public SettingStoreObserver {
   // The RempteAPI for sending messages to the debug_agent.
   RemoteAPI* remote_api() { return remote_api_.get(); }
   uint32_t ipc_version() const { return ipc_version_; }
+  // The version is normally negotiated when connecting. Tests using a custom RemoteAPI can set it
+  // to exercise the newer messages.
+  void set_ipc_version(uint32_t version) { ipc_version_ = version; }
 
   void AddObserver(SessionObserver* observer) { observers_.AddObserver(observer); }
   void RemoveObserver(SessionObserver* observer) { observers_.RemoveObserver(observer); }
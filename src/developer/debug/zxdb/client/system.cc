@@ -657,6 +657,11 @@ void System::DeleteFilter(Filter* filter) {
 }
 
 void System::Pause(fit::callback<void()> on_paused) {
+  for (const auto& target : targets_) {
+    if (ProcessImpl* process = target->process())
+      process->FlushPendingReads();
+  }
+
   debug_ipc::PauseRequest request;  // Unset process/thread means everything.
   session()->remote_api()->Pause(
       request, [weak_system = weak_factory_.GetWeakPtr(), on_paused = std::move(on_paused)](
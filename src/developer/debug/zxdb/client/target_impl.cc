@@ -126,6 +126,8 @@ void TargetImpl::Kill(Callback callback) {
     return;
   }
 
+  process_->FlushPendingReads();
+
   debug_ipc::KillRequest request;
   request.process_koid = process_->GetKoid();
   session()->remote_api()->Kill(
@@ -175,6 +177,8 @@ void TargetImpl::Detach(Callback callback) {
     return;
   }
 
+  process_->FlushPendingReads();
+
   debug_ipc::DetachRequest request;
   request.koid = process_->GetKoid();
   session()->remote_api()->Detach(
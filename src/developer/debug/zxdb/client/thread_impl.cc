@@ -68,6 +68,7 @@ void ThreadImpl::Pause(fit::callback<void()> on_paused) {
   debug_ipc::PauseRequest request;
   request.ids.push_back({.process = process_->GetKoid(), .thread = koid_});
 
+  process_->FlushPendingReads();
   session()->remote_api()->Pause(
       request, [weak_thread = weak_factory_.GetWeakPtr(), on_paused = std::move(on_paused)](
                    const Err& err, debug_ipc::PauseReply reply) mutable {
@@ -136,6 +137,7 @@ void ThreadImpl::Continue(bool forward_exception) {
   }
 
   ClearState();
+  process_->FlushPendingReads();
   session()->remote_api()->Resume(request, [](const Err& err, debug_ipc::ResumeReply) {});
 }
 
@@ -209,6 +211,7 @@ void ThreadImpl::JumpTo(uint64_t new_address, fit::callback<void(const Err&)> cb
   //
   // Another approach is to make the register request message able to optionally request a stack
   // backtrace and include that in the reply.
+  process_->FlushPendingReads();
   session()->remote_api()->WriteRegisters(
       request, [thread = weak_factory_.GetWeakPtr(), cb = std::move(cb)](
                    const Err& err, debug_ipc::WriteRegistersReply reply) mutable {
@@ -243,6 +246,7 @@ void ThreadImpl::StepInstructions(uint64_t count) {
   request.ids.push_back({.process = process_->GetKoid(), .thread = koid_});
   request.how = debug_ipc::ResumeRequest::How::kStepInstruction;
   request.count = count;
+  process_->FlushPendingReads();
   session()->remote_api()->Resume(request, [](const Err& err, debug_ipc::ResumeReply) {});
 }
 
@@ -382,6 +386,7 @@ void ThreadImpl::SyncFramesForStack(fit::callback<void(const Err&)> callback) {
   debug_ipc::ThreadStatusRequest request;
   request.id = {.process = process_->GetKoid(), .thread = koid_};
 
+  process_->FlushPendingReads();
   session()->remote_api()->ThreadStatus(
       request, [callback = std::move(callback), thread = weak_factory_.GetWeakPtr()](
                    const Err& err, debug_ipc::ThreadStatusReply reply) mutable {
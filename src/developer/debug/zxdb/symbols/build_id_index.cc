@@ -110,6 +110,12 @@ void BuildIDIndex::SetCacheDir(const std::string& cache_dir) {
   cache_dir_ = std::make_unique<CacheDir>(cache_dir);
 }
 
+std::filesystem::path BuildIDIndex::GetIndexCachePath(const std::string& build_id) const {
+  if (!cache_dir_ || build_id.size() <= 2)
+    return std::filesystem::path();
+  return cache_dir_->path() / build_id.substr(0, 2) / (build_id.substr(2) + ".zxdb_index");
+}
+
 void BuildIDIndex::AddSymbolIndexFile(const std::string& path) {
   if (StringEndsWith(path, ".json")) {
     LoadSymbolIndexFileJSON(path);
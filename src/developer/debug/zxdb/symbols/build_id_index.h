@@ -110,6 +110,11 @@ class BuildIDIndex {
   // Returns the path to the cache directory or an empty path if it's not set.
   std::filesystem::path GetCacheDir() const { return cache_dir_ ? cache_dir_->path() : ""; }
 
+  // Returns the path in the cache directory at which the symbol index for the given build ID is
+  // saved (see Index::WriteToFile()), or an empty path if there's no cache directory or build ID.
+  // Like the symbol files, these are stored as ab/cdefg.zxdb_index.
+  std::filesystem::path GetIndexCachePath(const std::string& build_id) const;
+
   // Add a symbol-index file that indexes various symbol sources.
   //
   // Two versions of symbol-index files are supported currently:
@@ -16,6 +16,7 @@
 #include <llvm/DebugInfo/DWARF/DWARFCompileUnit.h>
 #include <llvm/DebugInfo/DWARF/DWARFContext.h>
 #include <llvm/DebugInfo/DWARF/DWARFDebugArangeSet.h>
+#include <llvm/DebugInfo/DWARF/DWARFDebugInfoEntry.h>
 #include <llvm/DebugInfo/DWARF/DWARFUnit.h>
 #include <llvm/Object/Binary.h>
 #include <llvm/Object/ELFObjectFile.h>
@@ -23,6 +24,7 @@
 #include <llvm/Support/Error.h>
 
 #include "src/developer/debug/shared/logging/logging.h"
+#include "src/developer/debug/shared/message_loop.h"
 #include "src/developer/debug/zxdb/common/file_util.h"
 #include "src/developer/debug/zxdb/symbols/dwarf_unit_impl.h"
 #include "src/lib/elflib/elflib.h"
@@ -247,6 +249,66 @@ fxl::RefPtr<DwarfUnit> DwarfBinaryImpl::FromLLVMUnit(llvm::DWARFUnit* llvm_unit)
   return found->second;
 }
 
+const llvm::DWARFDebugLine::LineTable* DwarfBinaryImpl::GetLineTableForUnit(
+    llvm::DWARFUnit* unit) {
+  fxl::RefPtr<DwarfUnit> dwarf_unit = FromLLVMUnit(unit);
+  if (!dwarf_unit)
+    return nullptr;
+  return dwarf_unit->GetLLVMLineTable();
+}
+
+void DwarfBinaryImpl::NoteUnitUse(llvm::DWARFUnit* unit, bool used_dies) {
+  auto found = unit_lru_map_.find(unit);
+  if (found == unit_lru_map_.end()) {
+    unit_lru_.push_front(CachedUnit{unit});
+    found = unit_lru_map_.emplace(unit, unit_lru_.begin()).first;
+  } else if (found->second != unit_lru_.begin()) {
+    unit_lru_.splice(unit_lru_.begin(), unit_lru_, found->second);
+  }
+
+  CachedUnit& cached = *found->second;
+  cached.has_dies |= used_dies;
+
+  uint64_t size = 0;
+  if (cached.has_dies) {
+    // The DIEs have already been extracted so this won't parse them.
+    size += unit->getNumDIEs() * sizeof(llvm::DWARFDebugInfoEntry);
+  }
+  if (auto found_unit = unit_map_.find(unit); found_unit != unit_map_.end())
+    size += static_cast<DwarfUnitImpl*>(found_unit->second.get())->GetCachedDataSize();
+
+  unit_cache_size_ = unit_cache_size_ - cached.size + size;
+  cached.size = size;
+
+  if (unit_cache_size_ > unit_cache_budget_ && !unit_cache_trim_pending_) {
+    if (debug::MessageLoop* loop = debug::MessageLoop::Current()) {
+      unit_cache_trim_pending_ = true;
+      loop->PostTask(FROM_HERE, [weak_this = GetWeakPtr()]() {
+        if (weak_this)
+          weak_this->TrimUnitCache();
+      });
+    }
+  }
+}
+
+void DwarfBinaryImpl::TrimUnitCache() {
+  unit_cache_trim_pending_ = false;
+
+  while (unit_cache_size_ > unit_cache_budget_ && !unit_lru_.empty()) {
+    const CachedUnit& cached = unit_lru_.back();
+
+    // Keep the unit DIE. It's small and LLVM uses it for many things about the unit.
+    if (cached.has_dies)
+      cached.unit->clearDIEs(true);
+    if (auto found = unit_map_.find(cached.unit); found != unit_map_.end())
+      static_cast<DwarfUnitImpl*>(found->second.get())->ClearCachedData();
+
+    unit_cache_size_ -= cached.size;
+    unit_lru_map_.erase(cached.unit);
+    unit_lru_.pop_back();
+  }
+}
+
 std::optional<uint64_t> DwarfBinaryImpl::GetDebugAddrEntry(uint64_t addr_base,
                                                            uint64_t index) const {
   const llvm::DWARFObject& object = context_->getDWARFObj();
@@ -5,8 +5,10 @@
 #ifndef SRC_DEVELOPER_DEBUG_ZXDB_SYMBOLS_DWARF_BINARY_IMPL_H_
 #define SRC_DEVELOPER_DEBUG_ZXDB_SYMBOLS_DWARF_BINARY_IMPL_H_
 
+#include <list>
 #include <map>
 
+#include "llvm/DebugInfo/DWARF/DWARFDebugLine.h"
 #include "llvm/DebugInfo/DWARF/DWARFUnit.h"
 #include "src/developer/debug/zxdb/common/err.h"
 #include "src/developer/debug/zxdb/symbols/dwarf_binary.h"
@@ -58,6 +60,33 @@ class DwarfBinaryImpl final : public DwarfBinary {
   fxl::RefPtr<DwarfUnit> UnitForRelativeAddress(uint64_t relative_address) override;
   std::optional<uint64_t> GetDebugAddrEntry(uint64_t addr_base, uint64_t index) const override;
 
+  // Unit cache.
+  //
+  // LLVM parses all of a unit's DIEs the first time any of them is needed, and keeps them (and the
+  // line tables) until the binary is unloaded. For large binaries this can add up to many GB over
+  // a debugging session. To bound this, the units whose DIEs or line tables have been used are
+  // kept in least-recently-used order, and when their approximate total size exceeds the budget,
+  // the data of the least-recently-used ones is freed. It will be re-parsed if needed again.
+  //
+  // Freeing invalidates any llvm::DWARFDie and line table pointers into those units, so it's
+  // deferred to a new message loop task. If there's no message loop, call TrimUnitCache() at a
+  // point where no such pointers are held.
+  static constexpr uint64_t kDefaultUnitCacheBudget = 256 * 1024 * 1024;
+
+  void set_unit_cache_budget(uint64_t bytes) { unit_cache_budget_ = bytes; }
+  uint64_t unit_cache_size() const { return unit_cache_size_; }
+
+  // Returns the line table for the given unit, owned by the unit cache. Returns null if the unit
+  // has no line table. This can be used as a DwarfDieDecoder::LineTableGetter.
+  const llvm::DWARFDebugLine::LineTable* GetLineTableForUnit(llvm::DWARFUnit* unit);
+
+  // Marks the unit as most recently used and updates its size. The DIEs of the unit will be freed
+  // on eviction if |used_dies| is set for any call.
+  void NoteUnitUse(llvm::DWARFUnit* unit, bool used_dies);
+
+  // Frees the data of the least-recently-used units until the cache is within budget.
+  void TrimUnitCache();
+
  private:
   // Lazily creates a unit for us and returns it. This can handle null input pointers, which will
   // result in a null output pointer.
@@ -84,6 +113,17 @@ class DwarfBinaryImpl final : public DwarfBinary {
 
   uint64_t mapped_length_ = 0;
 
+  struct CachedUnit {
+    llvm::DWARFUnit* unit = nullptr;
+    bool has_dies = false;
+    uint64_t size = 0;
+  };
+  std::list<CachedUnit> unit_lru_;  // Most recently used first.
+  std::map<const llvm::DWARFUnit*, std::list<CachedUnit>::iterator> unit_lru_map_;
+  uint64_t unit_cache_size_ = 0;
+  uint64_t unit_cache_budget_ = kDefaultUnitCacheBudget;
+  bool unit_cache_trim_pending_ = false;
+
   fxl::WeakPtrFactory<DwarfBinaryImpl> weak_factory_;
 };
 
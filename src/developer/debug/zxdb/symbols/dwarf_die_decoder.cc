@@ -23,6 +23,9 @@ constexpr int kMaxAbstractOriginRefsToFollow = 8;
 
 DwarfDieDecoder::DwarfDieDecoder(llvm::DWARFContext* context) : context_(context) {}
 
+DwarfDieDecoder::DwarfDieDecoder(llvm::DWARFContext* context, LineTableGetter line_table_getter)
+    : context_(context), line_table_getter_(std::move(line_table_getter)) {}
+
 DwarfDieDecoder::~DwarfDieDecoder() = default;
 
 void DwarfDieDecoder::AddPresenceCheck(llvm::dwarf::Attribute attribute, bool* present) {
@@ -85,7 +88,7 @@ void DwarfDieDecoder::AddLineTableFile(llvm::dwarf::Attribute attribute,
                                        llvm::Optional<std::string>* output) {
   attrs_.emplace_back(
       attribute, [this, output](llvm::DWARFUnit* unit, const llvm::DWARFFormValue& form) {
-        const llvm::DWARFDebugLine::LineTable* line_table = context_->getLineTableForUnit(unit);
+        const llvm::DWARFDebugLine::LineTable* line_table = GetLineTable(unit);
         if (!line_table)
           return;
 
@@ -160,7 +163,7 @@ void DwarfDieDecoder::AddFile(llvm::dwarf::Attribute attribute,
         if (!file_index)
           return;
 
-        const llvm::DWARFDebugLine::LineTable* line_table = context_->getLineTableForUnit(unit);
+        const llvm::DWARFDebugLine::LineTable* line_table = GetLineTable(unit);
         if (!line_table)
           return;
 
@@ -330,4 +333,10 @@ llvm::DWARFDie DwarfDieDecoder::DecodeReference(llvm::DWARFUnit* unit,
   return llvm::DWARFDie();
 }
 
+const llvm::DWARFDebugLine::LineTable* DwarfDieDecoder::GetLineTable(llvm::DWARFUnit* unit) {
+  if (line_table_getter_)
+    return line_table_getter_(unit);
+  return context_->getLineTableForUnit(unit);
+}
+
 }  // namespace zxdb
@@ -12,6 +12,7 @@
 #include "llvm/ADT/Optional.h"
 #include "llvm/BinaryFormat/Dwarf.h"
 #include "llvm/DebugInfo/DWARF/DWARFDataExtractor.h"
+#include "llvm/DebugInfo/DWARF/DWARFDebugLine.h"
 #include "src/lib/fxl/macros.h"
 
 namespace llvm {
@@ -55,8 +56,16 @@ class DwarfDieDecoder {
     uint64_t value = 0;
   };
 
+  // Returns the line table for a unit, or null if it has none. Used to resolve file attributes.
+  using LineTableGetter =
+      fit::function<const llvm::DWARFDebugLine::LineTable*(llvm::DWARFUnit* unit)>;
+
   // The context and unit must outlive this class.
+  //
+  // File attributes are resolved using the line tables cached by the context, which are never
+  // freed. Callers that manage line table memory themselves can supply a getter instead.
   explicit DwarfDieDecoder(llvm::DWARFContext* context);
+  DwarfDieDecoder(llvm::DWARFContext* context, LineTableGetter line_table_getter);
   ~DwarfDieDecoder();
 
   // Adds a check for the given attribute. If the attribute is encountered, the given boolean will
@@ -135,7 +144,12 @@ class DwarfDieDecoder {
   // Decodes a cross-DIE reference. Return value will be !isValid() on failure.
   llvm::DWARFDie DecodeReference(llvm::DWARFUnit* unit, const llvm::DWARFFormValue& form);
 
+  // Returns the line table for the unit from the line_table_getter_ if there is one, or the
+  // context otherwise.
+  const llvm::DWARFDebugLine::LineTable* GetLineTable(llvm::DWARFUnit* unit);
+
   llvm::DWARFContext* context_;
+  LineTableGetter line_table_getter_;  // May be null.
 
   // Normally there will be few attributes and a brute-force search through a contiguous array will
   // be faster than a map lookup.
@@ -131,6 +131,9 @@ fxl::RefPtr<Symbol> DwarfSymbolFactory::CreateSymbol(uint64_t die_offset) const
   if (!die.isValid())
     return fxl::MakeRefCounted<Symbol>();
 
+  // Lets the unit cache know the DIEs of this unit are in use.
+  symbols_->binary()->NoteUnitUse(die.getDwarfUnit(), true);
+
   return DecodeSymbol(die);
 }
 
@@ -239,7 +242,10 @@ UncachedLazySymbol DwarfSymbolFactory::MakeUncachedLazy(const llvm::DWARFDie& di
 
 fxl::RefPtr<Symbol> DwarfSymbolFactory::DecodeFunction(const llvm::DWARFDie& die, DwarfTag tag,
                                                        bool is_specification) const {
-  DwarfDieDecoder decoder(GetLLVMContext());
+  // File names are resolved with the line tables from the unit cache.
+  DwarfDieDecoder decoder(GetLLVMContext(), [binary = symbols_->binary()](llvm::DWARFUnit* unit) {
+    return binary->GetLineTableForUnit(unit);
+  });
 
   llvm::DWARFDie parent;
   decoder.AddAbstractParent(&parent);
@@ -1028,7 +1034,10 @@ fxl::RefPtr<Symbol> DwarfSymbolFactory::DecodeUnspecifiedType(const llvm::DWARFD
 
 fxl::RefPtr<Symbol> DwarfSymbolFactory::DecodeVariable(const llvm::DWARFDie& die,
                                                        bool is_specification) const {
-  DwarfDieDecoder decoder(GetLLVMContext());
+  // File names are resolved with the line tables from the unit cache.
+  DwarfDieDecoder decoder(GetLLVMContext(), [binary = symbols_->binary()](llvm::DWARFUnit* unit) {
+    return binary->GetLineTableForUnit(unit);
+  });
 
   llvm::DWARFDie specification;
   decoder.AddReference(llvm::dwarf::DW_AT_specification, &specification);
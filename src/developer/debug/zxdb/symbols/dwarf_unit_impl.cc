@@ -7,12 +7,51 @@
 #include <lib/syslog/cpp/macros.h>
 
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/DebugInfo/DWARF/DWARFDataExtractor.h"
+#include "llvm/DebugInfo/DWARF/DWARFDebugInfoEntry.h"
+#include "llvm/DebugInfo/DWARF/DWARFDie.h"
+#include "llvm/DebugInfo/DWARF/DWARFFormValue.h"
+#include "llvm/DebugInfo/DWARF/DWARFUnit.h"
+#include "llvm/Support/Error.h"
 #include "src/developer/debug/zxdb/common/ref_ptr_to.h"
 #include "src/developer/debug/zxdb/symbols/dwarf_binary_impl.h"
 #include "src/developer/debug/zxdb/symbols/line_table_impl.h"
 
 namespace zxdb {
 
+namespace {
+
+// Parses the unit's line table the same way llvm::DWARFContext::getLineTableForUnit() does, but
+// without adding it to the context's cache. Returns null if the unit has no line table.
+std::unique_ptr<llvm::DWARFDebugLine::LineTable> ParseLineTable(llvm::DWARFContext* context,
+                                                                llvm::DWARFUnit* unit) {
+  llvm::DWARFDie unit_die = unit->getUnitDIE();
+  if (!unit_die)
+    return nullptr;
+
+  llvm::Optional<uint64_t> offset =
+      llvm::dwarf::toSectionOffset(unit_die.find(llvm::dwarf::DW_AT_stmt_list));
+  if (!offset)
+    return nullptr;  // No line table for this unit.
+
+  uint64_t stmt_offset = *offset + unit->getLineTableOffset();
+  const llvm::DWARFSection& section = unit->getLineSection();
+  if (stmt_offset >= section.Data.size())
+    return nullptr;
+
+  llvm::DWARFDataExtractor data(context->getDWARFObj(), section, context->isLittleEndian(),
+                                unit->getAddressByteSize());
+  auto line_table = std::make_unique<llvm::DWARFDebugLine::LineTable>();
+  auto ignore_recoverable = [](llvm::Error error) { llvm::consumeError(std::move(error)); };
+  if (llvm::Error err = line_table->parse(data, &stmt_offset, *context, unit, ignore_recoverable)) {
+    llvm::consumeError(std::move(err));
+    return nullptr;
+  }
+  return line_table;
+}
+
+}  // namespace
+
 DwarfUnitImpl::DwarfUnitImpl(DwarfBinaryImpl* binary, llvm::DWARFUnit* unit)
     : binary_(binary->GetWeakPtr()), unit_(unit) {}
 
@@ -20,10 +59,45 @@ uint64_t DwarfUnitImpl::FunctionDieOffsetForRelativeAddress(uint64_t relative_ad
   if (!binary_)
     return 0;
 
-  llvm::DWARFDie die = unit_->getSubroutineForAddress(relative_address);
-  if (!die.isValid())
+  if (!function_ranges_) {
+    // This is the same computation as llvm::DWARFUnit::updateAddressDieMap(). The DIEs are in
+    // pre-order so ranges of nested inlined subroutines are added after (and split) their parents'.
+    function_ranges_.emplace();
+    for (const llvm::DWARFDebugInfoEntry& entry : unit_->dies()) {
+      llvm::DWARFDie die(unit_, &entry);
+      if (!die.isSubroutineDIE())
+        continue;
+
+      llvm::Expected<llvm::DWARFAddressRangesVector> ranges = die.getAddressRanges();
+      if (!ranges) {
+        llvm::consumeError(ranges.takeError());
+        continue;
+      }
+      for (const llvm::DWARFAddressRange& range : *ranges) {
+        if (range.LowPC == range.HighPC)
+          continue;  // Ignore empty ranges.
+
+        auto found = function_ranges_->upper_bound(range.LowPC);
+        if (found != function_ranges_->begin() && range.LowPC < (--found)->second.end) {
+          // The range is inside an existing one which needs to be split around it.
+          if (range.HighPC < found->second.end)
+            (*function_ranges_)[range.HighPC] = found->second;
+          if (range.LowPC > found->first)
+            found->second.end = range.LowPC;
+        }
+        (*function_ranges_)[range.LowPC] = FunctionRange{range.HighPC, die.getOffset()};
+      }
+    }
+  }
+  binary_->NoteUnitUse(unit_, true);
+
+  auto found = function_ranges_->upper_bound(relative_address);
+  if (found == function_ranges_->begin())
     return 0;
-  return die.getOffset();
+  --found;  // Now the last range beginning at or before the address.
+  if (relative_address >= found->second.end)
+    return 0;
+  return found->second.die_offset;
 }
 
 uint64_t DwarfUnitImpl::GetOffset() const {
@@ -57,7 +131,35 @@ const LineTable& DwarfUnitImpl::GetLineTable() const {
 const llvm::DWARFDebugLine::LineTable* DwarfUnitImpl::GetLLVMLineTable() const {
   if (!binary_)
     return nullptr;
-  return binary_->context()->getLineTableForUnit(unit_);
+
+  if (!line_table_parsed_) {
+    line_table_parsed_ = true;
+    llvm_line_table_ = ParseLineTable(binary_->context(), unit_);
+  }
+  binary_->NoteUnitUse(unit_, false);
+  return llvm_line_table_.get();
+}
+
+void DwarfUnitImpl::ClearCachedData() {
+  line_table_.reset();
+  llvm_line_table_.reset();
+  line_table_parsed_ = false;
+  function_ranges_.reset();
+}
+
+uint64_t DwarfUnitImpl::GetCachedDataSize() const {
+  uint64_t size = 0;
+  if (llvm_line_table_) {
+    size += llvm_line_table_->Rows.capacity() * sizeof(llvm::DWARFDebugLine::Row);
+    size += llvm_line_table_->Sequences.capacity() * sizeof(llvm::DWARFDebugLine::Sequence);
+    size += llvm_line_table_->Prologue.FileNames.capacity() *
+            sizeof(llvm::DWARFDebugLine::FileNameEntry);
+  }
+  if (function_ranges_) {
+    // Approximates the size of a map node as the value plus the tree pointers and color.
+    size += function_ranges_->size() * (sizeof(FunctionRangeMap::value_type) + 4 * sizeof(void*));
+  }
+  return size;
 }
 
 }  // namespace zxdb
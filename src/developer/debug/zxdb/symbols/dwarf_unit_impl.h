@@ -5,6 +5,10 @@
 #ifndef SRC_DEVELOPER_DEBUG_ZXDB_SYMBOLS_DWARF_UNIT_IMPL_H_
 #define SRC_DEVELOPER_DEBUG_ZXDB_SYMBOLS_DWARF_UNIT_IMPL_H_
 
+#include <map>
+#include <memory>
+#include <optional>
+
 #include "src/developer/debug/zxdb/symbols/dwarf_unit.h"
 #include "src/developer/debug/zxdb/symbols/line_table_impl.h"
 #include "src/lib/fxl/memory/weak_ptr.h"
@@ -32,6 +36,14 @@ class DwarfUnitImpl : public DwarfUnit {
   const LineTable& GetLineTable() const override;
   const llvm::DWARFDebugLine::LineTable* GetLLVMLineTable() const override;
 
+  // Frees the line table and the function address map, which are recomputed when next needed.
+  // Called by the DwarfBinaryImpl's unit cache, so any references returned by GetLineTable() or
+  // GetLLVMLineTable() must not be held across message loop tasks.
+  void ClearCachedData();
+
+  // Returns the approximate number of bytes used by the data freed by ClearCachedData().
+  uint64_t GetCachedDataSize() const;
+
  private:
   FRIEND_REF_COUNTED_THREAD_SAFE(DwarfUnitImpl);
   FRIEND_MAKE_REF_COUNTED(DwarfUnitImpl);
@@ -46,8 +58,23 @@ class DwarfUnitImpl : public DwarfUnit {
   // users should check that the binary_ is still valid before dereferencing.
   llvm::DWARFUnit* unit_;
 
-  // The line table. Computed lazily.
+  // The line table, parsed lazily straight from the .debug_line section. This is owned here rather
+  // than by LLVM's DWARFContext (which would keep it forever) so it can be freed by
+  // ClearCachedData(). llvm_line_table_ will be null if the unit has no line table.
+  mutable bool line_table_parsed_ = false;
+  mutable std::unique_ptr<llvm::DWARFDebugLine::LineTable> llvm_line_table_;
   mutable std::optional<LineTableImpl> line_table_;
+
+  // Maps the beginning of each non-overlapping address range to the innermost function or inlined
+  // subroutine covering it, for FunctionDieOffsetForRelativeAddress(). This is the same as LLVM's
+  // DWARFUnit::getSubroutineForAddress() computes, but stores DIE offsets instead of DIEs so it
+  // remains valid after the unit's DIEs are freed. Computed lazily.
+  struct FunctionRange {
+    uint64_t end = 0;
+    uint64_t die_offset = 0;
+  };
+  using FunctionRangeMap = std::map<uint64_t, FunctionRange>;
+  mutable std::optional<FunctionRangeMap> function_ranges_;
 };
 
 }  // namespace zxdb
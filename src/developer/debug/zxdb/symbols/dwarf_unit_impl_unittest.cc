@@ -0,0 +1,92 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/developer/debug/zxdb/symbols/dwarf_unit_impl.h"
+
+#include <gtest/gtest.h>
+
+#include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/DebugInfo/DWARF/DWARFUnit.h"
+#include "src/developer/debug/zxdb/symbols/dwarf_binary_impl.h"
+#include "src/developer/debug/zxdb/symbols/function.h"
+#include "src/developer/debug/zxdb/symbols/module_symbols_impl.h"
+#include "src/developer/debug/zxdb/symbols/symbol_factory.h"
+#include "src/developer/debug/zxdb/symbols/test_symbol_module.h"
+
+namespace zxdb {
+
+// Our function lookup should match LLVM's DWARFUnit::getSubroutineForAddress().
+TEST(DwarfUnitImpl, FunctionDieOffsetForRelativeAddress) {
+  TestSymbolModule setup(TestSymbolModule::kCheckedIn);
+  ASSERT_TRUE(setup.Init("", false).ok());
+  DwarfBinaryImpl* binary = setup.symbols()->binary();
+
+  // Check the address of every row of every line table.
+  size_t checked = 0;
+  for (size_t i = 0; i < binary->GetUnitCount(); i++) {
+    fxl::RefPtr<DwarfUnit> unit = binary->GetUnitAtIndex(i);
+    llvm::DWARFUnit* llvm_unit = binary->context()->getUnitAtIndex(i);
+
+    const llvm::DWARFDebugLine::LineTable* line_table = unit->GetLLVMLineTable();
+    if (!line_table)
+      continue;
+
+    for (const llvm::DWARFDebugLine::Row& row : line_table->Rows) {
+      llvm::DWARFDie expected = llvm_unit->getSubroutineForAddress(row.Address.Address);
+      EXPECT_EQ(expected.isValid() ? expected.getOffset() : 0,
+                unit->FunctionDieOffsetForRelativeAddress(row.Address.Address))
+          << "Address 0x" << std::hex << row.Address.Address;
+      checked++;
+    }
+  }
+  EXPECT_LT(0u, checked);
+}
+
+TEST(DwarfUnitImpl, UnitCache) {
+  TestSymbolModule setup(TestSymbolModule::kCheckedIn);
+  ASSERT_TRUE(setup.Init("", false).ok());
+  DwarfBinaryImpl* binary = setup.symbols()->binary();
+  EXPECT_EQ(0u, binary->unit_cache_size());
+
+  fxl::RefPtr<DwarfUnit> unit =
+      binary->UnitForRelativeAddress(TestSymbolModule::kMyFunctionAddress);
+  ASSERT_TRUE(unit);
+
+  uint64_t function_offset =
+      unit->FunctionDieOffsetForRelativeAddress(TestSymbolModule::kMyFunctionAddress);
+  ASSERT_NE(0u, function_offset);
+  ASSERT_TRUE(unit->GetLLVMLineTable());
+  size_t row_count = unit->GetLLVMLineTable()->Rows.size();
+  EXPECT_LT(0u, binary->unit_cache_size());
+
+  // Nothing is freed while within the budget.
+  uint64_t cache_size = binary->unit_cache_size();
+  binary->TrimUnitCache();
+  EXPECT_EQ(cache_size, binary->unit_cache_size());
+
+  binary->set_unit_cache_budget(0);
+  binary->TrimUnitCache();
+  EXPECT_EQ(0u, binary->unit_cache_size());
+
+  // The freed data should be re-parsed when needed again.
+  EXPECT_EQ(function_offset,
+            unit->FunctionDieOffsetForRelativeAddress(TestSymbolModule::kMyFunctionAddress));
+  ASSERT_TRUE(unit->GetLLVMLineTable());
+  EXPECT_EQ(row_count, unit->GetLLVMLineTable()->Rows.size());
+
+  fxl::RefPtr<Symbol> symbol = setup.symbols()->symbol_factory()->CreateSymbol(function_offset);
+  const Function* function = symbol->As<Function>();
+  ASSERT_TRUE(function);
+  EXPECT_EQ(TestSymbolModule::kMyFunctionName, function->GetFullName());
+  EXPECT_LT(0u, binary->unit_cache_size());
+
+  binary->TrimUnitCache();
+  EXPECT_EQ(0u, binary->unit_cache_size());
+  symbol = setup.symbols()->symbol_factory()->CreateSymbol(function_offset);
+  function = symbol->As<Function>();
+  ASSERT_TRUE(function);
+  EXPECT_EQ(TestSymbolModule::kMyFunctionName, function->GetFullName());
+}
+
+}  // namespace zxdb
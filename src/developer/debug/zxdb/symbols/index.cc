@@ -4,6 +4,15 @@
 
 #include "src/developer/debug/zxdb/symbols/index.h"
 
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <tuple>
+
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
 #include "llvm/DebugInfo/DWARF/DWARFDebugInfoEntry.h"
 #include "llvm/DebugInfo/DWARF/DWARFUnit.h"
@@ -21,6 +30,25 @@ namespace {
 // Don't index more than this number of levels to prevent infinite recursion.
 constexpr size_t kMaxParentPath = 16;
 
+// Upper bound on the number of threads CreateIndex() picks by default. Beyond this, the memory for
+// each thread's DWARFContext outweighs the gains.
+constexpr unsigned kMaxIndexThreads = 16;
+
+// Each indexing thread claims about this many chunks of units. Unit sizes vary a lot, so using
+// several smaller chunks per thread keeps threads that get large units from holding up the others.
+constexpr unsigned kChunksPerThread = 4;
+
+// By default, binaries with fewer units than this are indexed on the calling thread since creating
+// a DWARFContext for each thread would cost more than it saves.
+constexpr unsigned kMinParallelUnits = 16;
+
+// Identifies the files written by Index::WriteToFile().
+constexpr char kCacheMagic[8] = {'Z', 'X', 'D', 'B', 'I', 'D', 'X', '\0'};
+
+// Index nodes nest no deeper than the indexing limit above, so anything much deeper in a cache file
+// means it's corrupt. This bounds the recursion when reading.
+constexpr int kMaxCacheNodeDepth = 4 * static_cast<int>(kMaxParentPath);
+
 // Stores a name with a SymbolRef for later indexing.
 class NamedSymbolRef : public IndexNode::SymbolRef {
  public:
@@ -567,30 +595,338 @@ void RecursiveFindExact(const IndexNode* node, const Identifier& input, size_t i
     RecursiveFindExact(&found->second, input, input_index, result);
 }
 
+// Extracts the units to a place where we can destroy them after indexing is complete. This
+// construction order matches that of LLVM's DWARFContext so the indexes into this vector will match
+// the indices into DWARFContext's.
+void ExtractUnits(llvm::DWARFContext* context, llvm::DWARFUnitVector* compile_units) {
+  context->getDWARFObj().forEachInfoSections([&](const llvm::DWARFSection& s) {
+    compile_units->addUnitsForSection(*context, s, llvm::DW_SECT_INFO);
+  });
+}
+
+// Free compilation units after we process them. They will hold all of the parsed DIE data that we
+// don't need any more which can be multiple GB's for large programs.
+//
+// This must be done after indexing since some internal LLVM functions assume the units exist.
+void FreeUnits(llvm::DWARFUnitVector* compile_units) {
+  for (unsigned i = 0; i < compile_units->size(); i++)
+    (*compile_units)[i].reset();
+}
+
+// Writes the index cache file. Integers are written in the host's byte order since the cache is
+// only read on the machine that wrote it.
+class CacheWriter {
+ public:
+  explicit CacheWriter(std::ostream& out) : out_(out) {}
+
+  void WriteBytes(const void* data, size_t size) {
+    out_.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+  }
+  template <typename T>
+  void WriteInt(T value) {
+    WriteBytes(&value, sizeof(T));
+  }
+  void WriteString(std::string_view str) {
+    WriteInt(static_cast<uint32_t>(str.size()));
+    WriteBytes(str.data(), str.size());
+  }
+
+  void WriteSymbolRefs(const std::vector<IndexNode::SymbolRef>& refs) {
+    WriteInt(static_cast<uint32_t>(refs.size()));
+    for (const IndexNode::SymbolRef& ref : refs) {
+      WriteInt(static_cast<uint8_t>(ref.kind()));
+      WriteInt(ref.offset());
+    }
+  }
+
+  void WriteNode(const IndexNode& node) {
+    WriteSymbolRefs(node.dies());
+    for (int i = 0; i < static_cast<int>(IndexNode::Kind::kEndPhysical); i++) {
+      const IndexNode::Map& map = node.MapForKind(static_cast<IndexNode::Kind>(i));
+      WriteInt(static_cast<uint32_t>(map.size()));
+      for (const auto& [name, child] : map) {
+        WriteString(name);
+        WriteNode(child);
+      }
+    }
+  }
+
+ private:
+  std::ostream& out_;
+};
+
+// Reads the index cache file from memory. Every read is bounds-checked and returns false on failure
+// so a truncated or corrupt file is rejected rather than trusted.
+class CacheReader {
+ public:
+  explicit CacheReader(std::string_view data) : data_(data) {}
+
+  bool done() const { return data_.empty(); }
+
+  bool ReadBytes(void* dest, size_t size) {
+    if (data_.size() < size)
+      return false;
+    memcpy(dest, data_.data(), size);
+    data_.remove_prefix(size);
+    return true;
+  }
+  template <typename T>
+  bool ReadInt(T* value) {
+    return ReadBytes(value, sizeof(T));
+  }
+  bool ReadString(std::string* str) {
+    uint32_t size = 0;
+    if (!ReadInt(&size) || data_.size() < size)
+      return false;
+    str->assign(data_.data(), size);
+    data_.remove_prefix(size);
+    return true;
+  }
+
+  bool ReadSymbolRef(IndexNode::SymbolRef* ref) {
+    uint8_t kind = 0;
+    uint64_t offset = 0;
+    if (!ReadInt(&kind) || !ReadInt(&offset))
+      return false;
+    if (kind != IndexNode::SymbolRef::kDwarf && kind != IndexNode::SymbolRef::kDwarfDeclaration)
+      return false;
+    *ref = IndexNode::SymbolRef(static_cast<IndexNode::SymbolRef::Kind>(kind), offset);
+    return true;
+  }
+
+  bool ReadSymbolRefs(std::vector<IndexNode::SymbolRef>* refs) {
+    uint32_t count = 0;
+    if (!ReadInt(&count))
+      return false;
+    for (uint32_t i = 0; i < count; i++) {
+      IndexNode::SymbolRef ref;
+      if (!ReadSymbolRef(&ref))
+        return false;
+      refs->push_back(ref);
+    }
+    return true;
+  }
+
+  bool ReadNode(IndexNode* node, int depth) {
+    if (depth > kMaxCacheNodeDepth)
+      return false;
+
+    std::vector<IndexNode::SymbolRef> dies;
+    if (!ReadSymbolRefs(&dies))
+      return false;
+    if (!dies.empty() && node->kind() == IndexNode::Kind::kRoot)
+      return false;  // The root has no DIEs and AddDie() would assert.
+    for (const IndexNode::SymbolRef& ref : dies)
+      node->AddDie(ref);
+
+    for (int i = 0; i < static_cast<int>(IndexNode::Kind::kEndPhysical); i++) {
+      auto kind = static_cast<IndexNode::Kind>(i);
+      IndexNode::Map& map = node->MapForKind(kind);
+
+      uint32_t count = 0;
+      if (!ReadInt(&count))
+        return false;
+      for (uint32_t child_i = 0; child_i < count; child_i++) {
+        std::string name;
+        if (!ReadString(&name))
+          return false;
+        auto [iter, inserted] = map.emplace(std::piecewise_construct,
+                                            std::forward_as_tuple(std::move(name)),
+                                            std::forward_as_tuple(kind));
+        if (!inserted || !ReadNode(&iter->second, depth + 1))
+          return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  std::string_view data_;
+};
+
 }  // namespace
 
-void Index::CreateIndex(llvm::object::ObjectFile* object_file, bool force_slow_path) {
+void Index::CreateIndex(llvm::object::ObjectFile* object_file, bool force_slow_path,
+                        unsigned thread_count) {
   std::unique_ptr<llvm::DWARFContext> context = llvm::DWARFContext::create(*object_file);
 
-  // Extracts the units to a place where we can destroy them after indexing is complete. This
-  // construction order matches that of LLVM's DWARFContext so the indexes into this vector will
-  // match the indices into DWARFContext's.
   llvm::DWARFUnitVector compile_units;
-  context->getDWARFObj().forEachInfoSections([&](const llvm::DWARFSection& s) {
-    compile_units.addUnitsForSection(*context, s, llvm::DW_SECT_INFO);
-  });
+  ExtractUnits(context.get(), &compile_units);
+  unsigned unit_count = static_cast<unsigned>(compile_units.size());
+
+  if (thread_count == 0) {
+    thread_count = unit_count < kMinParallelUnits
+                       ? 1
+                       : std::clamp(std::thread::hardware_concurrency(), 1u, kMaxIndexThreads);
+  }
+  unsigned chunk_size = std::max(1u, unit_count / (thread_count * kChunksPerThread));
+  unsigned chunk_count = (unit_count + chunk_size - 1) / chunk_size;
+  thread_count = std::min(thread_count, chunk_count);
+
+  if (thread_count <= 1) {
+    for (unsigned i = 0; i < unit_count; i++)
+      IndexCompileUnit(context.get(), compile_units[i].get(), i, force_slow_path);
 
-  for (unsigned i = 0; i < compile_units.size(); i++)
-    IndexCompileUnit(context.get(), compile_units[i].get(), i, force_slow_path);
+    IndexFileNames();
+    FreeUnits(&compile_units);
+    return;
+  }
+
+  // Each thread extracts the units again from its own context, so this one is no longer needed.
+  compile_units.clear();
+  context.reset();
 
+  std::vector<std::unique_ptr<Index>> chunks(chunk_count);
+  std::atomic<unsigned> next_unit(0);
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < thread_count; i++) {
+    threads.emplace_back(&Index::IndexUnitChunks, object_file, force_slow_path, chunk_size,
+                         &next_unit, &chunks);
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+
+  // Merging in unit order makes the result identical to indexing the units one after another.
+  for (std::unique_ptr<Index>& chunk : chunks) {
+    if (chunk)
+      MergeFrom(std::move(*chunk));
+    chunk.reset();
+  }
   IndexFileNames();
+}
 
-  // Free compilation units after we process them. They will hold all of the parsed DIE data that we
-  // don't need any more which can be multiple GB's for large programs.
-  //
-  // This must be done after indexing since some internal LLVM functions assume the units exist.
-  for (unsigned i = 0; i < compile_units.size(); i++)
-    compile_units[i].reset();
+// static
+std::optional<Index::CacheKey> Index::CacheKey::ForFile(const std::string& path,
+                                                         const std::string& build_id) {
+  std::error_code ec;
+  uint64_t size = std::filesystem::file_size(path, ec);
+  if (ec)
+    return std::nullopt;
+  std::filesystem::file_time_type mtime = std::filesystem::last_write_time(path, ec);
+  if (ec)
+    return std::nullopt;
+  return CacheKey{build_id, path, size, static_cast<int64_t>(mtime.time_since_epoch().count())};
+}
+
+bool Index::empty() const {
+  if (!main_functions_.empty() || !files_.empty() || !root_.dies().empty())
+    return false;
+  for (int i = 0; i < static_cast<int>(IndexNode::Kind::kEndPhysical); i++) {
+    if (!root_.MapForKind(static_cast<IndexNode::Kind>(i)).empty())
+      return false;
+  }
+  return true;
+}
+
+bool Index::WriteToFile(const std::filesystem::path& path, const CacheKey& key) const {
+  std::error_code ec;
+  std::filesystem::create_directories(path.parent_path(), ec);
+  if (ec)
+    return false;
+
+  // Write to a temporary file and move it into place so a concurrent reader never sees a partial
+  // index.
+  std::filesystem::path temp_path = path;
+  temp_path += ".tmp" + std::to_string(getpid());
+  {
+    std::ofstream out(temp_path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    if (!out.is_open())
+      return false;
+
+    CacheWriter writer(out);
+    writer.WriteBytes(kCacheMagic, sizeof(kCacheMagic));
+    writer.WriteInt(kCacheVersion);
+    writer.WriteString(key.build_id);
+    writer.WriteString(key.path);
+    writer.WriteInt(key.size);
+    writer.WriteInt(key.mtime);
+
+    writer.WriteSymbolRefs(main_functions_);
+
+    writer.WriteInt(static_cast<uint32_t>(files_.size()));
+    for (const auto& [file_name, unit_indices] : files_) {
+      writer.WriteString(file_name);
+      writer.WriteInt(static_cast<uint32_t>(unit_indices.size()));
+      for (unsigned unit_index : unit_indices)
+        writer.WriteInt(static_cast<uint32_t>(unit_index));
+    }
+
+    writer.WriteNode(root_);
+
+    out.close();
+    if (out.fail()) {
+      std::filesystem::remove(temp_path, ec);
+      return false;
+    }
+  }
+
+  std::filesystem::rename(temp_path, path, ec);
+  if (ec) {
+    std::filesystem::remove(temp_path, ec);
+    return false;
+  }
+  return true;
+}
+
+bool Index::ReadFromFile(const std::filesystem::path& path, const CacheKey& key) {
+  FX_DCHECK(files_.empty() && main_functions_.empty());
+
+  std::ifstream in(path, std::ios_base::in | std::ios_base::binary);
+  if (!in.is_open())
+    return false;
+  std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  if (in.bad())
+    return false;
+
+  CacheReader reader(data);
+
+  char magic[sizeof(kCacheMagic)];
+  uint32_t version = 0;
+  if (!reader.ReadBytes(magic, sizeof(magic)) || memcmp(magic, kCacheMagic, sizeof(magic)) != 0 ||
+      !reader.ReadInt(&version) || version != kCacheVersion)
+    return false;
+
+  CacheKey file_key;
+  if (!reader.ReadString(&file_key.build_id) || !reader.ReadString(&file_key.path) ||
+      !reader.ReadInt(&file_key.size) || !reader.ReadInt(&file_key.mtime))
+    return false;
+  if (file_key.build_id != key.build_id || file_key.path != key.path ||
+      file_key.size != key.size || file_key.mtime != key.mtime)
+    return false;
+
+  // Read into temporaries so a corrupt file leaves this index empty.
+  std::vector<IndexNode::SymbolRef> main_functions;
+  if (!reader.ReadSymbolRefs(&main_functions))
+    return false;
+
+  FileIndex files;
+  uint32_t file_count = 0;
+  if (!reader.ReadInt(&file_count))
+    return false;
+  for (uint32_t i = 0; i < file_count; i++) {
+    std::string file_name;
+    uint32_t unit_count = 0;
+    if (!reader.ReadString(&file_name) || !reader.ReadInt(&unit_count))
+      return false;
+
+    std::vector<unsigned>& unit_indices = files[std::move(file_name)];
+    for (uint32_t unit_i = 0; unit_i < unit_count; unit_i++) {
+      uint32_t unit_index = 0;
+      if (!reader.ReadInt(&unit_index))
+        return false;
+      unit_indices.push_back(unit_index);
+    }
+  }
+
+  IndexNode root(IndexNode::Kind::kRoot);
+  if (!reader.ReadNode(&root, 0) || !reader.done())
+    return false;
+
+  root_ = std::move(root);
+  files_ = std::move(files);
+  main_functions_ = std::move(main_functions);
+  IndexFileNames();
+  return true;
 }
 
 void Index::DumpFileIndex(std::ostream& out) const {
@@ -643,6 +979,43 @@ const std::vector<unsigned>* Index::FindFileUnitIndices(const std::string& name)
 
 size_t Index::CountSymbolsIndexed() const { return RecursiveCountDies(root_); }
 
+// static
+void Index::IndexUnitChunks(llvm::object::ObjectFile* object_file, bool force_slow_path,
+                            unsigned chunk_size, std::atomic<unsigned>* next_unit,
+                            std::vector<std::unique_ptr<Index>>* chunks) {
+  // LLVM's DWARF parsing isn't thread-safe, so each thread gets its own context and units.
+  std::unique_ptr<llvm::DWARFContext> context = llvm::DWARFContext::create(*object_file);
+
+  llvm::DWARFUnitVector compile_units;
+  ExtractUnits(context.get(), &compile_units);
+  unsigned unit_count = static_cast<unsigned>(compile_units.size());
+
+  for (unsigned begin = next_unit->fetch_add(chunk_size); begin < unit_count;
+       begin = next_unit->fetch_add(chunk_size)) {
+    auto chunk = std::make_unique<Index>();
+    unsigned end = std::min(begin + chunk_size, unit_count);
+    for (unsigned i = begin; i < end; i++)
+      chunk->IndexCompileUnit(context.get(), compile_units[i].get(), i, force_slow_path);
+
+    // Each chunk has its own slot so no locking is needed.
+    (*chunks)[begin / chunk_size] = std::move(chunk);
+  }
+
+  FreeUnits(&compile_units);
+}
+
+void Index::MergeFrom(Index&& other) {
+  root_.MergeFrom(std::move(other.root_));
+
+  main_functions_.insert(main_functions_.end(), other.main_functions_.begin(),
+                         other.main_functions_.end());
+
+  for (const auto& [file_name, unit_indices] : other.files_) {
+    std::vector<unsigned>& dest = files_[file_name];
+    dest.insert(dest.end(), unit_indices.begin(), unit_indices.end());
+  }
+}
+
 void Index::IndexCompileUnit(llvm::DWARFContext* context, llvm::DWARFUnit* unit,
                              unsigned unit_index, bool force_slow_path) {
   UnitIndexer indexer(context, unit);
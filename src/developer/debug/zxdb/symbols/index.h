@@ -5,10 +5,17 @@
 #ifndef SRC_DEVELOPER_DEBUG_ZXDB_SYMBOLS_INDEX_H_
 #define SRC_DEVELOPER_DEBUG_ZXDB_SYMBOLS_INDEX_H_
 
+#include <stdint.h>
+
+#include <atomic>
+#include <filesystem>
 #include <iosfwd>
 #include <map>
+#include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "src/developer/debug/zxdb/symbols/identifier.h"
 #include "src/developer/debug/zxdb/symbols/index_node.h"
@@ -31,6 +38,18 @@ namespace zxdb {
 
 class Index {
  public:
+  // Identifies the binary that an index cache file was created for. The build ID alone isn't
+  // enough: a binary can be rebuilt, or its debug info stripped or replaced, without changing it.
+  struct CacheKey {
+    std::string build_id;
+    std::string path;  // Of the file the index is created from.
+    uint64_t size = 0;
+    int64_t mtime = 0;  // In the host's file clock ticks; cache files never leave the host.
+
+    // Returns the key for the file at |path|, or nullopt if the file can't be examined.
+    static std::optional<CacheKey> ForFile(const std::string& path, const std::string& build_id);
+  };
+
   Index() = default;
   ~Index() = default;
 
@@ -41,7 +60,26 @@ class Index {
   // Normal callers will want to use the fast path (which internally falls back to the slow path
   // for cross unit references). Tests can set the force_slow_path flag to cause everything to be
   // indexed with the slow path for validation purposes.
-  void CreateIndex(llvm::object::ObjectFile* object_file, bool force_slow_path = false);
+  //
+  // Compile units are indexed in parallel on up to |thread_count| threads, each with its own
+  // DWARFContext (LLVM's is not thread-safe), and the results are merged in unit order so the index
+  // is the same as one built on a single thread. A |thread_count| of 0 picks one based on the
+  // number of cores and units.
+  void CreateIndex(llvm::object::ObjectFile* object_file, bool force_slow_path = false,
+                   unsigned thread_count = 0);
+
+  // Returns true if nothing has been indexed.
+  bool empty() const;
+
+  // Saves the index to the given file for a later ReadFromFile() to load instead of re-indexing the
+  // binary. The file is tagged with the key of the binary the index was created for and with
+  // kCacheVersion. Returns false on failure.
+  bool WriteToFile(const std::filesystem::path& path, const CacheKey& key) const;
+
+  // Loads an index saved by WriteToFile() into this (empty) index. Fails if the file is missing,
+  // corrupt, written by a different kCacheVersion, or for a binary with a different key, in which
+  // case the index is left empty.
+  bool ReadFromFile(const std::filesystem::path& path, const CacheKey& key);
 
   // Dumps the file index to the stream for debugging.
   void DumpFileIndex(std::ostream& out) const;
@@ -84,7 +122,22 @@ class Index {
   // Returns how many symbols are indexed. This iterates through everything so can be slow.
   size_t CountSymbolsIndexed() const;
 
+  // Version of the file format written by WriteToFile(). This must be incremented whenever the
+  // format or the contents of the index for a given binary change.
+  static constexpr uint32_t kCacheVersion = 2;
+
  private:
+  // Indexes the units of the object file in chunks of |chunk_size| consecutive units, claiming the
+  // next chunk from |next_unit| until they run out. Each chunk is indexed into its own Index in
+  // |chunks| (indexed by the unit index / chunk_size). This is run on each indexing thread.
+  static void IndexUnitChunks(llvm::object::ObjectFile* object_file, bool force_slow_path,
+                              unsigned chunk_size, std::atomic<unsigned>* next_unit,
+                              std::vector<std::unique_ptr<Index>>* chunks);
+
+  // Moves the contents of the given index, which must be for later units than those already
+  // indexed, into this one. IndexFileNames() must be called after all merges.
+  void MergeFrom(Index&& other);
+
   void IndexCompileUnit(llvm::DWARFContext* context, llvm::DWARFUnit* unit, unsigned unit_index,
                         bool force_slow_path);
 
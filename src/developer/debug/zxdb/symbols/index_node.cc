@@ -77,6 +77,25 @@ void IndexNode::AddDie(const SymbolRef& ref) {
   dies_.push_back(ref);
 }
 
+void IndexNode::MergeFrom(IndexNode&& other) {
+  FX_DCHECK(kind_ == other.kind_);
+
+  for (const SymbolRef& ref : other.dies_)
+    AddDie(ref);
+  other.dies_.clear();
+
+  for (int i = 0; i < static_cast<int>(Kind::kEndPhysical); i++) {
+    Map& map = children_[i];
+    Map& other_map = other.children_[i];
+    while (!other_map.empty()) {
+      // Nodes not already in this map are moved over without copying their subtrees.
+      auto result = map.insert(other_map.extract(other_map.begin()));
+      if (!result.inserted)
+        result.position->second.MergeFrom(std::move(result.node.mapped()));
+    }
+  }
+}
+
 const IndexNode::Map& IndexNode::MapForKind(Kind kind) const {
   FX_DCHECK(static_cast<int>(kind) >= 0 &&
             static_cast<int>(kind) < static_cast<int>(Kind::kEndPhysical));
@@ -74,6 +74,11 @@ class IndexNode {
   IndexNode* AddChild(Kind kind, const char* name, const SymbolRef& ref);
   void AddDie(const SymbolRef& ref);
 
+  // Moves the children and DIEs of the given node into this one. Children that exist in both are
+  // merged recursively, and DIEs are added with the same rules as AddDie(). Merging the indices of
+  // consecutive ranges of units in order produces the same result as indexing them all in one node.
+  void MergeFrom(IndexNode&& other);
+
   const Map& namespaces() const { return children_[static_cast<int>(Kind::kNamespace)]; }
   Map& namespaces() { return children_[static_cast<int>(Kind::kNamespace)]; }
 
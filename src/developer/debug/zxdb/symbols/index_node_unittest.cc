@@ -60,4 +60,35 @@ TEST(IndexNode, DeDupeNamespace) {
   EXPECT_TRUE(root.namespaces().begin()->second.dies().empty());
 }
 
+TEST(IndexNode, MergeFrom) {
+  IndexNode root(Kind::kRoot);
+  IndexNode* ns = root.AddChild(Kind::kNamespace, "ns");
+  ns->AddChild(Kind::kType, "Type", SymbolRef(IndexNode::SymbolRef::kDwarfDeclaration, 10));
+  ns->AddChild(Kind::kFunction, "Function", SymbolRef(IndexNode::SymbolRef::kDwarf, 20));
+
+  IndexNode other(Kind::kRoot);
+  IndexNode* other_ns = other.AddChild(Kind::kNamespace, "ns");
+  other_ns->AddChild(Kind::kType, "Type", SymbolRef(IndexNode::SymbolRef::kDwarf, 30));
+  other_ns->AddChild(Kind::kFunction, "Function", SymbolRef(IndexNode::SymbolRef::kDwarf, 40));
+  other.AddChild(Kind::kVar, "var", SymbolRef(IndexNode::SymbolRef::kDwarf, 50));
+
+  root.MergeFrom(std::move(other));
+
+  // The type's declaration is upgraded to the definition, and both functions are kept.
+  ASSERT_EQ(1u, root.namespaces().size());
+  const IndexNode& merged_ns = root.namespaces().begin()->second;
+  ASSERT_EQ(1u, merged_ns.types().size());
+  ASSERT_EQ(1u, merged_ns.types().begin()->second.dies().size());
+  EXPECT_EQ(30u, merged_ns.types().begin()->second.dies()[0].offset());
+  ASSERT_EQ(1u, merged_ns.functions().size());
+  const auto& function_dies = merged_ns.functions().begin()->second.dies();
+  ASSERT_EQ(2u, function_dies.size());
+  EXPECT_EQ(20u, function_dies[0].offset());
+  EXPECT_EQ(40u, function_dies[1].offset());
+
+  // Children only in the other node are moved over.
+  ASSERT_EQ(1u, root.vars().size());
+  EXPECT_EQ("var", root.vars().begin()->first);
+}
+
 }  // namespace zxdb
@@ -2,16 +2,53 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <optional>
+
 #include <gtest/gtest.h>
 
 #include "src/developer/debug/zxdb/common/perf_test.h"
+#include "src/developer/debug/zxdb/common/scoped_temp_file.h"
+#include "src/developer/debug/zxdb/symbols/dwarf_binary_impl.h"
 #include "src/developer/debug/zxdb/symbols/index.h"
+#include "src/developer/debug/zxdb/symbols/module_symbols_impl.h"
+#include "src/developer/debug/zxdb/symbols/test_symbol_module.h"
 
 namespace zxdb {
 
+// Compares building the index on one thread, on the default number of threads, and loading it from
+// the on-disk cache. The checked-in module is small, so the parallel case forces several threads.
 TEST(ModuleLoad, Perf) {
-  PerfTimeLogger logger("zxdb", "ModuleLoad");
-  // TODO(brettw) write this.
+  TestSymbolModule setup(TestSymbolModule::kCheckedIn);
+  ASSERT_TRUE(setup.Init("", false).ok());
+  llvm::object::ObjectFile* object_file = setup.symbols()->binary()->GetLLVMObjectFile();
+
+  {
+    PerfTimeLogger logger("zxdb", "CreateIndexSerial");
+    Index index;
+    index.CreateIndex(object_file, false, 1);
+  }
+
+  Index parallel_index;
+  {
+    PerfTimeLogger logger("zxdb", "CreateIndexParallel");
+    parallel_index.CreateIndex(object_file, false, 4);
+  }
+
+  std::optional<Index::CacheKey> cache_key = Index::CacheKey::ForFile(
+      TestSymbolModule::GetCheckedInTestFileName(), TestSymbolModule::kCheckedInBuildId);
+  ASSERT_TRUE(cache_key);
+
+  ScopedTempFile cache_file;
+  {
+    PerfTimeLogger logger("zxdb", "WriteIndexCache");
+    ASSERT_TRUE(parallel_index.WriteToFile(cache_file.name(), *cache_key));
+  }
+
+  {
+    PerfTimeLogger logger("zxdb", "ReadIndexCache");
+    Index index;
+    ASSERT_TRUE(index.ReadFromFile(cache_file.name(), *cache_key));
+  }
 }
 
 }  // namespace zxdb
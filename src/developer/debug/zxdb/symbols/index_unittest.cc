@@ -7,11 +7,14 @@
 #include <inttypes.h>
 #include <time.h>
 
+#include <filesystem>
+#include <optional>
 #include <ostream>
 #include <sstream>
 
 #include <gtest/gtest.h>
 
+#include "src/developer/debug/zxdb/common/scoped_temp_file.h"
 #include "src/developer/debug/zxdb/common/string_util.h"
 #include "src/developer/debug/zxdb/symbols/dwarf_binary_impl.h"
 #include "src/developer/debug/zxdb/symbols/module_symbols_impl.h"
@@ -135,6 +138,77 @@ zxdb_symbol_test2.cc -> ../../src/developer/debug/zxdb/symbols/test_data/zxdb_sy
   out = std::ostringstream();
   slow_index.root().Dump(out, setup.symbols()->symbol_factory(), 0);
   EXPECT_EQ(kExpected, out.str());
+
+  // Indexing in parallel should produce the same result too. Force more than one thread since the
+  // test module has too few units to use them by default.
+  Index parallel_index;
+  parallel_index.CreateIndex(setup.symbols()->binary()->GetLLVMObjectFile(), false, 3);
+  out = std::ostringstream();
+  parallel_index.root().Dump(out, setup.symbols()->symbol_factory(), 0);
+  EXPECT_EQ(kExpected, out.str());
+  files = std::ostringstream();
+  parallel_index.DumpFileIndex(files);
+  EXPECT_EQ(kExpectedFiles, files.str());
+}
+
+TEST(Index, CacheFile) {
+  TestSymbolModule setup(TestSymbolModule::kCheckedIn);
+  ASSERT_TRUE(setup.Init("", false).ok());
+
+  Index index;
+  EXPECT_TRUE(index.empty());
+  index.CreateIndex(setup.symbols()->binary()->GetLLVMObjectFile());
+  EXPECT_FALSE(index.empty());
+
+  std::optional<Index::CacheKey> key = Index::CacheKey::ForFile(
+      TestSymbolModule::GetCheckedInTestFileName(), TestSymbolModule::kCheckedInBuildId);
+  ASSERT_TRUE(key);
+  EXPECT_NE(0u, key->size);
+  EXPECT_FALSE(Index::CacheKey::ForFile("/does/not/exist", TestSymbolModule::kCheckedInBuildId));
+
+  ScopedTempFile temp_file;
+  ASSERT_TRUE(index.WriteToFile(temp_file.name(), *key));
+
+  Index loaded;
+  ASSERT_TRUE(loaded.ReadFromFile(temp_file.name(), *key));
+  std::ostringstream expected;
+  index.root().Dump(expected, setup.symbols()->symbol_factory(), 0);
+  std::ostringstream out;
+  loaded.root().Dump(out, setup.symbols()->symbol_factory(), 0);
+  EXPECT_EQ(expected.str(), out.str());
+
+  expected = std::ostringstream();
+  index.DumpFileIndex(expected);
+  out = std::ostringstream();
+  loaded.DumpFileIndex(out);
+  EXPECT_EQ(expected.str(), out.str());
+  EXPECT_EQ(index.main_functions().size(), loaded.main_functions().size());
+
+  // An index for a different build shouldn't be loaded.
+  Index::CacheKey other_key = *key;
+  other_key.build_id = "fedcba9876543210";
+  Index other_build;
+  EXPECT_FALSE(other_build.ReadFromFile(temp_file.name(), other_key));
+  EXPECT_EQ(0u, other_build.CountSymbolsIndexed());
+
+  // Nor should one for the same build ID in a different or changed file.
+  other_key = *key;
+  other_key.path += ".debug";
+  EXPECT_FALSE(other_build.ReadFromFile(temp_file.name(), other_key));
+  other_key = *key;
+  other_key.size++;
+  EXPECT_FALSE(other_build.ReadFromFile(temp_file.name(), other_key));
+  other_key = *key;
+  other_key.mtime++;
+  EXPECT_FALSE(other_build.ReadFromFile(temp_file.name(), other_key));
+  EXPECT_EQ(0u, other_build.CountSymbolsIndexed());
+
+  // Nor should a truncated one.
+  std::filesystem::resize_file(temp_file.name(), std::filesystem::file_size(temp_file.name()) / 2);
+  Index truncated;
+  EXPECT_FALSE(truncated.ReadFromFile(temp_file.name(), *key));
+  EXPECT_EQ(0u, truncated.CountSymbolsIndexed());
+  EXPECT_EQ(0u, truncated.files_indexed());
 }
 
 TEST(Index, FindExactFunction) {
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <optional>
 
 #include "llvm/DebugInfo/DIContext.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
@@ -147,7 +148,8 @@ bool HasOnlySupportedSpecialIdentifierTypes(const Identifier& ident) {
 }  // namespace
 
 ModuleSymbolsImpl::ModuleSymbolsImpl(std::unique_ptr<DwarfBinaryImpl> binary,
-                                     const std::string& build_dir, bool create_index)
+                                     const std::string& build_dir, bool create_index,
+                                     const std::filesystem::path& index_cache_path)
     : binary_(std::move(binary)), build_dir_(build_dir), weak_factory_(this) {
   symbol_factory_ = fxl::MakeRefCounted<DwarfSymbolFactory>(GetWeakPtr());
   FillElfSymbols();
@@ -159,8 +161,20 @@ ModuleSymbolsImpl::ModuleSymbolsImpl(std::unique_ptr<DwarfBinaryImpl> binary,
     //
     // Although it will be slightly slower to create, the memory savings may make such a change
     // worth it for large programs.
-    if (llvm::object::ObjectFile* object_file = binary_->GetLLVMObjectFile())
-      index_.CreateIndex(object_file);
+    if (llvm::object::ObjectFile* object_file = binary_->GetLLVMObjectFile()) {
+      // The cache is stored by build ID, so it can't be used for binaries without one.
+      std::optional<Index::CacheKey> cache_key;
+      std::string build_id = binary_->GetBuildID();
+      if (!index_cache_path.empty() && !build_id.empty())
+        cache_key = Index::CacheKey::ForFile(binary_->GetName(), build_id);
+      if (!cache_key || !index_.ReadFromFile(index_cache_path, *cache_key)) {
+        index_.CreateIndex(object_file);
+        // An empty index is cheap to recreate, and usually means the debug info is missing, so
+        // don't let it stand in for the debug info if it turns up later.
+        if (cache_key && !index_.empty() && !index_.WriteToFile(index_cache_path, *cache_key))
+          LOGS(Warn) << "Could not write the symbol index cache " << index_cache_path.string();
+      }
+    }
   }
 }
 
@@ -5,6 +5,7 @@
 #ifndef SRC_DEVELOPER_DEBUG_ZXDB_SYMBOLS_MODULE_SYMBOLS_IMPL_H_
 #define SRC_DEVELOPER_DEBUG_ZXDB_SYMBOLS_MODULE_SYMBOLS_IMPL_H_
 
+#include <filesystem>
 #include <map>
 
 #include "gtest/gtest_prod.h"
@@ -80,8 +81,12 @@ class ModuleSymbolsImpl final : public ModuleSymbols {
   // If create_index is true, an index will be created for fast symbol lookup.
   // Normal callers will always want to create the index, unless you don't need to query a symbol
   // from its name, e.g., in some test scenarios or in symbolizer.
+  //
+  // The index_cache_path, if not empty, names a file the index is loaded from when it was saved
+  // there for this binary before, and is saved to after it's created otherwise.
   explicit ModuleSymbolsImpl(std::unique_ptr<DwarfBinaryImpl> binary, const std::string& build_dir,
-                             bool create_index = true);
+                             bool create_index = true,
+                             const std::filesystem::path& index_cache_path = {});
   ~ModuleSymbolsImpl() override;
 
   // Helpers for ResolveInputLocation() for the different types of inputs.
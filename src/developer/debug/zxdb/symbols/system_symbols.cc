@@ -90,8 +90,9 @@ Err SystemSymbols::GetModule(const std::string& name, const std::string& build_i
   if (Err err = binary->Load(); err.has_error())
     return err;  // Symbols corrupt.
 
-  *module =
-      fxl::MakeRefCounted<ModuleSymbolsImpl>(std::move(binary), entry.build_dir, create_index_);
+  *module = fxl::MakeRefCounted<ModuleSymbolsImpl>(std::move(binary), entry.build_dir,
+                                                   create_index_,
+                                                   build_id_index_.GetIndexCachePath(build_id));
 
   SaveModule(build_id, module->get());  // Save in cache for future use.
   return Err();
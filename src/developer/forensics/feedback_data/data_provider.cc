@@ -16,6 +16,8 @@
 
 #include <map>
 #include <memory>
+#include <string>
+#include <string_view>
 #include <utility>
 
 #include "src/developer/forensics/feedback/annotations/annotation_manager.h"
@@ -159,11 +161,14 @@ void DataProvider::GetSnapshotInternal(
 
         const auto& annotations = std::get<0>(results).value();
         const auto& attachments = std::get<1>(results).value();
-        std::map<std::string, std::string> snapshot_files;
+
+        // |snapshot_files| only references the content of the files, which can be large, so the
+        // archive is the only copy made of them.
+        std::map<std::string, std::string_view> snapshot_files;
 
         // Add the annotations to |snapshot_files|
-        auto file = feedback::Encode<std::string>(annotations);
-        snapshot_files[kAttachmentAnnotations] = std::move(file);
+        const std::string annotations_file = feedback::Encode<std::string>(annotations);
+        snapshot_files[kAttachmentAnnotations] = annotations_file;
 
         // Add the attachments to |snapshot_files|
         for (const auto& [key, value] : attachments) {
@@ -172,9 +177,10 @@ void DataProvider::GetSnapshotInternal(
           }
         }
 
-        snapshot_files[kAttachmentMetadata] =
+        const std::string metadata_file =
             metadata_.MakeMetadata(annotations, attachments, uuid::Generate(),
                                    annotation_manager_->IsMissingNonPlatformAnnotations());
+        snapshot_files[kAttachmentMetadata] = metadata_file;
 
         fsl::SizedVmo archive;
 
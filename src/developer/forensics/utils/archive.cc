@@ -6,12 +6,17 @@
 
 #include <lib/syslog/cpp/macros.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include <contrib/minizip/ioapi.h>
 #include <contrib/minizip/unzip.h>
 #include <contrib/minizip/zip.h>
 
 #include "src/lib/files/file.h"
 #include "src/lib/files/scoped_temp_dir.h"
-#include "src/lib/fsl/vmo/file.h"
 #include "src/lib/fsl/vmo/sized_vmo.h"
 #include "src/lib/fsl/vmo/vector.h"
 #include "src/lib/fxl/strings/substitute.h"
@@ -21,80 +26,228 @@ namespace {
 
 using fuchsia::mem::Buffer;
 
-bool Archive(const std::map<std::string, std::string>& files, const std::string& archive_filename,
-             zipFile* zf, std::map<std::string, ArchiveFileStats>* file_to_size_stats) {
-  uint64_t old_zip_size = 0;
-  uint64_t new_zip_size = 0;
+// Upper bound on the size of the local header, zip64 extra fields and central directory entry of
+// each file, besides its name which is in both.
+constexpr size_t kMaxFileOverhead = 256;
 
-  for (const auto& [filename, content] : files) {
-    zip_fileinfo zf_info = {};
-    if (const int status =
-            zipOpenNewFileInZip64(*zf, filename.c_str(), &zf_info, nullptr, 0, nullptr, 0, nullptr,
-                                  Z_DEFLATED, Z_DEFAULT_COMPRESSION, /*zip64=*/1);
-        status != ZIP_OK) {
-      FX_LOGS(ERROR) << fxl::Substitute("cannot create $0 in output zip archive: ", filename)
-                     << status;
-      return false;
-    }
+// Upper bound on the size of the zip64 end of central directory record and locator, and end of
+// central directory record.
+constexpr size_t kMaxArchiveOverhead = 256;
 
-    if (const int status = zipWriteInFileInZip(*zf, content.data(), (uint32_t)content.size());
-        status != ZIP_OK) {
-      FX_LOGS(ERROR) << fxl::Substitute("cannot write $0 in output zip archive: ", filename)
-                     << status;
-      return false;
-    }
+}  // namespace
 
-    if (const int status = zipCloseFileInZip(*zf); status != ZIP_OK) {
-      FX_LOGS(WARNING) << fxl::Substitute("cannot close $0 in output zip archive: ", filename)
-                       << status;
-    }
+// Minizip I/O on a VMO of fixed capacity.
+struct ArchiveWriter::Stream {
+  zx::vmo vmo;
+  uint64_t capacity = 0;
+  uint64_t size = 0;
+  uint64_t position = 0;
+  bool error = false;
+};
 
-    if (file_to_size_stats != nullptr) {
-      files::GetFileSize(archive_filename.c_str(), &new_zip_size);
-      (*file_to_size_stats)[filename] = {.raw_bytes = content.size(),
-                                         .compressed_bytes = new_zip_size - old_zip_size};
-    }
+namespace {
 
-    old_zip_size = new_zip_size;
+using Stream = ArchiveWriter::Stream;
+
+voidpf ZCALLBACK OpenStream(voidpf opaque, const void* filename, int mode) { return opaque; }
+
+uLong ZCALLBACK ReadStream(voidpf opaque, voidpf stream, void* buf, uLong size) {
+  auto* s = static_cast<Stream*>(stream);
+  if (s->position >= s->size) {
+    return 0;
   }
 
-  return true;
+  size = static_cast<uLong>(std::min<uint64_t>(size, s->size - s->position));
+  if (const zx_status_t status = s->vmo.read(buf, s->position, size); status != ZX_OK) {
+    FX_PLOGS(ERROR, status) << "failed to read output zip archive VMO";
+    s->error = true;
+    return 0;
+  }
+
+  s->position += size;
+  return size;
 }
 
-}  // namespace
+uLong ZCALLBACK WriteStream(voidpf opaque, voidpf stream, const void* buf, uLong size) {
+  auto* s = static_cast<Stream*>(stream);
+  if (s->position > s->capacity || size > s->capacity - s->position) {
+    FX_LOGS(ERROR) << "output zip archive exceeds its maximum size of " << s->capacity;
+    s->error = true;
+    return 0;
+  }
 
-bool Archive(const std::map<std::string, std::string>& files, fsl::SizedVmo* archive,
-             std::map<std::string, ArchiveFileStats>* file_to_size_stats) {
-  // We write the archive to a temporary file because in-memory archiving in minizip is complicated.
-  files::ScopedTempDir tmp_dir;
-  std::string archive_filename;
-  tmp_dir.NewTempFile(&archive_filename);
+  if (const zx_status_t status = s->vmo.write(buf, s->position, size); status != ZX_OK) {
+    FX_PLOGS(ERROR, status) << "failed to write output zip archive VMO";
+    s->error = true;
+    return 0;
+  }
+
+  s->position += size;
+  s->size = std::max(s->size, s->position);
+  return size;
+}
+
+ZPOS64_T ZCALLBACK TellStream(voidpf opaque, voidpf stream) {
+  return static_cast<Stream*>(stream)->position;
+}
+
+long ZCALLBACK SeekStream(voidpf opaque, voidpf stream, ZPOS64_T offset, int origin) {
+  auto* s = static_cast<Stream*>(stream);
+  switch (origin) {
+    case ZLIB_FILEFUNC_SEEK_SET:
+      s->position = offset;
+      return 0;
+    case ZLIB_FILEFUNC_SEEK_CUR:
+      s->position += offset;
+      return 0;
+    case ZLIB_FILEFUNC_SEEK_END:
+      s->position = s->size + offset;
+      return 0;
+    default:
+      return -1;
+  }
+}
+
+int ZCALLBACK CloseStream(voidpf opaque, voidpf stream) { return 0; }
 
-  zipFile zf = zipOpen64(archive_filename.c_str(), APPEND_STATUS_CREATE);
-  if (zf == nullptr) {
+int ZCALLBACK TestErrorStream(voidpf opaque, voidpf stream) {
+  return static_cast<Stream*>(stream)->error ? 1 : 0;
+}
+
+}  // namespace
+
+ArchiveWriter::ArchiveWriter(const size_t max_size) : stream_(std::make_unique<Stream>()) {
+  // Pages are only committed as they are written so the VMO can be as big as the archive could
+  // possibly get.
+  if (const zx_status_t status = zx::vmo::create(max_size, 0, &stream_->vmo); status != ZX_OK) {
+    FX_PLOGS(ERROR, status) << "cannot create output zip archive VMO";
+    return;
+  }
+  stream_->capacity = max_size;
+
+  zlib_filefunc64_def file_functions = {
+      .zopen64_file = OpenStream,
+      .zread_file = ReadStream,
+      .zwrite_file = WriteStream,
+      .ztell64_file = TellStream,
+      .zseek64_file = SeekStream,
+      .zclose_file = CloseStream,
+      .zerror_file = TestErrorStream,
+      .opaque = stream_.get(),
+  };
+  zip_file_ = zipOpen2_64("snapshot.zip", APPEND_STATUS_CREATE, nullptr, &file_functions);
+  if (zip_file_ == nullptr) {
     FX_LOGS(ERROR) << "cannot create output zip archive";
+  }
+}
+
+ArchiveWriter::~ArchiveWriter() {
+  if (zip_file_ != nullptr) {
+    zipClose(zip_file_, nullptr);
+  }
+}
+
+size_t ArchiveWriter::MaxSize(const size_t num_files, const size_t filenames_size,
+                              const size_t contents_size) {
+  // DEFLATE expands incompressible data by at most a few bytes per block. compressBound() also
+  // accounts for the zlib header and trailer, which aren't in the archive.
+  return compressBound(contents_size) + num_files * (compressBound(0) + kMaxFileOverhead) +
+         2 * filenames_size + kMaxArchiveOverhead;
+}
+
+bool ArchiveWriter::Add(const std::string& filename, std::string_view content,
+                        ArchiveFileStats* stats) {
+  if (zip_file_ == nullptr) {
     return false;
   }
 
-  const bool success = Archive(files, archive_filename, &zf, file_to_size_stats);
+  const size_t raw_size = content.size();
+  const uint64_t old_zip_size = stream_->size;
 
-  // We always close the archive regardless of the success status.
-  if (const int status = zipClose(zf, nullptr); status != ZIP_OK) {
-    FX_LOGS(WARNING) << "cannot close output zip archive: " << status;
+  zip_fileinfo zf_info = {};
+  if (const int status =
+          zipOpenNewFileInZip64(zip_file_, filename.c_str(), &zf_info, nullptr, 0, nullptr, 0,
+                                nullptr, Z_DEFLATED, Z_DEFAULT_COMPRESSION, /*zip64=*/1);
+      status != ZIP_OK) {
+    FX_LOGS(ERROR) << fxl::Substitute("cannot create $0 in output zip archive: ", filename)
+                   << status;
+    return false;
+  }
+
+  // Minizip takes at most 4GiB at once.
+  while (!content.empty()) {
+    const auto chunk_size = static_cast<uint32_t>(
+        std::min<size_t>(content.size(), std::numeric_limits<uint32_t>::max()));
+    if (const int status = zipWriteInFileInZip(zip_file_, content.data(), chunk_size);
+        status != ZIP_OK) {
+      FX_LOGS(ERROR) << fxl::Substitute("cannot write $0 in output zip archive: ", filename)
+                     << status;
+      return false;
+    }
+    content.remove_prefix(chunk_size);
   }
 
-  if (!success) {
+  if (const int status = zipCloseFileInZip(zip_file_); status != ZIP_OK) {
+    FX_LOGS(WARNING) << fxl::Substitute("cannot close $0 in output zip archive: ", filename)
+                     << status;
+  }
+
+  if (stats != nullptr) {
+    *stats = {.raw_bytes = raw_size, .compressed_bytes = stream_->size - old_zip_size};
+  }
+
+  return !stream_->error;
+}
+
+bool ArchiveWriter::Finish(fsl::SizedVmo* archive) {
+  if (zip_file_ == nullptr) {
     return false;
   }
 
-  if (!fsl::VmoFromFilename(archive_filename, archive)) {
-    FX_LOGS(ERROR) << "error loading output zip archive into VMO";
+  const int status = zipClose(std::exchange(zip_file_, nullptr), nullptr);
+  if (status != ZIP_OK || stream_->error) {
+    FX_LOGS(ERROR) << "cannot close output zip archive: " << status;
     return false;
   }
 
+  *archive = fsl::SizedVmo(std::move(stream_->vmo), stream_->size);
   return true;
 }
 
+bool Archive(const std::map<std::string, std::string>& files, fsl::SizedVmo* archive,
+             std::map<std::string, ArchiveFileStats>* file_to_size_stats) {
+  std::map<std::string, std::string_view> file_views;
+  for (const auto& [filename, content] : files) {
+    file_views.emplace(filename, content);
+  }
+
+  return Archive(file_views, archive, file_to_size_stats);
+}
+
+bool Archive(const std::map<std::string, std::string_view>& files, fsl::SizedVmo* archive,
+             std::map<std::string, ArchiveFileStats>* file_to_size_stats) {
+  size_t filenames_size = 0;
+  size_t contents_size = 0;
+  for (const auto& [filename, content] : files) {
+    filenames_size += filename.size();
+    contents_size += content.size();
+  }
+
+  ArchiveWriter writer(ArchiveWriter::MaxSize(files.size(), filenames_size, contents_size));
+  for (const auto& [filename, content] : files) {
+    ArchiveFileStats stats;
+    if (!writer.Add(filename, content, &stats)) {
+      return false;
+    }
+
+    if (file_to_size_stats != nullptr) {
+      (*file_to_size_stats)[filename] = stats;
+    }
+  }
+
+  return writer.Finish(archive);
+}
+
 namespace {
 
 bool Unpack(unzFile* uf, std::map<std::string, std::string>* files) {
@@ -8,7 +8,9 @@
 #include <fuchsia/mem/cpp/fidl.h>
 
 #include <map>
+#include <memory>
 #include <string>
+#include <string_view>
 
 #include "src/lib/fsl/vmo/sized_vmo.h"
 
@@ -19,10 +21,46 @@ struct ArchiveFileStats {
   size_t compressed_bytes;
 };
 
+// Streams a ZIP archive with DEFLATE compression into a VMO, one file at a time.
+//
+// Each file is compressed straight into the VMO as it is added so neither a second copy of the
+// files nor of the archive is ever held. The VMO is created with a size bound up front, but its
+// pages are only committed as the archive is written, so the bound can be generous.
+class ArchiveWriter {
+ public:
+  // The archive can be at most |max_size| bytes; see MaxSize().
+  explicit ArchiveWriter(size_t max_size);
+  ~ArchiveWriter();
+
+  ArchiveWriter(const ArchiveWriter&) = delete;
+  ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+
+  // Returns an upper bound on the size of an archive holding |num_files| files whose names and
+  // contents add up to |filenames_size| and |contents_size| bytes respectively.
+  static size_t MaxSize(size_t num_files, size_t filenames_size, size_t contents_size);
+
+  // Compresses |content| into the archive as |filename|. |content| isn't used after this returns.
+  //
+  // Returns false on error, after which nothing else can be added to the archive.
+  bool Add(const std::string& filename, std::string_view content,
+           ArchiveFileStats* stats = nullptr);
+
+  // Completes the archive and moves it to |archive|.
+  bool Finish(fsl::SizedVmo* archive);
+
+ private:
+  struct Stream;
+
+  std::unique_ptr<Stream> stream_;
+  void* zip_file_ = nullptr;
+};
+
 // Bundles a map of filenames to string content into a single ZIP archive with DEFLATE compression.
 // Also returns a map of the same filenames to size stats.
 bool Archive(const std::map<std::string, std::string>& files, fsl::SizedVmo* archive,
              std::map<std::string, ArchiveFileStats>* file_to_size_stats = nullptr);
+bool Archive(const std::map<std::string, std::string_view>& files, fsl::SizedVmo* archive,
+             std::map<std::string, ArchiveFileStats>* file_to_size_stats = nullptr);
 
 // Unpack a ZIP archive into a map of filenames to string content.
 bool Unpack(const fuchsia::mem::Buffer& archive, std::map<std::string, std::string>* files);
@@ -8,6 +8,7 @@
 #include <lib/inspect/cpp/vmo/types.h>
 #include <lib/syslog/cpp/macros.h>
 
+#include <algorithm>
 #include <string_view>
 
 namespace forensics {
@@ -104,27 +105,73 @@ RedactorBase::RedactorBase(inspect::BoolProperty redaction_enabled)
 
 Redactor::Redactor(const int starting_id, inspect::UintProperty cache_size,
                    inspect::BoolProperty redaction_enabled)
-    : RedactorBase(std::move(redaction_enabled)), cache_(std::move(cache_size), starting_id) {
-  Add(ReplaceIPv4())
-      .Add(ReplaceIPv6())
-      .Add(ReplaceMac())
+    : RedactorBase(std::move(redaction_enabled)),
+      cache_(std::move(cache_size), starting_id),
+      patterns_(re2::RE2::DefaultOptions, re2::RE2::UNANCHORED) {
+  Add(IPv4Pattern(), ReplaceIPv4())
+      .Add(IPv6Pattern(), ReplaceIPv6())
+      .Add(MacPattern(), ReplaceMac())
       .AddTextReplacer(kEmailPattern, "<REDACTED-EMAIL>")
       .AddTextReplacer(kUuidPattern, "<REDACTED-UUID>")
       .AddTextReplacer(kUrlPattern, "<REDACTED-URL>")
       .AddIdReplacer(kSsidPattern, "<REDACTED-SSID: %d>")
       .AddIdReplacer(kHexPattern, "<REDACTED-HEX: %d>")
       .AddIdReplacer(kGaiaPattern, "<REDACTED-OBFUSCATED-GAIA-ID: %d>");
+
+  FX_CHECK(patterns_.Compile()) << "Failed to compile redaction patterns";
 }
 
 std::string& Redactor::Redact(std::string& text) {
-  for (const auto& replacer : replacers_) {
-    replacer(cache_, text);
+  std::vector<int> matches;
+  if (!Match(text, &matches)) {
+    return text;
+  }
+
+  // The replacers run in order on the output of the previous ones, as if all of them ran on the
+  // whole text, so ids are assigned in the same order. A replacer whose pattern doesn't occur in
+  // the text wouldn't change it and is skipped.
+  for (size_t i = 0; i < replacers_.size(); ++i) {
+    if (std::find(matches.begin(), matches.end(), static_cast<int>(i)) == matches.end()) {
+      continue;
+    }
+
+    replacers_[i](cache_, text);
+
+    // The replacement may have removed (or, in theory, created) occurrences of the later patterns.
+    if (i + 1 < replacers_.size() && !Match(text, &matches)) {
+      break;
+    }
   }
   return text;
 }
 
-Redactor& Redactor::Add(Replacer replacer) {
+bool Redactor::Match(const std::string& text, std::vector<int>* matches) const {
+  re2::RE2::Set::ErrorInfo error;
+  if (patterns_.Match(text, matches, &error)) {
+    return true;
+  }
+
+  if (error.kind == re2::RE2::Set::kNoError) {
+    return false;
+  }
+
+  // Matching can fail, e.g. if the DFA runs out of memory on very large text, so fall back to
+  // running all the replacers.
+  matches->resize(replacers_.size());
+  for (size_t i = 0; i < matches->size(); ++i) {
+    (*matches)[i] = static_cast<int>(i);
+  }
+  return true;
+}
+
+Redactor& Redactor::Add(const std::string_view pattern, Replacer replacer) {
   FX_CHECK(replacer != nullptr);
+
+  std::string error;
+  const int index = patterns_.Add(pattern, &error);
+  FX_CHECK(index == static_cast<int>(replacers_.size()))
+      << "Failed to add \"" << pattern << "\" to the pattern set: " << error;
+
   replacers_.push_back(std::move(replacer));
   return *this;
 }
@@ -133,14 +180,14 @@ Redactor& Redactor::AddTextReplacer(std::string_view pattern, std::string_view r
   auto replacer = ReplaceWithText(pattern, replacement);
   FX_CHECK(replacer != nullptr) << "Failed to build replacer for " << pattern << " " << replacement;
 
-  return Add(std::move(replacer));
+  return Add(pattern, std::move(replacer));
 }
 
 Redactor& Redactor::AddIdReplacer(std::string_view pattern, std::string_view format) {
   auto replacer = ReplaceWithIdFormatString(pattern, format);
   FX_CHECK(replacer != nullptr) << "Failed to build replacer for " << pattern << " " << format;
 
-  return Add(std::move(replacer));
+  return Add(pattern, std::move(replacer));
 }
 
 std::string Redactor::UnredactedCanary() const { return std::string(kUnredactedCanary); }
@@ -11,6 +11,8 @@
 #include <string_view>
 #include <vector>
 
+#include <re2/set.h>
+
 #include "src/developer/forensics/utils/redact/cache.h"
 #include "src/developer/forensics/utils/redact/replacer.h"
 
@@ -33,6 +35,10 @@ class RedactorBase {
 };
 
 // Redacts PII from text.
+//
+// All the patterns are matched at once in a single pass over the text first, and only the
+// replacers whose pattern occurs in the text are run. Most text has nothing to redact and is only
+// scanned once.
 class Redactor : public RedactorBase {
  public:
   Redactor(int starting_id, inspect::UintProperty cache_size,
@@ -45,12 +51,19 @@ class Redactor : public RedactorBase {
   std::string RedactedCanary() const override;
 
  private:
-  Redactor& Add(Replacer replacer);
+  Redactor& Add(std::string_view pattern, Replacer replacer);
   Redactor& AddTextReplacer(std::string_view pattern, std::string_view replacement);
   Redactor& AddIdReplacer(std::string_view pattern, std::string_view format);
 
+  // Sets |matches| to the indices in |replacers_| of the replacers whose pattern occurs in |text|
+  // and returns whether there are any.
+  bool Match(const std::string& text, std::vector<int>* matches) const;
+
   RedactionIdCache cache_;
   std::vector<Replacer> replacers_;
+
+  // The pattern of each replacer in |replacers_|, at the same index.
+  re2::RE2::Set patterns_;
 };
 
 // Do-nothing redactor
@@ -199,6 +199,8 @@ std::string RedactIPv4(RedactionIdCache& cache, const std::string& match) {
 
 Replacer ReplaceIPv4() { return FunctionBasedReplacer(kIPv4Pattern, RedactIPv4); }
 
+std::string_view IPv4Pattern() { return kIPv4Pattern; }
+
 namespace {
 
 constexpr std::string_view kIPv6Pattern{
@@ -255,6 +257,8 @@ std::string RedactIPv6(RedactionIdCache& cache, const std::string& match) {
 
 Replacer ReplaceIPv6() { return FunctionBasedReplacer(kIPv6Pattern, RedactIPv6); }
 
+std::string_view IPv6Pattern() { return kIPv6Pattern; }
+
 namespace {
 
 constexpr std::string_view kMacPattern{
@@ -279,4 +283,6 @@ std::string RedactMac(RedactionIdCache& cache, const std::string& match) {
 
 Replacer ReplaceMac() { return FunctionBasedReplacer(kMacPattern, RedactMac); }
 
+std::string_view MacPattern() { return kMacPattern; }
+
 }  // namespace forensics
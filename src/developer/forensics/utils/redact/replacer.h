@@ -39,6 +39,11 @@ Replacer ReplaceIPv6();
 // "REDACTED-MAC:"
 Replacer ReplaceMac();
 
+// The patterns the Replacers constructed by ReplaceIPv4(), ReplaceIPv6() and ReplaceMac() look for.
+std::string_view IPv4Pattern();
+std::string_view IPv6Pattern();
+std::string_view MacPattern();
+
 }  // namespace forensics
 
 #endif  // SRC_DEVELOPER_FORENSICS_UTILS_REDACT_REPLACER_H_
@@ -0,0 +1,106 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <lib/inspect/cpp/vmo/types.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <perftest/perftest.h>
+
+#include "src/developer/forensics/utils/redact/redactor.h"
+#include "src/lib/fxl/strings/string_printf.h"
+
+namespace forensics {
+namespace {
+
+// Size of the generated logs, roughly that of a full system log in a snapshot.
+constexpr size_t kLogSize = 4 * 1024 * 1024;
+
+// Lines that have nothing to redact, like the vast majority of lines in real logs.
+constexpr std::string_view kPlainLines[] = {
+    "[netstack] INFO: [ndp.go(123)] DAD resolved for interface 3, address is now assigned",
+    "[wlan] INFO: [src/connectivity/wlan/wlancfg/src/client/state_machine.rs(456)] scan complete",
+    "[component_manager] WARNING: Failed to route protocol `fuchsia.foo.Bar` from component",
+    "[audio_core] INFO: [audio_driver.cc:789] Output device 0x2a started, 48000 Hz, 2 channels",
+    "[session_manager] INFO: Launching session fuchsia-pkg://fuchsia.com/session#meta/s.cm",
+    "[scenic] INFO: [frame_scheduler.cc:321] Missed frame deadline by 2ms, frame number 10234",
+    "[driver_manager] INFO: Bound driver to device /dev/sys/platform/pci/00:1f.2/ahci",
+    "[cobalt] INFO: Uploaded 12 observations for project 1234 in 45ms",
+};
+
+// Lines that have something to redact.
+constexpr std::string_view kPiiFormats[] = {
+    "[netstack] INFO: [dhcp.go(88)] acquired lease 192.168.%d.%d for 86400s",
+    "[netstack] INFO: neighbor fe80::7d84:c1dc:ab34:%x is reachable",
+    "[wlan] INFO: connected to <ssid-666F6F%02x> with bssid de:ad:be:ef:42:%02x",
+    "[feedback] INFO: uploading report to https://crash.example.com/report?id=%d",
+    "[account] INFO: signed in as user%d@example.com",
+};
+
+// Generates a log where every |pii_period|-th line has something to redact, or no line at all if
+// |pii_period| is 0.
+std::vector<std::string> GenerateLogLines(const size_t pii_period) {
+  std::vector<std::string> lines;
+  size_t size = 0;
+  for (size_t i = 0; size < kLogSize; ++i) {
+    std::string line = fxl::StringPrintf("[%05zu.%03zu][1234][5678]", i / 1000, i % 1000);
+    if (pii_period != 0 && i % pii_period == 0) {
+      const size_t n = i / pii_period;
+      line += fxl::StringPrintf(kPiiFormats[n % std::size(kPiiFormats)].data(),
+                                static_cast<int>(n % 256), static_cast<int>((n / 256) % 256));
+    } else {
+      line += kPlainLines[i % std::size(kPlainLines)];
+    }
+    size += line.size() + 1;
+    lines.push_back(std::move(line));
+  }
+  return lines;
+}
+
+// Redacts the log one message at a time, like the system log recorder.
+bool RedactMessages(perftest::RepeatState* state, const size_t pii_period) {
+  const std::vector<std::string> lines = GenerateLogLines(pii_period);
+  state->SetBytesProcessedPerRun(kLogSize);
+  while (state->KeepRunning()) {
+    Redactor redactor(0, inspect::UintProperty(), inspect::BoolProperty());
+    for (const auto& line : lines) {
+      std::string message = line;
+      redactor.Redact(message);
+    }
+  }
+  return true;
+}
+
+// Redacts the log all at once, like the kernel log and the previous boot log.
+bool RedactWholeLog(perftest::RepeatState* state, const size_t pii_period) {
+  std::string log;
+  for (const auto& line : GenerateLogLines(pii_period)) {
+    log += line;
+    log += '\n';
+  }
+  state->SetBytesProcessedPerRun(log.size());
+  while (state->KeepRunning()) {
+    Redactor redactor(0, inspect::UintProperty(), inspect::BoolProperty());
+    std::string text = log;
+    redactor.Redact(text);
+  }
+  return true;
+}
+
+void RegisterTests() {
+  perftest::RegisterTest("Redactor/Messages/NoPii", RedactMessages, size_t{0});
+  perftest::RegisterTest("Redactor/Messages/SomePii", RedactMessages, size_t{20});
+  perftest::RegisterTest("Redactor/Messages/AllPii", RedactMessages, size_t{1});
+  perftest::RegisterTest("Redactor/WholeLog/SomePii", RedactWholeLog, size_t{20});
+}
+PERFTEST_CTOR(RegisterTests)
+
+}  // namespace
+}  // namespace forensics
+
+int main(int argc, char** argv) {
+  return perftest::PerfTestMain(argc, argv, "fuchsia.forensics.redact");
+}
@@ -95,6 +95,16 @@ TEST_F(RedactorTest, Check) {
             "obfuscated_gaia_id: <REDACTED-OBFUSCATED-GAIA-ID: 26>");
 }
 
+TEST_F(RedactorTest, MultiplePatterns) {
+  // The URL pattern only matches part of the text left after the email is redacted.
+  EXPECT_EQ(Redact("URL: http://alice@website.tld/x 8.8.8.8"),
+            "URL: <REDACTED-URL><REDACTED-EMAIL>/x <REDACTED-IPV4: 1>");
+  EXPECT_EQ(Redact("a 8.8.8.8 b 8.8.8.8 fe80::7d84:c1dc:ab34:656a"),
+            "a <REDACTED-IPV4: 1> b <REDACTED-IPV4: 1> fe80:<REDACTED-IPV6-LL: 2>");
+  EXPECT_EQ(Redact("Nothing to redact: service::fidl 123 abc-def"),
+            "Nothing to redact: service::fidl 123 abc-def");
+}
+
 TEST_F(RedactorTest, Canary) {
   EXPECT_EQ(Redact(redactor().UnredactedCanary()), redactor().RedactedCanary());
 }
@@ -8,6 +8,7 @@
 #include <fuchsia/mem/cpp/fidl.h>
 #include <lib/syslog/cpp/macros.h>
 
+#include <cstring>
 #include <map>
 #include <string>
 #include <vector>
@@ -82,5 +83,32 @@ TEST(ArchiveTest, UnpackArchive) {
   EXPECT_EQ(unpacked_attachments, kAttachments);
 }
 
+TEST(ArchiveTest, ArchiveWriter) {
+  ArchiveWriter writer(ArchiveWriter::MaxSize(1, strlen(kJsonFilename), strlen(kJsonFileContent)));
+
+  ArchiveFileStats stats;
+  ASSERT_TRUE(writer.Add(kJsonFilename, kJsonFileContent, &stats));
+  EXPECT_EQ(stats.raw_bytes, strlen(kJsonFileContent));
+  EXPECT_GT(stats.compressed_bytes, 0u);
+
+  fsl::SizedVmo archive;
+  ASSERT_TRUE(writer.Finish(&archive));
+  EXPECT_GT(archive.size(), stats.compressed_bytes);
+
+  std::map<std::string, std::string> unpacked_attachments;
+  ASSERT_TRUE(Unpack(std::move(archive).ToTransport(), &unpacked_attachments));
+  EXPECT_THAT(unpacked_attachments, UnorderedElementsAreArray({
+                                        Pair(kJsonFilename, kJsonFileContent),
+                                    }));
+}
+
+TEST(ArchiveTest, ArchiveWriter_ExceedsMaxSize) {
+  ArchiveWriter writer(16);
+  EXPECT_FALSE(writer.Add(kJsonFilename, kJsonFileContent));
+
+  fsl::SizedVmo archive;
+  EXPECT_FALSE(writer.Finish(&archive));
+}
+
 }  // namespace
 }  // namespace forensics
@@ -11,6 +11,7 @@
 #include <lib/trace/event.h>
 #include <lib/zx/channel.h>
 #include <lib/zx/job.h>
+#include <string.h>
 #include <zircon/process.h>
 #include <zircon/status.h>
 #include <zircon/types.h>
@@ -171,8 +172,17 @@ zx_status_t Capture::GetCapture(Capture* capture, const CaptureState& state, Cap
   return GetCapture(capture, state, level, &osImpl, rooted_vmo_names);
 }
 
+// static.
 zx_status_t Capture::GetCapture(Capture* capture, const CaptureState& state, CaptureLevel level,
-                                OS* os, const std::vector<std::string>& rooted_vmo_names) {
+                                CaptureCache* cache,
+                                const std::vector<std::string>& rooted_vmo_names) {
+  OSImpl osImpl;
+  return GetCapture(capture, state, level, &osImpl, rooted_vmo_names, cache);
+}
+
+zx_status_t Capture::GetCapture(Capture* capture, const CaptureState& state, CaptureLevel level,
+                                OS* os, const std::vector<std::string>& rooted_vmo_names,
+                                CaptureCache* cache) {
   TRACE_DURATION("memory_metrics", "Capture::GetCapture");
   capture->time_ = os->GetMonotonic();
 
@@ -193,8 +203,14 @@ zx_status_t Capture::GetCapture(Capture* capture, const CaptureState& state, Cap
     return err;
   }
 
+  if (cache != nullptr) {
+    cache->generation_++;
+    cache->processes_read_ = 0;
+  }
+
   err = os->GetProcesses(
-      [&state, capture, &os](int depth, zx_handle_t handle, zx_koid_t koid, zx_koid_t parent_koid) {
+      [&state, capture, &os, cache](int depth, zx_handle_t handle, zx_koid_t koid,
+                                    zx_koid_t parent_koid) {
         if (koid == state.self_koid) {
           return ZX_OK;
         }
@@ -204,6 +220,11 @@ zx_status_t Capture::GetCapture(Capture* capture, const CaptureState& state, Cap
           return s == ZX_ERR_BAD_STATE ? ZX_OK : s;
         }
 
+        if (cache != nullptr) {
+          s = capture->AddCachedProcess(os, cache, handle, koid, name);
+          return s == ZX_ERR_BAD_STATE ? ZX_OK : s;
+        }
+
         TRACE_DURATION_BEGIN("memory_metrics", "Capture::GetProcesses::GetVMOCount");
         size_t num_vmos;
         s = os->GetInfo(handle, ZX_INFO_PROCESS_VMOS, nullptr, 0, nullptr, &num_vmos);
@@ -247,10 +268,94 @@ zx_status_t Capture::GetCapture(Capture* capture, const CaptureState& state, Cap
 
         return ZX_OK;
       });
+
+  if (cache != nullptr) {
+    // Forget processes which have exited. Processes skipped because of an error are read again
+    // next time.
+    for (auto it = cache->processes_.begin(); it != cache->processes_.end();) {
+      if (it->second.generation != cache->generation_) {
+        it = cache->processes_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
   capture->ReallocateDescendents(rooted_vmo_names);
   return err;
 }
 
+zx_status_t Capture::AddCachedProcess(OS* os, CaptureCache* cache, zx_handle_t handle,
+                                      zx_koid_t koid, const char* name) {
+  TRACE_DURATION("memory_metrics", "Capture::AddCachedProcess");
+  zx_info_task_stats_t stats;
+  zx_status_t s = os->GetInfo(handle, ZX_INFO_TASK_STATS, &stats, sizeof(stats), nullptr, nullptr);
+  if (s != ZX_OK) {
+    return s;
+  }
+
+  auto [cached_it, inserted] = cache->processes_.try_emplace(koid);
+  auto& cached = cached_it->second;
+  const bool read_vmos =
+      inserted || memcmp(&cached.stats, &stats, sizeof(stats)) != 0 ||
+      (cache->refresh_period_ != 0 && (koid + cache->generation_) % cache->refresh_period_ == 0);
+  if (read_vmos) {
+    s = cache->ReadVmos(os, handle, &cached.vmos);
+    if (s != ZX_OK) {
+      cache->processes_.erase(cached_it);
+      return s;
+    }
+    cached.stats = stats;
+    cache->processes_read_++;
+  }
+  cached.generation = cache->generation_;
+
+  TRACE_DURATION_BEGIN("memory_metrics", "Capture::AddCachedProcess::InsertProcess");
+  auto [it, _] = koid_to_process_.insert({koid, {}});
+  auto& process = it->second;
+  process.koid = koid;
+  strncpy(process.name, name, ZX_MAX_NAME_LEN);
+  process.vmos.reserve(cached.vmos.size());
+  for (const auto& vmo : cached.vmos) {
+    // A VMO shared with another process may have been cached earlier, so prefer what was just read.
+    if (read_vmos) {
+      koid_to_vmo_.insert_or_assign(vmo.koid, vmo);
+    } else {
+      koid_to_vmo_.try_emplace(vmo.koid, vmo);
+    }
+    process.vmos.push_back(vmo.koid);
+  }
+  TRACE_DURATION_END("memory_metrics", "Capture::AddCachedProcess::InsertProcess");
+  return ZX_OK;
+}
+
+zx_status_t CaptureCache::ReadVmos(OS* os, zx_handle_t handle, std::vector<Vmo>* vmos) {
+  TRACE_DURATION("memory_metrics", "CaptureCache::ReadVmos");
+  size_t actual, avail;
+  for (;;) {
+    zx_status_t s = os->GetInfo(handle, ZX_INFO_PROCESS_VMOS, vmo_buffer_.data(),
+                                vmo_buffer_.size() * sizeof(zx_info_vmo_t), &actual, &avail);
+    if (s != ZX_OK) {
+      return s;
+    }
+    if (actual == avail) {
+      break;
+    }
+    // Leave headroom for VMOs created before the retry, and for the next, larger, process.
+    vmo_buffer_.resize(avail + avail / 4);
+  }
+
+  vmos->clear();
+  vmos->reserve(actual);
+  vmo_koids_.clear();
+  for (size_t i = 0; i < actual; i++) {
+    if (vmo_koids_.insert(vmo_buffer_[i].koid).second) {
+      vmos->emplace_back(vmo_buffer_[i]);
+    }
+  }
+  return ZX_OK;
+}
+
 // Descendents of this vmo will have their allocated_bytes treated as an allocation of their
 // immediate parent. This supports a usage pattern where a potentially large allocation is done
 // and then slices are given to read / write children. In this case the children have no
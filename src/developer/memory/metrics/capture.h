@@ -12,6 +12,7 @@
 #include <zircon/types.h>
 
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "src/lib/fxl/macros.h"
@@ -68,6 +69,50 @@ class OS {
       zx_info_kmem_stats_extended_t* kmem_ext, zx_info_kmem_stats_t* kmem = nullptr) = 0;
 };
 
+// Remembers the VMOs of each process between captures, so that a capture only needs to read the
+// VMOs of processes whose ZX_INFO_TASK_STATS changed since the previous capture. Processes are
+// keyed by koid, and processes which no longer exist are forgotten.
+//
+// Task stats only account for mapped memory, so changes to VMOs which a process holds only by
+// handle are missed until the process is read again. To bound how stale those get, every process
+// is also read once every |refresh_period| captures, spread evenly across captures.
+//
+// A CaptureCache isn't thread-safe, and must only be used with one CaptureState.
+class CaptureCache {
+ public:
+  static constexpr uint32_t kDefaultRefreshPeriod = 10;
+
+  // A |refresh_period| of 0 only reads processes whose task stats changed.
+  explicit CaptureCache(uint32_t refresh_period = kDefaultRefreshPeriod)
+      : refresh_period_(refresh_period) {}
+
+  // Number of processes whose VMOs were read by the last capture.
+  size_t processes_read() const { return processes_read_; }
+
+  // Number of processes currently remembered.
+  size_t size() const { return processes_.size(); }
+
+ private:
+  friend class Capture;
+
+  struct CachedProcess {
+    zx_info_task_stats_t stats;
+    std::vector<Vmo> vmos;
+    uint64_t generation;
+  };
+
+  // Reads the unique VMOs of the process into |vmos|. The buffer the kernel writes into is reused
+  // across processes and captures, so this is usually a single syscall.
+  zx_status_t ReadVmos(OS* os, zx_handle_t handle, std::vector<Vmo>* vmos);
+
+  const uint32_t refresh_period_;
+  uint64_t generation_ = 0;
+  size_t processes_read_ = 0;
+  std::unordered_map<zx_koid_t, CachedProcess> processes_;
+  std::vector<zx_info_vmo_t> vmo_buffer_;
+  std::unordered_set<zx_koid_t> vmo_koids_;
+};
+
 class Capture {
  public:
   static const std::vector<std::string> kDefaultRootedVmoNames;
@@ -87,6 +132,13 @@ class Capture {
       Capture* capture, const CaptureState& state, CaptureLevel level,
       const std::vector<std::string>& rooted_vmo_names = kDefaultRootedVmoNames);
 
+  // As above, but only reads the VMOs of processes which changed since the last capture taken with
+  // |cache|. See CaptureCache for the trade-offs. The result is the same as a full capture, other
+  // than for VMOs which are only held by handle.
+  static zx_status_t GetCapture(
+      Capture* capture, const CaptureState& state, CaptureLevel level, CaptureCache* cache,
+      const std::vector<std::string>& rooted_vmo_names = kDefaultRootedVmoNames);
+
   zx_time_t time() const { return time_; }
   const zx_info_kmem_stats_t& kmem() const { return kmem_; }
   const zx_info_kmem_stats_extended_t& kmem_extended() const { return kmem_extended_; }
@@ -102,7 +154,10 @@ class Capture {
  private:
   static zx_status_t GetCaptureState(CaptureState* state, OS* os);
   static zx_status_t GetCapture(Capture* capture, const CaptureState& state, CaptureLevel level,
-                                OS* os, const std::vector<std::string>& rooted_vmo_names);
+                                OS* os, const std::vector<std::string>& rooted_vmo_names,
+                                CaptureCache* cache = nullptr);
+  zx_status_t AddCachedProcess(OS* os, CaptureCache* cache, zx_handle_t handle, zx_koid_t koid,
+                               const char* name);
   void ReallocateDescendents(const std::vector<std::string>& rooted_vmo_names);
   void ReallocateDescendents(Vmo* parent);
 
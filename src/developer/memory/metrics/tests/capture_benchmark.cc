@@ -0,0 +1,175 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string.h>
+#include <zircon/assert.h>
+#include <zircon/limits.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <perftest/perftest.h>
+
+#include "src/developer/memory/metrics/capture.h"
+#include "src/developer/memory/metrics/tests/test_utils.h"
+#include "src/lib/fxl/strings/string_printf.h"
+
+namespace memory {
+namespace {
+
+// Every process maps this VMO, as it would a shared library.
+constexpr zx_koid_t kSharedVmoKoid = 1;
+constexpr zx_koid_t kFirstProcessKoid = 1000;
+constexpr zx_handle_t kFirstProcessHandle = 1000;
+
+// Simulates a large, mostly idle system: a flat job with |num_processes| processes, each holding
+// |vmos_per_process| VMOs, where every |change_period|th process changes its memory usage between
+// captures. Only the work done by Capture is measured, not the cost of the syscalls themselves.
+class SyntheticOS : public OS {
+ public:
+  SyntheticOS(size_t num_processes, size_t vmos_per_process, size_t change_period)
+      : num_processes_(num_processes),
+        change_period_(change_period),
+        versions_(num_processes, 0),
+        vmos_(vmos_per_process) {
+    for (size_t i = 0; i < vmos_.size(); i++) {
+      vmos_[i].koid = i == 0 ? kSharedVmoKoid : ZX_KOID_INVALID;
+      vmos_[i].size_bytes = (i + 1) * ZX_PAGE_SIZE;
+      vmos_[i].committed_bytes = ZX_PAGE_SIZE;
+      strncpy(vmos_[i].name, "synthetic", sizeof(vmos_[i].name));
+    }
+  }
+
+  // Changes the memory usage of a different set of processes.
+  void Advance() {
+    for (size_t i = tick_++ % change_period_; i < num_processes_; i += change_period_) {
+      versions_[i]++;
+    }
+  }
+
+ private:
+  zx_status_t GetKernelStats(fidl::WireSyncClient<fuchsia_kernel::Stats>* stats) override {
+    return ZX_OK;
+  }
+
+  zx_handle_t ProcessSelf() override { return TestUtils::kSelfHandle; }
+
+  zx_time_t GetMonotonic() override { return 0; }
+
+  zx_status_t GetProcesses(
+      fit::function<zx_status_t(int, zx_handle_t, zx_koid_t, zx_koid_t)> cb) override {
+    for (size_t i = 0; i < num_processes_; i++) {
+      zx_status_t s = cb(1, kFirstProcessHandle + i, kFirstProcessKoid + i, 0);
+      if (s != ZX_OK) {
+        return s;
+      }
+    }
+    return ZX_OK;
+  }
+
+  zx_status_t GetProperty(zx_handle_t handle, uint32_t property, void* value,
+                          size_t name_len) override {
+    strncpy(static_cast<char*>(value), "process", name_len);
+    return ZX_OK;
+  }
+
+  zx_status_t GetInfo(zx_handle_t handle, uint32_t topic, void* buffer, size_t buffer_size,
+                      size_t* actual, size_t* avail) override {
+    switch (topic) {
+      case ZX_INFO_HANDLE_BASIC: {
+        auto* info = static_cast<zx_info_handle_basic_t*>(buffer);
+        info->koid = TestUtils::kSelfKoid;
+        return ZX_OK;
+      }
+      case ZX_INFO_TASK_STATS: {
+        auto* stats = static_cast<zx_info_task_stats_t*>(buffer);
+        *stats = {};
+        stats->mem_private_bytes = versions_[handle - kFirstProcessHandle] * ZX_PAGE_SIZE;
+        return ZX_OK;
+      }
+      case ZX_INFO_PROCESS_VMOS: {
+        const zx_koid_t first_koid =
+            kSharedVmoKoid + 1 + (handle - kFirstProcessHandle) * vmos_.size();
+        auto* out = static_cast<zx_info_vmo_t*>(buffer);
+        const size_t count = std::min(vmos_.size(), buffer_size / sizeof(zx_info_vmo_t));
+        for (size_t i = 0; i < count; i++) {
+          out[i] = vmos_[i];
+          if (out[i].koid != kSharedVmoKoid) {
+            out[i].koid = first_koid + i;
+          }
+        }
+        if (actual != nullptr) {
+          *actual = count;
+        }
+        if (avail != nullptr) {
+          *avail = vmos_.size();
+        }
+        return ZX_OK;
+      }
+      default:
+        return ZX_ERR_NOT_SUPPORTED;
+    }
+  }
+
+  zx_status_t GetKernelMemoryStats(const fidl::WireSyncClient<fuchsia_kernel::Stats>& stats_client,
+                                   zx_info_kmem_stats_t* kmem) override {
+    *kmem = {};
+    return ZX_OK;
+  }
+
+  zx_status_t GetKernelMemoryStatsExtended(
+      const fidl::WireSyncClient<fuchsia_kernel::Stats>& stats_client,
+      zx_info_kmem_stats_extended_t* kmem_ext, zx_info_kmem_stats_t* kmem) override {
+    *kmem_ext = {};
+    if (kmem) {
+      *kmem = {};
+    }
+    return ZX_OK;
+  }
+
+  const size_t num_processes_;
+  const size_t change_period_;
+  std::vector<uint64_t> versions_;
+  std::vector<zx_info_vmo_t> vmos_;
+  size_t tick_ = 0;
+};
+
+// Measures the time taken by a VMO level capture, with and without a CaptureCache, when 1 in 20
+// processes changes between captures.
+bool CaptureTest(perftest::RepeatState* state, size_t num_processes, size_t vmos_per_process,
+                 bool cached) {
+  SyntheticOS os(num_processes, vmos_per_process, 20);
+  CaptureCache cache;
+  if (cached) {
+    // Fill the cache, as a long running caller would have.
+    Capture capture;
+    ZX_ASSERT(TestUtils::GetCapture(&capture, VMO, &os, &cache) == ZX_OK);
+  }
+  while (state->KeepRunning()) {
+    os.Advance();
+    Capture capture;
+    ZX_ASSERT(TestUtils::GetCapture(&capture, VMO, &os, cached ? &cache : nullptr) == ZX_OK);
+  }
+  return true;
+}
+
+void RegisterTests() {
+  for (size_t num_processes : {100, 1000}) {
+    for (size_t vmos_per_process : {20, 200}) {
+      for (bool cached : {false, true}) {
+        auto name = fxl::StringPrintf("MemoryCapture/%s/%zuProcesses/%zuVmos",
+                                      cached ? "Cached" : "Full", num_processes, vmos_per_process);
+        perftest::RegisterTest(name.c_str(), CaptureTest, num_processes, vmos_per_process, cached);
+      }
+    }
+  }
+}
+PERFTEST_CTOR(RegisterTests)
+
+}  // namespace
+}  // namespace memory
+
+int main(int argc, char** argv) {
+  return perftest::PerfTestMain(argc, argv, "fuchsia.memory_metrics");
+}
@@ -84,6 +84,13 @@ const static zx_info_vmo_t _vmo2 = {
 const static GetInfoResponse vmos2_info = {
     proc2_handle, ZX_INFO_PROCESS_VMOS, &_vmo2, sizeof(_vmo2), 1, ZX_OK};
 
+const static zx_info_task_stats_t _stats = {.mem_private_bytes = 4096};
+const static GetInfoResponse stats_info = {
+    proc_handle, ZX_INFO_TASK_STATS, &_stats, sizeof(_stats), 1, ZX_OK};
+const static zx_info_task_stats_t _stats_grown = {.mem_private_bytes = 8192};
+const static GetInfoResponse stats_grown_info = {
+    proc_handle, ZX_INFO_TASK_STATS, &_stats_grown, sizeof(_stats_grown), 1, ZX_OK};
+
 TEST_F(CaptureUnitTest, KMEM) {
   Capture c;
   auto ret = TestUtils::GetCapture(&c, KMEM,
@@ -259,6 +266,98 @@ TEST_F(CaptureUnitTest, VMOGetBadState) {
   EXPECT_STREQ(vmo2_name, vmo.name);
 }
 
+TEST_F(CaptureUnitTest, VMOCached) {
+  CaptureCache cache(0);
+
+  // The first capture sizes the VMO buffer, then reads the VMOs.
+  Capture c1;
+  auto ret = TestUtils::GetCapture(&c1, VMO,
+                                   {.get_processes = {{ZX_OK, {proc_cb}}},
+                                    .get_property = {proc_prop},
+                                    .get_info = {self_info, kmem_info, stats_info, vmos_info,
+                                                 vmos_info}},
+                                   &cache);
+  EXPECT_EQ(ZX_OK, ret);
+  EXPECT_EQ(1U, cache.processes_read());
+  EXPECT_EQ(1U, cache.size());
+  EXPECT_EQ(1U, c1.koid_to_vmo().size());
+
+  // The task stats are unchanged, so the VMOs aren't read again.
+  Capture c2;
+  ret = TestUtils::GetCapture(&c2, VMO,
+                              {.get_processes = {{ZX_OK, {proc_cb}}},
+                               .get_property = {proc_prop},
+                               .get_info = {self_info, kmem_info, stats_info}},
+                              &cache);
+  EXPECT_EQ(ZX_OK, ret);
+  EXPECT_EQ(0U, cache.processes_read());
+  const auto& process = c2.process_for_koid(proc_koid);
+  EXPECT_STREQ(proc_name, process.name);
+  ASSERT_EQ(1U, process.vmos.size());
+  EXPECT_EQ(vmo_koid, process.vmos[0]);
+  EXPECT_STREQ(vmo_name, c2.vmo_for_koid(vmo_koid).name);
+
+  // The task stats changed, so the VMOs are read again, with a single call.
+  Capture c3;
+  ret = TestUtils::GetCapture(&c3, VMO,
+                              {.get_processes = {{ZX_OK, {proc_cb}}},
+                               .get_property = {proc_prop},
+                               .get_info = {self_info, kmem_info, stats_grown_info, vmos_info}},
+                              &cache);
+  EXPECT_EQ(ZX_OK, ret);
+  EXPECT_EQ(1U, cache.processes_read());
+  EXPECT_EQ(1U, c3.koid_to_vmo().size());
+
+  // The process exited, so it's forgotten.
+  Capture c4;
+  ret = TestUtils::GetCapture(&c4, VMO,
+                              {.get_processes = {{ZX_OK, {}}}, .get_info = {self_info, kmem_info}},
+                              &cache);
+  EXPECT_EQ(ZX_OK, ret);
+  EXPECT_EQ(0U, c4.koid_to_process().size());
+  EXPECT_EQ(0U, cache.size());
+}
+
+TEST_F(CaptureUnitTest, VMOCachedRefresh) {
+  // With a refresh period of 1, every process is read on every capture.
+  CaptureCache cache(1);
+  Capture c1;
+  auto ret = TestUtils::GetCapture(&c1, VMO,
+                                   {.get_processes = {{ZX_OK, {proc_cb}}},
+                                    .get_property = {proc_prop},
+                                    .get_info = {self_info, kmem_info, stats_info, vmos_info,
+                                                 vmos_info}},
+                                   &cache);
+  EXPECT_EQ(ZX_OK, ret);
+  Capture c2;
+  ret = TestUtils::GetCapture(&c2, VMO,
+                              {.get_processes = {{ZX_OK, {proc_cb}}},
+                               .get_property = {proc_prop},
+                               .get_info = {self_info, kmem_info, stats_info, vmos_info}},
+                              &cache);
+  EXPECT_EQ(ZX_OK, ret);
+  EXPECT_EQ(1U, cache.processes_read());
+  EXPECT_EQ(1U, c2.koid_to_vmo().size());
+}
+
+TEST_F(CaptureUnitTest, VMOCachedBadState) {
+  // If the process disappears while its VMOs are read, it isn't cached.
+  CaptureCache cache(0);
+  Capture c;
+  auto ret = TestUtils::GetCapture(
+      &c, VMO,
+      {.get_processes = {{ZX_OK, {proc_cb}}},
+       .get_property = {proc_prop},
+       .get_info = {self_info,
+                    kmem_info,
+                    stats_info,
+                    {proc_handle, ZX_INFO_PROCESS_VMOS, &_vmo, sizeof(_vmo), 1, ZX_ERR_BAD_STATE}}},
+      &cache);
+  EXPECT_EQ(ZX_OK, ret);
+  EXPECT_EQ(0U, c.koid_to_process().size());
+  EXPECT_EQ(0U, cache.size());
+}
+
 TEST_F(CaptureUnitTest, VMORooted) {
   Capture c;
   TestUtils::CreateCapture(&c,
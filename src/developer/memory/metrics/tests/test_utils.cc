@@ -64,11 +64,7 @@ class MockOS : public OS {
       *actual = num_copied;
     }
     if (avail != nullptr) {
-      if (num_copied < r.value_count) {
-        *avail = r.value_count - num_copied;
-      } else {
-        *avail = 0;
-      }
+      *avail = r.value_count;
     }
     return r.ret;
   }
@@ -123,12 +119,19 @@ std::vector<ProcessSummary> TestUtils::GetProcessSummaries(const Summary& summar
   return summaries;
 }
 
-zx_status_t TestUtils::GetCapture(Capture* capture, CaptureLevel level, const OsResponses& r) {
+zx_status_t TestUtils::GetCapture(Capture* capture, CaptureLevel level, const OsResponses& r,
+                                  CaptureCache* cache) {
   MockOS os(r);
+  return GetCapture(capture, level, &os, cache);
+}
+
+// static.
+zx_status_t TestUtils::GetCapture(Capture* capture, CaptureLevel level, OS* os,
+                                  CaptureCache* cache) {
   CaptureState state;
-  zx_status_t ret = Capture::GetCaptureState(&state, &os);
+  zx_status_t ret = Capture::GetCaptureState(&state, os);
   EXPECT_EQ(ZX_OK, ret);
-  return Capture::GetCapture(capture, state, level, &os, Capture::kDefaultRootedVmoNames);
+  return Capture::GetCapture(capture, state, level, os, Capture::kDefaultRootedVmoNames, cache);
 }
 
 zx_status_t CaptureSupplier::GetCapture(Capture* capture, CaptureLevel level,
@@ -77,7 +77,10 @@ class TestUtils {
   const static zx_koid_t kSelfKoid;
 
   static void CreateCapture(Capture* capture, const CaptureTemplate& t, CaptureLevel level = VMO);
-  static zx_status_t GetCapture(Capture* capture, CaptureLevel level, const OsResponses& r);
+  static zx_status_t GetCapture(Capture* capture, CaptureLevel level, const OsResponses& r,
+                                CaptureCache* cache = nullptr);
+  static zx_status_t GetCapture(Capture* capture, CaptureLevel level, OS* os,
+                                CaptureCache* cache = nullptr);
 
   // Sorted by koid.
   static std::vector<ProcessSummary> GetProcessSummaries(const Summary& summary);
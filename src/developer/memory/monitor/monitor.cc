@@ -138,7 +138,7 @@ Monitor::Monitor(std::unique_ptr<sys::ComponentContext> context,
       component_context_(std::move(context)),
       inspector_(component_context_.get()),
       logger_(
-          dispatcher_, [this](Capture* c) { return GetCapture(c); },
+          dispatcher_, [this](Capture* c) { return GetCachedCapture(c); },
           [this](const Capture& c, Digest* d) { GetDigest(c, d); }),
       level_(Level::kNumLevels) {
   auto bucket_matches = CreateBucketMatchesFromConfigData();
@@ -262,7 +262,7 @@ void Monitor::CreateMetrics(const std::vector<memory::BucketMatch>& bucket_match
 
   metrics_ = std::make_unique<Metrics>(
       bucket_matches, kMetricsPollFrequency, dispatcher_, &inspector_, metric_event_logger_.get(),
-      [this](Capture* c) { return GetCapture(c); },
+      [this](Capture* c) { return GetCachedCapture(c); },
       [this](const Capture& c, Digest* d) { GetDigest(c, d); });
 }
 
@@ -572,6 +572,11 @@ zx_status_t Monitor::GetCapture(memory::Capture* capture) {
   return Capture::GetCapture(capture, capture_state_, VMO);
 }
 
+zx_status_t Monitor::GetCachedCapture(memory::Capture* capture) {
+  std::lock_guard<std::mutex> lock(capture_cache_mutex_);
+  return Capture::GetCapture(capture, capture_state_, VMO, &capture_cache_);
+}
+
 void Monitor::GetDigest(const memory::Capture& capture, memory::Digest* digest) {
   std::lock_guard<std::mutex> lock(digester_mutex_);
   digester_->Digest(capture, digest);
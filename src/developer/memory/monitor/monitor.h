@@ -15,6 +15,7 @@
 #include <zircon/types.h>
 
 #include <memory>
+#include <mutex>
 
 #include "lib/sys/inspect/cpp/component.h"
 #include "src/developer/memory/metrics/capture.h"
@@ -81,10 +82,17 @@ class Monitor : public fuchsia::memory::Monitor {
   void NotifyWatchers(const zx_info_kmem_stats_t& stats);
 
   zx_status_t GetCapture(memory::Capture* capture);
+  // Like GetCapture, but uses |capture_cache_|. Only for the periodic captures of |logger_| and
+  // |metrics_|; on-demand captures read every process.
+  zx_status_t GetCachedCapture(memory::Capture* capture);
   void GetDigest(const memory::Capture& capture, memory::Digest* digest);
   void PressureLevelChanged(Level level);
 
   memory::CaptureState capture_state_;
+  // Lets the periodic VMO captures of |logger_| and |metrics_| skip processes whose memory usage
+  // hasn't changed.
+  memory::CaptureCache capture_cache_;
+  std::mutex capture_cache_mutex_;
   std::unique_ptr<HighWater> high_water_;
   uint64_t prealloc_size_;
   zx::vmo prealloc_vmo_;
@@ -0,0 +1,181 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <zircon/assert.h>
+
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <perftest/perftest.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#include <test/fidlcodec/examples/cpp/fidl.h>
+
+#include "src/lib/fidl_codec/fidl_codec_test.h"
+#include "src/lib/fidl_codec/library_loader.h"
+#include "src/lib/fidl_codec/library_loader_test_data.h"
+#include "src/lib/fidl_codec/wire_object.h"
+#include "src/lib/fidl_codec/wire_parser.h"
+
+namespace fidl_codec {
+namespace {
+
+using test::fidlcodec::examples::FidlCodecTestProtocol;
+
+// Number of elements of the vectors in the big messages.
+constexpr size_t kElementCount = 1000;
+
+LibraryLoader* GetBenchmarkLoader() {
+  static LibraryLoader* loader = [] {
+    auto loader = new LibraryLoader();
+    LibraryReadError err;
+    fidl_codec_test::FidlcodecExamples examples;
+    for (const auto& element : examples.map()) {
+      loader->AddContent(element.second, &err);
+      ZX_ASSERT(err.value == LibraryReadError::kOk);
+    }
+    return loader;
+  }();
+  return loader;
+}
+
+// A request read from a channel. None of the requests used here have handles.
+struct Message {
+  std::vector<uint8_t> bytes;
+  uint64_t ordinal = 0;
+};
+
+Message CaptureRequest(std::function<void(fidl::InterfacePtr<FidlCodecTestProtocol>&)> invoke) {
+  fidl::IncomingMessageBuffer buffer;
+  fidl::HLCPPIncomingMessage message = buffer.CreateEmptyIncomingMessage();
+  InterceptRequest<FidlCodecTestProtocol>(message, std::move(invoke));
+  ZX_ASSERT(message.handles().size() == 0);
+  Message result;
+  result.bytes.assign(message.bytes().data(), message.bytes().data() + message.bytes().size());
+  result.ordinal = message.header().ordinal;
+  return result;
+}
+
+// A vector of small structs: one value per field plus one per element.
+Message VectorStructMessage() {
+  std::vector<test::fidlcodec::examples::SmallStruct> vector(kElementCount);
+  for (size_t i = 0; i < vector.size(); ++i) {
+    vector[i].a = static_cast<uint8_t>(i);
+    vector[i].b = static_cast<uint8_t>(i * 2);
+    vector[i].c = static_cast<uint8_t>(i * 3);
+  }
+  return CaptureRequest([&vector](fidl::InterfacePtr<FidlCodecTestProtocol>& ptr) {
+    ptr->VectorStruct(std::move(vector));
+  });
+}
+
+// Two vectors of strings.
+Message StringVectorsMessage() {
+  std::vector<std::string> v_1;
+  std::vector<std::string> v_2;
+  for (size_t i = 0; i < kElementCount; ++i) {
+    v_1.push_back("string " + std::to_string(i));
+    v_2.push_back("other string " + std::to_string(i));
+  }
+  return CaptureRequest([&v_1, &v_2](fidl::InterfacePtr<FidlCodecTestProtocol>& ptr) {
+    ptr->TwoStringVectors(std::move(v_1), std::move(v_2));
+  });
+}
+
+// A small message with a table, a struct and a union. This is dominated by the per message costs.
+Message TableMessage() {
+  test::fidlcodec::examples::ValueTable table;
+  table.set_first_int16(1);
+  test::fidlcodec::examples::TwoStringStruct two_string_struct;
+  two_string_struct.value1 = "harpo";
+  two_string_struct.value2 = "chico";
+  table.set_second_struct(std::move(two_string_struct));
+  test::fidlcodec::examples::IntStructUnion u;
+  u.set_variant_i(42);
+  table.set_third_union(std::move(u));
+  return CaptureRequest([&table](fidl::InterfacePtr<FidlCodecTestProtocol>& ptr) {
+    ptr->Table(std::move(table), 2);
+  });
+}
+
+enum class Mode {
+  // Decodes the message to a Value tree (what fidlcat does to display a message).
+  kValue,
+  // Decodes the message to a Value tree and then converts the tree to JSON.
+  kValueToJson,
+  // Decodes the message directly to JSON.
+  kStreamingJson,
+};
+
+bool DecodeTest(perftest::RepeatState* state, Message (*create_message)(), Mode mode) {
+  Message message = create_message();
+  const MethodDecodePlan* plan = GetBenchmarkLoader()->GetDecodePlan(message.ordinal);
+  ZX_ASSERT(plan != nullptr);
+  state->SetBytesProcessedPerRun(message.bytes.size());
+  while (state->KeepRunning()) {
+    std::stringstream error_stream;
+    switch (mode) {
+      case Mode::kValue: {
+        std::unique_ptr<PayloadableValue> decoded_request;
+        ZX_ASSERT(DecodeRequest(*plan, message.bytes.data(), message.bytes.size(), nullptr, 0,
+                                &decoded_request, error_stream));
+        break;
+      }
+      case Mode::kValueToJson: {
+        std::unique_ptr<PayloadableValue> decoded_request;
+        ZX_ASSERT(DecodeRequest(*plan, message.bytes.data(), message.bytes.size(), nullptr, 0,
+                                &decoded_request, error_stream));
+        rapidjson::Document document;
+        decoded_request->ExtractJson(document.GetAllocator(), document);
+        rapidjson::StringBuffer output;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(output);
+        document.Accept(writer);
+        break;
+      }
+      case Mode::kStreamingJson: {
+        rapidjson::StringBuffer output;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(output);
+        ZX_ASSERT(DecodeRequestToJson(*plan, message.bytes.data(), message.bytes.size(), nullptr,
+                                      0, &writer, error_stream));
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+void RegisterTests() {
+  struct {
+    const char* name;
+    Message (*create_message)();
+  } messages[] = {
+      {"VectorStruct", VectorStructMessage},
+      {"StringVectors", StringVectorsMessage},
+      {"Table", TableMessage},
+  };
+  struct {
+    const char* name;
+    Mode mode;
+  } modes[] = {
+      {"Value", Mode::kValue},
+      {"ValueToJson", Mode::kValueToJson},
+      {"StreamingJson", Mode::kStreamingJson},
+  };
+  for (const auto& message : messages) {
+    for (const auto& mode : modes) {
+      std::string name = std::string("FidlCodec/Decode/") + message.name + "/" + mode.name;
+      perftest::RegisterTest(name.c_str(), DecodeTest, message.create_message, mode.mode);
+    }
+  }
+}
+PERFTEST_CTOR(RegisterTests)
+
+}  // namespace
+}  // namespace fidl_codec
+
+int main(int argc, char** argv) {
+  return perftest::PerfTestMain(argc, argv, "fuchsia.fidl_codec");
+}
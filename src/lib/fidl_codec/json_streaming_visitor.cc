@@ -0,0 +1,223 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/lib/fidl_codec/json_streaming_visitor.h"
+
+#include <lib/fidl/txn_header.h>
+
+#include <optional>
+#include <sstream>
+
+#include "src/lib/fidl_codec/library_loader.h"
+#include "src/lib/fidl_codec/printer.h"
+#include "src/lib/fidl_codec/visitor.h"
+#include "src/lib/fidl_codec/wire_object.h"
+
+namespace fidl_codec {
+
+namespace {
+
+// Writes a scalar value the same way JsonVisitor does.
+class JsonScalarWriter : public Visitor {
+ public:
+  explicit JsonScalarWriter(rapidjson::Writer<rapidjson::StringBuffer>* writer)
+      : writer_(writer) {}
+
+ private:
+  void VisitValue(const Value* node, const Type* for_type) override {
+    std::stringstream ss;
+    PrettyPrinter printer(ss, WithoutColors, false, "", 0, /*header_on_every_line=*/false);
+    node->PrettyPrint(for_type, printer);
+    std::string result = ss.str();
+    writer_->String(result.data(), static_cast<rapidjson::SizeType>(result.size()));
+  }
+
+  void VisitInvalidValue(const InvalidValue* node, const Type* for_type) override {
+    writer_->String("(invalid)");
+  }
+
+  void VisitNullValue(const NullValue* node, const Type* for_type) override { writer_->Null(); }
+
+  void VisitStringValue(const StringValue* node, const Type* for_type) override {
+    writer_->String(node->string().data(), static_cast<rapidjson::SizeType>(node->string().size()));
+  }
+
+  rapidjson::Writer<rapidjson::StringBuffer>* writer_;
+};
+
+}  // namespace
+
+void JsonStreamingVisitor::VisitType(const Type* type) {
+  std::unique_ptr<Value> value = type->Decode(decoder_, offset_);
+  if (value == nullptr) {
+    writer_->Null();
+    return;
+  }
+  JsonScalarWriter scalar_writer(writer_);
+  value->Visit(&scalar_writer, type);
+}
+
+void JsonStreamingVisitor::VisitUnionType(const UnionType* type) {
+  // Same checks as UnionType::Decode.
+  uint64_t offset = offset_;
+  Ordinal64 ordinal = 0;
+  if (decoder_->GetValueAt(offset, &ordinal)) {
+    if ((ordinal == 0) && !type->Nullable()) {
+      decoder_->AddError() << std::hex << (decoder_->absolute_offset() + offset) << std::dec
+                           << ": Null envelope for a non nullable extensible union\n";
+      WriteInvalid();
+      return;
+    }
+  }
+
+  offset += sizeof(ordinal);
+
+  if (ordinal == 0) {
+    if (!decoder_->CheckNullEnvelope(offset)) {
+      WriteInvalid();
+      return;
+    }
+    writer_->Null();
+    return;
+  }
+
+  const UnionMember* member = type->union_definition().MemberFromOrdinal(ordinal);
+  if (member == nullptr) {
+    WriteInvalid();
+    return;
+  }
+  writer_->StartObject();
+  WriteEnvelope(offset, member->type(), member->name().c_str(), /*skip_null=*/false);
+  writer_->EndObject();
+}
+
+void JsonStreamingVisitor::VisitStructType(const StructType* type) {
+  // Same checks as StructType::Decode.
+  uint64_t offset = offset_;
+  const Struct& struct_definition = type->struct_definition();
+  if (type->Nullable()) {
+    bool is_null;
+    uint64_t nullable_offset;
+    if (!decoder_->DecodeNullableHeader(offset, struct_definition.Size(decoder_->version()),
+                                        &is_null, &nullable_offset)) {
+      WriteInvalid();
+      return;
+    }
+    if (is_null) {
+      writer_->Null();
+      return;
+    }
+    offset = nullable_offset;
+  }
+
+  writer_->StartObject();
+  for (const auto& member : struct_definition.members()) {
+    writer_->Key(member->name().c_str());
+    WriteValue(member->type(), offset + member->Offset(decoder_->version()));
+  }
+  writer_->EndObject();
+}
+
+void JsonStreamingVisitor::VisitArrayType(const ArrayType* type) {
+  // Same as ArrayType::Decode.
+  uint64_t offset = offset_;
+  const Type* component_type = type->component_type();
+  size_t component_size = component_type->InlineSize(decoder_->version());
+  writer_->StartArray();
+  for (uint64_t i = 0; i < type->count(); ++i) {
+    WriteValue(component_type, offset);
+    offset += component_size;
+  }
+  writer_->EndArray();
+}
+
+void JsonStreamingVisitor::VisitVectorType(const VectorType* type) {
+  // Same checks as VectorType::Decode.
+  uint64_t offset = offset_;
+  const Type* component_type = type->component_type();
+  size_t component_size = component_type->InlineSize(decoder_->version());
+  uint64_t element_count = 0;
+  decoder_->GetValueAt(offset, &element_count);
+  offset += sizeof(element_count);
+  bool is_null;
+  uint64_t nullable_offset;
+  if (!decoder_->DecodeNullableHeader(offset, element_count * component_size, &is_null,
+                                      &nullable_offset)) {
+    WriteInvalid();
+    return;
+  }
+  if (is_null) {
+    writer_->Null();
+    return;
+  }
+
+  writer_->StartArray();
+  for (uint64_t i = 0;
+       (i < element_count) && (nullable_offset + component_size <= decoder_->num_bytes()); ++i) {
+    WriteValue(component_type, nullable_offset);
+    nullable_offset += component_size;
+  }
+  writer_->EndArray();
+}
+
+void JsonStreamingVisitor::VisitTableType(const TableType* type) {
+  // Same checks as TableType::Decode.
+  uint64_t offset = offset_;
+  uint64_t member_count = 0;
+  decoder_->GetValueAt(offset, &member_count);
+  offset += sizeof(member_count);
+
+  bool is_null;
+  uint64_t nullable_offset;
+  size_t kEnvelopeSize = sizeof(uint32_t) + 2 * sizeof(uint16_t);
+  if (!decoder_->DecodeNullableHeader(offset, member_count * kEnvelopeSize, &is_null,
+                                      &nullable_offset)) {
+    WriteInvalid();
+    return;
+  }
+  if (is_null) {
+    decoder_->AddError() << "Tables are not nullable.";
+    WriteInvalid();
+    return;
+  }
+  writer_->StartObject();
+  for (uint64_t i = 1; i <= member_count; ++i) {
+    const TableMember* member = type->table_definition().MemberFromOrdinal(i);
+    if ((member == nullptr) || member->reserved()) {
+      decoder_->SkipEnvelope(nullable_offset);
+    } else {
+      // Absent members are not written.
+      WriteEnvelope(nullable_offset, member->type(), member->name().c_str(), /*skip_null=*/true);
+    }
+    nullable_offset += kEnvelopeSize;
+  }
+  writer_->EndObject();
+}
+
+void JsonStreamingVisitor::WriteEnvelope(uint64_t offset, const Type* type, const char* key,
+                                         bool skip_null) {
+  bool is_null;
+  bool is_inline;
+  std::optional<MessageDecoder> envelope_decoder;
+  if (!decoder_->DecodeEnvelopeHeader(offset, &is_null, &is_inline, &envelope_decoder)) {
+    writer_->Key(key);
+    WriteInvalid();
+    return;
+  }
+  if (is_null) {
+    if (!skip_null) {
+      writer_->Key(key);
+      writer_->Null();
+    }
+    return;
+  }
+  writer_->Key(key);
+  // Same as MessageDecoder::DecodeValue.
+  envelope_decoder->BeginEnvelopeValue(type, is_inline);
+  JsonStreamingVisitor visitor(&envelope_decoder.value(), 0, writer_);
+  type->Visit(&visitor);
+  envelope_decoder->EndEnvelopeValue(is_inline);
+}
+
+}  // namespace fidl_codec
@@ -0,0 +1,56 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SRC_LIB_FIDL_CODEC_JSON_STREAMING_VISITOR_H_
+#define SRC_LIB_FIDL_CODEC_JSON_STREAMING_VISITOR_H_
+
+#include <cstdint>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include "src/lib/fidl_codec/message_decoder.h"
+#include "src/lib/fidl_codec/type_visitor.h"
+#include "src/lib/fidl_codec/wire_types.h"
+
+namespace fidl_codec {
+
+// Decodes the value of the visited type at |offset| in the buffer of |decoder| and writes it as
+// JSON to |writer|. This produces the same output as JsonVisitor on the decoded Value but only
+// scalars are decoded to a Value (which is destroyed as soon as it has been written). The
+// aggregates (structs, tables, unions, arrays and vectors) are streamed directly from the wire.
+class JsonStreamingVisitor : public TypeVisitor {
+ public:
+  JsonStreamingVisitor(MessageDecoder* decoder, uint64_t offset,
+                       rapidjson::Writer<rapidjson::StringBuffer>* writer)
+      : decoder_(decoder), offset_(offset), writer_(writer) {}
+
+ private:
+  void VisitType(const Type* type) override;
+  void VisitUnionType(const UnionType* type) override;
+  void VisitStructType(const StructType* type) override;
+  void VisitArrayType(const ArrayType* type) override;
+  void VisitVectorType(const VectorType* type) override;
+  void VisitTableType(const TableType* type) override;
+
+  // Writes the value of |type| at |offset|.
+  void WriteValue(const Type* type, uint64_t offset) {
+    JsonStreamingVisitor visitor(decoder_, offset, writer_);
+    type->Visit(&visitor);
+  }
+
+  // Writes |key| and the value of |type| stored in the envelope at |offset|. If the envelope is
+  // empty and |skip_null| is set, nothing is written (that's the case for absent table members).
+  void WriteEnvelope(uint64_t offset, const Type* type, const char* key, bool skip_null);
+
+  void WriteInvalid() { writer_->String("(invalid)"); }
+
+  MessageDecoder* const decoder_;
+  const uint64_t offset_;
+  rapidjson::Writer<rapidjson::StringBuffer>* const writer_;
+};
+
+}  // namespace fidl_codec
+
+#endif  // SRC_LIB_FIDL_CODEC_JSON_STREAMING_VISITOR_H_
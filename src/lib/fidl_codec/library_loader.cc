@@ -876,6 +876,8 @@ void LibraryLoader::AddContent(const std::string& content, LibraryReadError* err
 }
 
 void LibraryLoader::AddMethod(const ProtocolMethod* method) {
+  // The method which decodes the messages may change.
+  decode_plans_.erase(method->ordinal());
   if (ordinal_map_[method->ordinal()] == nullptr) {
     ordinal_map_[method->ordinal()] = std::make_unique<std::vector<const ProtocolMethod*>>();
   }
@@ -888,6 +890,23 @@ void LibraryLoader::AddMethod(const ProtocolMethod* method) {
   }
 }
 
+const MethodDecodePlan* LibraryLoader::GetDecodePlan(Ordinal64 ordinal) {
+  auto cached = decode_plans_.find(ordinal);
+  if (cached != decode_plans_.end()) {
+    return &cached->second;
+  }
+  const std::vector<const ProtocolMethod*>* methods = GetByOrdinal(ordinal);
+  if ((methods == nullptr) || methods->empty()) {
+    return nullptr;
+  }
+  MethodDecodePlan& plan = decode_plans_[ordinal];
+  plan.method = (*methods)[0];
+  // request() and response() decode the types of the payloads.
+  plan.request = plan.method->request();
+  plan.response = plan.method->response();
+  return &plan;
+}
+
 void LibraryLoader::ParseBuiltinSemantic() {
   semantic::ParserErrors parser_errors;
   {
@@ -8,6 +8,7 @@
 #include <iostream>
 #include <map>
 #include <optional>
+#include <unordered_map>
 #include <vector>
 
 #include <rapidjson/document.h>
@@ -584,6 +585,18 @@ class Library {
   std::map<std::string, std::unique_ptr<Table>> tables_;
 };
 
+// Everything needed to decode the messages of an ordinal. This is computed once by the
+// LibraryLoader so that decoding a message doesn't need to search the method and check that its
+// types are decoded each time.
+struct MethodDecodePlan {
+  // The method used to decode the messages (the first one returned by GetByOrdinal).
+  const ProtocolMethod* method = nullptr;
+  // The formats of the request and the response, with their types already decoded. They are null
+  // if the method has no request (or response) or if it has one with an empty payload.
+  const Payload* request = nullptr;
+  const Payload* response = nullptr;
+};
+
 // An indexed collection of libraries.
 // WARNING: All references on Enum, Struct, Table, ... and all references on
 //          types and fields must be destroyed before this class (LibraryLoader
@@ -632,6 +645,11 @@ class LibraryLoader {
     return nullptr;
   }
 
+  // Returns the decode plan for the messages with this ordinal or |nullptr| if no method has this
+  // ordinal. The plan is computed on the first call and then cached. The returned pointer is owned
+  // by the LibraryLoader and is valid until a method with the same ordinal is added or removed.
+  const MethodDecodePlan* GetDecodePlan(Ordinal64 ordinal);
+
   // If the library with name |name| is present in this loader, returns the
   // library. Otherwise, returns null.
   // |name| is of the format "a.b.c"
@@ -652,6 +670,7 @@ class LibraryLoader {
     for (const auto& iface : library->protocols()) {
       for (const auto& method : iface->methods()) {
         ordinal_map_.erase(method->ordinal());
+        decode_plans_.erase(method->ordinal());
       }
     }
   }
@@ -659,6 +678,8 @@ class LibraryLoader {
   // Because Delete() above is run whenever a Library is destructed, we want ordinal_map_ to be
   // intact when a Library is destructed.  Therefore, ordinal_map_ has to come first.
   std::map<Ordinal64, std::unique_ptr<std::vector<const ProtocolMethod*>>> ordinal_map_;
+  // Cache of the decode plans indexed by ordinal. This is looked up for every decoded message.
+  std::unordered_map<Ordinal64, MethodDecodePlan> decode_plans_;
   std::map<std::string, std::unique_ptr<Library>> representations_;
 };
 
@@ -88,6 +88,37 @@ TEST(LibraryLoader, LoadSimpleOneAtATime) {
   ASSERT_NE(found_method, nullptr) << "Could not find method " << kDesiredFullMethodName;
 }
 
+// Checks that the decode plans are computed once and then taken from the cache.
+TEST(LibraryLoader, DecodePlan) {
+  fidl_codec_test::FidlcodecExamples examples;
+  LibraryLoader loader;
+  LibraryReadError err;
+  for (const auto& element : examples.map()) {
+    loader.AddContent(element.second, &err);
+    ASSERT_EQ(LibraryReadError::kOk, err.value);
+  }
+
+  Library* library_ptr = loader.GetLibraryFromName("fidl.test.frobinator");
+  ASSERT_NE(library_ptr, nullptr);
+  Protocol* found_protocol = nullptr;
+  ASSERT_TRUE(library_ptr->GetProtocolByName("fidl.test.frobinator/Frobinator", &found_protocol));
+  const ProtocolMethod* found_method = nullptr;
+  found_protocol->GetMethodByFullName("fidl.test.frobinator/Frobinator.Grob", &found_method);
+  ASSERT_NE(found_method, nullptr);
+
+  const MethodDecodePlan* plan = loader.GetDecodePlan(found_method->ordinal());
+  ASSERT_NE(plan, nullptr);
+  EXPECT_EQ(plan->method, loader.GetByOrdinal(found_method->ordinal())->at(0));
+  ASSERT_NE(plan->request, nullptr);
+  ASSERT_NE(plan->response, nullptr);
+  // The types are decoded when the plan is built.
+  EXPECT_NE(plan->request->type(), nullptr);
+  EXPECT_NE(plan->response->type(), nullptr);
+
+  EXPECT_EQ(plan, loader.GetDecodePlan(found_method->ordinal()));
+  EXPECT_EQ(loader.GetDecodePlan(0), nullptr);
+}
+
 // Ensure that, if you load two libraries with the same name, the first one loaded wins.
 // LoadAll calls AddContent using the last item in the list. That means that, for LoadAll, the
 // last one wins.
@@ -12,6 +12,7 @@
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
+#include "src/lib/fidl_codec/json_streaming_visitor.h"
 #include "src/lib/fidl_codec/library_loader.h"
 #include "src/lib/fidl_codec/status.h"
 #include "src/lib/fidl_codec/wire_object.h"
@@ -60,18 +61,18 @@ bool DecodedMessage::DecodeMessage(MessageDecoderDispatcher* dispatcher, uint64_
     return false;
   }
 
-  const std::vector<const ProtocolMethod*>* methods = dispatcher->loader()->GetByOrdinal(ordinal_);
-  if (methods == nullptr || methods->empty()) {
+  const MethodDecodePlan* plan = dispatcher->loader()->GetDecodePlan(ordinal_);
+  if (plan == nullptr) {
     error_stream << "Protocol method with ordinal 0x" << std::hex << header_->ordinal
                  << " not found\n";
     return false;
   }
 
-  method_ = (*methods)[0];
+  method_ = plan->method;
 
-  matched_request_ = DecodeRequest(method_, bytes, num_bytes, handles, num_handles,
+  matched_request_ = DecodeRequest(*plan, bytes, num_bytes, handles, num_handles,
                                    &decoded_request_, request_error_stream_);
-  matched_response_ = DecodeResponse(method_, bytes, num_bytes, handles, num_handles,
+  matched_response_ = DecodeResponse(*plan, bytes, num_bytes, handles, num_handles,
                                      &decoded_response_, response_error_stream_);
 
   direction_ = dispatcher->ComputeDirection(process_koid, handle, type, method_,
@@ -195,7 +196,28 @@ std::unique_ptr<PayloadableValue> MessageDecoder::DecodeMessage(const Payload* m
 
   // Decode the message payload (ie, everything past the header).
   std::unique_ptr<PayloadableValue> message = message_format->Decode(*this);
+  CheckMessageDecoded();
+  return message;
+}
 
+void MessageDecoder::DecodeMessageToJson(const Payload* message_format,
+                                         rapidjson::Writer<rapidjson::StringBuffer>* writer) {
+  SkipObject(kTransactionHeaderSize);
+  if (message_format == nullptr) {
+    writer->StartObject();
+    writer->EndObject();
+    return;
+  }
+
+  // Same as Payloadable::DecodeAsPayload.
+  const Type* payload_type = message_format->type().get();
+  SkipObject(payload_type->InlineSize(version_));
+  JsonStreamingVisitor visitor(this, kTransactionHeaderSize, writer);
+  payload_type->Visit(&visitor);
+  CheckMessageDecoded();
+}
+
+void MessageDecoder::CheckMessageDecoded() {
   // It's an error if we didn't use all the bytes in the buffer.
   if (next_object_offset_ != num_bytes_) {
     AddError() << "Message not fully decoded (decoded=" << next_object_offset_
@@ -206,19 +228,27 @@ std::unique_ptr<PayloadableValue> MessageDecoder::DecodeMessage(const Payload* m
   if (GetRemainingHandles() != 0) {
     AddError() << "Message not fully decoded (remain " << GetRemainingHandles() << " handles)\n";
   }
-  return message;
 }
 
 std::unique_ptr<Value> MessageDecoder::DecodeValue(const Type* type, bool is_inline) {
   if (type == nullptr) {
     return nullptr;
   }
+  BeginEnvelopeValue(type, is_inline);
+  // Decode the envelope.
+  std::unique_ptr<Value> result = type->Decode(this, 0);
+  EndEnvelopeValue(is_inline);
+  return result;
+}
+
+void MessageDecoder::BeginEnvelopeValue(const Type* type, bool is_inline) {
   if (!is_inline) {
     // Set the offset for the next object (just after this one).
     SkipObject(type->InlineSize(version_));
   }
-  // Decode the envelope.
-  std::unique_ptr<Value> result = type->Decode(this, 0);
+}
+
+void MessageDecoder::EndEnvelopeValue(bool is_inline) {
   if (!is_inline) {
     // It's an error if we didn't use all the bytes in the buffer.
     if (next_object_offset_ != num_bytes_) {
@@ -231,7 +261,6 @@ std::unique_ptr<Value> MessageDecoder::DecodeValue(const Type* type, bool is_inl
     AddError() << "Message envelope not fully decoded (remain " << GetRemainingHandles()
                << " handles)\n";
   }
-  return result;
 }
 
 bool MessageDecoder::DecodeNullableHeader(uint64_t offset, uint64_t size, bool* is_null,
@@ -260,11 +289,23 @@ bool MessageDecoder::DecodeNullableHeader(uint64_t offset, uint64_t size, bool*
 
 std::unique_ptr<Value> MessageDecoder::DecodeEnvelope(uint64_t offset, const Type* type) {
   FX_DCHECK(type != nullptr);
+  bool is_null;
+  bool is_inline;
+  std::optional<MessageDecoder> envelope_decoder;
+  if (!DecodeEnvelopeHeader(offset, &is_null, &is_inline, &envelope_decoder)) {
+    return std::make_unique<InvalidValue>();
+  }
+  if (is_null) {
+    return std::make_unique<NullValue>();
+  }
+  return envelope_decoder->DecodeValue(type, is_inline);
+}
+
+bool MessageDecoder::DecodeEnvelopeHeader(uint64_t offset, bool* is_null, bool* is_inline,
+                                          std::optional<MessageDecoder>* envelope_decoder) {
   uint32_t envelope_bytes;
   uint32_t envelope_handles;
-  bool is_null;
   uint64_t nullable_offset;
-  bool is_inline = false;
   uint64_t inline_offset = offset;
   GetValueAt(offset, &envelope_bytes);
   offset += sizeof(envelope_bytes);
@@ -275,30 +316,30 @@ std::unique_ptr<Value> MessageDecoder::DecodeEnvelope(uint64_t offset, const Typ
   GetValueAt(offset, &flags);
   offset += sizeof(flags);
 
-  is_inline = (flags & 1) != 0;
+  *is_inline = (flags & 1) != 0;
 
   envelope_handles = envelope_handles_16;
-  is_null = !is_inline && (envelope_bytes == 0) && (envelope_handles == 0);
-  if (is_null) {
-    return std::make_unique<NullValue>();
+  *is_null = !*is_inline && (envelope_bytes == 0) && (envelope_handles == 0);
+  if (*is_null) {
+    return true;
   }
-  nullable_offset = is_inline ? inline_offset : next_object_offset();
-  envelope_bytes = is_inline ? sizeof(uint32_t) : envelope_bytes;
-  if ((envelope_bytes > 0) && !is_inline) {
+  nullable_offset = *is_inline ? inline_offset : next_object_offset();
+  envelope_bytes = *is_inline ? sizeof(uint32_t) : envelope_bytes;
+  if ((envelope_bytes > 0) && !*is_inline) {
     SkipObject(envelope_bytes);
   }
-  if (!is_inline && (envelope_bytes > num_bytes() - nullable_offset)) {
+  if (!*is_inline && (envelope_bytes > num_bytes() - nullable_offset)) {
     AddError() << std::hex << (absolute_offset() + nullable_offset) << std::dec
                << ": Not enough data to decode an envelope\n";
-    return std::make_unique<InvalidValue>();
+    return false;
   }
   if (envelope_handles > GetRemainingHandles()) {
     AddError() << std::hex << (absolute_offset() + nullable_offset) << std::dec
                << ": Not enough handles to decode an envelope\n";
-    return std::make_unique<InvalidValue>();
+    return false;
   }
-  MessageDecoder envelope_decoder(this, nullable_offset, envelope_bytes, envelope_handles);
-  return envelope_decoder.DecodeValue(type, is_inline);
+  envelope_decoder->emplace(this, nullable_offset, envelope_bytes, envelope_handles);
+  return true;
 }
 
 bool MessageDecoder::CheckNullEnvelope(uint64_t offset) {
@@ -10,12 +10,16 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <ostream>
 #include <sstream>
 #include <string_view>
 #include <unordered_set>
 #include <vector>
 
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
 #include "src/lib/fidl_codec/display_options.h"
 #include "src/lib/fidl_codec/library_loader.h"
 #include "src/lib/fidl_codec/memory_helpers.h"
@@ -198,9 +202,19 @@ class MessageDecoder {
   // Decodes a whole message (request or response) and return a Value.
   std::unique_ptr<PayloadableValue> DecodeMessage(const Payload* message_format);
 
+  // Decodes a whole message (request or response) and writes it as JSON to |writer|. The result is
+  // the same as calling ExtractJson on the result of DecodeMessage but no Value is kept alive
+  // longer than needed to format a scalar.
+  void DecodeMessageToJson(const Payload* message_format,
+                           rapidjson::Writer<rapidjson::StringBuffer>* writer);
+
   // Decodes a field. Used by envelopes.
   std::unique_ptr<Value> DecodeValue(const Type* type, bool is_inline);
 
+  // Must be called by an envelope decoder before and after the decoding of its value.
+  void BeginEnvelopeValue(const Type* type, bool is_inline);
+  void EndEnvelopeValue(bool is_inline);
+
   // Decodes the header for a value which can be null.
   bool DecodeNullableHeader(uint64_t offset, uint64_t size, bool* is_null,
                             uint64_t* nullable_offset);
@@ -208,6 +222,12 @@ class MessageDecoder {
   // Decodes a value in an envelope.
   std::unique_ptr<Value> DecodeEnvelope(uint64_t offset, const Type* type);
 
+  // Decodes the header of the envelope at |offset|. Returns false if the envelope is invalid.
+  // Otherwise, |is_null| is set if the envelope is empty. If it's not empty, |is_inline| tells if
+  // the value is stored inline and |envelope_decoder| is set to a decoder for the envelope content.
+  bool DecodeEnvelopeHeader(uint64_t offset, bool* is_null, bool* is_inline,
+                            std::optional<MessageDecoder>* envelope_decoder);
+
   // Checks that we have a null envelope encoded.
   bool CheckNullEnvelope(uint64_t offset);
 
@@ -215,6 +235,9 @@ class MessageDecoder {
   void SkipEnvelope(uint64_t offset);
 
  private:
+  // Checks that the whole message has been consumed once its payload has been decoded.
+  void CheckMessageDecoded();
+
   // The absolute offset in the main buffer.
   const uint64_t absolute_offset_ = 0;
 
@@ -6,6 +6,7 @@
 
 #include <lib/syslog/cpp/macros.h>
 
+#include <cstddef>
 #include <iomanip>
 #include <iostream>
 #include <memory>
@@ -25,6 +26,96 @@
 
 namespace fidl_codec {
 
+namespace {
+
+// Recycled values are grouped by size in steps of kValueSizeStep bytes.
+constexpr size_t kValueSizeStep = alignof(std::max_align_t);
+constexpr size_t kMaxRecycledValueSize = 256;
+constexpr size_t kValueSizeClasses = kMaxRecycledValueSize / kValueSizeStep;
+
+// Maximum number of free values kept for each size. This bounds the memory kept after the
+// decoding of an exceptionally big message.
+constexpr size_t kMaxFreeValues = 4096;
+
+// The values freed by a thread, available for the next allocations of that thread.
+class ValueFreeLists {
+ public:
+  ~ValueFreeLists();
+
+  // Returns a free block for |size_class| or null if there is none.
+  void* Allocate(size_t size_class) {
+    FreeValue* head = heads_[size_class];
+    if (head == nullptr) {
+      return nullptr;
+    }
+    heads_[size_class] = head->next;
+    --counts_[size_class];
+    return head;
+  }
+
+  // Keeps the block for a future allocation. Returns false if there are already enough free
+  // blocks of this size.
+  bool Release(void* ptr, size_t size_class) {
+    if (counts_[size_class] >= kMaxFreeValues) {
+      return false;
+    }
+    auto value = static_cast<FreeValue*>(ptr);
+    value->next = heads_[size_class];
+    heads_[size_class] = value;
+    ++counts_[size_class];
+    return true;
+  }
+
+ private:
+  struct FreeValue {
+    FreeValue* next;
+  };
+
+  FreeValue* heads_[kValueSizeClasses] = {};
+  size_t counts_[kValueSizeClasses] = {};
+};
+
+thread_local ValueFreeLists value_free_lists;
+
+// Values can still be destroyed after the free lists of their thread (for example by static
+// destructors). In that case, they go straight back to the heap.
+thread_local bool value_free_lists_destroyed = false;
+
+ValueFreeLists::~ValueFreeLists() {
+  value_free_lists_destroyed = true;
+  for (FreeValue*& head : heads_) {
+    while (head != nullptr) {
+      FreeValue* next = head->next;
+      ::operator delete(head);
+      head = next;
+    }
+  }
+}
+
+}  // namespace
+
+void* Value::operator new(size_t size) {
+  if ((size == 0) || (size > kMaxRecycledValueSize)) {
+    return ::operator new(size);
+  }
+  size_t size_class = (size - 1) / kValueSizeStep;
+  if (!value_free_lists_destroyed) {
+    void* result = value_free_lists.Allocate(size_class);
+    if (result != nullptr) {
+      return result;
+    }
+  }
+  return ::operator new((size_class + 1) * kValueSizeStep);
+}
+
+void Value::operator delete(void* ptr, size_t size) {
+  if ((ptr != nullptr) && (size != 0) && (size <= kMaxRecycledValueSize) &&
+      !value_free_lists_destroyed && value_free_lists.Release(ptr, (size - 1) / kValueSizeStep)) {
+    return;
+  }
+  ::operator delete(ptr);
+}
+
 std::string DocumentToString(rapidjson::Document* document) {
   rapidjson::StringBuffer output;
   rapidjson::Writer<rapidjson::StringBuffer> writer(output);
@@ -34,6 +34,12 @@ class Value {
   Value() = default;
   virtual ~Value() = default;
 
+  // Values are created and destroyed in large numbers while decoding messages. Their memory is
+  // recycled by size instead of going back to the heap each time so that the tree of a message
+  // reuses the memory of the tree of a previous message.
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr, size_t size);
+
   virtual bool IsNull() const { return false; }
 
   // Returns the uint8_t value of the value. If the value is not a uint8_t value this returns zero.
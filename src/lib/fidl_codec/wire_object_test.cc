@@ -95,4 +95,21 @@ TEST_PRINT_OBJECT(TableValue, TableValueWithNullFields(loader()),
 
 TEST_PRINT_OBJECT(InvalidValue, InvalidValue(), "#red#invalid#rst#", "\"(invalid)\"")
 
+TEST_F(WireObjectTest, RecycledValues) {
+  // The memory of a destroyed value is used for the next value of the same size.
+  auto value = std::make_unique<IntegerValue>(1, false);
+  const void* address = value.get();
+  value.reset();
+  auto new_value = std::make_unique<IntegerValue>(2, false);
+  EXPECT_EQ(address, new_value.get());
+
+  // Values are destroyed through a base class pointer.
+  std::unique_ptr<Value> string_value = std::make_unique<StringValue>("recycled");
+  address = string_value.get();
+  string_value.reset();
+  auto new_string_value = std::make_unique<StringValue>("again");
+  EXPECT_EQ(address, new_string_value.get());
+  EXPECT_EQ("again", new_string_value->string());
+}
+
 }  // namespace fidl_codec
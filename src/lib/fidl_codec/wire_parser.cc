@@ -23,6 +23,15 @@ bool DecodeMessage(const Payload* str, const uint8_t* bytes, size_t num_bytes,
   return !decoder.HasError();
 }
 
+bool DecodeMessageToJson(const Payload* str, const uint8_t* bytes, size_t num_bytes,
+                         const zx_handle_disposition_t* handles, size_t num_handles,
+                         rapidjson::Writer<rapidjson::StringBuffer>* writer,
+                         std::ostream& error_stream) {
+  MessageDecoder decoder(bytes, num_bytes, handles, num_handles, error_stream);
+  decoder.DecodeMessageToJson(str, writer);
+  return !decoder.HasError();
+}
+
 }  // anonymous namespace
 
 bool DecodeRequest(const ProtocolMethod* method, const uint8_t* bytes, size_t num_bytes,
@@ -45,4 +54,46 @@ bool DecodeResponse(const ProtocolMethod* method, const uint8_t* bytes, size_t n
                        error_stream);
 }
 
+bool DecodeRequest(const MethodDecodePlan& plan, const uint8_t* bytes, size_t num_bytes,
+                   const zx_handle_disposition_t* handles, size_t num_handles,
+                   std::unique_ptr<PayloadableValue>* decoded_object, std::ostream& error_stream) {
+  if (!plan.method->has_request()) {
+    return false;
+  }
+  return DecodeMessage(plan.request, bytes, num_bytes, handles, num_handles, decoded_object,
+                       error_stream);
+}
+
+bool DecodeResponse(const MethodDecodePlan& plan, const uint8_t* bytes, size_t num_bytes,
+                    const zx_handle_disposition_t* handles, size_t num_handles,
+                    std::unique_ptr<PayloadableValue>* decoded_object, std::ostream& error_stream) {
+  if (!plan.method->has_response()) {
+    return false;
+  }
+  return DecodeMessage(plan.response, bytes, num_bytes, handles, num_handles, decoded_object,
+                       error_stream);
+}
+
+bool DecodeRequestToJson(const MethodDecodePlan& plan, const uint8_t* bytes, size_t num_bytes,
+                         const zx_handle_disposition_t* handles, size_t num_handles,
+                         rapidjson::Writer<rapidjson::StringBuffer>* writer,
+                         std::ostream& error_stream) {
+  if (!plan.method->has_request()) {
+    return false;
+  }
+  return DecodeMessageToJson(plan.request, bytes, num_bytes, handles, num_handles, writer,
+                             error_stream);
+}
+
+bool DecodeResponseToJson(const MethodDecodePlan& plan, const uint8_t* bytes, size_t num_bytes,
+                          const zx_handle_disposition_t* handles, size_t num_handles,
+                          rapidjson::Writer<rapidjson::StringBuffer>* writer,
+                          std::ostream& error_stream) {
+  if (!plan.method->has_response()) {
+    return false;
+  }
+  return DecodeMessageToJson(plan.response, bytes, num_bytes, handles, num_handles, writer,
+                             error_stream);
+}
+
 }  // namespace fidl_codec
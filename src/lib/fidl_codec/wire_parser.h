@@ -7,6 +7,9 @@
 
 #include <cstdint>
 
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
 #include "src/lib/fidl_codec/library_loader.h"
 #include "src/lib/fidl_codec/wire_types.h"
 
@@ -38,6 +41,30 @@ bool DecodeResponse(const ProtocolMethod* method, const uint8_t* bytes, size_t n
                     const zx_handle_disposition_t* handles, size_t num_handles,
                     std::unique_ptr<PayloadableValue>* decoded_object, std::ostream& error_stream);
 
+// Same as above but uses the decode plan of the method (see LibraryLoader::GetDecodePlan).
+bool DecodeRequest(const MethodDecodePlan& plan, const uint8_t* bytes, size_t num_bytes,
+                   const zx_handle_disposition_t* handles, size_t num_handles,
+                   std::unique_ptr<PayloadableValue>* decoded_object, std::ostream& error_stream);
+bool DecodeResponse(const MethodDecodePlan& plan, const uint8_t* bytes, size_t num_bytes,
+                    const zx_handle_disposition_t* handles, size_t num_handles,
+                    std::unique_ptr<PayloadableValue>* decoded_object, std::ostream& error_stream);
+
+// Given a wire-formatted |message| and the decode plan of its method, writes the request (or the
+// response) as JSON to |writer|. The JSON is the same as the one given by ExtractJson on the value
+// decoded by DecodeRequest (or DecodeResponse) but the Value tree is never built. This is what
+// should be used when the JSON is the only output needed.
+//
+// Returns false if it cannot decode the message. In that case, |error_stream| contains the errors
+// and |writer| may contain a partial object.
+bool DecodeRequestToJson(const MethodDecodePlan& plan, const uint8_t* bytes, size_t num_bytes,
+                         const zx_handle_disposition_t* handles, size_t num_handles,
+                         rapidjson::Writer<rapidjson::StringBuffer>* writer,
+                         std::ostream& error_stream);
+bool DecodeResponseToJson(const MethodDecodePlan& plan, const uint8_t* bytes, size_t num_bytes,
+                          const zx_handle_disposition_t* handles, size_t num_handles,
+                          rapidjson::Writer<rapidjson::StringBuffer>* writer,
+                          std::ostream& error_stream);
+
 }  // namespace fidl_codec
 
 #endif  // SRC_LIB_FIDL_CODEC_WIRE_PARSER_H_
@@ -204,6 +204,20 @@ TEST_F(WireParserTest, ParseSingleString) {
                                 << expected_source << ")"                                         \
                                 << " and actual = " << actual_string.GetString();                 \
                                                                                                   \
+    if ((num_bytes == -1) && (patched_offset == -1)) {                                            \
+      /* The streaming decoding gives the same JSON without building the value. */                \
+      const MethodDecodePlan* plan = loader()->GetDecodePlan(header.ordinal);                     \
+      ASSERT_NE(plan, nullptr);                                                                   \
+      std::stringstream streaming_error_stream;                                                   \
+      rapidjson::StringBuffer streaming_string;                                                   \
+      rapidjson::Writer<rapidjson::StringBuffer> streaming_w(streaming_string);                   \
+      ASSERT_TRUE(DecodeRequestToJson(*plan, message.bytes().data(), message.bytes().size(),      \
+                                      handle_dispositions, message.handles().size(),              \
+                                      &streaming_w, streaming_error_stream))                      \
+          << streaming_error_stream.str();                                                        \
+      ASSERT_EQ(std::string(actual_string.GetString()), streaming_string.GetString());            \
+    }                                                                                             \
+                                                                                                  \
     std::stringstream result;                                                                     \
     if (object != nullptr) {                                                                      \
       PrettyPrinter printer(result, FakeColors, false, "", 80, /*header_on_every_line=*/false);   \
@@ -8,6 +8,7 @@
 #include <lib/zxdump/fd-writer.h>
 #include <lib/zxdump/task.h>
 #include <lib/zxdump/zstd-writer.h>
+#include <sys/stat.h>
 
 #include "test-file.h"
 #include "test-tool-process.h"
@@ -204,6 +205,60 @@ TEST(ZxdumpTests, ProcessDumpBasic) {
   }
 }
 
+TEST(ZxdumpTests, ProcessDumpMemory) {
+  TestFile file;
+  zxdump::FdWriter writer(file.RewoundFd());
+
+  TestProcess process;
+  ASSERT_NO_FATAL_FAILURE(process.StartChild());
+  zxdump::ProcessDump<zx::unowned_process> dump(process.borrow());
+
+  // Dump everything the default policy would.
+  auto collect_result = dump.CollectProcess(
+      [](zxdump::SegmentDisposition segment, const zx_info_maps_t& maps,
+         const zx_info_vmo_t& vmo) -> fit::result<zxdump::Error, zxdump::SegmentDisposition> {
+        return fit::ok(segment);
+      });
+  ASSERT_TRUE(collect_result.is_ok()) << collect_result.error_value();
+  const size_t dump_size = collect_result.value();
+
+  auto dump_result = dump.DumpHeaders(writer.AccumulateFragmentsCallback());
+  ASSERT_TRUE(dump_result.is_ok()) << dump_result.error_value();
+
+  auto write_result = writer.WriteFragments();
+  ASSERT_TRUE(write_result.is_ok()) << write_result.error_value();
+  const size_t bytes_written = write_result.value();
+  ASSERT_LT(bytes_written, dump_size);
+
+  // Check the offsets in each callback on the way to the writer.
+  size_t end_offset = bytes_written;
+  size_t memory_bytes = 0;
+  auto write = writer.WriteCallback();
+  auto memory_result = dump.DumpMemory([&](size_t offset, ByteView data) {
+    EXPECT_GE(offset, end_offset);
+    EXPECT_FALSE(data.empty());
+    end_offset = offset + data.size();
+    memory_bytes += data.size();
+    return write(offset, data);
+  });
+  ASSERT_TRUE(memory_result.is_ok()) << memory_result.error_value();
+  EXPECT_EQ(memory_result.value(), dump_size);
+
+  // The end of the last segment is always written, so the file is complete
+  // even though zero pages were skipped over.
+  EXPECT_EQ(end_offset, dump_size);
+  struct stat st;
+  ASSERT_EQ(0, fstat(fileno(file.stdio()), &st));
+  EXPECT_EQ(static_cast<size_t>(st.st_size), dump_size);
+
+  // Some of the memory, at least most of the stack, will be zero pages.
+  EXPECT_LT(memory_bytes, dump_size - bytes_written);
+
+  zxdump::TaskHolder holder;
+  auto read_result = holder.Insert(file.RewoundFd());
+  ASSERT_TRUE(read_result.is_ok()) << read_result.error_value();
+}
+
 TEST(ZxdumpTests, ProcessDumpPropertiesAndInfo) {
   TestFile file;
   zxdump::FdWriter writer(file.RewoundFd());
@@ -14,12 +14,17 @@
 #include <array>
 #include <cassert>
 #include <charconv>
+#include <condition_variable>
 #include <cstdint>
 #include <cstdlib>
 #include <limits>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <thread>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include <rapidjson/document.h>
@@ -554,6 +559,66 @@ constexpr auto CollectKernelNoteData = [](auto&& resource, auto&& task,
   return fit::ok();
 };
 
+// Read some data from the process's memory at the given address into the
+// buffer.  This yields at least min_bytes and at most max_bytes of data.  The
+// call can fail with ZX_ERR_NOT_FOUND in some cases where not all pages are
+// readable addresses, so retry with one page fewer until reading succeeds.
+fit::result<Error, size_t> ReadProcessMemory(const zx::process& process, uintptr_t vaddr,
+                                             std::byte* buffer, size_t min_bytes,
+                                             size_t max_bytes) {
+  size_t valid_size = 0;
+  auto try_read = [&]() { return process.read_memory(vaddr, buffer, max_bytes, &valid_size); };
+
+  zx_status_t status = try_read();
+  while (status == ZX_ERR_NOT_FOUND && max_bytes >= min_bytes) {
+    uintptr_t end_vaddr = vaddr + max_bytes;
+    if (end_vaddr % ZX_PAGE_SIZE != 0) {
+      // Try again without the partial page.
+      end_vaddr &= -uintptr_t{ZX_PAGE_SIZE};
+      max_bytes = end_vaddr - vaddr;
+      status = try_read();
+    } else {
+      // Try one page fewer.
+      end_vaddr -= ZX_PAGE_SIZE;
+      max_bytes = end_vaddr - vaddr;
+      if (end_vaddr > vaddr) {
+        status = try_read();
+      } else {
+        break;
+      }
+    }
+  }
+
+  if (status != ZX_OK) {
+    return fit::error(Error{"zx_process_read_memory", status});
+  }
+
+  if (valid_size < min_bytes) {
+    return fit::error(Error{"short memory read", ZX_ERR_NO_MEMORY});
+  }
+
+  return fit::ok(valid_size);
+}
+
+// Returns true if the data is all zero bytes.
+bool IsZero(ByteView data) {
+  // Check a word at a time where possible.  This is always the case for the
+  // whole pages that matter.
+  const std::byte* p = data.data();
+  const std::byte* end = p + data.size();
+  while (p < end && reinterpret_cast<uintptr_t>(p) % sizeof(uint64_t) != 0) {
+    if (*p++ != std::byte{}) {
+      return false;
+    }
+  }
+  for (; end - p >= static_cast<ptrdiff_t>(sizeof(uint64_t)); p += sizeof(uint64_t)) {
+    if (*reinterpret_cast<const uint64_t*>(p) != 0) {
+      return false;
+    }
+  }
+  return std::all_of(p, end, [](std::byte b) { return b == std::byte{}; });
+}
+
 }  // namespace
 
 // The public class is just a container for a std::unique_ptr to this private
@@ -695,12 +760,15 @@ class ProcessDumpBase::Collector {
   // from the callback.  If `dump` returns an error result, that is returned
   // immediately.  If it returns success, additional callbacks will be made
   // until all the data has been dumped, and the final `dump` callback's return
-  // value will be the "success" return value.
+  // value will be the "success" return value.  Whole pages of zero bytes are
+  // not passed to `dump` at all, just skipped over in the offsets.
   fit::result<Error, size_t> DumpMemory(DumpCallback dump, size_t limit) {
+    // Collect all the ranges first so the reader can run ahead of the dump
+    // callbacks, straight through from one segment to the next.
+    std::vector<MemoryPipeline::Range> ranges;
     size_t offset = headers_size_bytes() + notes_size_bytes();
     for (const auto& segment : phdrs_) {
       if (segment.type == elfldltl::ElfPhdrType::kLoad) {
-        uintptr_t vaddr = segment.vaddr;
         if (segment.offset >= limit) {
           break;
         }
@@ -708,31 +776,32 @@ class ProcessDumpBase::Collector {
         if (size == 0) {
           continue;
         }
-        size_t left = size;
-        offset = segment.offset;
-        do {
-          ByteView chunk;
-
-          // This yields some nonempty subset of the requested range.
-          if (auto read = memory_.ReadBytes(vaddr, 1, left); read.is_error()) {
-            return read.take_error();
-          } else {
-            chunk = read.value();
-            ZX_DEBUG_ASSERT(chunk.size() <= left);
-            ZX_DEBUG_ASSERT(!chunk.empty());
-            ZX_DEBUG_ASSERT(chunk.data());
-          }
+        ranges.push_back({.vaddr = segment.vaddr, .offset = segment.offset, .size = size});
+        offset = segment.offset + size;
+      }
+    }
 
-          // Send it to the callback to write it out.
-          if (dump(offset, chunk)) {
-            break;
-          }
+    if (ranges.empty()) {
+      return fit::ok(offset);
+    }
+
+    MemoryPipeline pipeline(*process_, std::move(ranges));
+    while (true) {
+      auto next = pipeline.Next();
+      if (next.is_error()) {
+        return next.take_error();
+      }
+      if (!next.value()) {
+        break;
+      }
+
+      const MemoryPipeline::Chunk& chunk = *next.value();
+      ZX_DEBUG_ASSERT(!chunk.data.empty());
+      ZX_DEBUG_ASSERT(chunk.data.data());
 
-          vaddr += chunk.size();
-          offset += chunk.size();
-          left -= chunk.size();
-        } while (left > 0);
-        ZX_DEBUG_ASSERT(offset == segment.offset + size);
+      // Send it to the callback to write it out.
+      if (DumpNonzeroPages(dump, chunk)) {
+        break;
       }
     }
     return fit::ok(offset);
@@ -1242,41 +1311,12 @@ class ProcessDumpBase::Collector {
       buffer_vaddr_ = vaddr;
       max_bytes = std::min(max_bytes, kWindowSize_);
 
-      auto try_read = [&]() {
-        ZX_DEBUG_ASSERT(buffer_);
-        ZX_DEBUG_ASSERT(buffer_->data());
-        return process_->read_memory(buffer_vaddr_, buffer_->data(), max_bytes, &valid_size_);
-      };
-
-      // Try to read the chosen maximum.  The call can fail with
-      // ZX_ERR_NOT_FOUND in some cases where not all pages are readable
-      // addresses, so retry with one page fewer until reading succeeds.
-      zx_status_t status = try_read();
-      while (status == ZX_ERR_NOT_FOUND && max_bytes >= min_bytes) {
-        uintptr_t end_vaddr = buffer_vaddr_ + max_bytes;
-        if (end_vaddr % ZX_PAGE_SIZE != 0) {
-          // Try again without the partial page.
-          end_vaddr &= -uintptr_t{ZX_PAGE_SIZE};
-          max_bytes = end_vaddr - buffer_vaddr_;
-          status = try_read();
-        } else {
-          // Try one page fewer.
-          end_vaddr -= ZX_PAGE_SIZE;
-          max_bytes = end_vaddr - buffer_vaddr_;
-          if (end_vaddr > buffer_vaddr_) {
-            status = try_read();
-          } else {
-            break;
-          }
-        }
-      }
-
-      if (status != ZX_OK) {
-        return fit::error(Error{"zx_process_read_memory", status});
-      }
-
-      if (valid_size_ < min_bytes) {
-        return fit::error(Error{"short memory read", ZX_ERR_NO_MEMORY});
+      if (auto result = ReadProcessMemory(*process_, buffer_vaddr_, buffer_->data(), min_bytes,
+                                          max_bytes);
+          result.is_error()) {
+        return result.take_error();
+      } else {
+        valid_size_ = result.value();
       }
 
       ZX_DEBUG_ASSERT(valid_size_ > 0);
@@ -1331,6 +1371,186 @@ class ProcessDumpBase::Collector {
     zx::unowned_process process_;
   };
 
+  // This reads the memory for DumpMemory on a separate thread, so reading the
+  // process memory overlaps with the dump callbacks writing out (and usually
+  // compressing) the data read before.  The reader thread fills a small ring
+  // of large buffers in order and Next() consumes them in the same order.
+  class MemoryPipeline {
+   public:
+    // A contiguous range of memory to read, and where it goes in the file.
+    struct Range {
+      uintptr_t vaddr;
+      size_t offset;
+      size_t size;
+    };
+
+    // The data in a Chunk is valid only until the next call to Next().
+    struct Chunk {
+      size_t offset;
+      ByteView data;
+      bool last;  // This is the end of a Range.
+    };
+
+    MemoryPipeline() = delete;
+    MemoryPipeline(const MemoryPipeline&) = delete;
+    MemoryPipeline& operator=(const MemoryPipeline&) = delete;
+
+    // The reader thread starts right away.
+    MemoryPipeline(const zx::process& process, std::vector<Range> ranges)
+        : process_(process), ranges_(std::move(ranges)) {
+      for (Slot& slot : slots_) {
+        slot.buffer = std::make_unique<std::byte[]>(kChunkSize);
+      }
+      reader_ = std::thread([this]() { ReadAll(); });
+    }
+
+    // If Next() wasn't called until the end, this stops the reader early.
+    ~MemoryPipeline() {
+      {
+        std::lock_guard lock(mutex_);
+        canceled_ = true;
+      }
+      slot_free_.notify_one();
+      reader_.join();
+    }
+
+    // Get the next chunk of data, or std::nullopt after the last one.
+    fit::result<Error, std::optional<Chunk>> Next() {
+      std::unique_lock lock(mutex_);
+      if (std::exchange(holding_slot_, false)) {
+        // The reader can reuse the buffer from the last call.
+        ++consumed_;
+        slot_free_.notify_one();
+      }
+      slot_filled_.wait(lock, [this]() { return produced_ > consumed_ || finished_; });
+      if (produced_ == consumed_) {
+        return fit::ok(std::nullopt);
+      }
+      const Slot& slot = slots_[consumed_ % kDepth];
+      if (slot.error) {
+        return fit::error(*slot.error);
+      }
+      holding_slot_ = true;
+      return fit::ok(Chunk{
+          .offset = slot.offset,
+          .data = {slot.buffer.get(), slot.size},
+          .last = slot.last,
+      });
+    }
+
+   private:
+    // Each read fills up to this much of a buffer.  The ring buffers hold
+    // kDepth chunks that have been read but not yet passed on by Next().
+    static constexpr size_t kChunkSize = 256 * 1024;
+    static constexpr size_t kDepth = 4;
+
+    struct Slot {
+      std::unique_ptr<std::byte[]> buffer;
+      size_t offset = 0;
+      size_t size = 0;
+      bool last = false;
+      std::optional<Error> error;
+    };
+
+    // This runs on the reader thread.  The buffer in the slot being filled is
+    // not touched by the consuming thread until produced_ is advanced past it,
+    // so the reads themselves happen without holding the lock.
+    void ReadAll() {
+      auto finish = [this]() {
+        {
+          std::lock_guard lock(mutex_);
+          finished_ = true;
+        }
+        slot_filled_.notify_one();
+      };
+
+      for (const Range& range : ranges_) {
+        size_t done = 0;
+        while (done < range.size) {
+          Slot* slot;
+          {
+            std::unique_lock lock(mutex_);
+            slot_free_.wait(lock, [this]() { return canceled_ || produced_ - consumed_ < kDepth; });
+            if (canceled_) {
+              return;
+            }
+            slot = &slots_[produced_ % kDepth];
+          }
+
+          const size_t max_bytes = std::min(kChunkSize, range.size - done);
+          auto result =
+              ReadProcessMemory(*process_, range.vaddr + done, slot->buffer.get(), 1, max_bytes);
+          const bool failed = result.is_error();
+          slot->offset = range.offset + done;
+          if (failed) {
+            slot->error = result.error_value();
+            slot->size = 0;
+          } else {
+            slot->size = result.value();
+            done += slot->size;
+          }
+          slot->last = done == range.size;
+
+          {
+            std::lock_guard lock(mutex_);
+            ++produced_;
+          }
+          slot_filled_.notify_one();
+
+          if (failed) {
+            finish();
+            return;
+          }
+        }
+      }
+
+      finish();
+    }
+
+    zx::unowned_process process_;
+    std::vector<Range> ranges_;
+    std::array<Slot, kDepth> slots_;
+    std::thread reader_;
+
+    std::mutex mutex_;
+    std::condition_variable slot_filled_;
+    std::condition_variable slot_free_;
+    size_t produced_ = 0;  // Slots filled by the reader.
+    size_t consumed_ = 0;  // Slots released by Next().
+    bool holding_slot_ = false;
+    bool finished_ = false;
+    bool canceled_ = false;
+  };
+
+  // Send the chunk's data to the callback, leaving out any whole pages that
+  // are all zero.  Those just become gaps between the offsets passed to the
+  // callback, which the writer fills with zero bytes or leaves as a sparse
+  // region of the file.  The last page of each segment is always sent so the
+  // file always extends to the end of the segment.  This returns true if the
+  // callback bailed out.
+  static bool DumpNonzeroPages(DumpCallback& dump, const MemoryPipeline::Chunk& chunk) {
+    const size_t page_size = zx_system_get_page_size();
+    size_t offset = chunk.offset;
+    ByteView data = chunk.data;
+    size_t nonzero = 0;  // This much at the front of data is yet to be sent.
+    while (nonzero < data.size()) {
+      const size_t page = std::min(page_size - (offset + nonzero) % page_size,  //
+                                   data.size() - nonzero);
+      const bool last_page = chunk.last && nonzero + page == data.size();
+      if (last_page || !IsZero(data.substr(nonzero, page))) {
+        nonzero += page;
+        continue;
+      }
+      if (nonzero > 0 && dump(offset, data.substr(0, nonzero))) {
+        return true;
+      }
+      offset += nonzero + page;
+      data.remove_prefix(nonzero + page);
+      nonzero = 0;
+    }
+    return nonzero > 0 && dump(offset, data);
+  }
+
   size_t headers_size_bytes() const {
     return sizeof(ehdr_) + (sizeof(phdrs_[0]) * phdrs_.size()) +
            (ehdr_.phnum == Elf::Ehdr::kPnXnum ? sizeof(shdr_) : 0);
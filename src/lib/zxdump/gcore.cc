@@ -48,6 +48,7 @@ struct Flags {
   std::string_view output_prefix = kOutputPrefix;
   size_t limit = zxdump::DefaultLimit();
   bool dump_memory = true;
+  bool dump_file_memory = true;
   bool collect_system = false;
   bool repeat_system = false;
   bool collect_kernel = false;
@@ -165,6 +166,19 @@ class DumperBase {
     return fit::ok(segment);
   }
 
+  static fit::result<zxdump::Error, zxdump::SegmentDisposition> PruneFileMemory(
+      zxdump::SegmentDisposition segment, const zx_info_maps_t& mapping, const zx_info_vmo_t& vmo) {
+    if (!(mapping.u.mapping.mmu_flags & ZX_VM_PERM_WRITE) &&  // Never written,
+        mapping.u.mapping.committed_pages == 0 &&              // no private RAM here,
+        (vmo.flags & ZX_INFO_VMO_PAGER_BACKED)) {              // and all from a file.
+      // This is just the unmodified contents of a file, such as the text and
+      // rodata of a shared library.  A debugger can get it from the file.
+      segment.filesz = 0;
+      return fit::ok(segment);
+    }
+    return PruneDefault(segment, mapping, vmo);
+  }
+
   // Read errors from syscalls use the PID (or job KOID).
   void Error(const zxdump::Error& error) const {
     std::cerr << koid_ << ": "sv << error << std::endl;
@@ -228,7 +242,7 @@ class ProcessDumper : public DumperBase {
     zxdump::SegmentCallback prune = PruneAll;
     if (flags.dump_memory) {
       // TODO(mcgrathr): more filtering switches
-      prune = PruneDefault;
+      prune = flags.dump_file_memory ? PruneDefault : PruneFileMemory;
     }
 
     if (flags.collect_threads) {
@@ -608,13 +622,14 @@ bool WriteManyCoreFiles(JobDumper dumper, const Flags& flags) {
   return ok;
 }
 
-constexpr const char kOptString[] = "hlo:zamtcpJjfDUsSkK";
+constexpr const char kOptString[] = "hlo:zamFtcpJjfDUsSkK";
 constexpr const option kLongOpts[] = {
     {"help", no_argument, nullptr, 'h'},                 //
     {"limit", required_argument, nullptr, 'l'},          //
     {"output-prefix", required_argument, nullptr, 'o'},  //
     {"zstd", no_argument, nullptr, 'z'},                 //
     {"exclude-memory", no_argument, nullptr, 'm'},       //
+    {"exclude-file-memory", no_argument, nullptr, 'F'},  //
     {"no-threads", no_argument, nullptr, 't'},           //
     {"no-children", no_argument, nullptr, 'c'},          //
     {"no-processes", no_argument, nullptr, 'p'},         //
@@ -647,6 +662,7 @@ int main(int argc, char** argv) {
     --zstd, -z                         compress output files with zstd -11
     --limit=BYTES, -l BYTES            truncate output to BYTES per process
     --exclude-memory, -M               exclude all process memory from dumps
+    --exclude-file-memory, -F          exclude read-only memory from files
     --no-threads, -t                   collect only memory, threads left to run
     --jobs, -J                         allow PIDs to be job KOIDs instead
     --job-archive, -j                  write job archives, not process dumps
@@ -663,6 +679,12 @@ int main(int argc, char** argv) {
 
 By default, each PID must be the KOID of a process.
 
+Memory pages that are all zero bytes are never written to the file; they are
+left as sparse regions when the output is seekable.
+
+With --exclude-file-memory, read-only mappings of file contents that the process
+has never modified, such as shared library code, are omitted from the dump.
+
 With --jobs, the KOID of a job is allowed.  Each process gets a separate dump
 named for its individual PID.
 
@@ -735,6 +757,10 @@ essential services.  PID arguments are not allowed with --root-job unless
         flags.dump_memory = false;
         continue;
 
+      case 'F':
+        flags.dump_file_memory = false;
+        continue;
+
       case 't':
         flags.collect_threads = false;
         continue;
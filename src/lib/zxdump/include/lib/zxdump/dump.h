@@ -204,7 +204,11 @@ class ProcessDumpBase : protected DumpBase {
   // The offset in the first callback is greater than the offset in the last
   // DumpHeaders callback, and later callbacks always increase the offset.
   // There may be a gap from the end of previous chunk, which should be filled
-  // with zero (or made sparse in the output file).  Unlike DumpHeaders, the
+  // with zero (or made sparse in the output file).  Pages of memory that are
+  // all zero bytes are left as such gaps rather than passed to `dump`, except
+  // at the end of a segment.  The memory is read from the process on another
+  // thread while earlier data is being passed to `dump`, but all the `dump`
+  // calls are made on the calling thread, in order.  Unlike DumpHeaders, the
   // view passed to the `dump` callback here points into a temporary buffer
   // that will be reused for the next callback.  So this `dump` callback must
   // stream the data out or copy it, not just accumulate the view objects.
@@ -29,16 +29,33 @@ PacketQueue::PacketQueue(Format format, fbl::RefPtr<VersionedTimelineFunction> t
 
 void PacketQueue::PushPacket(const fbl::RefPtr<Packet>& packet) {
   TRACE_DURATION("audio", "PacketQueue::PushPacket");
+  if (incoming_packets_.Push(packet)) {
+    return;
+  }
+
+  // The mix thread hasn't kept up. Drain the incoming packets ourselves so this one stays in order.
+  TRACE_INSTANT("audio", "PacketQueue::PushPacket.full", TRACE_SCOPE_THREAD);
   std::lock_guard<std::mutex> locker(pending_mutex_);
+  DrainIncomingPackets();
   pending_packet_queue_.push_back({
       .packet = packet,
       .seen_in_read_lock = false,
   });
 }
 
+void PacketQueue::DrainIncomingPackets() {
+  while (auto packet = incoming_packets_.Pop()) {
+    pending_packet_queue_.push_back({
+        .packet = std::move(*packet),
+        .seen_in_read_lock = false,
+    });
+  }
+}
+
 void PacketQueue::Flush(const fbl::RefPtr<PendingFlushToken>& flush_token) {
   TRACE_DURATION("audio", "PacketQueue::Flush");
   std::lock_guard<std::mutex> locker(pending_mutex_);
+  DrainIncomingPackets();
 
   if (read_lock_in_progress_) {
     // Is the sink currently mixing? If so, the flush cannot complete until the mix operation has
@@ -72,6 +89,7 @@ std::optional<ReadableStream::Buffer> PacketQueue::ReadLockImpl(ReadLockContext&
   if (read_lock_in_progress_) {
     FX_CHECK(false) << "PacketQueue::ReadLockImpl called while read lock still held";
   }
+  DrainIncomingPackets();
 
   // Since ReadLock never goes backwards in time, we can safely trim packets before `frame`.
   // If the packet starts before the requested frame and has not been seen before, it underflowed.
@@ -147,6 +165,7 @@ void PacketQueue::ReadUnlock() {
 
 void PacketQueue::TrimImpl(Fixed frame) {
   std::lock_guard<std::mutex> locker(pending_mutex_);
+  DrainIncomingPackets();
 
   // Release packets that end before our trim position.
   while (!pending_packet_queue_.empty()) {
@@ -16,6 +16,7 @@
 #include "src/media/audio/audio_core/v1/clock.h"
 #include "src/media/audio/audio_core/v1/packet.h"
 #include "src/media/audio/audio_core/v1/pending_flush_token.h"
+#include "src/media/audio/audio_core/v1/spsc_queue.h"
 #include "src/media/audio/audio_core/v1/stream.h"
 #include "src/media/audio/audio_core/v1/versioned_timeline_function.h"
 #include "src/media/audio/lib/format/format.h"
@@ -31,7 +32,7 @@ class PacketQueue : public ReadableStream {
 
   bool empty() const {
     std::lock_guard<std::mutex> locker(pending_mutex_);
-    return pending_packet_queue_.empty();
+    return pending_packet_queue_.empty() && incoming_packets_.empty();
   }
 
   void set_usage(const StreamUsage& usage) {
@@ -39,6 +40,8 @@ class PacketQueue : public ReadableStream {
     usage_mask_.insert(usage);
   }
 
+  // PushPacket is normally lock-free, so that the mix thread never waits on the thread sending
+  // packets. Calls to PushPacket must not race with each other.
   void PushPacket(const fbl::RefPtr<Packet>& packet);
   void Flush(const fbl::RefPtr<PendingFlushToken>& flush_token = nullptr);
 
@@ -62,16 +65,28 @@ class PacketQueue : public ReadableStream {
   void ReportUnderflow(const fbl::RefPtr<Packet>& packet, Fixed underflow_frames)
       FXL_REQUIRE(pending_mutex_);
 
+  // Moves packets from `incoming_packets_` to the back of `pending_packet_queue_`.
+  void DrainIncomingPackets() FXL_REQUIRE(pending_mutex_);
+
   StreamUsageMask usage_mask_;
 
   mutable std::mutex pending_mutex_;
 
+  // Holds enough packets for well over one mix period of 1ms packets. If the mix thread falls
+  // further behind than this, PushPacket falls back to taking `pending_mutex_`.
+  static constexpr size_t kIncomingPacketCapacity = 64;
+
+  // New packets go on `incoming_packets_` without taking `pending_mutex_`. PushPacket is the only
+  // producer. Packets are consumed only with `pending_mutex_` held, which serializes the consumers
+  // (the mix thread and Flush), and are moved to `pending_packet_queue_` before use.
+  SpscQueue<fbl::RefPtr<Packet>, kIncomingPacketCapacity> incoming_packets_;
+
   struct PendingPacket {
     fbl::RefPtr<Packet> packet;
     bool seen_in_read_lock = false;
   };
 
-  // New packets go on `pending_packet_queue_`.
+  // Incoming packets are moved to `pending_packet_queue_` in order.
   //
   // If a Flush happens while a ReadLock is held, then a downstream stage has a
   // non-reference-counted pointer to the first packet in `pending_packet_queue_`.
@@ -6,6 +6,7 @@
 
 #include <lib/syslog/cpp/macros.h>
 
+#include <numeric>
 #include <unordered_map>
 
 #include <fbl/ref_ptr.h>
@@ -525,5 +526,32 @@ TEST_F(PacketQueueTest, ReportUnderflow) {
   EXPECT_TRUE(packet_queue->empty());
 }
 
+// Packets pushed while the reader is not keeping up must still be read in order, even once there
+// are more of them than PushPacket can queue without locking.
+TEST_F(PacketQueueTest, PushManyPacketsBeforeRead) {
+  auto packet_queue = CreatePacketQueue();
+
+  constexpr int64_t kPacketCount = 100;
+  constexpr int64_t kPacketSize = 10;
+  for (int64_t k = 0; k < kPacketCount; ++k) {
+    packet_queue->PushPacket(CreatePacket(static_cast<uint32_t>(k), k * kPacketSize, kPacketSize));
+  }
+  ASSERT_FALSE(packet_queue->empty());
+
+  for (int64_t k = 0; k < kPacketCount; ++k) {
+    auto buffer = packet_queue->ReadLock(rlctx, Fixed(k * kPacketSize), kPacketSize);
+    ASSERT_TRUE(buffer) << k;
+    EXPECT_EQ(Fixed(k * kPacketSize), buffer->start()) << k;
+    EXPECT_EQ(kPacketSize, buffer->length()) << k;
+  }
+  packet_queue->Trim(Fixed(kPacketCount * kPacketSize));
+  RunLoopUntilIdle();
+
+  EXPECT_TRUE(packet_queue->empty());
+  std::vector<int64_t> expected(kPacketCount);
+  std::iota(expected.begin(), expected.end(), 0);
+  EXPECT_EQ(expected, released_packets());
+}
+
 }  // namespace
 }  // namespace media::audio
@@ -0,0 +1,76 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SRC_MEDIA_AUDIO_AUDIO_CORE_V1_SPSC_QUEUE_H_
+#define SRC_MEDIA_AUDIO_AUDIO_CORE_V1_SPSC_QUEUE_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+namespace media::audio {
+
+// A bounded FIFO for handing values from one producer thread to one consumer thread without
+// locks. Push and Pop never block and never allocate: storage for |kCapacity| values is part of
+// the object.
+//
+// At any time there must be at most one producer and at most one consumer. The producer or
+// consumer role may move between threads only if the handoff is otherwise synchronized, e.g. if
+// every thread that pops does so while holding the same mutex.
+template <typename T, size_t kCapacity>
+class SpscQueue {
+ public:
+  static_assert(kCapacity > 0 && (kCapacity & (kCapacity - 1)) == 0,
+                "kCapacity must be a power of two");
+
+  SpscQueue() = default;
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  // Producer only. Appends a copy of |value|, or returns false if the queue is full.
+  bool Push(const T& value) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == kCapacity) {
+      return false;
+    }
+    slots_[tail & kMask] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer only. Removes and returns the oldest value, or std::nullopt if the queue is empty.
+  std::optional<T> Pop() {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return std::nullopt;
+    }
+    // Leave the slot moved-from (for RefPtrs, null) so it doesn't hold on to the value.
+    std::optional<T> value(std::move(slots_[head & kMask]));
+    head_.store(head + 1, std::memory_order_release);
+    return value;
+  }
+
+  // May be called from any thread, but is only a snapshot if the other side is running.
+  bool empty() const {
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+  }
+
+  static constexpr size_t capacity() { return kCapacity; }
+
+ private:
+  static constexpr size_t kMask = kCapacity - 1;
+
+  std::array<T, kCapacity> slots_;
+
+  // Free-running counts of values popped and pushed. Each is written by one side only and kept
+  // on its own cache line so the producer and consumer don't contend.
+  alignas(64) std::atomic<size_t> head_ = 0;
+  alignas(64) std::atomic<size_t> tail_ = 0;
+};
+
+}  // namespace media::audio
+
+#endif  // SRC_MEDIA_AUDIO_AUDIO_CORE_V1_SPSC_QUEUE_H_
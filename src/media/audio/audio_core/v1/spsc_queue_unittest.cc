@@ -0,0 +1,85 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/media/audio/audio_core/v1/spsc_queue.h"
+
+#include <memory>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace media::audio {
+namespace {
+
+TEST(SpscQueueTest, PushPopInOrder) {
+  SpscQueue<int, 4> queue;
+  EXPECT_TRUE(queue.empty());
+  EXPECT_FALSE(queue.Pop().has_value());
+
+  // Wrap around the end of the storage a few times.
+  for (int k = 0; k < 10; ++k) {
+    EXPECT_TRUE(queue.Push(2 * k));
+    EXPECT_TRUE(queue.Push(2 * k + 1));
+    EXPECT_FALSE(queue.empty());
+    EXPECT_EQ(queue.Pop(), 2 * k);
+    EXPECT_EQ(queue.Pop(), 2 * k + 1);
+    EXPECT_TRUE(queue.empty());
+  }
+}
+
+TEST(SpscQueueTest, PushFailsWhenFull) {
+  SpscQueue<int, 4> queue;
+  for (int k = 0; k < 4; ++k) {
+    EXPECT_TRUE(queue.Push(k));
+  }
+  EXPECT_FALSE(queue.Push(4));
+
+  EXPECT_EQ(queue.Pop(), 0);
+  EXPECT_TRUE(queue.Push(4));
+  for (int k = 1; k <= 4; ++k) {
+    EXPECT_EQ(queue.Pop(), k);
+  }
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(SpscQueueTest, PopReleasesSlot) {
+  SpscQueue<std::shared_ptr<int>, 2> queue;
+  auto value = std::make_shared<int>(1);
+  ASSERT_TRUE(queue.Push(value));
+  EXPECT_EQ(value.use_count(), 2);
+
+  auto popped = queue.Pop();
+  ASSERT_TRUE(popped.has_value());
+  popped.reset();
+  EXPECT_EQ(value.use_count(), 1);
+}
+
+TEST(SpscQueueTest, ProducerAndConsumerThreads) {
+  constexpr int kCount = 100'000;
+  SpscQueue<int, 64> queue;
+
+  std::thread producer([&queue] {
+    for (int k = 0; k < kCount;) {
+      if (queue.Push(k)) {
+        ++k;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  for (int expected = 0; expected < kCount;) {
+    if (auto value = queue.Pop()) {
+      ASSERT_EQ(*value, expected);
+      ++expected;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+  EXPECT_TRUE(queue.empty());
+}
+
+}  // namespace
+}  // namespace media::audio
@@ -10,6 +10,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "src/media/audio/lib/analysis/fft.h"
 #include "src/media/audio/lib/format/traits.h"
 
 namespace media::audio {
@@ -27,112 +28,11 @@ double SampleToDouble<uint8_t>(uint8_t value) {
   return static_cast<double>(value) - 128.0;
 }
 
-// Perform a Fast Fourier Transform on the provided data arrays.
-//
-// On input, real[] and imag[] contain 'buf_size' number of double-float values in the time domain
-// (such as audio samples); buf_size must be a power-of-two.
-//
-// On output, real[] and imag[] contain 'buf_size' number of double-float values in frequency
-// domain, but generally used only through buf_size/2 (per Nyquist).
-//
-// The classic FFT derivation (based on Cooley-Tukey), and what I implement here, achieves NlogN
-// performance (instead of N^2) with divide-and-conquer, while additional optimizing by working
-// in-place. To do this, it first breaks the data stream into single elements (so-called interlaced
-// decomposition) that are in the appropriate order, and then combines these to form series of
-// 2-element matrices, then combines these to form 4-element matrices, and so on, until combining
-// the final matrices (each of which is half the size of the original). Two interesting details
-// deserve further explanation:
-//
-// 1. Interlaced decomposition into the "appropriate order" mentioned above is achieved by sorting
-// values by index, but in ascending order if viewing the index in bit-reversed manner! (This is
-// exactly what is needed in order to combine the pairs of values in the appropriate cross-matrix
-// sequence.) So for a stream of 16 values (4 bits of index), this re-sorted order is as follows -
-//    0,    8,    4,   12,   2,     10,    6, ...,    7,   15 ... or, in binary:
-// 0000, 1000, 0100, 1100, 0010, 11010, 0110, ..., 0111, 1111.
-//
-// 2. Combining each matrix (called synthesis) is accomplished in the following fashion, regardless
-// of size: combining [ac] and [bd] to make [abcd] is done by spacing [ac] into [a0c0] and spacing
-// [bd] into [0b0d] and then overlaying them.  The frequency-domain equivalent of making [a0c0] from
-// [ac] is simply to turn [AC] into [ACAC]. The equivalent of creating [0b0d] from [bd] is to
-// multiply [BD] by a sinusoid (to delay it by one sample) while also duplicating [BD] into [BDBD].
-// This results in a 'butterfly' flow (based on the shape of two inputs, two outputs, and the four
-// arrows between them).
-// Specifically, in each pair of values that are combined:
-// even_output = even_input + (sinusoid_factor x odd_input), and
-// odd_output  = even input - (sinusoid_factor x odd_input).
-// (specifically, this sinusoid is the spectrum of a shifted delta function)
-// This butterfly operation transforms two complex points into two other complex points, combining
-// two 1-element signals into one 2-element signal (etc).
-//
-// Classic DSP texts by Oppenheim, Schaffer, Rabiner, or the Cooley-Tukey paper itself, are
-// serviceable references for these concepts.
-//
-// TODO(mpuryear): Consider std::complex<double> instead of real/imag arrays.
+// Perform a Fast Fourier Transform on the provided data arrays, in-place. This is a convenience
+// wrapper that builds a one-off FftPlan; callers that transform repeatedly should keep a plan.
 void FFT(double* reals, double* imags, uint32_t buf_size) {
   FX_DCHECK(cpp20::has_single_bit(buf_size));
-  const uint32_t buf_sz_2 = buf_size >> 1;
-
-  uint32_t N = 0;
-  while (buf_size > (1 << N)) {
-    ++N;
-  }
-
-  // First, perform a bit-reversal sort of indices. Again, this is done so that all subsequent
-  // matrix-merging work can be done on adjacent values. This sort implementation performs the
-  // minimal number of swaps/moves (considering buf_size could be 128K, 256K or more), but is
-  // admittedly more difficult to follow than some.
-  // When debugging, remember 1) each swap moves both vals to final locations, 2) each val is
-  // touched once or not at all, and 3) the final index ordering is **ascending if looking at
-  // indices in bit-reversed fashion**.
-  uint32_t swap_idx = buf_sz_2;
-  for (uint32_t idx = 1; idx < buf_size - 1; ++idx) {
-    if (idx < swap_idx) {
-      std::swap(reals[idx], reals[swap_idx]);
-      std::swap(imags[idx], imags[swap_idx]);
-    }
-    uint32_t alt_idx = buf_sz_2;
-    while (alt_idx <= swap_idx) {
-      swap_idx -= alt_idx;
-      alt_idx /= 2;
-    }
-    swap_idx += alt_idx;
-  }
-
-  // Loop through log2(buf_size) stages: one for each power of two, starting with 2, then 4, then 8,
-  // .... During each stage, combine pairs of shorter signals (of length 'sub_dft_sz_2') into
-  // single, longer signals (of length 'sub_dft_sz'). From previous sorting, signals to be combined
-  // are adjacent.
-  for (uint32_t fft_level = 1; fft_level <= N; ++fft_level) {
-    const uint32_t sub_dft_sz = 1 << fft_level;     // length of combined signal
-    const uint32_t sub_dft_sz_2 = sub_dft_sz >> 1;  // length of shorter signals
-    // 'Odd' values are multiplied by complex (real & imaginary) factors before being combined with
-    // 'even' values. These coefficients help the real and imaginary factors advance correctly,
-    // within each sub_dft.
-    const double real_coef = std::cos(M_PI / static_cast<double>(sub_dft_sz_2));
-    const double imag_coef = -std::sin(M_PI / static_cast<double>(sub_dft_sz_2));
-
-    // For each point in this signal (for each complex pair in this 'sub_dft'),
-    double real_factor = 1.0, imag_factor = 0.0;
-    for (uint32_t btrfly_num = 1; btrfly_num <= sub_dft_sz_2; ++btrfly_num) {
-      double temp_real, temp_imag;
-
-      // ... perform the so-called butterfly operation on a pair of points.
-      for (uint32_t idx = btrfly_num - 1; idx < buf_size; idx += sub_dft_sz) {
-        const uint32_t idx2 = idx + sub_dft_sz_2;
-
-        temp_real = reals[idx2] * real_factor - imags[idx2] * imag_factor;
-        temp_imag = reals[idx2] * imag_factor + imags[idx2] * real_factor;
-        reals[idx2] = reals[idx] - temp_real;
-        imags[idx2] = imags[idx] - temp_imag;
-        reals[idx] += temp_real;
-        imags[idx] += temp_imag;
-      }
-      // Update the sinusoid coefficients, for the next points in this signal.
-      temp_real = real_factor;
-      real_factor = temp_real * real_coef - imag_factor * imag_coef;
-      imag_factor = temp_real * imag_coef + imag_factor * real_coef;
-    }
-  }
+  FftPlan<double>(buf_size).Forward(reals, imags);
 }
 
 // Calculate phase for a given complex number, spanning [-PI, PI].
@@ -223,17 +123,7 @@ void InverseDFT(double* real_freq, double* imag_freq, uint32_t buf_size, double*
 // (also len buf_size)
 void InverseFFT(double* reals, double* imags, uint32_t buf_size) {
   FX_DCHECK(cpp20::has_single_bit(buf_size));
-
-  for (uint32_t idx = 0; idx < buf_size; ++idx) {
-    imags[idx] = -imags[idx];
-  }
-
-  FFT(reals, imags, buf_size);
-
-  for (uint32_t idx = 0; idx < buf_size; ++idx) {
-    reals[idx] = reals[idx] / static_cast<double>(buf_size);
-    imags[idx] = -imags[idx] / static_cast<double>(buf_size);
-  }
+  FftPlan<double>(buf_size).Inverse(reals, imags);
 }
 
 }  // namespace internal
@@ -272,26 +162,27 @@ void AudioFreqResult::Display(std::string tag, double magn_display_threshold) {
 // For specified audio buffer & length, analyze the contents and return the magnitude (and phase) of
 // signal at given frequency (i.e. frequency at which 'freq' periods fit perfectly within buffer
 // length). Also return the magnitude of all other content. Useful for frequency response and
-// signal-to-noise. Internally uses an FFT, so slice.NumFrames() must be a power-of-two.
+// signal-to-noise. Internally uses a real-input FFT, so slice.NumFrames() must be even.
 template <fuchsia::media::AudioSampleFormat SampleFormat>
 AudioFreqResult MeasureAudioFreqs(AudioBufferSlice<SampleFormat> slice,
                                   std::unordered_set<int32_t> freqs) {
-  FX_CHECK(cpp20::has_single_bit(static_cast<uint64_t>(slice.NumFrames())));
+  FX_CHECK(slice.NumFrames() > 0 && slice.NumFrames() % 2 == 0);
   FX_CHECK(slice.format().channels() == 1);
 
   const int64_t buf_size = slice.NumFrames();
   const int64_t buf_sz_2 = buf_size >> 1;
 
-  // Copy input to double buffer, before doing a high-res FFT (freq-analysis). Note that we set
-  // imags[] to zero: MeasureAudioFreq retrieves a REAL (not Complex) FFT for the data, the return
-  // real and imaginary frequency-domain data only spans 0...N/2 (inclusive).
-  std::vector<double> reals(buf_size);
-  std::vector<double> imags(buf_size);
+  // Copy input to double buffer, before doing a high-res FFT (freq-analysis). The input is REAL
+  // (not Complex), so the frequency-domain data only spans 0...N/2 (inclusive) and we use the
+  // cheaper real-input transform.
+  std::vector<double> samples(buf_size);
   for (int64_t frame = 0; frame < buf_size; ++frame) {
-    reals[frame] = internal::SampleToDouble(slice.SampleAt(frame, 0));
-    imags[frame] = 0.0;
+    samples[frame] = internal::SampleToDouble(slice.SampleAt(frame, 0));
   }
-  internal::FFT(reals.data(), imags.data(), static_cast<uint32_t>(buf_size));
+  std::vector<double> reals(buf_sz_2 + 1);
+  std::vector<double> imags(buf_sz_2 + 1);
+  FftPlan<double>(static_cast<size_t>(buf_size))
+      .ForwardReal(samples.data(), reals.data(), imags.data());
 
   // Convert real FFT results from frequency domain into sinusoid amplitudes
   //
@@ -43,6 +43,9 @@ void InverseDFT(double* real, double* imag, uint32_t buf_size, double* real_out)
 
 void InverseFFT(double* real, double* imag, uint32_t buf_size);
 
+// FFT and InverseFFT are kept for existing callers. New code (particularly code that transforms
+// repeatedly, or needs float or non-power-of-two transforms) should use FftPlan from fft.h.
+
 }  // namespace internal
 
 struct AudioFreqResult {
@@ -65,7 +68,7 @@ struct AudioFreqResult {
 
 // For the given audio buffer, analyze contents and return the magnitude (and phase) at the given
 // frequency. Also return magnitude of all other content. Useful for frequency response and
-// signal-to-noise. Internally uses an FFT, so slice.NumFrames() must be a power-of-two. The format
+// signal-to-noise. Internally uses a real-input FFT, so slice.NumFrames() must be even. The format
 // must have channels() == 1.
 //
 // |freq| is the number of **complete sinusoidal periods** that should perfectly fit into the
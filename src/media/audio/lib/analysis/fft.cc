@@ -0,0 +1,335 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/media/audio/lib/analysis/fft.h"
+
+#include <lib/stdcompat/bit.h>
+#include <lib/syslog/cpp/macros.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace media::audio {
+
+namespace {
+
+// Angles are always computed in double and reduced before calling cos/sin, so float plans get
+// correctly-rounded twiddles and large plans don't accumulate error in the angle itself.
+void Rotation(uint64_t numerator, uint64_t denominator, double* real, double* imag) {
+  const double angle = -2.0 * M_PI * static_cast<double>(numerator % denominator) /
+                       static_cast<double>(denominator);
+  *real = std::cos(angle);
+  *imag = std::sin(angle);
+}
+
+}  // namespace
+
+template <typename T>
+FftPlan<T>::FftPlan(size_t size, bool real_transforms)
+    : size_(size), is_power_of_two_(cpp20::has_single_bit(size)) {
+  FX_CHECK(size_ > 0);
+  FX_CHECK(size_ <= std::numeric_limits<uint32_t>::max());
+
+  if (is_power_of_two_) {
+    // Bit-reversal permutation, recorded as the minimal set of swaps. Each swap moves both values
+    // to their final locations; every index is touched at most once.
+    const uint32_t bits = static_cast<uint32_t>(cpp20::countr_zero(size_));
+    for (uint32_t idx = 1; idx + 1 < size_; ++idx) {
+      uint32_t rev = 0;
+      for (uint32_t bit = 0; bit < bits; ++bit) {
+        rev |= ((idx >> bit) & 1u) << (bits - 1 - bit);
+      }
+      if (idx < rev) {
+        bit_reverse_swaps_.emplace_back(idx, rev);
+      }
+    }
+
+    // The stage that combines pairs of length-m transforms needs exp(-2*pi*i*k/(2m)), k in [0,m).
+    // Store each stage's twiddles contiguously so the butterfly loops are unit-stride.
+    twiddle_real_.resize(size_ > 1 ? size_ - 1 : 0);
+    twiddle_imag_.resize(twiddle_real_.size());
+    for (size_t m = 1; m < size_; m <<= 1) {
+      for (size_t k = 0; k < m; ++k) {
+        double re, im;
+        Rotation(k, 2 * m, &re, &im);
+        twiddle_real_[m - 1 + k] = static_cast<T>(re);
+        twiddle_imag_[m - 1 + k] = static_cast<T>(im);
+      }
+    }
+  } else {
+    // Bluestein's algorithm re-expresses the DFT as a circular convolution of the chirp-modulated
+    // input with the conjugate chirp, computed with power-of-two transforms of length >= 2N-1.
+    const size_t conv_size = cpp20::bit_ceil(2 * size_ - 1);
+    convolution_plan_ = std::unique_ptr<FftPlan<T>>(new FftPlan<T>(conv_size, false));
+
+    chirp_real_.resize(size_);
+    chirp_imag_.resize(size_);
+    filter_real_.assign(conv_size, 0);
+    filter_imag_.assign(conv_size, 0);
+    for (size_t n = 0; n < size_; ++n) {
+      // exp(-pi*i*n^2/N) == exp(-2*pi*i*(n^2 mod 2N)/(2N)); reducing first preserves precision.
+      const uint64_t n_sq = static_cast<uint64_t>(n) * n;
+      double re, im;
+      Rotation(n_sq, 2 * static_cast<uint64_t>(size_), &re, &im);
+      chirp_real_[n] = static_cast<T>(re);
+      chirp_imag_[n] = static_cast<T>(im);
+
+      filter_real_[n] = static_cast<T>(re);
+      filter_imag_[n] = static_cast<T>(-im);
+      if (n > 0) {
+        filter_real_[conv_size - n] = static_cast<T>(re);
+        filter_imag_[conv_size - n] = static_cast<T>(-im);
+      }
+    }
+    convolution_plan_->Forward(filter_real_.data(), filter_imag_.data());
+
+    // Fold the inverse transform's 1/M normalization into the filter, saving a pass per call.
+    const T scale = static_cast<T>(1.0 / static_cast<double>(conv_size));
+    for (size_t k = 0; k < conv_size; ++k) {
+      filter_real_[k] *= scale;
+      filter_imag_[k] *= scale;
+    }
+    conv_real_.resize(conv_size);
+    conv_imag_.resize(conv_size);
+  }
+
+  if (!real_transforms) {
+    return;
+  }
+  const size_t half = size_ / 2;
+  if (size_ % 2 == 0) {
+    half_plan_ = std::unique_ptr<FftPlan<T>>(new FftPlan<T>(half, false));
+    split_real_.resize(half + 1);
+    split_imag_.resize(half + 1);
+    for (size_t k = 0; k <= half; ++k) {
+      double re, im;
+      Rotation(k, size_, &re, &im);
+      split_real_[k] = static_cast<T>(re);
+      split_imag_[k] = static_cast<T>(im);
+    }
+    real_scratch_.resize(half);
+    imag_scratch_.resize(half);
+  } else {
+    real_scratch_.resize(size_);
+    imag_scratch_.resize(size_);
+  }
+}
+
+template <typename T>
+FftPlan<T>::~FftPlan() = default;
+
+template <typename T>
+void FftPlan<T>::Forward(T* real, T* imag) {
+  if (is_power_of_two_) {
+    Radix2(real, imag);
+  } else {
+    Bluestein(real, imag);
+  }
+}
+
+// The inverse transform is the forward transform with real and imaginary parts exchanged on both
+// input and output: IDFT(x) = swap(DFT(swap(x))) / N. Exchanging the array pointers is free.
+template <typename T>
+void FftPlan<T>::Inverse(T* real, T* imag) {
+  Forward(imag, real);
+
+  const T scale = static_cast<T>(1.0 / static_cast<double>(size_));
+  for (size_t idx = 0; idx < size_; ++idx) {
+    real[idx] *= scale;
+    imag[idx] *= scale;
+  }
+}
+
+// Iterative, in-place radix-2 Cooley-Tukey transform. After a bit-reversal sort of the input, we
+// run log2(N) stages; each stage combines adjacent pairs of length-m transforms into length-2m
+// transforms with "butterflies":
+//   even' = even + w^k * odd
+//   odd'  = even - w^k * odd
+// where w^k are the stage's twiddles. The inner loop runs over k with contiguous data and twiddle
+// accesses, so it vectorizes cleanly. The first stage has a unit twiddle and is special-cased.
+template <typename T>
+void FftPlan<T>::Radix2(T* real, T* imag) const {
+  for (const auto& [a, b] : bit_reverse_swaps_) {
+    std::swap(real[a], real[b]);
+    std::swap(imag[a], imag[b]);
+  }
+
+  if (size_ >= 2) {
+    for (size_t base = 0; base < size_; base += 2) {
+      const T r1 = real[base + 1];
+      const T i1 = imag[base + 1];
+      real[base + 1] = real[base] - r1;
+      imag[base + 1] = imag[base] - i1;
+      real[base] += r1;
+      imag[base] += i1;
+    }
+  }
+
+  for (size_t m = 2; m < size_; m <<= 1) {
+    const T* __restrict tw_re = twiddle_real_.data() + (m - 1);
+    const T* __restrict tw_im = twiddle_imag_.data() + (m - 1);
+
+    for (size_t base = 0; base < size_; base += 2 * m) {
+      T* __restrict even_re = real + base;
+      T* __restrict even_im = imag + base;
+      T* __restrict odd_re = real + base + m;
+      T* __restrict odd_im = imag + base + m;
+
+      for (size_t k = 0; k < m; ++k) {
+        const T t_re = odd_re[k] * tw_re[k] - odd_im[k] * tw_im[k];
+        const T t_im = odd_re[k] * tw_im[k] + odd_im[k] * tw_re[k];
+        odd_re[k] = even_re[k] - t_re;
+        odd_im[k] = even_im[k] - t_im;
+        even_re[k] += t_re;
+        even_im[k] += t_im;
+      }
+    }
+  }
+}
+
+// Bluestein's algorithm, using nk = (n^2 + k^2 - (k-n)^2) / 2:
+//   X[k] = c[k] * sum_n (x[n] * c[n]) * conj(c[k-n]),  where c[n] = exp(-pi*i*n^2/N)
+// The sum is a convolution, computed as a pointwise product of power-of-two transforms.
+template <typename T>
+void FftPlan<T>::Bluestein(T* real, T* imag) {
+  const size_t conv_size = conv_real_.size();
+  T* __restrict a_re = conv_real_.data();
+  T* __restrict a_im = conv_imag_.data();
+  const T* __restrict c_re = chirp_real_.data();
+  const T* __restrict c_im = chirp_imag_.data();
+
+  for (size_t n = 0; n < size_; ++n) {
+    a_re[n] = real[n] * c_re[n] - imag[n] * c_im[n];
+    a_im[n] = real[n] * c_im[n] + imag[n] * c_re[n];
+  }
+  std::fill(a_re + size_, a_re + conv_size, static_cast<T>(0));
+  std::fill(a_im + size_, a_im + conv_size, static_cast<T>(0));
+
+  convolution_plan_->Forward(a_re, a_im);
+
+  // Multiply by the (pre-scaled) filter spectrum, conjugating the product so that the following
+  // forward transform acts as an inverse transform (conj(DFT(conj(x))) == N * IDFT(x)).
+  const T* __restrict f_re = filter_real_.data();
+  const T* __restrict f_im = filter_imag_.data();
+  for (size_t k = 0; k < conv_size; ++k) {
+    const T p_re = a_re[k] * f_re[k] - a_im[k] * f_im[k];
+    const T p_im = a_re[k] * f_im[k] + a_im[k] * f_re[k];
+    a_re[k] = p_re;
+    a_im[k] = -p_im;
+  }
+
+  convolution_plan_->Forward(a_re, a_im);
+
+  // Undo the conjugation from above, and apply the output chirp.
+  for (size_t k = 0; k < size_; ++k) {
+    const T y_re = a_re[k];
+    const T y_im = -a_im[k];
+    real[k] = y_re * c_re[k] - y_im * c_im[k];
+    imag[k] = y_re * c_im[k] + y_im * c_re[k];
+  }
+}
+
+// For even N, pack z[n] = x[2n] + i*x[2n+1] and take its N/2-point transform Z. The transforms of
+// the even and odd samples are then
+//   E[k] = (Z[k] + conj(Z[N/2-k])) / 2
+//   O[k] = (Z[k] - conj(Z[N/2-k])) / 2i
+// and X[k] = E[k] + exp(-2*pi*i*k/N) * O[k], for k in [0, N/2].
+template <typename T>
+void FftPlan<T>::ForwardReal(const T* input, T* real_out, T* imag_out) {
+  FX_DCHECK(!real_scratch_.empty());
+  const size_t half = size_ / 2;
+
+  if (!half_plan_) {
+    for (size_t idx = 0; idx < size_; ++idx) {
+      real_scratch_[idx] = input[idx];
+      imag_scratch_[idx] = 0;
+    }
+    Forward(real_scratch_.data(), imag_scratch_.data());
+    std::copy(real_scratch_.begin(), real_scratch_.begin() + half + 1, real_out);
+    std::copy(imag_scratch_.begin(), imag_scratch_.begin() + half + 1, imag_out);
+    return;
+  }
+
+  T* __restrict z_re = real_scratch_.data();
+  T* __restrict z_im = imag_scratch_.data();
+  for (size_t n = 0; n < half; ++n) {
+    z_re[n] = input[2 * n];
+    z_im[n] = input[2 * n + 1];
+  }
+  half_plan_->Forward(z_re, z_im);
+
+  const T* __restrict w_re = split_real_.data();
+  const T* __restrict w_im = split_imag_.data();
+  for (size_t k = 0; k <= half; ++k) {
+    const size_t k1 = (k == half) ? 0 : k;
+    const size_t k2 = (k == 0) ? 0 : half - k;
+
+    const T e_re = static_cast<T>(0.5) * (z_re[k1] + z_re[k2]);
+    const T e_im = static_cast<T>(0.5) * (z_im[k1] - z_im[k2]);
+    const T o_re = static_cast<T>(0.5) * (z_im[k1] + z_im[k2]);
+    const T o_im = static_cast<T>(0.5) * (z_re[k2] - z_re[k1]);
+
+    real_out[k] = e_re + (o_re * w_re[k] - o_im * w_im[k]);
+    imag_out[k] = e_im + (o_re * w_im[k] + o_im * w_re[k]);
+  }
+}
+
+// Reverses ForwardReal's split step: with conj(X[N/2-k]) = E[k] - w^k * O[k],
+//   E[k] = (X[k] + conj(X[N/2-k])) / 2
+//   O[k] = (X[k] - conj(X[N/2-k])) * conj(w^k) / 2
+// then Z[k] = E[k] + i*O[k] is inverse-transformed and unpacked into even and odd samples.
+template <typename T>
+void FftPlan<T>::InverseReal(const T* real_in, const T* imag_in, T* output) {
+  FX_DCHECK(!real_scratch_.empty());
+  const size_t half = size_ / 2;
+
+  if (!half_plan_) {
+    // Rebuild the full conjugate-symmetric spectrum and do a complex inverse transform.
+    for (size_t k = 0; k <= half; ++k) {
+      real_scratch_[k] = real_in[k];
+      imag_scratch_[k] = (k == 0) ? 0 : imag_in[k];
+    }
+    for (size_t k = half + 1; k < size_; ++k) {
+      real_scratch_[k] = real_in[size_ - k];
+      imag_scratch_[k] = -imag_in[size_ - k];
+    }
+    Inverse(real_scratch_.data(), imag_scratch_.data());
+    std::copy(real_scratch_.begin(), real_scratch_.end(), output);
+    return;
+  }
+
+  T* __restrict z_re = real_scratch_.data();
+  T* __restrict z_im = imag_scratch_.data();
+  const T* __restrict w_re = split_real_.data();
+  const T* __restrict w_im = split_imag_.data();
+  for (size_t k = 0; k < half; ++k) {
+    const T x1_re = real_in[k];
+    const T x1_im = (k == 0) ? 0 : imag_in[k];
+    const T x2_re = real_in[half - k];
+    const T x2_im = (k == 0) ? 0 : -imag_in[half - k];  // conj(X[N/2-k])
+
+    const T e_re = static_cast<T>(0.5) * (x1_re + x2_re);
+    const T e_im = static_cast<T>(0.5) * (x1_im + x2_im);
+    const T d_re = static_cast<T>(0.5) * (x1_re - x2_re);
+    const T d_im = static_cast<T>(0.5) * (x1_im - x2_im);
+    const T o_re = d_re * w_re[k] + d_im * w_im[k];
+    const T o_im = d_im * w_re[k] - d_re * w_im[k];
+
+    z_re[k] = e_re - o_im;
+    z_im[k] = e_im + o_re;
+  }
+  half_plan_->Inverse(z_re, z_im);
+
+  for (size_t n = 0; n < half; ++n) {
+    output[2 * n] = z_re[n];
+    output[2 * n + 1] = z_im[n];
+  }
+}
+
+template class FftPlan<float>;
+template class FftPlan<double>;
+
+}  // namespace media::audio
@@ -0,0 +1,111 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SRC_MEDIA_AUDIO_LIB_ANALYSIS_FFT_H_
+#define SRC_MEDIA_AUDIO_LIB_ANALYSIS_FFT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace media::audio {
+
+// A precomputed plan for discrete Fourier transforms of a single, fixed size.
+//
+// All twiddle factors, bit-reversal permutations and scratch buffers are computed when the plan
+// is constructed, so the transforms themselves perform no allocation and no trigonometry. This
+// makes a plan suitable for use on real-time threads (e.g. within an effect's process call), as
+// long as the plan itself is constructed ahead of time.
+//
+// Any size is supported. Power-of-two sizes use an iterative radix-2 Cooley-Tukey transform; all
+// other sizes use Bluestein's algorithm, built on an internal power-of-two plan. Complex data is
+// represented as split arrays (real[] and imag[]) rather than interleaved pairs, so that each
+// butterfly stage is a set of unit-stride loops over contiguous data and twiddles. These loops
+// are written to be vectorized by the compiler, for both float and double.
+//
+// Transforms follow the usual (unnormalized forward, normalized inverse) convention:
+//   Forward:  X[k] = sum_n x[n] * exp(-2*pi*i*k*n/N)
+//   Inverse:  x[n] = (1/N) * sum_k X[k] * exp(2*pi*i*k*n/N)
+//
+// A plan holds mutable scratch memory, so it is not thread-safe. Threads that transform
+// concurrently should each use their own plan.
+template <typename T>
+class FftPlan {
+ public:
+  static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>,
+                "FftPlan supports only float and double");
+
+  // Creates a plan for transforms of |size| points. |size| must be greater than zero.
+  explicit FftPlan(size_t size) : FftPlan(size, true) {}
+  ~FftPlan();
+
+  FftPlan(const FftPlan&) = delete;
+  FftPlan& operator=(const FftPlan&) = delete;
+  FftPlan(FftPlan&&) = delete;
+  FftPlan& operator=(FftPlan&&) = delete;
+
+  size_t size() const { return size_; }
+
+  // In-place complex forward transform of |size()| points.
+  void Forward(T* real, T* imag);
+
+  // In-place complex inverse transform of |size()| points, including the 1/N normalization.
+  void Inverse(T* real, T* imag);
+
+  // Forward transform of |size()| real-valued points. Because the spectrum of real input is
+  // conjugate-symmetric, only bins [0, size()/2] are produced: |real_out| and |imag_out| must each
+  // hold |size()/2 + 1| values. For even sizes this costs about half of the complex transform.
+  void ForwardReal(const T* input, T* real_out, T* imag_out);
+
+  // Inverse of ForwardReal: reconstructs |size()| real-valued points from bins [0, size()/2],
+  // including the 1/N normalization. The imaginary parts of bin 0 (and of bin size()/2, for even
+  // sizes) are ignored, as they must be zero for any real-valued signal.
+  void InverseReal(const T* real_in, const T* imag_in, T* output);
+
+ private:
+  // Plans used internally (for Bluestein convolutions and packed real transforms) only need the
+  // complex transforms, so they skip building their own real-transform state.
+  FftPlan(size_t size, bool real_transforms);
+
+  void Radix2(T* real, T* imag) const;
+  void Bluestein(T* real, T* imag);
+
+  const size_t size_;
+  const bool is_power_of_two_;
+
+  // Radix-2 state: index pairs to swap for the bit-reversal permutation, and per-stage twiddles
+  // laid out contiguously (stage with half-length m occupies [m-1, 2m-1)).
+  std::vector<std::pair<uint32_t, uint32_t>> bit_reverse_swaps_;
+  std::vector<T> twiddle_real_;
+  std::vector<T> twiddle_imag_;
+
+  // Bluestein state: the chirp exp(-pi*i*n^2/N), the precomputed transform of the conjugate chirp
+  // filter, a power-of-two plan for the convolution and scratch space of that size.
+  std::vector<T> chirp_real_;
+  std::vector<T> chirp_imag_;
+  std::vector<T> filter_real_;
+  std::vector<T> filter_imag_;
+  std::unique_ptr<FftPlan<T>> convolution_plan_;
+  std::vector<T> conv_real_;
+  std::vector<T> conv_imag_;
+
+  // Real-transform state. For even sizes, the N real points are packed into N/2 complex points
+  // and transformed with |half_plan_|, then split using |split_real_|/|split_imag_| =
+  // exp(-2*pi*i*k/N). For odd sizes, |half_plan_| is unused and a full complex transform is done.
+  std::unique_ptr<FftPlan<T>> half_plan_;
+  std::vector<T> split_real_;
+  std::vector<T> split_imag_;
+  std::vector<T> real_scratch_;
+  std::vector<T> imag_scratch_;
+};
+
+extern template class FftPlan<float>;
+extern template class FftPlan<double>;
+
+}  // namespace media::audio
+
+#endif  // SRC_MEDIA_AUDIO_LIB_ANALYSIS_FFT_H_
@@ -0,0 +1,169 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/media/audio/lib/analysis/fft.h"
+
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace media::audio {
+namespace {
+
+// Deterministic, non-trivial input: a sum of incommensurate sinusoids plus a ramp.
+double TestSignal(size_t idx, double seed) {
+  const double x = static_cast<double>(idx);
+  return 0.5 * std::sin(0.37 * x + seed) + 0.25 * std::cos(1.91 * x - seed) + 0.001 * x;
+}
+
+// Naive O(N^2) reference DFT, in double regardless of the type under test.
+void ReferenceDFT(const std::vector<double>& in_real, const std::vector<double>& in_imag,
+                  std::vector<double>* out_real, std::vector<double>* out_imag) {
+  const size_t size = in_real.size();
+  out_real->assign(size, 0.0);
+  out_imag->assign(size, 0.0);
+  for (size_t k = 0; k < size; ++k) {
+    for (size_t n = 0; n < size; ++n) {
+      const double angle = -2.0 * M_PI * static_cast<double>((k * n) % size) /
+                           static_cast<double>(size);
+      (*out_real)[k] += in_real[n] * std::cos(angle) - in_imag[n] * std::sin(angle);
+      (*out_imag)[k] += in_real[n] * std::sin(angle) + in_imag[n] * std::cos(angle);
+    }
+  }
+}
+
+template <typename T>
+class FftPlanTest : public ::testing::Test {
+ protected:
+  // Float error grows with the magnitude of the bins (about N for this signal) and with log2(N).
+  static double Tolerance(size_t size) {
+    return (std::is_same_v<T, float> ? 1e-5 : 1e-12) * static_cast<double>(size);
+  }
+};
+
+using SampleTypes = ::testing::Types<float, double>;
+TYPED_TEST_SUITE(FftPlanTest, SampleTypes);
+
+// Power-of-two, odd, and even non-power-of-two sizes exercise each of the internal paths.
+constexpr size_t kSizes[] = {1, 2, 3, 4, 5, 8, 12, 16, 30, 64, 127, 441, 480, 1024};
+
+TYPED_TEST(FftPlanTest, ForwardMatchesReferenceDFT) {
+  for (auto size : kSizes) {
+    SCOPED_TRACE(testing::Message() << "size " << size);
+    std::vector<double> ref_in_real(size), ref_in_imag(size);
+    std::vector<TypeParam> real(size), imag(size);
+    for (size_t idx = 0; idx < size; ++idx) {
+      real[idx] = static_cast<TypeParam>(TestSignal(idx, 0.1));
+      imag[idx] = static_cast<TypeParam>(TestSignal(idx, 2.3));
+      ref_in_real[idx] = static_cast<double>(real[idx]);
+      ref_in_imag[idx] = static_cast<double>(imag[idx]);
+    }
+
+    std::vector<double> ref_real, ref_imag;
+    ReferenceDFT(ref_in_real, ref_in_imag, &ref_real, &ref_imag);
+
+    FftPlan<TypeParam> plan(size);
+    EXPECT_EQ(plan.size(), size);
+    plan.Forward(real.data(), imag.data());
+    for (size_t k = 0; k < size; ++k) {
+      EXPECT_NEAR(real[k], ref_real[k], this->Tolerance(size)) << "bin " << k;
+      EXPECT_NEAR(imag[k], ref_imag[k], this->Tolerance(size)) << "bin " << k;
+    }
+  }
+}
+
+TYPED_TEST(FftPlanTest, InverseRoundTrip) {
+  for (auto size : kSizes) {
+    SCOPED_TRACE(testing::Message() << "size " << size);
+    std::vector<TypeParam> real(size), imag(size);
+    for (size_t idx = 0; idx < size; ++idx) {
+      real[idx] = static_cast<TypeParam>(TestSignal(idx, 0.7));
+      imag[idx] = static_cast<TypeParam>(TestSignal(idx, 1.9));
+    }
+    const auto orig_real = real;
+    const auto orig_imag = imag;
+
+    FftPlan<TypeParam> plan(size);
+    plan.Forward(real.data(), imag.data());
+    plan.Inverse(real.data(), imag.data());
+    for (size_t idx = 0; idx < size; ++idx) {
+      EXPECT_NEAR(real[idx], orig_real[idx], this->Tolerance(size)) << idx;
+      EXPECT_NEAR(imag[idx], orig_imag[idx], this->Tolerance(size)) << idx;
+    }
+  }
+}
+
+TYPED_TEST(FftPlanTest, ForwardRealMatchesComplexForward) {
+  for (auto size : kSizes) {
+    SCOPED_TRACE(testing::Message() << "size " << size);
+    std::vector<TypeParam> input(size), real(size), imag(size, 0);
+    for (size_t idx = 0; idx < size; ++idx) {
+      input[idx] = static_cast<TypeParam>(TestSignal(idx, 0.4));
+      real[idx] = input[idx];
+    }
+
+    FftPlan<TypeParam> plan(size);
+    plan.Forward(real.data(), imag.data());
+
+    const size_t num_bins = size / 2 + 1;
+    std::vector<TypeParam> real_out(num_bins), imag_out(num_bins);
+    plan.ForwardReal(input.data(), real_out.data(), imag_out.data());
+    for (size_t k = 0; k < num_bins; ++k) {
+      EXPECT_NEAR(real_out[k], real[k], this->Tolerance(size)) << "bin " << k;
+      EXPECT_NEAR(imag_out[k], imag[k], this->Tolerance(size)) << "bin " << k;
+    }
+
+    std::vector<TypeParam> output(size);
+    plan.InverseReal(real_out.data(), imag_out.data(), output.data());
+    for (size_t idx = 0; idx < size; ++idx) {
+      EXPECT_NEAR(output[idx], input[idx], this->Tolerance(size)) << idx;
+    }
+  }
+}
+
+// A plan is reused across calls; results must not depend on earlier calls' scratch contents.
+TYPED_TEST(FftPlanTest, PlanIsReusable) {
+  constexpr size_t kSize = 30;
+  FftPlan<TypeParam> plan(kSize);
+
+  std::vector<TypeParam> input(kSize);
+  for (size_t idx = 0; idx < kSize; ++idx) {
+    input[idx] = static_cast<TypeParam>(TestSignal(idx, 1.1));
+  }
+  std::vector<TypeParam> first_real(kSize / 2 + 1), first_imag(kSize / 2 + 1);
+  plan.ForwardReal(input.data(), first_real.data(), first_imag.data());
+
+  std::vector<TypeParam> real(kSize, 1), imag(kSize, -1);
+  plan.Forward(real.data(), imag.data());
+
+  std::vector<TypeParam> second_real(kSize / 2 + 1), second_imag(kSize / 2 + 1);
+  plan.ForwardReal(input.data(), second_real.data(), second_imag.data());
+  EXPECT_EQ(first_real, second_real);
+  EXPECT_EQ(first_imag, second_imag);
+}
+
+// A cosine that fits exactly |freq| times into the buffer lands entirely in bin |freq|, even when
+// the buffer length is not a power of two (e.g. 10ms at 48kHz).
+TEST(FftPlan, CosineInNonPowerOfTwoBuffer) {
+  constexpr size_t kSize = 480;
+  constexpr size_t kFreq = 17;
+  std::vector<double> input(kSize);
+  for (size_t idx = 0; idx < kSize; ++idx) {
+    input[idx] = std::cos(2.0 * M_PI * static_cast<double>(kFreq * idx) / kSize);
+  }
+
+  FftPlan<double> plan(kSize);
+  std::vector<double> real(kSize / 2 + 1), imag(kSize / 2 + 1);
+  plan.ForwardReal(input.data(), real.data(), imag.data());
+  for (size_t k = 0; k <= kSize / 2; ++k) {
+    const double expect = (k == kFreq) ? kSize / 2.0 : 0.0;
+    EXPECT_NEAR(real[k], expect, 1e-9) << k;
+    EXPECT_NEAR(imag[k], 0.0, 1e-9) << k;
+  }
+}
+
+}  // namespace
+}  // namespace media::audio
@@ -0,0 +1,78 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/media/audio/services/mixer/tools/mixer_graph_benchmark/allocation_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<uint64_t> allocation_count{0};
+
+void* Allocate(size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  // operator new must return a unique pointer even for zero-byte requests.
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void* AllocateAligned(size_t size, std::align_val_t alignment) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  // aligned_alloc requires a size which is a non-zero multiple of the alignment.
+  const auto align = static_cast<size_t>(alignment);
+  return std::aligned_alloc(align, size == 0 ? align : (size + align - 1) / align * align);
+}
+
+// Exceptions are disabled, so allocation failures are fatal.
+void* CheckAllocation(void* ptr) {
+  if (!ptr) {
+    std::abort();
+  }
+  return ptr;
+}
+
+}  // namespace
+
+namespace media_audio {
+
+uint64_t AllocationCount() { return allocation_count.load(std::memory_order_relaxed); }
+
+}  // namespace media_audio
+
+void* operator new(size_t size) { return CheckAllocation(Allocate(size)); }
+void* operator new[](size_t size) { return CheckAllocation(Allocate(size)); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return Allocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return Allocate(size); }
+
+void* operator new(size_t size, std::align_val_t alignment) {
+  return CheckAllocation(AllocateAligned(size, alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+  return CheckAllocation(AllocateAligned(size, alignment));
+}
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  return AllocateAligned(size, alignment);
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  return AllocateAligned(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
@@ -0,0 +1,19 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SRC_MEDIA_AUDIO_SERVICES_MIXER_TOOLS_MIXER_GRAPH_BENCHMARK_ALLOCATION_COUNTER_H_
+#define SRC_MEDIA_AUDIO_SERVICES_MIXER_TOOLS_MIXER_GRAPH_BENCHMARK_ALLOCATION_COUNTER_H_
+
+#include <cstdint>
+
+namespace media_audio {
+
+// Reports how many times any thread in this process has called the global operator new. The count
+// is maintained by replacing the global operator new and operator delete, so it is only available
+// in executables which link allocation_counter.cc.
+uint64_t AllocationCount();
+
+}  // namespace media_audio
+
+#endif  // SRC_MEDIA_AUDIO_SERVICES_MIXER_TOOLS_MIXER_GRAPH_BENCHMARK_ALLOCATION_COUNTER_H_
@@ -0,0 +1,205 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <lib/syslog/cpp/log_settings.h>
+#include <lib/syslog/cpp/macros.h>
+
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <perftest/results.h>
+
+#include "src/lib/files/path.h"
+#include "src/lib/fxl/command_line.h"
+#include "src/lib/fxl/strings/split_string.h"
+#include "src/lib/fxl/strings/string_number_conversions.h"
+#include "src/media/audio/services/mixer/tools/mixer_graph_benchmark/mixer_graph_benchmark.h"
+
+using media_audio::MixerGraphBenchmark;
+
+namespace {
+
+struct Options {
+  std::vector<MixerGraphBenchmark::Scenario> scenarios;
+  MixerGraphBenchmark::Options benchmark;
+  std::optional<std::string> perftest_json;
+  bool hide_legend = false;
+};
+
+std::string ToString(const std::vector<MixerGraphBenchmark::Scenario>& scenarios) {
+  std::string out;
+  std::string sep;
+  for (auto& s : scenarios) {
+    out += sep + s.ToString();
+    sep = ",";
+  }
+  return out;
+}
+
+const Options kDefaultOptions = {
+    // Default to a range of mixer fan-in, plus the costlier samplers, effects, and splitters each
+    // applied to a mid-sized graph.
+    .scenarios =
+        {
+            MixerGraphBenchmark::Scenario::FromString("P1"),
+            MixerGraphBenchmark::Scenario::FromString("P4"),
+            MixerGraphBenchmark::Scenario::FromString("P16"),
+            MixerGraphBenchmark::Scenario::FromString("P4/R44100"),
+            MixerGraphBenchmark::Scenario::FromString("P4/sinc"),
+            MixerGraphBenchmark::Scenario::FromString("P4/E1"),
+            MixerGraphBenchmark::Scenario::FromString("P4/E2"),
+            MixerGraphBenchmark::Scenario::FromString("P4/S2"),
+        },
+
+    // Default to 10ms mix periods run 100x, for a total of 1s of audio per scenario, with half of
+    // each period budgeted for the mix thread.
+    .benchmark =
+        {
+            .mix_period = zx::msec(10),
+            .cpu_per_period = zx::msec(5),
+            .warmup_periods = 10,
+            .measured_periods = 100,
+        },
+};
+
+void Usage(const char* prog_name) {
+  printf("\nUsage: %s [--option] [...]\n", prog_name);
+  printf("Measure the performance of mix jobs in a mixer service graph.\n");
+  printf("\n");
+  printf("Valid options are:\n");
+  printf("\n");
+  printf("  --scenarios=<string>\n");
+  printf("    Run these scenarios. Comma-separated list of scenarios. For example,\n");
+  printf("    \"P4/sinc,P16/E1\" contains two scenarios: the first mixes four producers\n");
+  printf("    using sinc samplers, while the second mixes sixteen producers and passes\n");
+  printf("    the result through one effect. Defaults to: %s\n",
+         ToString(kDefaultOptions.scenarios).c_str());
+  printf("\n");
+  printf("  --periods-per-scenario=<count>\n");
+  printf("    Measure this many mix jobs per scenario (default: %ld).\n",
+         kDefaultOptions.benchmark.measured_periods);
+  printf("\n");
+  printf("  --warmup-periods=<count>\n");
+  printf("    Run this many unmeasured mix jobs before measuring a scenario (default: %ld).\n",
+         kDefaultOptions.benchmark.warmup_periods);
+  printf("\n");
+  printf("  --mix-period=<seconds>\n");
+  printf("    Length of each mix job (default: %.3f sec).\n",
+         static_cast<double>(kDefaultOptions.benchmark.mix_period.to_nsecs()) / 1e9);
+  printf("\n");
+  printf("  --cpu-per-period=<seconds>\n");
+  printf("    CPU budget of each mix job (default: half of the mix period).\n");
+  printf("\n");
+  printf("  --perftest-json=<filepath.json>\n");
+  printf("    Record perftest results to the specified json filepath.\n");
+  printf("\n");
+  printf("  --hide-legend\n");
+  printf("    Don't display a verbose explanation of scenario types and other details.\n");
+  printf("\n");
+  printf("  --help\n");
+  printf("    Display this message.\n");
+  printf("\n");
+}
+
+int64_t ParseCount(const fxl::CommandLine& command_line, const std::string& name) {
+  std::string str;
+  command_line.GetOptionValue(name, &str);
+  int64_t count;
+  FX_CHECK(fxl::StringToNumberWithError(str, &count) && count > 0)
+      << "--" << name << " must be a positive integer, got '" << str << "'";
+  return count;
+}
+
+zx::duration ParseSeconds(const fxl::CommandLine& command_line, const std::string& name) {
+  std::string str;
+  command_line.GetOptionValue(name, &str);
+  char* end = nullptr;
+  const double secs = std::strtod(str.c_str(), &end);
+  FX_CHECK(!str.empty() && *end == '\0' && secs > 0)
+      << "--" << name << " must be a positive number of seconds, got '" << str << "'";
+  return zx::nsec(static_cast<int64_t>(secs * 1e9));
+}
+
+Options ParseCommandLine(int argc, char** argv) {
+  auto command_line = fxl::CommandLineFromArgcArgv(argc, argv);
+  Options opts = kDefaultOptions;
+
+  if (command_line.HasOption("help")) {
+    Usage(argv[0]);
+    exit(0);
+  }
+
+  if (command_line.HasOption("scenarios")) {
+    std::string str;
+    command_line.GetOptionValue("scenarios", &str);
+    opts.scenarios.clear();
+    for (auto s : fxl::SplitStringCopy(str, ",", fxl::kTrimWhitespace, fxl::kSplitWantNonEmpty)) {
+      opts.scenarios.push_back(MixerGraphBenchmark::Scenario::FromString(s));
+    }
+  }
+
+  if (command_line.HasOption("periods-per-scenario")) {
+    opts.benchmark.measured_periods = ParseCount(command_line, "periods-per-scenario");
+  }
+
+  if (command_line.HasOption("warmup-periods")) {
+    opts.benchmark.warmup_periods = ParseCount(command_line, "warmup-periods");
+  }
+
+  if (command_line.HasOption("mix-period")) {
+    opts.benchmark.mix_period = ParseSeconds(command_line, "mix-period");
+    opts.benchmark.cpu_per_period = opts.benchmark.mix_period / 2;
+  }
+
+  if (command_line.HasOption("cpu-per-period")) {
+    opts.benchmark.cpu_per_period = ParseSeconds(command_line, "cpu-per-period");
+  }
+  FX_CHECK(opts.benchmark.cpu_per_period <= opts.benchmark.mix_period)
+      << "--cpu-per-period must not exceed --mix-period";
+
+  if (command_line.HasOption("perftest-json")) {
+    std::string json;
+    command_line.GetOptionValue("perftest-json", &json);
+    opts.perftest_json = json;
+  }
+
+  opts.hide_legend = command_line.HasOption("hide-legend");
+
+  return opts;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  // Rewrite the program name to be just the executable file, not the full path.
+  const std::string prog_name = files::GetBaseName(argv[0]);
+  syslog::SetTags({prog_name});
+
+  auto opts = ParseCommandLine(argc, argv);
+  printf("Audio mixer graph profiling tool\n");
+
+  std::optional<perftest::ResultsSet> results;
+  if (opts.perftest_json) {
+    results.emplace();
+  }
+
+  MixerGraphBenchmark benchmark;
+  if (!opts.hide_legend) {
+    benchmark.PrintLegend(opts.benchmark);
+  }
+
+  benchmark.PrintHeader();
+  for (auto& scenario : opts.scenarios) {
+    benchmark.Run(scenario, opts.benchmark, results ? &*results : nullptr);
+  }
+  benchmark.PrintHeader();
+
+  if (results) {
+    return results->WriteJSONFile(opts.perftest_json->c_str()) ? 0 : 1;
+  }
+
+  return 0;
+}
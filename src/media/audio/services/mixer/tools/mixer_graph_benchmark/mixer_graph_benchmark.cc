@@ -0,0 +1,530 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/media/audio/services/mixer/tools/mixer_graph_benchmark/mixer_graph_benchmark.h"
+
+#include <fidl/fuchsia.audio.effects/cpp/wire.h>
+#include <fidl/fuchsia.audio.mixer/cpp/wire.h>
+#include <lib/fidl/cpp/wire/client.h>
+#include <lib/syslog/cpp/macros.h>
+#include <lib/zx/process.h>
+#include <lib/zx/vmo.h>
+#include <zircon/syscalls/object.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "src/lib/fxl/strings/split_string.h"
+#include "src/lib/fxl/strings/string_number_conversions.h"
+#include "src/media/audio/lib/clock/synthetic_clock_realm.h"
+#include "src/media/audio/lib/format2/format.h"
+#include "src/media/audio/services/common/fidl_thread.h"
+#include "src/media/audio/services/mixer/common/basic_types.h"
+#include "src/media/audio/services/mixer/fidl/clock_registry.h"
+#include "src/media/audio/services/mixer/fidl/graph_server.h"
+#include "src/media/audio/services/mixer/fidl/synthetic_clock_factory.h"
+#include "src/media/audio/services/mixer/tools/mixer_graph_benchmark/allocation_counter.h"
+
+namespace media_audio {
+namespace {
+
+using ::fuchsia_media2::wire::RealTime;
+using ::fuchsia_media2::wire::StreamTime;
+
+// The mixer, the effects, the splitter and every consumer use this format.
+const Format kDestFormat = Format::CreateOrDie({
+    .sample_type = ::fuchsia_audio::SampleType::kFloat32,
+    .channels = 2,
+    .frames_per_second = 48000,
+});
+
+// Start calls complete from mix jobs. If they haven't all completed after this many mix periods,
+// the graph is not running.
+constexpr int64_t kMaxStartupPeriods = 100;
+
+double to_usecs(zx::duration duration) { return static_cast<double>(duration.to_nsecs()) / 1000.0; }
+
+// Reports CPU time used by all threads in this process. During a mix job, the only threads with
+// work to do are the mix thread and, for scenarios with effects, the thread serving those effects.
+zx::duration ProcessCpuTime() {
+  zx_info_task_runtime_t info;
+  if (auto status = zx::process::self()->get_info(ZX_INFO_TASK_RUNTIME, &info, sizeof(info),
+                                                  nullptr, nullptr);
+      status != ZX_OK) {
+    FX_PLOGS(FATAL, status) << "zx::process::get_info(ZX_INFO_TASK_RUNTIME) failed";
+  }
+  return zx::nsec(info.cpu_time);
+}
+
+zx::vmo MakeVmo(uint64_t size) {
+  zx::vmo vmo;
+  if (auto status = zx::vmo::create(size, 0, &vmo); status != ZX_OK) {
+    FX_PLOGS(FATAL, status) << "zx::vmo::create failed";
+  }
+  return vmo;
+}
+
+template <typename ResultT>
+auto& ValueOrDie(ResultT& result, std::string_view method) {
+  FX_CHECK(result.ok()) << method << " failed: " << result.status_string();
+  FX_CHECK(!result->is_error()) << method << " failed with error "
+                                << static_cast<uint32_t>(result->error_value());
+  return *result->value();
+}
+
+template <typename T>
+T PercentileFromSorted(const std::vector<T>& sorted, int percentile) {
+  const auto k = static_cast<size_t>(std::round(static_cast<double>(percentile) / 100.0 *
+                                                static_cast<double>(sorted.size() - 1)));
+  return sorted[k];
+}
+
+// Serves fuchsia.audio.effects.Processor, leaving its in-place buffer unchanged. This stands in for
+// an out-of-process effect: CustomStage still makes one synchronous call per block of frames, but
+// the effect itself does no work.
+class PassthroughProcessor : public fidl::WireServer<fuchsia_audio_effects::Processor> {
+ public:
+  void Process(ProcessRequestView request, ProcessCompleter::Sync& completer) final {
+    completer.ReplySuccess(fidl::VectorView<fuchsia_audio_effects::wire::ProcessMetrics>());
+  }
+};
+
+// A GraphServer running in a SyntheticClockRealm, plus a client connection to that server. Mix
+// jobs run only when the realm advances.
+class SyntheticGraph {
+ public:
+  explicit SyntheticGraph(const MixerGraphBenchmark::Options& options)
+      : mix_period_(options.mix_period) {
+    registry_->Add(clock_);
+
+    auto endpoints = fidl::CreateEndpoints<fuchsia_audio_mixer::Graph>();
+    FX_CHECK(endpoints.is_ok()) << endpoints.status_string();
+    server_ = GraphServer::Create(FidlThread::CreateFromNewThread("MixerGraphBenchmarkFidlThread"),
+                                  std::move(endpoints->server),
+                                  GraphServer::Args{
+                                      .name = "MixerGraphBenchmark",
+                                      .clock_factory = std::make_shared<SyntheticClockFactory>(realm_),
+                                      .clock_registry = registry_,
+                                  });
+    client_.Bind(std::move(endpoints->client), client_thread_->dispatcher());
+
+    fidl::Arena arena;
+    auto result = client_.sync()->CreateThread(
+        fuchsia_audio_mixer::wire::GraphCreateThreadRequest::Builder(arena)
+            .name(fidl::StringView::FromExternal("MixerGraphBenchmarkMixThread"))
+            .period(options.mix_period.to_nsecs())
+            .cpu_per_period(options.cpu_per_period.to_nsecs())
+            .Build());
+    thread_id_ = ValueOrDie(result, "CreateThread").id();
+  }
+
+  ~SyntheticGraph() {
+    // Mix threads shut down asynchronously after the server shuts down, but they can't observe
+    // that request until the realm advances.
+    client_.AsyncTeardown();
+    FX_CHECK(server_->WaitForShutdown(zx::sec(5)));
+    realm_->AdvanceTo(realm_->now());
+  }
+
+  SyntheticGraph(const SyntheticGraph&) = delete;
+  SyntheticGraph& operator=(const SyntheticGraph&) = delete;
+
+  NodeId CreateProducer(int64_t frames_per_second) {
+    const auto format = Format::CreateOrDie({
+        .sample_type = ::fuchsia_audio::SampleType::kFloat32,
+        .channels = kDestFormat.channels(),
+        .frames_per_second = frames_per_second,
+    });
+
+    fidl::Arena arena;
+    auto result = client_.sync()->CreateProducer(
+        fuchsia_audio_mixer::wire::GraphCreateProducerRequest::Builder(arena)
+            .name(fidl::StringView::FromExternal("Producer"))
+            .direction(PipelineDirection::kOutput)
+            .data_source(fuchsia_audio_mixer::wire::ProducerDataSource::WithRingBuffer(
+                arena, MakeRingBuffer(arena, format, /*fill_with_sine=*/true)))
+            .Build());
+    return ValueOrDie(result, "CreateProducer").id();
+  }
+
+  NodeId CreateMixer() {
+    fidl::Arena arena;
+    auto result = client_.sync()->CreateMixer(
+        fuchsia_audio_mixer::wire::GraphCreateMixerRequest::Builder(arena)
+            .name(fidl::StringView::FromExternal("Mixer"))
+            .direction(PipelineDirection::kOutput)
+            .dest_format(kDestFormat.ToWireFidl(arena))
+            .dest_reference_clock(MakeReferenceClock(arena))
+            .dest_buffer_frame_count(kDestFormat.integer_frames_per(mix_period_))
+            .Build());
+    return ValueOrDie(result, "CreateMixer").id();
+  }
+
+  // Returns the IDs of the effect's child source and child destination nodes.
+  std::pair<NodeId, NodeId> CreateEffect() {
+    // The effect processes in place, one mix period per call.
+    const int64_t frames = kDestFormat.integer_frames_per(mix_period_);
+    const uint64_t bytes = static_cast<uint64_t>(frames * kDestFormat.bytes_per_frame());
+    auto input_vmo = MakeVmo(bytes);
+    zx::vmo output_vmo;
+    if (auto status = input_vmo.duplicate(ZX_RIGHT_SAME_RIGHTS, &output_vmo); status != ZX_OK) {
+      FX_PLOGS(FATAL, status) << "zx::vmo::duplicate failed";
+    }
+
+    auto processor_endpoints = fidl::CreateEndpoints<fuchsia_audio_effects::Processor>();
+    FX_CHECK(processor_endpoints.is_ok()) << processor_endpoints.status_string();
+    fidl::BindServer(client_thread_->dispatcher(), std::move(processor_endpoints->server),
+                     std::make_unique<PassthroughProcessor>());
+
+    fidl::Arena arena;
+    fidl::VectorView<fuchsia_audio_effects::wire::InputConfiguration> inputs(arena, 1);
+    inputs.at(0) = fuchsia_audio_effects::wire::InputConfiguration::Builder(arena)
+                       .buffer(fuchsia_mem::wire::Range{
+                           .vmo = std::move(input_vmo), .offset = 0, .size = bytes})
+                       .format(kDestFormat.ToLegacyFidl())
+                       .Build();
+    fidl::VectorView<fuchsia_audio_effects::wire::OutputConfiguration> outputs(arena, 1);
+    outputs.at(0) = fuchsia_audio_effects::wire::OutputConfiguration::Builder(arena)
+                        .buffer(fuchsia_mem::wire::Range{
+                            .vmo = std::move(output_vmo), .offset = 0, .size = bytes})
+                        .format(kDestFormat.ToLegacyFidl())
+                        .latency_frames(0)
+                        .ring_out_frames(0)
+                        .Build();
+
+    auto result = client_.sync()->CreateCustom(
+        fuchsia_audio_mixer::wire::GraphCreateCustomRequest::Builder(arena)
+            .name(fidl::StringView::FromExternal("Effect"))
+            .direction(PipelineDirection::kOutput)
+            .reference_clock(MakeReferenceClock(arena))
+            .config(fuchsia_audio_effects::wire::ProcessorConfiguration::Builder(arena)
+                        .block_size_frames(1)
+                        .max_frames_per_call(static_cast<uint64_t>(frames))
+                        .inputs(inputs)
+                        .outputs(outputs)
+                        .processor(std::move(processor_endpoints->client))
+                        .Build())
+            .Build());
+    auto& properties = ValueOrDie(result, "CreateCustom").node_properties();
+    return {properties.source_ids()[0], properties.dest_ids()[0]};
+  }
+
+  NodeId CreateSplitter() {
+    fidl::Arena arena;
+    auto result = client_.sync()->CreateSplitter(
+        fuchsia_audio_mixer::wire::GraphCreateSplitterRequest::Builder(arena)
+            .name(fidl::StringView::FromExternal("Splitter"))
+            .direction(PipelineDirection::kOutput)
+            .format(kDestFormat.ToWireFidl(arena))
+            .thread(thread_id_)
+            .reference_clock(MakeReferenceClock(arena))
+            .Build());
+    return ValueOrDie(result, "CreateSplitter").id();
+  }
+
+  NodeId CreateConsumer() {
+    fidl::Arena arena;
+    auto result = client_.sync()->CreateConsumer(
+        fuchsia_audio_mixer::wire::GraphCreateConsumerRequest::Builder(arena)
+            .name(fidl::StringView::FromExternal("Consumer"))
+            .direction(PipelineDirection::kOutput)
+            .data_sink(fuchsia_audio_mixer::wire::ConsumerDataSink::WithRingBuffer(
+                arena, MakeRingBuffer(arena, kDestFormat, /*fill_with_sine=*/false)))
+            .thread(thread_id_)
+            .external_delay_watcher(fuchsia_audio_mixer::wire::ExternalDelayWatcher::Builder(arena)
+                                        .initial_delay(0)
+                                        .Build())
+            .Build());
+    return ValueOrDie(result, "CreateConsumer").id();
+  }
+
+  void CreateEdge(NodeId source_id, NodeId dest_id, bool sinc_sampler = false) {
+    fidl::Arena arena;
+    auto builder = fuchsia_audio_mixer::wire::GraphCreateEdgeRequest::Builder(arena);
+    builder.source_id(source_id);
+    builder.dest_id(dest_id);
+    if (sinc_sampler) {
+      builder.mixer_sampler(fuchsia_audio_mixer::wire::Sampler::WithSincSampler(
+          arena, fuchsia_audio_mixer::wire::SincSampler::Builder(arena).Build()));
+    }
+    auto result = client_.sync()->CreateEdge(builder.Build());
+    ValueOrDie(result, "CreateEdge");
+  }
+
+  // Starts a producer or consumer. Start completes during a mix job, so this doesn't wait for a
+  // response. Use `AdvanceUntilStarted` to wait for all pending Start calls.
+  void Start(NodeId node_id) {
+    ++pending_starts_;
+    fidl::Arena arena;
+    client_
+        ->Start(fuchsia_audio_mixer::wire::GraphStartRequest::Builder(arena)
+                    .node_id(node_id)
+                    .when(RealTime::WithSystemTime(arena, realm_->now().get()))
+                    .stream_time(StreamTime::WithStreamTime(arena, 0))
+                    .Build())
+        .Then([this](fidl::WireUnownedResult<fuchsia_audio_mixer::Graph::Start>& result) {
+          ValueOrDie(result, "Start");
+          --pending_starts_;
+        });
+  }
+
+  // Runs mix jobs until all pending Start calls have completed.
+  void AdvanceUntilStarted() {
+    for (int64_t k = 0; pending_starts_ > 0; k++) {
+      FX_CHECK(k < kMaxStartupPeriods) << pending_starts_ << " Start calls did not complete";
+      AdvanceOnePeriod();
+    }
+  }
+
+  // Runs exactly one mix job.
+  void AdvanceOnePeriod() { realm_->AdvanceBy(mix_period_); }
+
+ private:
+  // Every node uses the same clock, so no mix job spends time on clock synchronization.
+  fuchsia_audio_mixer::wire::ReferenceClock MakeReferenceClock(fidl::AnyArena& arena) {
+    return fuchsia_audio_mixer::wire::ReferenceClock::Builder(arena)
+        .handle(clock_->DuplicateZxClockUnreadable())
+        .domain(Clock::kMonotonicDomain)
+        .Build();
+  }
+
+  // The buffer is split evenly between producer and consumer, two mix periods each. This is the
+  // smallest producer partition that CreateConsumer accepts.
+  fuchsia_audio::wire::RingBuffer MakeRingBuffer(fidl::AnyArena& arena, const Format& format,
+                                                 bool fill_with_sine) {
+    const int64_t half_frames = format.integer_frames_per(2 * mix_period_);
+    const auto half_bytes = static_cast<uint64_t>(half_frames * format.bytes_per_frame());
+    auto vmo = MakeVmo(2 * half_bytes);
+
+    if (fill_with_sine) {
+      // A 1kHz sine, so the mixer's inputs are never silent.
+      const auto channels = static_cast<size_t>(format.channels());
+      std::vector<float> samples(static_cast<size_t>(2 * half_frames) * channels);
+      for (size_t k = 0; k < samples.size(); k++) {
+        const auto frame = static_cast<double>(k / channels);
+        samples[k] = static_cast<float>(
+            0.5 * std::sin(2.0 * M_PI * 1000.0 * frame /
+                           static_cast<double>(format.frames_per_second())));
+      }
+      if (auto status = vmo.write(samples.data(), 0, samples.size() * sizeof(float));
+          status != ZX_OK) {
+        FX_PLOGS(FATAL, status) << "zx::vmo::write failed";
+      }
+    }
+
+    return fuchsia_audio::wire::RingBuffer::Builder(arena)
+        .buffer(fuchsia_mem::wire::Buffer{.vmo = std::move(vmo), .size = 2 * half_bytes})
+        .format(format.ToWireFidl(arena))
+        .producer_bytes(half_bytes)
+        .consumer_bytes(half_bytes)
+        .reference_clock(clock_->DuplicateZxClockUnreadable())
+        .reference_clock_domain(Clock::kMonotonicDomain)
+        .Build();
+  }
+
+  const zx::duration mix_period_;
+  const std::shared_ptr<SyntheticClockRealm> realm_ = SyntheticClockRealm::Create();
+  const std::shared_ptr<SyntheticClock> clock_ =
+      realm_->CreateClock("ReferenceClock", Clock::kMonotonicDomain, /*adjustable=*/false);
+  const std::shared_ptr<ClockRegistry> registry_ = std::make_shared<ClockRegistry>();
+
+  // Serves client-side callbacks and the effect processors.
+  const std::shared_ptr<FidlThread> client_thread_ =
+      FidlThread::CreateFromNewThread("MixerGraphBenchmarkClientThread");
+
+  std::shared_ptr<GraphServer> server_;
+  fidl::WireSharedClient<fuchsia_audio_mixer::Graph> client_;
+  ThreadId thread_id_;
+  std::atomic<int64_t> pending_starts_ = 0;
+};
+
+}  // namespace
+
+std::string MixerGraphBenchmark::Scenario::ToString() const {
+  std::string out = "P" + std::to_string(num_producers);
+  if (producer_frames_per_second != kDestFormat.frames_per_second()) {
+    out += "/R" + std::to_string(producer_frames_per_second);
+  }
+  if (force_sinc_sampler) {
+    out += "/sinc";
+  }
+  if (num_effects > 0) {
+    out += "/E" + std::to_string(num_effects);
+  }
+  if (num_splitter_outputs > 0) {
+    out += "/S" + std::to_string(num_splitter_outputs);
+  }
+  return out;
+}
+
+MixerGraphBenchmark::Scenario MixerGraphBenchmark::Scenario::FromString(const std::string& str) {
+  Scenario s;
+  bool has_producers = false;
+  for (auto field : fxl::SplitString(str, "/", fxl::kTrimWhitespace, fxl::kSplitWantNonEmpty)) {
+    if (field == "sinc") {
+      s.force_sinc_sampler = true;
+      continue;
+    }
+
+    int64_t value;
+    FX_CHECK(fxl::StringToNumberWithError(field.substr(1), &value))
+        << "Scenario '" << str << "' has malformed field '" << field << "'";
+    switch (field[0]) {
+      case 'P':
+        FX_CHECK(value > 0) << "Scenario '" << str << "' must have at least one producer";
+        s.num_producers = value;
+        has_producers = true;
+        break;
+      case 'R':
+        FX_CHECK(value > 0) << "Scenario '" << str << "' has invalid frame rate";
+        s.producer_frames_per_second = value;
+        break;
+      case 'E':
+        FX_CHECK(value >= 0) << "Scenario '" << str << "' has invalid effect count";
+        s.num_effects = value;
+        break;
+      case 'S':
+        FX_CHECK(value >= 0) << "Scenario '" << str << "' has invalid splitter output count";
+        s.num_splitter_outputs = value;
+        break;
+      default:
+        FX_CHECK(false) << "Scenario '" << str << "' has unknown field '" << field << "'";
+        __builtin_unreachable();
+    }
+  }
+  FX_CHECK(has_producers) << "Scenario '" << str << "' is missing a producer count";
+  return s;
+}
+
+void MixerGraphBenchmark::PrintLegend(const Options& options) {
+  printf(
+      "\n"
+      "    Each scenario runs %ld mix jobs of %.2f ms each, after %ld warmup jobs.\n"
+      "    The mix thread has a budget of %.2f ms CPU per job.\n"
+      "\n"
+      "    For each scenario we report:\n"
+      "\n"
+      "        cpu = CPU time used by this process per mix job, in microseconds\n"
+      "              (min, 10pp, 50pp, 90pp, max)\n"
+      "        allocs = heap allocations per mix job (mean, max)\n"
+      "        missed = jobs whose CPU time exceeded the budget (count, percent)\n"
+      "\n"
+      "    All clocks and timers are synthetic, so jobs never miss deadlines\n"
+      "    in wall time; a 'missed' job would miss its deadline on a real\n"
+      "    device with the same CPU budget.\n"
+      "\n"
+      "    A scenario has the form P<n>[/R<fps>][/sinc][/E<n>][/S<n>], where:\n"
+      "\n"
+      "        P<n>: n producers, each mixed into a single %ld Hz mixer\n"
+      "        R<fps>: producer frame rate (default: %ld)\n"
+      "        sinc: always use a SincSampler (default: the mixer picks a sampler)\n"
+      "        E<n>: n passthrough out-of-process effects after the mixer\n"
+      "        S<n>: a splitter after the mixer and effects, with n consumers\n"
+      "              (default: no splitter and one consumer)\n"
+      "\n",
+      options.measured_periods, static_cast<double>(options.mix_period.to_nsecs()) / 1e6,
+      options.warmup_periods, static_cast<double>(options.cpu_per_period.to_nsecs()) / 1e6,
+      kDestFormat.frames_per_second(), kDestFormat.frames_per_second());
+}
+
+void MixerGraphBenchmark::PrintHeader() {
+  printf("%-24s %10s %10s %10s %10s %10s %10s %8s %8s %8s\n", "scenario", "cpu:min", "10%", "50%",
+         "90%", "max", "allocs", "max", "missed", "%");
+}
+
+void MixerGraphBenchmark::Run(const Scenario& scenario, const Options& options,
+                              perftest::ResultsSet* results) {
+  SyntheticGraph graph(options);
+
+  // Build the graph from the bottom up.
+  std::vector<NodeId> consumers;
+  for (int64_t k = 0; k < std::max<int64_t>(scenario.num_splitter_outputs, 1); k++) {
+    consumers.push_back(graph.CreateConsumer());
+  }
+  NodeId last = graph.CreateMixer();
+  const NodeId mixer = last;
+  for (int64_t k = 0; k < scenario.num_effects; k++) {
+    auto [effect_source, effect_dest] = graph.CreateEffect();
+    graph.CreateEdge(last, effect_source);
+    last = effect_dest;
+  }
+  if (scenario.num_splitter_outputs > 0) {
+    const NodeId splitter = graph.CreateSplitter();
+    graph.CreateEdge(last, splitter);
+    last = splitter;
+  }
+  for (auto consumer : consumers) {
+    graph.CreateEdge(last, consumer);
+  }
+
+  std::vector<NodeId> producers;
+  for (int64_t k = 0; k < scenario.num_producers; k++) {
+    producers.push_back(graph.CreateProducer(scenario.producer_frames_per_second));
+    graph.CreateEdge(producers.back(), mixer, scenario.force_sinc_sampler);
+  }
+
+  for (auto consumer : consumers) {
+    graph.Start(consumer);
+  }
+  for (auto producer : producers) {
+    graph.Start(producer);
+  }
+  graph.AdvanceUntilStarted();
+
+  for (int64_t k = 0; k < options.warmup_periods; k++) {
+    graph.AdvanceOnePeriod();
+  }
+
+  std::vector<zx::duration> cpu_times;
+  std::vector<uint64_t> allocations;
+  cpu_times.reserve(static_cast<size_t>(options.measured_periods));
+  allocations.reserve(static_cast<size_t>(options.measured_periods));
+  for (int64_t k = 0; k < options.measured_periods; k++) {
+    const auto cpu_start = ProcessCpuTime();
+    const auto allocations_start = AllocationCount();
+    graph.AdvanceOnePeriod();
+    cpu_times.push_back(ProcessCpuTime() - cpu_start);
+    allocations.push_back(AllocationCount() - allocations_start);
+  }
+
+  const auto missed = std::count_if(cpu_times.begin(), cpu_times.end(), [&options](auto t) {
+    return t > options.cpu_per_period;
+  });
+
+  if (results) {
+    const auto name = scenario.ToString();
+    auto cpu_result =
+        results->AddTestCase("fuchsia.audio.mixer_graph", name + "/cpu", "nanoseconds");
+    auto allocations_result =
+        results->AddTestCase("fuchsia.audio.mixer_graph", name + "/allocations", "count");
+    for (size_t k = 0; k < cpu_times.size(); k++) {
+      cpu_result->AppendValue(static_cast<double>(cpu_times[k].to_nsecs()));
+      allocations_result->AppendValue(static_cast<double>(allocations[k]));
+    }
+    results->AddTestCase("fuchsia.audio.mixer_graph", name + "/missed_deadlines", "count")
+        ->AppendValue(static_cast<double>(missed));
+  }
+
+  std::sort(cpu_times.begin(), cpu_times.end());
+  uint64_t total_allocations = 0;
+  for (auto n : allocations) {
+    total_allocations += n;
+  }
+  printf("%-24s %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f %8lu %8ld %8.2f\n",
+         scenario.ToString().c_str(), to_usecs(cpu_times.front()),
+         to_usecs(PercentileFromSorted(cpu_times, 10)),
+         to_usecs(PercentileFromSorted(cpu_times, 50)),
+         to_usecs(PercentileFromSorted(cpu_times, 90)), to_usecs(cpu_times.back()),
+         static_cast<double>(total_allocations) / static_cast<double>(allocations.size()),
+         *std::max_element(allocations.begin(), allocations.end()), missed,
+         100.0 * static_cast<double>(missed) / static_cast<double>(cpu_times.size()));
+}
+
+}  // namespace media_audio
@@ -0,0 +1,66 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SRC_MEDIA_AUDIO_SERVICES_MIXER_TOOLS_MIXER_GRAPH_BENCHMARK_MIXER_GRAPH_BENCHMARK_H_
+#define SRC_MEDIA_AUDIO_SERVICES_MIXER_TOOLS_MIXER_GRAPH_BENCHMARK_MIXER_GRAPH_BENCHMARK_H_
+
+#include <lib/zx/time.h>
+
+#include <string>
+
+#include <perftest/results.h>
+
+namespace media_audio {
+
+// Measures mix jobs of a mixer service graph. Each scenario builds a fresh graph through the
+// fuchsia.audio.mixer.Graph protocol, served by an in-process GraphServer whose clocks and timers
+// belong to a SyntheticClockRealm. The benchmark advances the realm one mix period at a time, so
+// each step runs exactly one mix job regardless of how fast or slow this machine is.
+class MixerGraphBenchmark {
+ public:
+  // Describes the topology of a graph:
+  //
+  // ```
+  //   P_1 ... P_N   // producers, each reading a looping ring buffer
+  //     \  |  /
+  //      mixer
+  //        |
+  //       E_1       // optional passthrough effects, each a CustomNode
+  //        |
+  //       ...
+  //        |
+  //    [splitter]   // optional, with one output per consumer
+  //     /  |  \
+  //   C_1 ... C_M   // ring buffer consumers, all on the same mix thread
+  // ```
+  struct Scenario {
+    int64_t num_producers = 1;
+    int64_t producer_frames_per_second = 48000;
+    bool force_sinc_sampler = false;  // otherwise the mixer picks a sampler based on frame rate
+    int64_t num_effects = 0;
+    int64_t num_splitter_outputs = 0;  // if zero, there is no splitter and one consumer
+
+    std::string ToString() const;
+    static Scenario FromString(const std::string& str);
+  };
+
+  struct Options {
+    zx::duration mix_period;
+    zx::duration cpu_per_period;
+    int64_t warmup_periods;
+    int64_t measured_periods;
+  };
+
+  void PrintLegend(const Options& options);
+  void PrintHeader();
+
+  // Builds the graph for `scenario`, starts it, then runs `options.warmup_periods` followed by
+  // `options.measured_periods` mix jobs. If `results` is not null, per-job results are appended to
+  // it.
+  void Run(const Scenario& scenario, const Options& options, perftest::ResultsSet* results);
+};
+
+}  // namespace media_audio
+
+#endif  // SRC_MEDIA_AUDIO_SERVICES_MIXER_TOOLS_MIXER_GRAPH_BENCHMARK_MIXER_GRAPH_BENCHMARK_H_
@@ -8,10 +8,12 @@
 
 ChunkInputStream::ChunkInputStream(size_t chunk_size,
                                    TimestampExtrapolator&& timestamp_extrapolator,
-                                   InputBlockProcessor&& input_block_processor)
+                                   InputBlockProcessor&& input_block_processor,
+                                   CopyStats* copy_stats)
     : chunk_size_(chunk_size),
       timestamp_extrapolator_(std::move(timestamp_extrapolator)),
-      input_block_processor_(std::move(input_block_processor)) {
+      input_block_processor_(std::move(input_block_processor)),
+      copy_stats_(copy_stats) {
   ZX_DEBUG_ASSERT_MSG(chunk_size_ != 0, "A chunk size of zero will never make progress.");
   ZX_DEBUG_ASSERT(input_block_processor_);
   scratch_block_.data.resize(chunk_size_);
@@ -59,6 +61,9 @@ ChunkInputStream::Status ChunkInputStream::ProcessInputPacket(
     }
 
     input_packet.offset += chunk_size_;
+    if (copy_stats_) {
+      copy_stats_->AddInput(chunk_size_, /*copied=*/false);
+    }
   }
 
   AppendToScratchBlock(&input_packet);
@@ -91,6 +96,9 @@ void ChunkInputStream::AppendToScratchBlock(InputPacket* input_packet) {
   memcpy(scratch_block_.empty_start(), input_packet->data_at_offset(), n);
   input_packet->offset += n;
   scratch_block_.len += n;
+  if (copy_stats_) {
+    copy_stats_->AddInput(n, /*copied=*/true);
+  }
 }
 
 ChunkInputStream::Status ChunkInputStream::EmitBlock(const uint8_t* data,
@@ -12,6 +12,7 @@
 #include <optional>
 #include <vector>
 
+#include "copy_stats.h"
 #include "timestamp_extrapolator.h"
 
 // A chunk iterator for a stream of input packets. Provides fixed size input
@@ -22,6 +23,10 @@
 // `ChunkInputStream` will extrapolate timestamps with the provided extrapolator
 // if the input packet's timestamp does not align with the block size. See
 // `TimestampExtrapolator` for extrapolation semantics.
+//
+// Blocks that lie entirely within one input packet are emitted in place,
+// pointing into the client's input buffer. Only bytes that straddle packet
+// boundaries are copied into the scratch block.
 class ChunkInputStream {
  public:
   struct InputBlock {
@@ -60,8 +65,10 @@ class ChunkInputStream {
 
   using InputBlockProcessor = fit::function<ControlFlow(const InputBlock input_block)>;
 
+  // If `copy_stats` is provided, every input byte is counted there as either
+  // consumed in place or copied. It must outlive this instance.
   ChunkInputStream(size_t chunk_size, TimestampExtrapolator&& timestamp_extrapolator,
-                   InputBlockProcessor&& input_block_processor);
+                   InputBlockProcessor&& input_block_processor, CopyStats* copy_stats = nullptr);
 
   // Adds a new input packet to the input stream and executes
   // `input_block_processor` for all the newly available input blocks (which may
@@ -130,6 +137,7 @@ class ChunkInputStream {
   const size_t chunk_size_ = 0;
   TimestampExtrapolator timestamp_extrapolator_;
   const InputBlockProcessor input_block_processor_ = nullptr;
+  CopyStats* const copy_stats_ = nullptr;
 
   // The next output timestamp we will attach when emitting a block.
   std::optional<uint64_t> next_output_timestamp_;
@@ -0,0 +1,59 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SRC_MEDIA_CODEC_CODECS_COPY_STATS_H_
+#define SRC_MEDIA_CODEC_CODECS_COPY_STATS_H_
+
+#include <lib/trace/event.h>
+
+#include <atomic>
+#include <cstdint>
+
+// Counts the bytes a software codec consumed from (or produced into) client buffers in place,
+// versus the bytes it had to copy through an intermediate buffer first.
+//
+// Counts are accumulated on the codec's input processing thread and exported as a per-instance
+// "codec_runner" trace counter, so copy overhead can be compared across codecs and streams.
+class CopyStats {
+ public:
+  void AddInput(uint64_t bytes, bool copied) {
+    (copied ? input_bytes_copied_ : input_bytes_in_place_) += bytes;
+  }
+  void AddOutput(uint64_t bytes, bool copied) {
+    (copied ? output_bytes_copied_ : output_bytes_in_place_) += bytes;
+  }
+
+  uint64_t input_bytes_in_place() const { return input_bytes_in_place_; }
+  uint64_t input_bytes_copied() const { return input_bytes_copied_; }
+  uint64_t output_bytes_in_place() const { return output_bytes_in_place_; }
+  uint64_t output_bytes_copied() const { return output_bytes_copied_; }
+
+  // Clears the counts, keeping this instance's trace counter id.
+  void Reset() {
+    input_bytes_in_place_ = 0;
+    input_bytes_copied_ = 0;
+    output_bytes_in_place_ = 0;
+    output_bytes_copied_ = 0;
+  }
+
+  // Emits the current counts as the "Media:CopyStats" trace counter.
+  void Trace() const {
+    TRACE_COUNTER("codec_runner", "Media:CopyStats", trace_counter_id_, "input_bytes_in_place",
+                  input_bytes_in_place_, "input_bytes_copied", input_bytes_copied_,
+                  "output_bytes_in_place", output_bytes_in_place_, "output_bytes_copied",
+                  output_bytes_copied_);
+  }
+
+ private:
+  static inline std::atomic<trace_counter_id_t> next_trace_counter_id_ = 0;
+
+  uint64_t input_bytes_in_place_ = 0;
+  uint64_t input_bytes_copied_ = 0;
+  uint64_t output_bytes_in_place_ = 0;
+  uint64_t output_bytes_copied_ = 0;
+
+  trace_counter_id_t trace_counter_id_ = next_trace_counter_id_++;
+};
+
+#endif  // SRC_MEDIA_CODEC_CODECS_COPY_STATS_H_
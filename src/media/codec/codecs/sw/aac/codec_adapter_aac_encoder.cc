@@ -299,6 +299,7 @@ void CodecAdapterAacEncoder::ProcessInput(CodecInputItem input_item) {
     ZX_DEBUG_ASSERT(input_item.is_end_of_stream());
     status = stream_->chunk_input_stream.Flush();
   }
+  stream_->copy_stats.Trace();
 
   switch (status) {
     case ChunkInputStream::kExtrapolationFailedWithoutTimebase:
@@ -535,6 +536,8 @@ ChunkInputStream::ControlFlow CodecAdapterAacEncoder::ProcessInputBlock(
           }
 
           encode_result = result.take_value();
+          // The encoder writes straight into the client's output buffer.
+          stream_->copy_stats.AddOutput(encode_result.bytes_written, /*copied=*/false);
           return {.len = encode_result.bytes_written, .status = OutputSink::kSuccess};
         });
     if (output_sink_status != OutputSink::kOk) {
@@ -559,6 +562,7 @@ ChunkInputStream::ControlFlow CodecAdapterAacEncoder::ProcessInputBlock(
             return {.len = 0, .status = OutputSink::kError};
           }
           encode_result = result.take_value();
+          stream_->copy_stats.AddOutput(encode_result.bytes_written, /*copied=*/false);
           return {.len = encode_result.bytes_written, .status = OutputSink::kSuccess};
         });
     if (output_sink_status != OutputSink::kOk) {
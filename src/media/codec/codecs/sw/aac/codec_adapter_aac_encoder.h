@@ -96,11 +96,13 @@ class CodecAdapterAacEncoder : public CodecAdapter {
            uint64_t in_format_details_version_ordinal, size_t in_output_buffer_size)
         : encoder(std::move(in_encoder)),
           chunk_input_stream(chunk_size, std::move(timestamp_extrapolator),
-                             std::move(input_block_processor)),
+                             std::move(input_block_processor), &copy_stats),
           format_details_version_ordinal(in_format_details_version_ordinal),
           output_buffer_size(in_output_buffer_size) {}
 
     Encoder encoder;
+    // Declared before `chunk_input_stream`, which counts input bytes into it.
+    CopyStats copy_stats;
     ChunkInputStream chunk_input_stream;
     uint64_t format_details_version_ordinal;
     size_t output_buffer_size;
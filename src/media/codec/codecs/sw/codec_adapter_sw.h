@@ -19,6 +19,7 @@
 #include <queue>
 
 #include "buffer_pool.h"
+#include "copy_stats.h"
 #include "src/lib/fxl/macros.h"
 #include "src/lib/fxl/synchronization/thread_annotations.h"
 #include "src/media/lib/mpsc_queue/mpsc_queue.h"
@@ -114,8 +115,10 @@ class CodecAdapterSW : public CodecAdapter {
     output_buffer_pool_.Reset(/*keep_data=*/true);
     LoadStagedOutputBuffers();
 
-    zx_status_t post_result =
-        async::PostTask(input_processing_loop_.dispatcher(), [this] { ProcessInputLoop(); });
+    zx_status_t post_result = async::PostTask(input_processing_loop_.dispatcher(), [this] {
+      copy_stats_.Reset();
+      ProcessInputLoop();
+    });
     ZX_ASSERT_MSG(post_result == ZX_OK,
                   "async::PostTask() failed to post input processing loop - result: %d\n",
                   post_result);
@@ -303,6 +306,11 @@ class CodecAdapterSW : public CodecAdapter {
   BlockingMpscQueue<CodecInputItem> input_queue_;
   BlockingMpscQueue<CodecPacket*> free_output_packets_;
 
+  // Per-stream counts of bytes consumed or produced in place in client buffers versus copied.
+  // Only touched on input_processing_thread_; subclasses update it as they decode or encode and
+  // call copy_stats_.Trace() to export it.
+  CopyStats copy_stats_;
+
   // The order of output_buffer_pool_ and in_use_by_client_ matters, so that
   // destruction of in_use_by_client_ happens first, because those destructing
   // will return buffers to output_buffer_pool_.
@@ -21,11 +21,15 @@
 // If a software can only provide an encoder or decoder, the other should be
 // assigned NoAdapter in the template arguments, e.g.:
 //   CodecRunnerApp<CodecAdapterFfmpeg, NoAdapter>
+//
+// The runner serves a single codec, which may use up to `max_codec_threads`
+// threads if its adapter supports more than one.
 template <typename Decoder, typename Encoder>
 class CodecRunnerApp {
  public:
-  CodecRunnerApp()
-      : codec_admission_control_(std::make_unique<CodecAdmissionControl>(loop_.dispatcher())) {}
+  explicit CodecRunnerApp(uint32_t max_codec_threads = 1)
+      : codec_admission_control_(std::make_unique<CodecAdmissionControl>(loop_.dispatcher())),
+        max_codec_threads_(max_codec_threads) {}
 
   void Run() {
     syslog::SetTags({"codec_runner"});
@@ -80,7 +84,8 @@ class CodecRunnerApp {
                     if (!codec_instance_) {
                       loop_.Quit();
                     }
-                  });
+                  },
+                  max_codec_threads_);
               // This runner only expects a single Local Codec Factory to ever
               // be requested.
               //
@@ -107,6 +112,7 @@ class CodecRunnerApp {
   async::Loop loop_{&kAsyncLoopConfigAttachToCurrentThread};
   std::unique_ptr<sys::ComponentContext> component_context_{sys::ComponentContext::Create()};
   std::unique_ptr<CodecAdmissionControl> codec_admission_control_;
+  const uint32_t max_codec_threads_;
   std::unique_ptr<LocalSingleCodecFactory<Decoder, Encoder>> codec_factory_;
   std::unique_ptr<CodecImpl> codec_instance_;
 };
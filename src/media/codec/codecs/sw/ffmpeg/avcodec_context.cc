@@ -6,6 +6,8 @@
 
 #include <lib/media/codec_impl/codec_buffer.h>
 
+#include <algorithm>
+#include <cstring>
 #include <limits>
 #include <map>
 #include <string>
@@ -23,7 +25,9 @@ static inline constexpr uint32_t make_fourcc(uint8_t a, uint8_t b, uint8_t c, ui
 }  // namespace
 
 std::optional<std::unique_ptr<AvCodecContext>> AvCodecContext::CreateDecoder(
-    const fuchsia::media::FormatDetails& format_details, GetBufferCallback get_buffer_callback) {
+    const fuchsia::media::FormatDetails& format_details, GetBufferCallback get_buffer_callback,
+    uint32_t max_threads) {
+  ZX_DEBUG_ASSERT(max_threads >= 1);
   if (!format_details.has_mime_type()) {
     return std::nullopt;
   }
@@ -40,17 +44,29 @@ std::optional<std::unique_ptr<AvCodecContext>> AvCodecContext::CreateDecoder(
       [](AVCodecContext* avcodec_context) { avcodec_free_context(&avcodec_context); });
   ZX_ASSERT(avcodec_context);
 
-  // This flag must be set in case our packets come on NAL boundaries
-  // and not just frame boundaries.
-  avcodec_context->flags2 |= AV_CODEC_FLAG2_CHUNKS;
+  // Frame threading hands each packet to a different thread, so it needs
+  // packets to be whole frames and ffmpeg won't enable it together with
+  // AV_CODEC_FLAG2_CHUNKS. A parser reassembles frames from our packets instead.
+  AVCodecParserContextPtr parser;
+  if (max_threads > 1 && (codec->capabilities & AV_CODEC_CAP_FRAME_THREADS)) {
+    parser = AVCodecParserContextPtr(av_parser_init(codec->id),
+                                     [](AVCodecParserContext* parser) { av_parser_close(parser); });
+  }
+  if (!parser) {
+    // This flag must be set in case our packets come on NAL boundaries
+    // and not just frame boundaries.
+    avcodec_context->flags2 |= AV_CODEC_FLAG2_CHUNKS;
+  }
+  avcodec_context->thread_count = static_cast<int>(max_threads);
+  avcodec_context->thread_type = FF_THREAD_SLICE | (parser ? FF_THREAD_FRAME : 0);
 
   // This flag is required to override get_buffer2.
   ZX_ASSERT(avcodec_context->codec->capabilities & AV_CODEC_CAP_DR1);
 
   avcodec_context->get_buffer2 = AvCodecContext::GetBufferCallbackRouter;
 
-  std::unique_ptr<AvCodecContext> decoder(
-      new AvCodecContext(std::move(avcodec_context), std::move(get_buffer_callback)));
+  std::unique_ptr<AvCodecContext> decoder(new AvCodecContext(
+      std::move(avcodec_context), std::move(parser), std::move(get_buffer_callback)));
 
   if (format_details.has_oob_bytes() && !format_details.oob_bytes().empty()) {
     // Freed in AVCodecContext deleter in avcodec_free.
@@ -80,6 +96,18 @@ int AvCodecContext::SendPacket(const CodecPacket* codec_packet) {
   ZX_DEBUG_ASSERT(codec_packet->has_valid_length_bytes());
   ZX_DEBUG_ASSERT(codec_packet->buffer());
 
+  if (parser_) {
+    int result = ParseInput(codec_packet->buffer()->base() + codec_packet->start_offset(),
+                            static_cast<int>(codec_packet->valid_length_bytes()),
+                            codec_packet->has_timestamp_ish()
+                                ? static_cast<int64_t>(codec_packet->timestamp_ish())
+                                : AV_NOPTS_VALUE);
+    if (result < 0) {
+      return result;
+    }
+    return SendParsedPackets();
+  }
+
   AVPacket* packet = av_packet_alloc();
   ZX_ASSERT(packet);
 
@@ -97,6 +125,74 @@ int AvCodecContext::SendPacket(const CodecPacket* codec_packet) {
   return result;
 }
 
+uint32_t AvCodecContext::frame_thread_count() const {
+  ZX_DEBUG_ASSERT(avcodec_context_);
+  ZX_DEBUG_ASSERT(avcodec_is_open(avcodec_context_.get()));
+  // avcodec_open2 leaves the threading it actually set up in
+  // active_thread_type and thread_count.
+  if (!(avcodec_context_->active_thread_type & FF_THREAD_FRAME)) {
+    return 1;
+  }
+  return static_cast<uint32_t>(std::max(avcodec_context_->thread_count, 1));
+}
+
+int AvCodecContext::ParseInput(const uint8_t* data, int size, int64_t pts) {
+  ZX_DEBUG_ASSERT(parser_);
+  do {
+    uint8_t* frame_data = nullptr;
+    int frame_size = 0;
+    int consumed = av_parser_parse2(parser_.get(), avcodec_context_.get(), &frame_data,
+                                    &frame_size, data, size, pts, AV_NOPTS_VALUE, 0);
+    if (consumed < 0) {
+      return consumed;
+    }
+    data += consumed;
+    size -= consumed;
+    // The parser tracks which bytes the timestamp arrived with and reports it
+    // with the frame that starts at those bytes, so it's passed only once.
+    pts = AV_NOPTS_VALUE;
+
+    if (frame_size > 0) {
+      // frame_data is only valid until the next parse, so copy it into a
+      // padded, ref-counted packet which the decoder can then keep as is.
+      AVPacketPtr packet(av_packet_alloc(), [](AVPacket* packet) { av_packet_free(&packet); });
+      ZX_ASSERT(packet);
+      int result = av_new_packet(packet.get(), frame_size);
+      if (result < 0) {
+        return result;
+      }
+      std::memcpy(packet->data, frame_data, frame_size);
+      packet->pts = parser_->pts;
+      if (parser_->key_frame == 1) {
+        packet->flags |= AV_PKT_FLAG_KEY;
+      }
+      parsed_packets_.push(std::move(packet));
+    } else if (consumed == 0) {
+      break;
+    }
+  } while (size > 0);
+  return 0;
+}
+
+int AvCodecContext::SendParsedPackets() {
+  while (!parsed_packets_.empty()) {
+    int result = avcodec_send_packet(avcodec_context_.get(), parsed_packets_.front().get());
+    if (result == AVERROR(EAGAIN)) {
+      // The decoder has output to hand back first; ReceiveFrame resumes sending.
+      return 0;
+    }
+    parsed_packets_.pop();
+    if (result < 0) {
+      return result;
+    }
+  }
+  if (end_of_stream_pending_) {
+    end_of_stream_pending_ = false;
+    return avcodec_send_packet(avcodec_context_.get(), nullptr);
+  }
+  return 0;
+}
+
 std::pair<int, AvCodecContext::AVFramePtr> AvCodecContext::ReceiveFrame() {
   ZX_DEBUG_ASSERT(avcodec_context_);
   ZX_DEBUG_ASSERT(avcodec_is_open(avcodec_context_.get()));
@@ -107,6 +203,15 @@ std::pair<int, AvCodecContext::AVFramePtr> AvCodecContext::ReceiveFrame() {
   ZX_ASSERT(frame);
 
   int result_code = avcodec_receive_frame(avcodec_context_.get(), frame.get());
+  // Each pass sends at least one parsed frame (or end of stream), since the
+  // decoder accepts input whenever it has no output.
+  while (result_code == AVERROR(EAGAIN) && (!parsed_packets_.empty() || end_of_stream_pending_)) {
+    int send_result = SendParsedPackets();
+    if (send_result < 0) {
+      return {send_result, nullptr};
+    }
+    result_code = avcodec_receive_frame(avcodec_context_.get(), frame.get());
+  }
   if (result_code < 0) {
     return {result_code, nullptr};
   }
@@ -118,6 +223,14 @@ int AvCodecContext::EndStream() {
   ZX_DEBUG_ASSERT(avcodec_context_);
   ZX_DEBUG_ASSERT(avcodec_is_open(avcodec_context_.get()));
   ZX_DEBUG_ASSERT(av_codec_is_decoder(avcodec_context_->codec));
+  if (parser_) {
+    int result = ParseInput(nullptr, 0, AV_NOPTS_VALUE);
+    if (result < 0) {
+      return result;
+    }
+    end_of_stream_pending_ = true;
+    return SendParsedPackets();
+  }
   return avcodec_send_packet(avcodec_context_.get(), nullptr);
 }
 
@@ -208,8 +321,9 @@ int AvCodecContext::GetBufferHandler(AVCodecContext* avcodec_context, AVFrame* f
 
 AvCodecContext::AvCodecContext(
     std::unique_ptr<AVCodecContext, fit::function<void(AVCodecContext*)>> avcodec_context,
-    GetBufferCallback get_buffer_callback)
+    AVCodecParserContextPtr parser, GetBufferCallback get_buffer_callback)
     : avcodec_context_(std::move(avcodec_context)),
+      parser_(std::move(parser)),
       get_buffer_callback_(std::move(get_buffer_callback)) {
   ZX_DEBUG_ASSERT(avcodec_context_);
   ZX_DEBUG_ASSERT(get_buffer_callback_);
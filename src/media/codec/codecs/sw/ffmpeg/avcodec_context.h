@@ -6,6 +6,7 @@
 #define SRC_MEDIA_CODEC_CODECS_SW_FFMPEG_AVCODEC_CONTEXT_H_
 
 #include <optional>
+#include <queue>
 
 // Ignore warnings about conversions in libav
 #pragma clang diagnostic push
@@ -17,6 +18,7 @@ extern "C" {
 #pragma clang diagnostic pop
 
 #include <fuchsia/mediacodec/cpp/fidl.h>
+#include <lib/fit/function.h>
 #include <lib/media/codec_impl/codec_packet.h>
 
 #include "src/lib/fxl/macros.h"
@@ -54,15 +56,39 @@ class AvCodecContext {
   // to gracefully conclude its work.
   //
   // See ffmpeg's get_buffer2 and av_buffer_create for more details.
+  //
+  // At most `max_threads` threads decode the stream. With more than one,
+  // slice threading is enabled, as is frame threading if the codec supports
+  // it. A frame-threaded decoder may call get_buffer_callback on any of its
+  // threads, and holds up to `max_threads - 1` more frames than a
+  // single-threaded one.
   static std::optional<std::unique_ptr<AvCodecContext>> CreateDecoder(
-      const fuchsia::media::FormatDetails& format_details, GetBufferCallback get_buffer_callback);
+      const fuchsia::media::FormatDetails& format_details, GetBufferCallback get_buffer_callback,
+      uint32_t max_threads = 1);
 
   // Sends a compressed packet to the decoder. The semantics of SendPacket and
   // ReceiveFrame mirror those of avcodec_send_packet and avcodec_receive_frame
   // of ffmpeg. Returns an ffmpeg return code.
+  //
+  // The packet's data is always copied before this returns, so the input
+  // packet can go back to the client right away. Input buffers are shared with
+  // the client, which could rewrite them while ffmpeg reads them, including
+  // the padding ffmpeg's bitstream readers rely on to over-read safely.
+  //
+  // A frame-threaded decoder needs whole frames, so its input is first split
+  // into frames by an ffmpeg parser, which copies it and carries each packet's
+  // timestamp over to the frame that starts in that packet. Parsed frames
+  // that the decoder can't take yet are queued and sent by ReceiveFrame.
   int SendPacket(const CodecPacket* codec_packet);
 
+  // Returns how many frames the decoder decodes at once, each holding a frame
+  // buffer: the number of frame threads ffmpeg started, or 1 if the decoder
+  // isn't frame-threaded. This can be less than the `max_threads` given to
+  // CreateDecoder, which only bounds what ffmpeg may choose.
+  uint32_t frame_thread_count() const;
+
   // Receives a frame from ffmpeg decoder, paired with its ffmpeg return code.
+  // AVERROR(EAGAIN) means the decoder needs another packet first.
   std::pair<int, AVFramePtr> ReceiveFrame();
 
   // No further packets may be sent to the decoder after this call. Input data
@@ -75,18 +101,42 @@ class AvCodecContext {
   // be allocated for it.
   FrameBufferRequest frame_buffer_request(AVFrame* frame) const;
 
+  // Splits `size` bytes of input into frames, queueing each in
+  // parsed_packets_. A `size` of zero flushes the parser's final frame.
+  // Returns an ffmpeg return code.
+  int ParseInput(const uint8_t* data, int size, int64_t pts);
+
+  // Sends queued frames (and then end of stream, if pending) until the
+  // decoder won't accept more. Returns an ffmpeg return code.
+  int SendParsedPackets();
+
   static int GetBufferCallbackRouter(AVCodecContext* avcodec_context, AVFrame* frame, int flag);
 
   int GetBufferHandler(AVCodecContext* avcodec_context, AVFrame* frame, int flag);
 
-  // Takes ownership of ffmpeg's AVCodecContext type (note uppercase V).
+  using AVPacketPtr = std::unique_ptr<AVPacket, fit::function<void(AVPacket*)>>;
+  using AVCodecParserContextPtr =
+      std::unique_ptr<AVCodecParserContext, fit::function<void(AVCodecParserContext*)>>;
+
+  // Takes ownership of ffmpeg's AVCodecContext type (note uppercase V), and of
+  // the parser used to split input into frames, if any.
   AvCodecContext(
       std::unique_ptr<AVCodecContext, fit::function<void(AVCodecContext*)>> avcodec_context,
-      GetBufferCallback get_buffer_callback);
+      AVCodecParserContextPtr parser, GetBufferCallback get_buffer_callback);
 
   // ffmpeg's AVCodecContext (note uppercase V).
   std::unique_ptr<AVCodecContext, fit::function<void(AVCodecContext*)>> avcodec_context_;
 
+  // Splits input into whole frames for a frame-threaded decoder. Null if the
+  // decoder takes input as it arrives.
+  AVCodecParserContextPtr parser_;
+
+  // Parsed frames waiting for the decoder to accept them.
+  std::queue<AVPacketPtr> parsed_packets_;
+
+  // Whether end of stream should be sent once parsed_packets_ drains.
+  bool end_of_stream_pending_ = false;
+
   // callback to get buffers for decoding.
   GetBufferCallback get_buffer_callback_;
 
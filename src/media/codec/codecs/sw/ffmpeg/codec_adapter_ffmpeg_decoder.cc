@@ -4,6 +4,7 @@
 
 #include "codec_adapter_ffmpeg_decoder.h"
 
+#include <algorithm>
 #include <limits>
 
 extern "C" {
@@ -50,8 +51,11 @@ static constexpr uint32_t kFfmpegOutputFramePaddingBytes = 16;
 }  // namespace
 
 CodecAdapterFfmpegDecoder::CodecAdapterFfmpegDecoder(std::mutex& lock,
-                                                     CodecAdapterEvents* codec_adapter_events)
-    : CodecAdapterSW(lock, codec_adapter_events) {}
+                                                     CodecAdapterEvents* codec_adapter_events,
+                                                     uint32_t max_threads)
+    : CodecAdapterSW(lock, codec_adapter_events), max_threads_(max_threads) {
+  ZX_DEBUG_ASSERT(max_threads_ >= 1);
+}
 
 CodecAdapterFfmpegDecoder::~CodecAdapterFfmpegDecoder() = default;
 
@@ -69,28 +73,37 @@ void CodecAdapterFfmpegDecoder::ProcessInputLoop() {
           [this](const AvCodecContext::FrameBufferRequest& frame_buffer_request,
                  AVCodecContext* avcodec_context, AVFrame* frame, int flags) {
             return GetBuffer(frame_buffer_request, avcodec_context, frame, flags);
-          });
+          },
+          max_threads_);
       if (!maybe_avcodec_context) {
         events_->onCoreCodecFailCodec("Failed to create ffmpeg decoder.");
         return;
       }
       avcodec_context_ = std::move(maybe_avcodec_context.value());
+      {
+        std::lock_guard<std::mutex> lock(lock_);
+        frame_thread_count_ = avcodec_context_->frame_thread_count();
+      }
     } else if (input_item.is_end_of_stream()) {
       ZX_ASSERT(avcodec_context_);
       avcodec_context_->EndStream();
       DecodeFrames();
     } else if (input_item.is_packet()) {
       ZX_DEBUG_ASSERT(avcodec_context_);
-      int result = avcodec_context_->SendPacket(input_item.packet());
+      CodecPacket* packet = input_item.packet();
+      const uint32_t input_bytes = packet->valid_length_bytes();
+      int result = avcodec_context_->SendPacket(packet);
       if (result < 0) {
         events_->onCoreCodecFailCodec("Failed to decode input packet with ffmpeg error: %s",
                                       av_err2str(result));
         return;
       }
 
-      events_->onCoreCodecInputPacketDone(input_item.packet());
+      events_->onCoreCodecInputPacketDone(packet);
+      copy_stats_.AddInput(input_bytes, /*copied=*/true);
 
       DecodeFrames();
+      copy_stats_.Trace();
     }
   }
 }
@@ -224,7 +237,15 @@ void CodecAdapterFfmpegDecoder::DecodeFrames() {
     output_packet->SetBuffer(buffer_alloc->buffer);
     output_packet->SetStartOffset(0);
     output_packet->SetValidLengthBytes(static_cast<uint32_t>(buffer_alloc->bytes_used));
-    output_packet->SetTimstampIsh(frame->pts);
+    // ffmpeg carries each input packet's timestamp through (re)ordering and
+    // frame threading; frames decoded from untimestamped input have none.
+    if (frame->pts != AV_NOPTS_VALUE) {
+      output_packet->SetTimstampIsh(frame->pts);
+    } else {
+      output_packet->ClearTimestampIsh();
+    }
+    // GetBuffer() had ffmpeg decode directly into this client buffer.
+    copy_stats_.AddOutput(buffer_alloc->bytes_used, /*copied=*/false);
 
     {
       std::lock_guard<std::mutex> lock(lock_);
@@ -265,7 +286,7 @@ CodecAdapterFfmpegDecoder::CoreCodecGetBufferCollectionConstraints(
   // the client wants more buffers the client can demand buffers in its own
   // fuchsia::sysmem::BufferCollection::SetConstraints().
   if (port == kOutputPort) {
-    result.min_buffer_count_for_camping = kMinOutputBufferCountForCamping;
+    result.min_buffer_count_for_camping = min_output_buffer_count_for_camping();
   } else {
     result.min_buffer_count_for_camping = kMinInputBufferCountForCamping;
   }
@@ -390,6 +411,11 @@ void CodecAdapterFfmpegDecoder::CoreCodecSetBufferCollectionInfo(
   if (port == kInputPort) {
     ZX_DEBUG_ASSERT(buffer_collection_info.buffer_count >= kMinInputBufferCountForCamping);
   } else {
-    ZX_DEBUG_ASSERT(buffer_collection_info.buffer_count >= kMinOutputBufferCountForCamping);
+    std::lock_guard<std::mutex> lock(lock_);
+    ZX_DEBUG_ASSERT(buffer_collection_info.buffer_count >= min_output_buffer_count_for_camping());
   }
 }
+
+uint32_t CodecAdapterFfmpegDecoder::min_output_buffer_count_for_camping() const {
+  return std::min(kMinOutputBufferCountForCamping + frame_thread_count_ - 1, kMaxOutputBufferCount);
+}
@@ -12,7 +12,9 @@
 
 class CodecAdapterFfmpegDecoder : public CodecAdapterSW<AvCodecContext::AVFramePtr> {
  public:
-  CodecAdapterFfmpegDecoder(std::mutex& lock, CodecAdapterEvents* codec_adapter_events);
+  // At most `max_threads` threads decode each stream; see AvCodecContext::CreateDecoder().
+  CodecAdapterFfmpegDecoder(std::mutex& lock, CodecAdapterEvents* codec_adapter_events,
+                            uint32_t max_threads = 1);
   ~CodecAdapterFfmpegDecoder();
 
   fuchsia::sysmem::BufferCollectionConstraints CoreCodecGetBufferCollectionConstraints(
@@ -42,6 +44,15 @@ class CodecAdapterFfmpegDecoder : public CodecAdapterSW<AvCodecContext::AVFrameP
   // Decodes frames until the decoder is empty.
   void DecodeFrames();
 
+  // Each frame thread beyond the first holds an output buffer of its own.
+  uint32_t min_output_buffer_count_for_camping() const FXL_REQUIRE(lock_);
+
+  const uint32_t max_threads_;
+
+  // How many frames the current stream's decoder decodes at once; see
+  // AvCodecContext::frame_thread_count().
+  uint32_t frame_thread_count_ FXL_GUARDED_BY(lock_) = 1;
+
   std::optional<AvCodecContext::FrameBufferRequest> decoded_output_info_ FXL_GUARDED_BY(lock_);
 
   std::unique_ptr<AvCodecContext> avcodec_context_;
@@ -0,0 +1,250 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures the throughput of the ffmpeg software decoder at a range of thread counts.
+//
+// The input is an Annex B H.264 elementary stream, typically 1080p60 or 4K. It is fed to the
+// decoder one NAL unit per packet, each with its own timestamp, the way a demuxer would feed the
+// codec runner, so frame-threaded runs also exercise parsing input into frames.
+
+#include <lib/syslog/cpp/macros.h>
+#include <lib/zx/clock.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <perftest/results.h>
+
+#include "avcodec_context.h"
+#include "src/lib/files/file.h"
+#include "src/lib/files/path.h"
+#include "src/lib/fxl/command_line.h"
+#include "src/lib/fxl/strings/split_string.h"
+#include "src/lib/fxl/strings/string_number_conversions.h"
+#include "src/lib/fxl/strings/string_printf.h"
+#include "src/media/codec/codecs/test/test_codec_packets.h"
+
+namespace {
+
+struct Options {
+  std::string input;
+  std::vector<uint32_t> thread_counts = {1, 2, 4, 8};
+  uint32_t runs = 3;
+  std::optional<std::string> perftest_json;
+};
+
+struct RunResult {
+  uint64_t frames = 0;
+  uint64_t frames_with_timestamp = 0;
+  zx::duration elapsed;
+};
+
+void Usage(const char* prog_name) {
+  printf("\nUsage: %s --input=<file.h264> [--option] [...]\n", prog_name);
+  printf("Measure ffmpeg software decode throughput at a range of thread counts.\n");
+  printf("\n");
+  printf("Valid options are:\n");
+  printf("\n");
+  printf("  --input=<file.h264>\n");
+  printf("    Annex B H.264 elementary stream to decode (required).\n");
+  printf("\n");
+  printf("  --threads=<count>[,<count>...]\n");
+  printf("    Decode with each of these thread counts (default: 1,2,4,8).\n");
+  printf("\n");
+  printf("  --runs=<count>\n");
+  printf("    Decode the input this many times per thread count (default: 3).\n");
+  printf("\n");
+  printf("  --perftest-json=<filepath.json>\n");
+  printf("    Record the decode time per frame of each run to the specified json filepath.\n");
+  printf("\n");
+}
+
+std::optional<Options> ParseCommandLine(int argc, char** argv) {
+  auto command_line = fxl::CommandLineFromArgcArgv(argc, argv);
+  Options opts;
+
+  if (command_line.HasOption("help") || !command_line.GetOptionValue("input", &opts.input)) {
+    return std::nullopt;
+  }
+
+  std::string str;
+  if (command_line.GetOptionValue("threads", &str)) {
+    opts.thread_counts.clear();
+    for (auto s : fxl::SplitString(str, ",", fxl::kTrimWhitespace, fxl::kSplitWantNonEmpty)) {
+      uint32_t thread_count;
+      if (!fxl::StringToNumberWithError(s, &thread_count) || thread_count == 0) {
+        return std::nullopt;
+      }
+      opts.thread_counts.push_back(thread_count);
+    }
+  }
+
+  if (command_line.GetOptionValue("runs", &str) &&
+      (!fxl::StringToNumberWithError(str, &opts.runs) || opts.runs == 0)) {
+    return std::nullopt;
+  }
+
+  if (command_line.GetOptionValue("perftest-json", &str)) {
+    opts.perftest_json = str;
+  }
+
+  return opts;
+}
+
+// Returns the offset of each NAL unit's start code. Each NAL unit runs to the next start code.
+std::vector<size_t> FindNalUnits(const std::vector<uint8_t>& stream) {
+  std::vector<size_t> offsets;
+  for (size_t i = 0; i + 3 <= stream.size(); ++i) {
+    if (stream[i] == 0 && stream[i + 1] == 0 && stream[i + 2] == 1) {
+      // Include the leading zero of a four-byte start code.
+      offsets.push_back(i > 0 && stream[i - 1] == 0 ? i - 1 : i);
+      i += 2;
+    }
+  }
+  return offsets;
+}
+
+// Decodes every packet, returning std::nullopt on a decode error.
+std::optional<RunResult> DecodeOnce(const std::vector<CodecPacket*>& packets,
+                                    uint32_t thread_count) {
+  fuchsia::media::FormatDetails format_details;
+  format_details.set_mime_type("video/h264");
+
+  RunResult result;
+  const zx::time start = zx::clock::get_monotonic();
+
+  auto maybe_decoder = AvCodecContext::CreateDecoder(
+      format_details,
+      [](const AvCodecContext::FrameBufferRequest& frame_buffer_request,
+         AVCodecContext* avcodec_context, AVFrame* frame, int flags) {
+        return avcodec_default_get_buffer2(avcodec_context, frame, flags);
+      },
+      thread_count);
+  if (!maybe_decoder) {
+    return std::nullopt;
+  }
+  auto& decoder = *maybe_decoder;
+
+  // Returns the ffmpeg error, if any, that ended the drain.
+  auto drain = [&decoder, &result] {
+    while (true) {
+      auto [error, frame] = decoder->ReceiveFrame();
+      if (error < 0) {
+        return error;
+      }
+      ++result.frames;
+      if (frame->pts != AV_NOPTS_VALUE) {
+        ++result.frames_with_timestamp;
+      }
+    }
+  };
+
+  for (CodecPacket* packet : packets) {
+    int error = decoder->SendPacket(packet);
+    if (error < 0) {
+      FX_LOGS(ERROR) << "SendPacket failed: " << av_err2str(error);
+      return std::nullopt;
+    }
+    if (error = drain(); error != AVERROR(EAGAIN)) {
+      FX_LOGS(ERROR) << "ReceiveFrame failed: " << av_err2str(error);
+      return std::nullopt;
+    }
+  }
+  if (int error = decoder->EndStream(); error < 0) {
+    FX_LOGS(ERROR) << "EndStream failed: " << av_err2str(error);
+    return std::nullopt;
+  }
+  if (int error = drain(); error != AVERROR_EOF) {
+    FX_LOGS(ERROR) << "ReceiveFrame failed: " << av_err2str(error);
+    return std::nullopt;
+  }
+
+  // Include joining the decode threads.
+  decoder = nullptr;
+  result.elapsed = zx::clock::get_monotonic() - start;
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const std::string prog_name = files::GetBaseName(argv[0]);
+  auto opts = ParseCommandLine(argc, argv);
+  if (!opts) {
+    Usage(prog_name.c_str());
+    return 1;
+  }
+
+  std::vector<uint8_t> stream;
+  if (!files::ReadFileToVector(opts->input, &stream)) {
+    fprintf(stderr, "Failed to read %s\n", opts->input.c_str());
+    return 1;
+  }
+  std::vector<size_t> nal_offsets = FindNalUnits(stream);
+  if (nal_offsets.empty()) {
+    fprintf(stderr, "%s has no Annex B start codes\n", opts->input.c_str());
+    return 1;
+  }
+
+  // One buffer holds the whole stream, with zeroed padding after it for ffmpeg.
+  auto buffers = Buffers({stream.size() + AV_INPUT_BUFFER_PADDING_SIZE});
+  std::memcpy(buffers.buffers[0]->base(), stream.data(), stream.size());
+  std::memset(buffers.buffers[0]->base() + stream.size(), 0, AV_INPUT_BUFFER_PADDING_SIZE);
+
+  auto packets = Packets(nal_offsets.size());
+  std::vector<CodecPacket*> packet_ptrs;
+  for (size_t i = 0; i < nal_offsets.size(); ++i) {
+    const size_t end = i + 1 < nal_offsets.size() ? nal_offsets[i + 1] : stream.size();
+    CodecPacket* packet = packets.ptr(i);
+    packet->SetBuffer(buffers.ptr(0));
+    packet->SetStartOffset(static_cast<uint32_t>(nal_offsets[i]));
+    packet->SetValidLengthBytes(static_cast<uint32_t>(end - nal_offsets[i]));
+    packet->SetTimstampIsh(i);
+    packet_ptrs.push_back(packet);
+  }
+
+  std::optional<perftest::ResultsSet> results;
+  if (opts->perftest_json) {
+    results.emplace();
+  }
+
+  printf("%s: %zu bytes in %zu NAL units\n", opts->input.c_str(), stream.size(),
+         packet_ptrs.size());
+  printf("%8s %8s %10s %12s %10s\n", "threads", "run", "frames", "timestamped", "fps");
+  for (uint32_t thread_count : opts->thread_counts) {
+    perftest::TestCaseResults* test_case =
+        results ? results->AddTestCase(
+                      "fuchsia.media.ffmpeg_decoder",
+                      fxl::StringPrintf("%s/threads_%u", files::GetBaseName(opts->input).c_str(),
+                                        thread_count),
+                      "nanoseconds")
+                : nullptr;
+    for (uint32_t run = 0; run < opts->runs; ++run) {
+      auto result = DecodeOnce(packet_ptrs, thread_count);
+      if (!result) {
+        return 1;
+      }
+      if (result->frames == 0) {
+        fprintf(stderr, "No frames decoded\n");
+        return 1;
+      }
+      const double seconds = static_cast<double>(result->elapsed.to_nsecs()) / 1e9;
+      printf("%8u %8u %10" PRIu64 " %12" PRIu64 " %10.1f\n", thread_count, run, result->frames,
+             result->frames_with_timestamp, static_cast<double>(result->frames) / seconds);
+      if (test_case) {
+        test_case->AppendValue(static_cast<double>(result->elapsed.to_nsecs()) /
+                               static_cast<double>(result->frames));
+      }
+    }
+  }
+
+  if (results) {
+    return results->WriteJSONFile(opts->perftest_json->c_str()) ? 0 : 1;
+  }
+  return 0;
+}
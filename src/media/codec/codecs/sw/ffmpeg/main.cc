@@ -2,14 +2,47 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <lib/syslog/cpp/macros.h>
+#include <zircon/syscalls.h>
+
+#include <algorithm>
+#include <string>
+
 #include "codec_adapter_ffmpeg_decoder.h"
 #include "codec_adapter_ffmpeg_encoder.h"
 #include "codec_runner_app.h"
+#include "src/lib/fxl/command_line.h"
+#include "src/lib/fxl/strings/string_number_conversions.h"
+#include "src/media/codec/codecs/sw/ffmpeg/codec_runner_sw_ffmpeg_config.h"
+
+namespace {
+
+// Beyond this, more threads add decode latency (and held output buffers) for little throughput.
+constexpr uint32_t kMaxDecodeThreads = 8;
 
+}  // namespace
+
+// Usage: codec_runner_sw_ffmpeg [--max-threads=<count>]
+//
+// The thread budget for the one codec this runner serves comes from the `max_decode_threads`
+// structured config value. --max-threads overrides it, e.g. to compare thread counts by hand. The
+// budget is capped at kMaxDecodeThreads and at the number of CPUs.
 int main(int argc, char* argv[]) {
-  ZX_DEBUG_ASSERT(argc == 1);
+  auto command_line = fxl::CommandLineFromArgcArgv(argc, argv);
+  ZX_DEBUG_ASSERT(command_line.positional_args().empty());
+
+  auto config = codec_runner_sw_ffmpeg_config::Config::TakeFromStartupHandle();
+  uint32_t max_threads = config.max_decode_threads();
+
+  std::string max_threads_value;
+  if (command_line.GetOptionValue("max-threads", &max_threads_value) &&
+      !fxl::StringToNumberWithError(max_threads_value, &max_threads)) {
+    FX_LOGS(ERROR) << "Invalid --max-threads value: \"" << max_threads_value << "\"";
+    return 1;
+  }
+  max_threads = std::clamp(max_threads, 1u, std::min(zx_system_get_num_cpus(), kMaxDecodeThreads));
 
-  CodecRunnerApp<CodecAdapterFfmpegDecoder, CodecAdapterFfmpegEncoder>().Run();
+  CodecRunnerApp<CodecAdapterFfmpegDecoder, CodecAdapterFfmpegEncoder>(max_threads).Run();
 
   return 0;
 }
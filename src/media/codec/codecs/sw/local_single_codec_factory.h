@@ -13,6 +13,8 @@
 #include <lib/syslog/cpp/macros.h>
 #include <threads.h>
 
+#include <type_traits>
+
 // Marker type to specify these is no adapter to serve a request.
 class NoAdapter {};
 
@@ -20,6 +22,10 @@ class NoAdapter {};
 // If a software can only provide an encoder or decoder, the other should be
 // assigned NoAdapter in the template arguments, e.g.:
 //   LocalSingleCodecFactory<CodecAdapterFfmpeg, NoAdapter>
+//
+// `max_codec_threads` is the thread budget for the codec this factory creates.
+// It's passed to adapters constructible with it; other adapters are
+// single-threaded.
 template <typename DecoderAdapter, typename EncoderAdapter>
 class LocalSingleCodecFactory : public fuchsia::mediacodec::CodecFactory {
  public:
@@ -28,12 +34,14 @@ class LocalSingleCodecFactory : public fuchsia::mediacodec::CodecFactory {
                           fidl::InterfaceRequest<CodecFactory> request,
                           fit::function<void(std::unique_ptr<CodecImpl>)> factory_done_callback,
                           CodecAdmissionControl* codec_admission_control,
-                          fit::function<void(zx_status_t)> error_handler)
+                          fit::function<void(zx_status_t)> error_handler,
+                          uint32_t max_codec_threads = 1)
       : fidl_dispatcher_(fidl_dispatcher),
         sysmem_(std::move(sysmem)),
         binding_(this),
         factory_done_callback_(std::move(factory_done_callback)),
-        codec_admission_control_(codec_admission_control) {
+        codec_admission_control_(codec_admission_control),
+        max_codec_threads_(max_codec_threads) {
     binding_.set_error_handler(std::move(error_handler));
     zx_status_t status = binding_.Bind(std::move(request), fidl_dispatcher);
     ZX_ASSERT(status == ZX_OK);
@@ -101,8 +109,14 @@ class LocalSingleCodecFactory : public fuchsia::mediacodec::CodecFactory {
 
           codec_impl->SetLifetimeTracking(std::move(lifetime_tracking_eventpair));
 
-          codec_impl->SetCoreCodecAdapter(
-              std::make_unique<Adapter>(codec_impl->lock(), codec_impl.get()));
+          if constexpr (std::is_constructible_v<Adapter, std::mutex&, CodecAdapterEvents*,
+                                                uint32_t>) {
+            codec_impl->SetCoreCodecAdapter(std::make_unique<Adapter>(
+                codec_impl->lock(), codec_impl.get(), max_codec_threads_));
+          } else {
+            codec_impl->SetCoreCodecAdapter(
+                std::make_unique<Adapter>(codec_impl->lock(), codec_impl.get()));
+          }
 
           // This hands off the codec impl to the creator of |this| and is
           // expected to |~this|.
@@ -136,6 +150,7 @@ class LocalSingleCodecFactory : public fuchsia::mediacodec::CodecFactory {
   // Returns the codec implementation and requests drop of self.
   fit::function<void(std::unique_ptr<CodecImpl>)> factory_done_callback_;
   CodecAdmissionControl* codec_admission_control_;
+  const uint32_t max_codec_threads_;
   std::vector<zx::eventpair> lifetime_tracking_;
 };
 
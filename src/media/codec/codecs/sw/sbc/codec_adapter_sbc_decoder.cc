@@ -259,6 +259,7 @@ CodecAdapterSbcDecoder::InputLoopStatus CodecAdapterSbcDecoder::DecodeInput(
 
     uint32_t output_bytes = static_cast<uint32_t>(output_buffer_->size() - output_offset_);
 
+    const uint32_t bytes_left_before = bytes_left;
     OI_STATUS status =
         OI_CODEC_SBC_DecodeFrame(&context_->context, const_cast<const OI_BYTE**>(&input_data),
                                  &bytes_left, reinterpret_cast<int16_t*>(output), &output_bytes);
@@ -266,11 +267,15 @@ CodecAdapterSbcDecoder::InputLoopStatus CodecAdapterSbcDecoder::DecodeInput(
       FX_LOGS(WARNING) << "decode failure " << status;
       break;
     }
+    // The decoder parses straight from the client's input buffer into the client's output buffer.
+    copy_stats_.AddInput(bytes_left_before - bytes_left, /*copied=*/false);
+    copy_stats_.AddOutput(output_bytes, /*copied=*/false);
 
     QueueAndSend(output_bytes);
   }
 
   SendQueuedOutput();
+  copy_stats_.Trace();
 
   return kOk;
 }
@@ -272,6 +272,7 @@ CodecAdapterSbcEncoder::InputLoopStatus CodecAdapterSbcEncoder::CreateContext(
 
         SBC_Encode(&context_->params,
                    reinterpret_cast<int16_t*>(const_cast<uint8_t*>(input_block.data)), output);
+        copy_stats_.AddOutput(context_->sbc_frame_length(), /*copied=*/false);
 
         if (output_offset_ + context_->sbc_frame_length() > output_buffer_->size() ||
             input_block.is_end_of_stream) {
@@ -288,7 +289,8 @@ CodecAdapterSbcEncoder::InputLoopStatus CodecAdapterSbcEncoder::CreateContext(
         }
 
         return ChunkInputStream::kContinue;
-      });
+      },
+      &copy_stats_);
 
   return kOk;
 }
@@ -312,6 +314,7 @@ CodecAdapterSbcEncoder::InputLoopStatus CodecAdapterSbcEncoder::EncodeInput(
   } else {
     status = chunk_input_stream_->ProcessInputPacket(input_packet);
   }
+  copy_stats_.Trace();
 
   switch (status) {
     case ChunkInputStream::kExtrapolationFailedWithoutTimebase:
@@ -6,6 +6,7 @@
 #include <lib/syslog/cpp/macros.h>
 
 #include <algorithm>
+#include <iterator>
 
 #include <gtest/gtest.h>
 
@@ -177,6 +178,54 @@ TEST(ChunkInputStream, FlushLeftover) {
   EXPECT_TRUE(flush_called);
 }
 
+TEST(ChunkInputStream, CountsCopiedAndInPlaceBytes) {
+  constexpr size_t kChunkSize = 4;
+  // The first packet yields one block in place and leaves 2 bytes in scratch;
+  // the second completes that block through scratch and yields one more block
+  // in place.
+  constexpr uint32_t kPacketLens[] = {6, 6};
+  auto packets = Packets(std::size(kPacketLens));
+  auto buffers = Buffers({kPacketLens[0] + kPacketLens[1]});
+  auto buffer = buffers.ptr(0);
+
+  uint32_t offset = 0;
+  for (size_t i = 0; i < std::size(kPacketLens); ++i) {
+    packets.ptr(i)->SetValidLengthBytes(kPacketLens[i]);
+    packets.ptr(i)->SetBuffer(buffer);
+    packets.ptr(i)->SetStartOffset(offset);
+    offset += kPacketLens[i];
+  }
+
+  std::vector<const uint8_t*> block_starts;
+  auto input_block_processor = [&block_starts](ChunkInputStream::InputBlock input_block) {
+    block_starts.push_back(input_block.data);
+    return ChunkInputStream::kContinue;
+  };
+
+  CopyStats copy_stats;
+  auto under_test =
+      ChunkInputStream(kChunkSize, TimestampExtrapolator(), input_block_processor, &copy_stats);
+
+  EXPECT_EQ(under_test.ProcessInputPacket(packets.ptr(0)), ChunkInputStream::kOk);
+  EXPECT_EQ(copy_stats.input_bytes_in_place(), kChunkSize);
+  EXPECT_EQ(copy_stats.input_bytes_copied(), 2u);
+
+  EXPECT_EQ(under_test.ProcessInputPacket(packets.ptr(1)), ChunkInputStream::kOk);
+  EXPECT_EQ(copy_stats.input_bytes_in_place(), 2 * kChunkSize);
+  EXPECT_EQ(copy_stats.input_bytes_copied(), 4u);
+  EXPECT_EQ(copy_stats.input_bytes_in_place() + copy_stats.input_bytes_copied(),
+            kPacketLens[0] + kPacketLens[1]);
+
+  // In-place blocks point directly into the client's buffer.
+  ASSERT_EQ(block_starts.size(), 3u);
+  EXPECT_EQ(block_starts[0], buffer->base());
+  EXPECT_EQ(block_starts[2], buffer->base() + kPacketLens[0] + 2);
+
+  // Padding added by Flush() is not input and is not counted.
+  EXPECT_EQ(under_test.Flush(), ChunkInputStream::kOk);
+  EXPECT_EQ(copy_stats.input_bytes_copied(), 4u);
+}
+
 TEST(ChunkInputStream, TimestampsCarry) {
   constexpr size_t kChunkSize = 5;
   constexpr size_t kPacketLen = 7;
@@ -29,10 +29,12 @@ static constexpr char kUsageString[] =
     "The remaining options are optional.\n"
     "\n"
     "General output options:\n"
-    "--output-format=raw\n"
+    "--output-format=raw|pprof\n"
     "                    Default is \"raw\"\n"
+    "                    \"pprof\" aggregates pc and last_branch samples into a\n"
+    "                    pprof profile\n"
     "--output-file=PATH\n"
-    "                    For raw the default is stdout.\n"
+    "                    The default is stdout.\n"
     "\n"
     "Logging options:\n"
     "  --quiet[=LEVEL]   Set quietness level (opposite of verbose)\n"
@@ -69,6 +71,8 @@ static bool ParseArgv(const fxl::CommandLine& cl, std::string* session_result_sp
   if (cl.GetOptionValue("output-format", &arg)) {
     if (arg == "raw") {
       out_printer_config->output_format = cpuperf::OutputFormat::kRaw;
+    } else if (arg == "pprof") {
+      out_printer_config->output_format = cpuperf::OutputFormat::kPprof;
     } else {
       FX_LOGS(ERROR) << "Bad value for --output-format: " << arg;
       return false;
@@ -134,6 +138,15 @@ int main(int argc, char** argv) {
       return EXIT_FAILURE;
     }
     total_records = printer->PrintFiles();
+  } else if (printer_config.output_format == cpuperf::OutputFormat::kPprof) {
+    std::unique_ptr<cpuperf::PprofPrinter> printer;
+    if (!cpuperf::PprofPrinter::Create(&session_result_spec, printer_config.ToPprofPrinterConfig(),
+                                       &printer)) {
+      return EXIT_FAILURE;
+    }
+    if (!printer->PrintFiles(&total_records)) {
+      return EXIT_FAILURE;
+    }
   } else {
     FX_LOGS(ERROR) << "Invalid output format\n";
     return EXIT_FAILURE;
@@ -0,0 +1,236 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pprof_printer.h"
+
+#include <lib/syslog/cpp/macros.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "profile_proto.h"
+#include "src/performance/lib/perfmon/file_reader.h"
+
+namespace cpuperf {
+
+namespace {
+
+// Field numbers from profile.proto.
+constexpr uint32_t kProfileSampleType = 1;
+constexpr uint32_t kProfileSample = 2;
+constexpr uint32_t kProfileLocation = 4;
+constexpr uint32_t kProfileStringTable = 6;
+constexpr uint32_t kProfileDurationNanos = 10;
+constexpr uint32_t kProfilePeriodType = 11;
+constexpr uint32_t kProfileDefaultSampleType = 14;
+constexpr uint32_t kValueTypeType = 1;
+constexpr uint32_t kValueTypeUnit = 2;
+constexpr uint32_t kSampleLocationId = 1;
+constexpr uint32_t kSampleValue = 2;
+constexpr uint32_t kSampleLabel = 3;
+constexpr uint32_t kLabelKey = 1;
+constexpr uint32_t kLabelNum = 3;
+constexpr uint32_t kLocationId = 1;
+constexpr uint32_t kLocationAddress = 3;
+
+ProtoWriter MakeValueType(StringTable* strings, const std::string& type, const std::string& unit) {
+  ProtoWriter value_type;
+  value_type.Varint(kValueTypeType, strings->Intern(type));
+  value_type.Varint(kValueTypeUnit, strings->Intern(unit));
+  return value_type;
+}
+
+ProtoWriter MakeNumLabel(StringTable* strings, const std::string& key, uint64_t num) {
+  ProtoWriter label;
+  label.Varint(kLabelKey, strings->Intern(key));
+  label.Varint(kLabelNum, num);
+  return label;
+}
+
+// Locations are per address space: the same address in two processes is
+// usually different code. Ids are assigned in order of first use, starting
+// at 1.
+class LocationTable {
+ public:
+  uint64_t Id(uint64_t aspace, uint64_t address) {
+    auto [it, inserted] = ids_.try_emplace({aspace, address}, addresses_.size() + 1);
+    if (inserted) {
+      addresses_.push_back(address);
+    }
+    return it->second;
+  }
+
+  const std::vector<uint64_t>& addresses() const { return addresses_; }
+
+ private:
+  std::map<std::pair<uint64_t, uint64_t>, uint64_t> ids_;
+  std::vector<uint64_t> addresses_;
+};
+
+}  // namespace
+
+bool PprofPrinter::Sample::operator<(const Sample& other) const {
+  return std::tie(cpu, aspace, pc) < std::tie(other.cpu, other.aspace, other.pc);
+}
+
+bool PprofPrinter::Branch::operator<(const Branch& other) const {
+  return std::tie(cpu, aspace, from, to) <
+         std::tie(other.cpu, other.aspace, other.from, other.to);
+}
+
+bool PprofPrinter::Create(const SessionResultSpec* session_result_spec, const Config& config,
+                          std::unique_ptr<PprofPrinter>* out_printer) {
+  const std::string& output_file_name = config.output_file_name;
+  FILE* out_file = stdout;
+  if (output_file_name != "") {
+    out_file = fopen(output_file_name.c_str(), "wb");
+    if (!out_file) {
+      FX_LOGS(ERROR) << "Unable to open file for writing: " << output_file_name;
+      return false;
+    }
+  }
+
+  out_printer->reset(new PprofPrinter(out_file, session_result_spec, config));
+  return true;
+}
+
+PprofPrinter::PprofPrinter(FILE* out_file, const SessionResultSpec* session_result_spec,
+                           const Config& config)
+    : out_file_(out_file), session_result_spec_(session_result_spec), config_(config) {}
+
+PprofPrinter::~PprofPrinter() {
+  if (config_.output_file_name != "")
+    fclose(out_file_);
+}
+
+void PprofPrinter::AddPcRecord(uint32_t cpu, const perfmon::SampleRecord& record) {
+  ++samples_[Sample{cpu, record.pc->aspace, record.pc->pc}];
+}
+
+void PprofPrinter::AddLastBranchRecord(uint32_t cpu, const perfmon::SampleRecord& record) {
+  const perfmon::LastBranchRecord* lbr = record.last_branch;
+  const uint32_t num_branches =
+      std::min(lbr->num_branches, perfmon::LastBranchRecord::kMaxNumLastBranch);
+  for (uint32_t i = 0; i < num_branches; ++i) {
+    ++branches_[Branch{cpu, lbr->aspace, lbr->branches[i].from, lbr->branches[i].to}];
+  }
+}
+
+uint64_t PprofPrinter::ReadOneTrace(uint32_t iter_num) {
+  uint64_t total_records = 0;
+
+  auto get_file_name = [this, &iter_num](uint32_t trace_num) -> std::string {
+    return session_result_spec_->GetTraceFilePath(iter_num, trace_num);
+  };
+
+  std::unique_ptr<perfmon::FileReader> reader;
+  if (!perfmon::FileReader::Create(get_file_name, session_result_spec_->num_traces, &reader)) {
+    return 0;
+  }
+
+  uint32_t trace;
+  perfmon::SampleRecord record;
+  while (reader->ReadNextRecord(&trace, &record) == perfmon::ReaderStatus::kOk) {
+    ++total_records;
+
+    switch (record.type()) {
+      case perfmon::kRecordTypeTime:
+        ticks_per_second_ = reader->ticks_per_second();
+        if (first_time_ == 0 || record.time->time < first_time_) {
+          first_time_ = record.time->time;
+        }
+        last_time_ = std::max(last_time_, record.time->time);
+        break;
+      case perfmon::kRecordTypePc:
+        AddPcRecord(trace, record);
+        break;
+      case perfmon::kRecordTypeLastBranch:
+        AddLastBranchRecord(trace, record);
+        break;
+      default:
+        // Counts and values don't contribute to the profile.
+        break;
+    }
+  }
+
+  return total_records;
+}
+
+bool PprofPrinter::WriteProfile() {
+  StringTable strings;
+  ProtoWriter profile;
+
+  // Each sample has a value of each type, in this order.
+  profile.Message(kProfileSampleType, MakeValueType(&strings, "samples", "count"));
+  profile.Message(kProfileSampleType, MakeValueType(&strings, "branches", "count"));
+  profile.Message(kProfilePeriodType, MakeValueType(&strings, "samples", "count"));
+  profile.Varint(kProfileDefaultSampleType, strings.Intern("samples"));
+
+  LocationTable locations;
+  for (const auto& [sample, count] : samples_) {
+    ProtoWriter message;
+    message.PackedVarints(kSampleLocationId, {locations.Id(sample.aspace, sample.pc)});
+    message.PackedVarints(kSampleValue, {count, 0});
+    message.Message(kSampleLabel, MakeNumLabel(&strings, "cpu", sample.cpu));
+    message.Message(kSampleLabel, MakeNumLabel(&strings, "aspace", sample.aspace));
+    profile.Message(kProfileSample, message);
+  }
+  for (const auto& [branch, count] : branches_) {
+    ProtoWriter message;
+    message.PackedVarints(kSampleLocationId, {locations.Id(branch.aspace, branch.from)});
+    message.PackedVarints(kSampleValue, {0, count});
+    message.Message(kSampleLabel, MakeNumLabel(&strings, "cpu", branch.cpu));
+    message.Message(kSampleLabel, MakeNumLabel(&strings, "aspace", branch.aspace));
+    message.Message(kSampleLabel, MakeNumLabel(&strings, "branch_to", branch.to));
+    profile.Message(kProfileSample, message);
+  }
+
+  for (size_t i = 0; i < locations.addresses().size(); ++i) {
+    ProtoWriter location;
+    location.Varint(kLocationId, i + 1);
+    location.Varint(kLocationAddress, locations.addresses()[i]);
+    profile.Message(kProfileLocation, location);
+  }
+
+  for (const std::string& str : strings.strings()) {
+    profile.Bytes(kProfileStringTable, str);
+  }
+
+  if (ticks_per_second_ != 0 && last_time_ > first_time_) {
+    const double seconds =
+        static_cast<double>(last_time_ - first_time_) / static_cast<double>(ticks_per_second_);
+    profile.Varint(kProfileDurationNanos, static_cast<uint64_t>(seconds * 1e9));
+  }
+
+  const std::string& data = profile.data();
+  if (fwrite(data.data(), 1, data.size(), out_file_) != data.size() || fflush(out_file_) != 0) {
+    FX_LOGS(ERROR) << "Error writing profile";
+    return false;
+  }
+  return true;
+}
+
+bool PprofPrinter::PrintFiles(uint64_t* out_total_records) {
+  uint64_t total_records = 0;
+
+  for (uint32_t iter = 0; iter < session_result_spec_->num_iterations; ++iter) {
+    total_records += ReadOneTrace(iter);
+  }
+
+  FX_LOGS(INFO) << samples_.size() << " unique pc(s), " << branches_.size()
+                << " unique branch(es)";
+  if (!WriteProfile()) {
+    return false;
+  }
+
+  *out_total_records = total_records;
+  return true;
+}
+
+}  // namespace cpuperf
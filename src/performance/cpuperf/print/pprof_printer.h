@@ -0,0 +1,88 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SRC_PERFORMANCE_CPUPERF_PRINT_PPROF_PRINTER_H_
+#define SRC_PERFORMANCE_CPUPERF_PRINT_PPROF_PRINTER_H_
+
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "src/lib/fxl/macros.h"
+#include "src/performance/cpuperf/session_result_spec.h"
+#include "src/performance/lib/perfmon/records.h"
+
+namespace cpuperf {
+
+// Aggregates the PC and last branch samples of a session into a profile in
+// pprof's profile.proto format, which `pprof` and most profile viewers read.
+//
+// The profile has two sample types. "samples" counts the sampled PCs; each
+// is a single location, since the records carry no call stack. "branches"
+// counts the taken branches in last branch records, at the branch source and
+// labeled with its target. Last branch records are the most recent branches,
+// not callers, so they are not turned into stacks. Identical samples or
+// branches on the same cpu in the same address space are counted together.
+// The records say nothing about the processes or modules behind an address
+// space, so the profile has no mappings or build IDs. pprof can't symbolize
+// it and reports raw addresses.
+class PprofPrinter {
+ public:
+  struct Config {
+    // If "" then output goes to stdout.
+    std::string output_file_name;
+  };
+
+  static bool Create(const SessionResultSpec* session_result_spec, const Config& config,
+                     std::unique_ptr<PprofPrinter>* out_printer);
+
+  ~PprofPrinter();
+
+  // Aggregate the trace(s) and write the profile.
+  // Returns false if the profile couldn't be written. Otherwise
+  // |*out_total_records| is the number of records processed.
+  bool PrintFiles(uint64_t* out_total_records);
+
+ private:
+  struct Sample {
+    uint32_t cpu;
+    uint64_t aspace;
+    uint64_t pc;
+
+    bool operator<(const Sample& other) const;
+  };
+
+  struct Branch {
+    uint32_t cpu;
+    uint64_t aspace;
+    uint64_t from;
+    uint64_t to;
+
+    bool operator<(const Branch& other) const;
+  };
+
+  PprofPrinter(FILE* output, const SessionResultSpec* session_result_spec, const Config& config);
+
+  uint64_t ReadOneTrace(uint32_t iter_num);
+  void AddPcRecord(uint32_t cpu, const perfmon::SampleRecord& record);
+  void AddLastBranchRecord(uint32_t cpu, const perfmon::SampleRecord& record);
+  bool WriteProfile();
+
+  FILE* const out_file_;
+  const SessionResultSpec* const session_result_spec_;
+  const Config config_;
+
+  std::map<Sample, uint64_t> samples_;
+  std::map<Branch, uint64_t> branches_;
+  uint64_t ticks_per_second_ = 0;
+  zx_ticks_t first_time_ = 0;
+  zx_ticks_t last_time_ = 0;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(PprofPrinter);
+};
+
+}  // namespace cpuperf
+
+#endif  // SRC_PERFORMANCE_CPUPERF_PRINT_PPROF_PRINTER_H_
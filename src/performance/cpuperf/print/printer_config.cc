@@ -12,4 +12,10 @@ RawPrinter::Config PrinterConfig::ToRawPrinterConfig() const {
   return config;
 }
 
+PprofPrinter::Config PrinterConfig::ToPprofPrinterConfig() const {
+  PprofPrinter::Config config;
+  config.output_file_name = output_file_name;
+  return config;
+}
+
 }  // namespace cpuperf
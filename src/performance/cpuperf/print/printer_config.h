@@ -7,6 +7,7 @@
 
 #include <string>
 
+#include "pprof_printer.h"
 #include "raw_printer.h"
 
 namespace cpuperf {
@@ -15,10 +16,13 @@ namespace cpuperf {
 enum class OutputFormat {
   // Raw format. Prints data for each instruction.
   kRaw,
+  // pprof profile.proto format. Aggregates the PC and last branch samples.
+  kPprof,
 };
 
 struct PrinterConfig {
   RawPrinter::Config ToRawPrinterConfig() const;
+  PprofPrinter::Config ToPprofPrinterConfig() const;
 
   OutputFormat output_format = OutputFormat::kRaw;
 
@@ -0,0 +1,44 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "profile_proto.h"
+
+namespace cpuperf {
+
+void ProtoWriter::Varint(uint32_t field, uint64_t value) {
+  Tag(field, kWireTypeVarint);
+  RawVarint(value);
+}
+
+void ProtoWriter::Bytes(uint32_t field, const std::string& value) {
+  Tag(field, kWireTypeLengthDelimited);
+  RawVarint(value.size());
+  data_.append(value);
+}
+
+void ProtoWriter::PackedVarints(uint32_t field, const std::vector<uint64_t>& values) {
+  ProtoWriter packed;
+  for (uint64_t value : values) {
+    packed.RawVarint(value);
+  }
+  Bytes(field, packed.data());
+}
+
+void ProtoWriter::RawVarint(uint64_t value) {
+  while (value >= 0x80) {
+    data_.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  data_.push_back(static_cast<char>(value));
+}
+
+uint64_t StringTable::Intern(const std::string& str) {
+  auto [it, inserted] = indices_.try_emplace(str, strings_.size());
+  if (inserted) {
+    strings_.push_back(str);
+  }
+  return it->second;
+}
+
+}  // namespace cpuperf
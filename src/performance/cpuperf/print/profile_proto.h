@@ -0,0 +1,51 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SRC_PERFORMANCE_CPUPERF_PRINT_PROFILE_PROTO_H_
+#define SRC_PERFORMANCE_CPUPERF_PRINT_PROFILE_PROTO_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cpuperf {
+
+// Just enough of the protobuf wire format to write a pprof profile.
+class ProtoWriter {
+ public:
+  static constexpr uint32_t kWireTypeVarint = 0;
+  static constexpr uint32_t kWireTypeLengthDelimited = 2;
+
+  const std::string& data() const { return data_; }
+
+  void Varint(uint32_t field, uint64_t value);
+  void Bytes(uint32_t field, const std::string& value);
+  void Message(uint32_t field, const ProtoWriter& message) { Bytes(field, message.data()); }
+  void PackedVarints(uint32_t field, const std::vector<uint64_t>& values);
+
+ private:
+  void Tag(uint32_t field, uint32_t wire_type) { RawVarint((field << 3) | wire_type); }
+  void RawVarint(uint64_t value);
+
+  std::string data_;
+};
+
+// Interns the strings of a profile. Index 0 is always the empty string.
+class StringTable {
+ public:
+  StringTable() { Intern(""); }
+
+  uint64_t Intern(const std::string& str);
+
+  const std::vector<std::string>& strings() const { return strings_; }
+
+ private:
+  std::unordered_map<std::string, uint64_t> indices_;
+  std::vector<std::string> strings_;
+};
+
+}  // namespace cpuperf
+
+#endif  // SRC_PERFORMANCE_CPUPERF_PRINT_PROFILE_PROTO_H_
@@ -0,0 +1,149 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "profile_proto.h"
+
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace cpuperf {
+
+namespace {
+
+// A field read back from the wire format: a varint value, or the bytes of a
+// length-delimited field.
+struct Field {
+  uint32_t number;
+  uint32_t wire_type;
+  uint64_t value;
+  std::string bytes;
+};
+
+bool ReadVarint(const std::string& data, size_t* pos, uint64_t* out_value) {
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (*pos >= data.size()) {
+      return false;
+    }
+    uint8_t byte = static_cast<uint8_t>(data[(*pos)++]);
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      *out_value = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ReadFields(const std::string& data, std::vector<Field>* out_fields) {
+  size_t pos = 0;
+  while (pos < data.size()) {
+    uint64_t tag;
+    if (!ReadVarint(data, &pos, &tag)) {
+      return false;
+    }
+    Field field{static_cast<uint32_t>(tag >> 3), static_cast<uint32_t>(tag & 7), 0, {}};
+    if (field.wire_type == ProtoWriter::kWireTypeVarint) {
+      if (!ReadVarint(data, &pos, &field.value)) {
+        return false;
+      }
+    } else if (field.wire_type == ProtoWriter::kWireTypeLengthDelimited) {
+      uint64_t size;
+      if (!ReadVarint(data, &pos, &size) || size > data.size() - pos) {
+        return false;
+      }
+      field.bytes = data.substr(pos, size);
+      pos += size;
+    } else {
+      return false;
+    }
+    out_fields->push_back(std::move(field));
+  }
+  return true;
+}
+
+TEST(ProfileProtoTest, VarintRoundTrip) {
+  const std::vector<uint64_t> values = {0, 1, 127, 128, 300, 1ull << 32,
+                                        std::numeric_limits<uint64_t>::max()};
+  ProtoWriter writer;
+  for (size_t i = 0; i < values.size(); ++i) {
+    writer.Varint(static_cast<uint32_t>(i + 1), values[i]);
+  }
+
+  std::vector<Field> fields;
+  ASSERT_TRUE(ReadFields(writer.data(), &fields));
+  ASSERT_EQ(fields.size(), values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(fields[i].number, i + 1);
+    EXPECT_EQ(fields[i].wire_type, ProtoWriter::kWireTypeVarint);
+    EXPECT_EQ(fields[i].value, values[i]);
+  }
+}
+
+TEST(ProfileProtoTest, NestedMessageRoundTrip) {
+  ProtoWriter inner;
+  inner.Varint(1, 42);
+  inner.Bytes(2, std::string("a\0b", 3));
+  inner.PackedVarints(3, {5, 1000, 0});
+
+  ProtoWriter outer;
+  outer.Message(4, inner);
+  // A field number that needs a multi-byte tag.
+  outer.Varint(100, 7);
+
+  std::vector<Field> fields;
+  ASSERT_TRUE(ReadFields(outer.data(), &fields));
+  ASSERT_EQ(fields.size(), 2u);
+  EXPECT_EQ(fields[0].number, 4u);
+  EXPECT_EQ(fields[0].wire_type, ProtoWriter::kWireTypeLengthDelimited);
+  EXPECT_EQ(fields[0].bytes, inner.data());
+  EXPECT_EQ(fields[1].number, 100u);
+  EXPECT_EQ(fields[1].value, 7u);
+
+  std::vector<Field> inner_fields;
+  ASSERT_TRUE(ReadFields(fields[0].bytes, &inner_fields));
+  ASSERT_EQ(inner_fields.size(), 3u);
+  EXPECT_EQ(inner_fields[0].value, 42u);
+  EXPECT_EQ(inner_fields[1].bytes, std::string("a\0b", 3));
+
+  size_t pos = 0;
+  std::vector<uint64_t> packed;
+  const std::string& packed_bytes = inner_fields[2].bytes;
+  while (pos < packed_bytes.size()) {
+    uint64_t value;
+    ASSERT_TRUE(ReadVarint(packed_bytes, &pos, &value));
+    packed.push_back(value);
+  }
+  EXPECT_EQ(packed, (std::vector<uint64_t>{5, 1000, 0}));
+}
+
+TEST(ProfileProtoTest, StringTableRoundTrip) {
+  StringTable strings;
+  EXPECT_EQ(strings.Intern(""), 0u);
+  EXPECT_EQ(strings.Intern("samples"), 1u);
+  EXPECT_EQ(strings.Intern("count"), 2u);
+  EXPECT_EQ(strings.Intern("samples"), 1u);
+
+  ProtoWriter writer;
+  for (const std::string& str : strings.strings()) {
+    writer.Bytes(6, str);
+  }
+
+  std::vector<Field> fields;
+  ASSERT_TRUE(ReadFields(writer.data(), &fields));
+  std::vector<std::string> read_strings;
+  for (const Field& field : fields) {
+    EXPECT_EQ(field.number, 6u);
+    read_strings.push_back(field.bytes);
+  }
+  EXPECT_EQ(read_strings, (std::vector<std::string>{"", "samples", "count"}));
+}
+
+}  // namespace
+
+}  // namespace cpuperf
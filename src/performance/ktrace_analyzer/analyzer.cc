@@ -0,0 +1,460 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/performance/ktrace_analyzer/analyzer.h"
+
+#include <inttypes.h>
+#include <lib/syslog/cpp/macros.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <string_view>
+
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
+
+namespace ktrace_analyzer {
+
+namespace {
+
+using JsonWriter = rapidjson::PrettyWriter<rapidjson::OStreamWrapper>;
+
+constexpr std::string_view kIrqCategory = "kernel:irq";
+constexpr std::string_view kIrqName = "irq";
+constexpr std::string_view kIrqNumberArg = "irq #";
+
+constexpr std::string_view kSchedCategory = "kernel:sched";
+constexpr std::string_view kProbeCategory = "kernel:probe";
+
+// Durations the kernel's lock tracing emits around contended acquisitions.
+constexpr std::string_view kContendedAcquireNames[] = {
+    "Mutex::AcquireContended",
+    "ContendedReadAcquire",
+    "ContendedWriteAcquire",
+    "ContendedReadUpgrade",
+};
+
+constexpr std::string_view kMutexBlockName = "mutex_block";
+constexpr std::string_view kMutexReleaseName = "mutex_release";
+constexpr std::string_view kMutexIdArg = "mutex_id";
+constexpr std::string_view kMutexWaiterCountArg = "waiter_count";
+constexpr std::string_view kMutexTidTypeArg = "tid_type";
+
+constexpr std::string_view kThreadEnqueueName = "tqe_enque";
+constexpr std::string_view kThreadEnqueueTidArg = "arg0";
+
+constexpr std::string_view kInheritPriorityName = "inherit_prio";
+
+constexpr double kPercentiles[] = {50, 90, 99};
+
+const trace::ArgumentValue* FindArgument(const fbl::Vector<trace::Argument>& arguments,
+                                         std::string_view name) {
+  for (const auto& argument : arguments) {
+    if (std::string_view(argument.name()) == name) {
+      return &argument.value();
+    }
+  }
+  return nullptr;
+}
+
+std::optional<uint64_t> GetUnsignedArgument(const fbl::Vector<trace::Argument>& arguments,
+                                            std::string_view name) {
+  const trace::ArgumentValue* value = FindArgument(arguments, name);
+  if (value == nullptr) {
+    return std::nullopt;
+  }
+  switch (value->type()) {
+    case trace::ArgumentType::kUint32:
+      return value->GetUint32();
+    case trace::ArgumentType::kUint64:
+      return value->GetUint64();
+    case trace::ArgumentType::kPointer:
+      return value->GetPointer();
+    case trace::ArgumentType::kKoid:
+      return value->GetKoid();
+    default:
+      return std::nullopt;
+  }
+}
+
+uint64_t ToNanoseconds(trace_ticks_t ticks, trace_ticks_t ticks_per_second) {
+  if (ticks_per_second == 0) {
+    return ticks;
+  }
+  return static_cast<uint64_t>(static_cast<double>(ticks) * 1e9 /
+                               static_cast<double>(ticks_per_second));
+}
+
+void WriteDistribution(JsonWriter* writer, const Distribution& distribution,
+                       trace_ticks_t ticks_per_second) {
+  writer->Key("count");
+  writer->Uint64(distribution.count());
+  writer->Key("total_ns");
+  writer->Uint64(ToNanoseconds(distribution.total(), ticks_per_second));
+  writer->Key("max_ns");
+  writer->Uint64(ToNanoseconds(distribution.max(), ticks_per_second));
+  for (double percentile : kPercentiles) {
+    char key[16];
+    snprintf(key, sizeof(key), "p%d_ns", static_cast<int>(percentile));
+    writer->Key(key);
+    writer->Uint64(ToNanoseconds(distribution.Percentile(percentile), ticks_per_second));
+  }
+}
+
+}  // namespace
+
+void Distribution::Add(trace_ticks_t ticks) {
+  values_.push_back(ticks);
+  sorted_ = false;
+  total_ += ticks;
+  max_ = std::max(max_, ticks);
+}
+
+trace_ticks_t Distribution::Percentile(double percentile) const {
+  if (values_.empty()) {
+    return 0;
+  }
+  if (!sorted_) {
+    std::sort(values_.begin(), values_.end());
+    sorted_ = true;
+  }
+  const auto rank = static_cast<size_t>(
+      std::ceil(percentile / 100.0 * static_cast<double>(values_.size())));
+  return values_[std::clamp<size_t>(rank, 1, values_.size()) - 1];
+}
+
+KernelTraceAnalyzer::KernelTraceAnalyzer()
+    : reader_([this](trace::Record record) { AddRecord(record); },
+              [](fbl::String error) { FX_LOGS(ERROR) << error.c_str(); }) {}
+
+KernelTraceAnalyzer::~KernelTraceAnalyzer() = default;
+
+bool KernelTraceAnalyzer::ReadTrace(std::istream* in) {
+  size_t buffer_end = 0;
+  while (!in->eof()) {
+    size_t bytes_read = in->read(buffer_.data() + buffer_end, buffer_.size() - buffer_end).gcount();
+    if (bytes_read == 0) {
+      FX_LOGS(ERROR) << "Read returned 0 bytes";
+      return false;
+    }
+    buffer_end += bytes_read;
+
+    size_t words = buffer_end / sizeof(uint64_t);
+    trace::Chunk chunk(reinterpret_cast<const uint64_t*>(buffer_.data()), words);
+
+    if (!reader_.ReadRecords(chunk)) {
+      FX_LOGS(ERROR) << "Error parsing trace";
+      return false;
+    }
+
+    size_t offset = chunk.current_byte_offset();
+    memmove(buffer_.data(), buffer_.data() + offset, buffer_end - offset);
+    buffer_end -= offset;
+  }
+
+  if (buffer_end > 0) {
+    FX_LOGS(ERROR) << "Trace file did not end at a record boundary.";
+    return false;
+  }
+
+  return true;
+}
+
+void KernelTraceAnalyzer::AddRecord(const trace::Record& record) {
+  switch (record.type()) {
+    case trace::RecordType::kInitialization:
+      ticks_per_second_ = record.GetInitialization().ticks_per_second;
+      break;
+    case trace::RecordType::kEvent:
+      AddEvent(record.GetEvent());
+      break;
+    case trace::RecordType::kContextSwitch:
+      AddContextSwitch(record.GetContextSwitch());
+      break;
+    default:
+      break;
+  }
+}
+
+void KernelTraceAnalyzer::AddEvent(const trace::Record::Event& event) {
+  switch (event.type()) {
+    case trace::EventType::kDurationBegin: {
+      const uint64_t irq = GetUnsignedArgument(event.arguments, kIrqNumberArg).value_or(0);
+      open_durations_[event.process_thread].push_back(
+          OpenDuration{event.timestamp, event.category, event.name, irq});
+      break;
+    }
+    case trace::EventType::kDurationEnd: {
+      auto it = open_durations_.find(event.process_thread);
+      if (it == open_durations_.end() || it->second.empty()) {
+        // The duration began before the trace did.
+        break;
+      }
+      const OpenDuration begin = it->second.back();
+      it->second.pop_back();
+      AddDuration(begin.category, begin.name, begin.irq, begin.begin, event.timestamp);
+      break;
+    }
+    case trace::EventType::kDurationComplete: {
+      const std::string_view name(event.name);
+      if (std::string_view(event.category) == kSchedCategory &&
+          (name == kMutexBlockName || name == kMutexReleaseName)) {
+        AddMutexEvent(event);
+        break;
+      }
+      const uint64_t irq = GetUnsignedArgument(event.arguments, kIrqNumberArg).value_or(0);
+      AddDuration(event.category, event.name, irq, event.timestamp,
+                  event.data.GetDurationComplete().end_time);
+      break;
+    }
+    case trace::EventType::kInstant:
+      if (std::string_view(event.category) == kProbeCategory &&
+          std::string_view(event.name) == kThreadEnqueueName) {
+        if (auto tid = GetUnsignedArgument(event.arguments, kThreadEnqueueTidArg); tid && *tid) {
+          // A thread that is already waiting to run keeps its original time.
+          runnable_since_.try_emplace(*tid, event.timestamp);
+        }
+      }
+      break;
+    case trace::EventType::kFlowBegin:
+      AddInheritanceFlow(event, event.data.GetFlowBegin().id);
+      break;
+    case trace::EventType::kFlowStep:
+      AddInheritanceFlow(event, event.data.GetFlowStep().id);
+      break;
+    case trace::EventType::kFlowEnd:
+      AddInheritanceFlow(event, event.data.GetFlowEnd().id);
+      break;
+    default:
+      break;
+  }
+}
+
+void KernelTraceAnalyzer::AddDuration(const fbl::String& category, const fbl::String& name,
+                                      uint64_t irq, trace_ticks_t begin, trace_ticks_t end) {
+  if (end < begin) {
+    return;
+  }
+  const trace_ticks_t duration = end - begin;
+
+  if (std::string_view(category) == kIrqCategory && std::string_view(name) == kIrqName) {
+    irq_time_.Add(duration);
+    irqs_[irq].Add(duration);
+    return;
+  }
+
+  if (std::string_view(category) == kSchedCategory) {
+    for (std::string_view contended_name : kContendedAcquireNames) {
+      if (std::string_view(name) == contended_name) {
+        contended_acquires_[std::string(contended_name)].Add(duration);
+        return;
+      }
+    }
+  }
+}
+
+void KernelTraceAnalyzer::AddMutexEvent(const trace::Record::Event& event) {
+  const std::optional<uint64_t> mutex_id = GetUnsignedArgument(event.arguments, kMutexIdArg);
+  if (!mutex_id) {
+    return;
+  }
+
+  if (std::string_view(event.name) == kMutexBlockName) {
+    LockStats& stats = mutexes_[*mutex_id];
+    stats.blocks++;
+    const uint64_t waiters = GetUnsignedArgument(event.arguments, kMutexWaiterCountArg).value_or(0);
+    stats.max_waiters = std::max(stats.max_waiters, static_cast<uint32_t>(waiters));
+    blocked_since_[*mutex_id].push_back(event.timestamp);
+    return;
+  }
+
+  // Uncontested releases have no new owner. Otherwise, one of the blocked threads was woken.
+  // Waiters aren't identified in the trace, so each wake is matched with the longest waiting
+  // thread; the total time spent blocked is exact even if the order of wakes is not.
+  const trace::ArgumentValue* tid_type = FindArgument(event.arguments, kMutexTidTypeArg);
+  if (tid_type == nullptr || tid_type->type() != trace::ArgumentType::kString ||
+      std::string_view(tid_type->GetString()) == "none") {
+    return;
+  }
+  auto it = blocked_since_.find(*mutex_id);
+  if (it == blocked_since_.end() || it->second.empty()) {
+    return;
+  }
+  const trace_ticks_t blocked = it->second.front();
+  it->second.pop_front();
+  if (event.timestamp >= blocked) {
+    mutexes_[*mutex_id].wait.Add(event.timestamp - blocked);
+  }
+}
+
+void KernelTraceAnalyzer::AddContextSwitch(const trace::Record::ContextSwitch& context_switch) {
+  const zx_koid_t outgoing = context_switch.outgoing_thread.thread_koid();
+  const zx_koid_t incoming = context_switch.incoming_thread.thread_koid();
+
+  if (outgoing != ZX_KOID_INVALID) {
+    // Preempted threads are reported as new (ready to run) or still running.
+    if (context_switch.outgoing_thread_state == trace::ThreadState::kNew ||
+        context_switch.outgoing_thread_state == trace::ThreadState::kRunning) {
+      runnable_since_.try_emplace(outgoing, context_switch.timestamp);
+    } else {
+      runnable_since_.erase(outgoing);
+    }
+  }
+
+  if (incoming != ZX_KOID_INVALID) {
+    auto it = runnable_since_.find(incoming);
+    if (it != runnable_since_.end()) {
+      if (context_switch.timestamp >= it->second) {
+        const trace_ticks_t latency = context_switch.timestamp - it->second;
+        scheduling_latency_.Add(latency);
+        ThreadStats& stats = threads_[incoming];
+        stats.process_koid = context_switch.incoming_thread.process_koid();
+        stats.latency.Add(latency);
+      }
+      runnable_since_.erase(it);
+    }
+  }
+}
+
+void KernelTraceAnalyzer::AddInheritanceFlow(const trace::Record::Event& event,
+                                             trace_flow_id_t id) {
+  if (std::string_view(event.category) != kSchedCategory ||
+      std::string_view(event.name) != kInheritPriorityName) {
+    return;
+  }
+
+  if (event.type() == trace::EventType::kFlowBegin) {
+    open_chains_[id] = InheritanceChain{event.timestamp, event.timestamp, {}};
+  }
+  auto it = open_chains_.find(id);
+  if (it == open_chains_.end()) {
+    // The chain began before the trace did.
+    return;
+  }
+
+  InheritanceChain& chain = it->second;
+  const zx_koid_t thread = event.process_thread.thread_koid();
+  if (chain.threads.empty() || chain.threads.back() != thread) {
+    chain.threads.push_back(thread);
+  }
+  chain.end = event.timestamp;
+
+  if (event.type() == trace::EventType::kFlowEnd) {
+    inheritance_chains_.push_back(std::move(chain));
+    open_chains_.erase(it);
+  }
+}
+
+void KernelTraceAnalyzer::WriteJson(std::ostream* out) const {
+  rapidjson::OStreamWrapper stream(*out);
+  JsonWriter writer(stream);
+
+  writer.StartObject();
+  writer.Key("ticks_per_second");
+  writer.Uint64(ticks_per_second_);
+
+  writer.Key("lock_contention");
+  writer.StartObject();
+  writer.Key("contended_acquires");
+  writer.StartArray();
+  for (const auto& [name, distribution] : contended_acquires_) {
+    writer.StartObject();
+    writer.Key("name");
+    writer.String(name.c_str());
+    WriteDistribution(&writer, distribution, ticks_per_second_);
+    writer.EndObject();
+  }
+  writer.EndArray();
+
+  // The most contended mutexes come first.
+  std::vector<std::pair<uint64_t, const LockStats*>> mutexes;
+  for (const auto& [id, stats] : mutexes_) {
+    mutexes.emplace_back(id, &stats);
+  }
+  std::stable_sort(mutexes.begin(), mutexes.end(), [](const auto& a, const auto& b) {
+    return a.second->wait.total() > b.second->wait.total();
+  });
+  writer.Key("mutexes");
+  writer.StartArray();
+  for (const auto& [id, stats] : mutexes) {
+    char mutex_id[24];
+    snprintf(mutex_id, sizeof(mutex_id), "%#" PRIx64, id);
+    writer.StartObject();
+    writer.Key("mutex_id");
+    writer.String(mutex_id);
+    writer.Key("blocks");
+    writer.Uint64(stats->blocks);
+    writer.Key("max_waiters");
+    writer.Uint(stats->max_waiters);
+    WriteDistribution(&writer, stats->wait, ticks_per_second_);
+    writer.EndObject();
+  }
+  writer.EndArray();
+  writer.EndObject();
+
+  writer.Key("scheduling_latency");
+  writer.StartObject();
+  WriteDistribution(&writer, scheduling_latency_, ticks_per_second_);
+  // The threads that waited longest to run come first.
+  std::vector<std::pair<zx_koid_t, const ThreadStats*>> threads;
+  for (const auto& [koid, stats] : threads_) {
+    threads.emplace_back(koid, &stats);
+  }
+  std::stable_sort(threads.begin(), threads.end(), [](const auto& a, const auto& b) {
+    return a.second->latency.max() > b.second->latency.max();
+  });
+  writer.Key("threads");
+  writer.StartArray();
+  for (const auto& [koid, stats] : threads) {
+    writer.StartObject();
+    writer.Key("process_koid");
+    writer.Uint64(stats->process_koid);
+    writer.Key("thread_koid");
+    writer.Uint64(koid);
+    WriteDistribution(&writer, stats->latency, ticks_per_second_);
+    writer.EndObject();
+  }
+  writer.EndArray();
+  writer.EndObject();
+
+  writer.Key("irqs_disabled");
+  writer.StartObject();
+  WriteDistribution(&writer, irq_time_, ticks_per_second_);
+  writer.Key("irqs");
+  writer.StartArray();
+  for (const auto& [irq, distribution] : irqs_) {
+    writer.StartObject();
+    writer.Key("irq");
+    writer.Uint64(irq);
+    WriteDistribution(&writer, distribution, ticks_per_second_);
+    writer.EndObject();
+  }
+  writer.EndArray();
+  writer.EndObject();
+
+  writer.Key("priority_inheritance_chains");
+  writer.StartArray();
+  for (const InheritanceChain& chain : inheritance_chains_) {
+    writer.StartObject();
+    writer.Key("duration_ns");
+    writer.Uint64(ToNanoseconds(chain.end - chain.begin, ticks_per_second_));
+    writer.Key("threads");
+    writer.StartArray();
+    for (zx_koid_t thread : chain.threads) {
+      writer.Uint64(thread);
+    }
+    writer.EndArray();
+    writer.EndObject();
+  }
+  writer.EndArray();
+
+  writer.EndObject();
+  stream.Flush();
+  *out << std::endl;
+}
+
+}  // namespace ktrace_analyzer
@@ -0,0 +1,143 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SRC_PERFORMANCE_KTRACE_ANALYZER_ANALYZER_H_
+#define SRC_PERFORMANCE_KTRACE_ANALYZER_ANALYZER_H_
+
+#include <lib/trace-engine/fields.h>
+#include <stdint.h>
+
+#include <array>
+#include <deque>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <trace-reader/reader.h>
+
+namespace ktrace_analyzer {
+
+// A set of intervals, in ticks, summarized by their count, total, maximum and percentiles.
+class Distribution {
+ public:
+  void Add(trace_ticks_t ticks);
+
+  size_t count() const { return values_.size(); }
+  trace_ticks_t total() const { return total_; }
+  trace_ticks_t max() const { return max_; }
+
+  // Returns the smallest value that at least |percentile| percent of the values are less than or
+  // equal to, or 0 if there are no values.
+  trace_ticks_t Percentile(double percentile) const;
+
+ private:
+  mutable std::vector<trace_ticks_t> values_;
+  mutable bool sorted_ = true;
+  trace_ticks_t total_ = 0;
+  trace_ticks_t max_ = 0;
+};
+
+// Computes lock contention, scheduling latency, interrupt and priority inheritance statistics
+// from the records the kernel writes to a trace:
+//
+//  - Contended lock acquisitions, from the "kernel:sched" durations the kernel emits around them
+//    (e.g. "Mutex::AcquireContended"), grouped by name. When kernel mutex tracing is enabled,
+//    time spent blocked on each mutex is also computed from its "mutex_block" and
+//    "mutex_release" events.
+//  - Runnable-to-running latency per thread, from context switch records. A thread becomes
+//    runnable when it is preempted, or when the scheduler's queue tracing reports it enqueued
+//    ("tqe_enque"); without queue tracing only the latency after preemption is measured.
+//  - Time spent in interrupt handlers, with interrupts disabled, from "kernel:irq" durations.
+//  - Priority inheritance chains, from the "inherit_prio" flows the kernel emits as a blocked
+//    thread's priority is propagated to the owners of the locks it waits on.
+class KernelTraceAnalyzer {
+ public:
+  struct LockStats {
+    // Number of times a thread blocked on the lock.
+    uint64_t blocks = 0;
+    uint32_t max_waiters = 0;
+    Distribution wait;
+  };
+
+  struct ThreadStats {
+    zx_koid_t process_koid = ZX_KOID_INVALID;
+    Distribution latency;
+  };
+
+  struct InheritanceChain {
+    trace_ticks_t begin = 0;
+    trace_ticks_t end = 0;
+    // Threads whose priority changed, in the order it was propagated to them.
+    std::vector<zx_koid_t> threads;
+  };
+
+  KernelTraceAnalyzer();
+  ~KernelTraceAnalyzer();
+
+  // Reads a complete trace in the Fuchsia trace format from |in| and analyzes its records.
+  bool ReadTrace(std::istream* in);
+
+  void AddRecord(const trace::Record& record);
+
+  // Writes the statistics gathered so far as a JSON report. Durations are reported in
+  // nanoseconds.
+  void WriteJson(std::ostream* out) const;
+
+  const std::map<std::string, Distribution>& contended_acquires() const {
+    return contended_acquires_;
+  }
+  const std::map<uint64_t, LockStats>& mutexes() const { return mutexes_; }
+  const Distribution& scheduling_latency() const { return scheduling_latency_; }
+  const std::map<zx_koid_t, ThreadStats>& threads() const { return threads_; }
+  const Distribution& irq_time() const { return irq_time_; }
+  const std::map<uint64_t, Distribution>& irqs() const { return irqs_; }
+  const std::vector<InheritanceChain>& inheritance_chains() const { return inheritance_chains_; }
+
+ private:
+  static constexpr size_t kReadBufferSize = trace::RecordFields::kMaxRecordSizeBytes * 4;
+
+  struct OpenDuration {
+    trace_ticks_t begin;
+    fbl::String category;
+    fbl::String name;
+    uint64_t irq;
+  };
+
+  void AddEvent(const trace::Record::Event& event);
+  void AddContextSwitch(const trace::Record::ContextSwitch& context_switch);
+  void AddDuration(const fbl::String& category, const fbl::String& name, uint64_t irq,
+                   trace_ticks_t begin, trace_ticks_t end);
+  void AddMutexEvent(const trace::Record::Event& event);
+  void AddInheritanceFlow(const trace::Record::Event& event, trace_flow_id_t id);
+
+  trace::TraceReader reader_;
+  std::array<char, kReadBufferSize> buffer_;
+  trace_ticks_t ticks_per_second_ = 0;
+
+  // Durations that have begun but not yet ended, by thread.
+  std::map<trace::ProcessThread, std::vector<OpenDuration>> open_durations_;
+
+  std::map<std::string, Distribution> contended_acquires_;
+
+  std::map<uint64_t, LockStats> mutexes_;
+  // Times at which threads blocked on each mutex and have not yet been woken.
+  std::map<uint64_t, std::deque<trace_ticks_t>> blocked_since_;
+
+  Distribution scheduling_latency_;
+  std::map<zx_koid_t, ThreadStats> threads_;
+  // Times at which threads became runnable and have not yet run.
+  std::map<zx_koid_t, trace_ticks_t> runnable_since_;
+
+  Distribution irq_time_;
+  std::map<uint64_t, Distribution> irqs_;
+
+  std::map<trace_flow_id_t, InheritanceChain> open_chains_;
+  std::vector<InheritanceChain> inheritance_chains_;
+};
+
+}  // namespace ktrace_analyzer
+
+#endif  // SRC_PERFORMANCE_KTRACE_ANALYZER_ANALYZER_H_
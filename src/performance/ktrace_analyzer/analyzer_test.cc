@@ -0,0 +1,216 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/performance/ktrace_analyzer/analyzer.h"
+
+#include <gtest/gtest.h>
+#include <rapidjson/document.h>
+
+#include <sstream>
+#include <utility>
+
+namespace ktrace_analyzer {
+namespace {
+
+constexpr zx_koid_t kKernelPseudoCpuBase = 0x100000000;
+
+trace::Record MakeEvent(trace_ticks_t timestamp, trace::ProcessThread thread, const char* category,
+                        const char* name, trace::EventData data,
+                        fbl::Vector<trace::Argument> arguments = {}) {
+  return trace::Record(trace::Record::Event{timestamp, thread, category, name,
+                                            std::move(arguments), std::move(data)});
+}
+
+trace::Record MakeContextSwitch(trace_ticks_t timestamp, zx_koid_t outgoing,
+                                trace::ThreadState outgoing_state, zx_koid_t incoming) {
+  return trace::Record(trace::Record::ContextSwitch{
+      timestamp, 0, outgoing_state, trace::ProcessThread(1, outgoing),
+      trace::ProcessThread(1, incoming), 16, 16});
+}
+
+fbl::Vector<trace::Argument> MakeMutexArguments(uint64_t mutex_id, const char* tid_type,
+                                                uint32_t waiter_count) {
+  fbl::Vector<trace::Argument> arguments;
+  arguments.push_back(trace::Argument("mutex_id", trace::ArgumentValue::MakePointer(mutex_id)));
+  arguments.push_back(trace::Argument("tid", trace::ArgumentValue::MakeKoid(1234)));
+  arguments.push_back(trace::Argument("tid_type", trace::ArgumentValue::MakeString(tid_type)));
+  arguments.push_back(
+      trace::Argument("waiter_count", trace::ArgumentValue::MakeUint32(waiter_count)));
+  return arguments;
+}
+
+TEST(KernelTraceAnalyzer, ContendedAcquires) {
+  KernelTraceAnalyzer analyzer;
+  const trace::ProcessThread thread(1, 2);
+
+  analyzer.AddRecord(MakeEvent(100, thread, "kernel:sched", "Mutex::AcquireContended",
+                               trace::EventData(trace::EventData::DurationBegin{})));
+  analyzer.AddRecord(MakeEvent(130, thread, "kernel:sched", "Mutex::AcquireContended",
+                               trace::EventData(trace::EventData::DurationEnd{})));
+  analyzer.AddRecord(MakeEvent(200, thread, "kernel:sched", "ContendedWriteAcquire",
+                               trace::EventData(trace::EventData::DurationBegin{})));
+  // Durations that aren't lock contention are ignored, even when nested.
+  analyzer.AddRecord(MakeEvent(210, thread, "kernel:sched", "other",
+                               trace::EventData(trace::EventData::DurationBegin{})));
+  analyzer.AddRecord(MakeEvent(220, thread, "kernel:sched", "other",
+                               trace::EventData(trace::EventData::DurationEnd{})));
+  analyzer.AddRecord(MakeEvent(250, thread, "kernel:sched", "ContendedWriteAcquire",
+                               trace::EventData(trace::EventData::DurationEnd{})));
+
+  const auto& acquires = analyzer.contended_acquires();
+  ASSERT_EQ(2u, acquires.size());
+  EXPECT_EQ(1u, acquires.at("Mutex::AcquireContended").count());
+  EXPECT_EQ(30u, acquires.at("Mutex::AcquireContended").total());
+  EXPECT_EQ(1u, acquires.at("ContendedWriteAcquire").count());
+  EXPECT_EQ(50u, acquires.at("ContendedWriteAcquire").total());
+}
+
+TEST(KernelTraceAnalyzer, MutexContention) {
+  KernelTraceAnalyzer analyzer;
+  const trace::ProcessThread owner(1, 1234);
+  constexpr uint64_t kMutex = 0xffff0000'00001000;
+
+  // Two threads block on the mutex, and are woken in turn as it is released.
+  analyzer.AddRecord(
+      MakeEvent(100, owner, "kernel:sched", "mutex_block",
+                trace::EventData(trace::EventData::DurationComplete{150}),
+                MakeMutexArguments(kMutex, "kernel_mode", 1)));
+  analyzer.AddRecord(
+      MakeEvent(120, owner, "kernel:sched", "mutex_block",
+                trace::EventData(trace::EventData::DurationComplete{170}),
+                MakeMutexArguments(kMutex, "kernel_mode", 2)));
+  analyzer.AddRecord(
+      MakeEvent(200, owner, "kernel:sched", "mutex_release",
+                trace::EventData(trace::EventData::DurationComplete{250}),
+                MakeMutexArguments(kMutex, "kernel_mode", 1)));
+  analyzer.AddRecord(
+      MakeEvent(300, owner, "kernel:sched", "mutex_release",
+                trace::EventData(trace::EventData::DurationComplete{350}),
+                MakeMutexArguments(kMutex, "user_mode", 0)));
+  // An uncontested release doesn't wake anyone.
+  analyzer.AddRecord(
+      MakeEvent(400, owner, "kernel:sched", "mutex_release",
+                trace::EventData(trace::EventData::DurationComplete{450}),
+                MakeMutexArguments(kMutex, "none", 0)));
+
+  const auto& mutexes = analyzer.mutexes();
+  ASSERT_EQ(1u, mutexes.size());
+  const auto& stats = mutexes.at(kMutex);
+  EXPECT_EQ(2u, stats.blocks);
+  EXPECT_EQ(2u, stats.max_waiters);
+  EXPECT_EQ(2u, stats.wait.count());
+  EXPECT_EQ((200u - 100u) + (300u - 120u), stats.wait.total());
+  EXPECT_EQ(180u, stats.wait.max());
+}
+
+TEST(KernelTraceAnalyzer, SchedulingLatency) {
+  KernelTraceAnalyzer analyzer;
+
+  // Thread 10 is preempted by thread 11, and runs again 40 ticks later.
+  analyzer.AddRecord(MakeContextSwitch(100, 10, trace::ThreadState::kNew, 11));
+  analyzer.AddRecord(MakeContextSwitch(140, 11, trace::ThreadState::kBlocked, 10));
+  // Thread 11 was blocked, so it has no latency until it is enqueued.
+  analyzer.AddRecord(MakeContextSwitch(150, 10, trace::ThreadState::kBlocked, 11));
+
+  fbl::Vector<trace::Argument> arguments;
+  arguments.push_back(trace::Argument("arg0", trace::ArgumentValue::MakeUint64(10)));
+  analyzer.AddRecord(
+      MakeEvent(200, trace::ProcessThread(0, kKernelPseudoCpuBase), "kernel:probe", "tqe_enque",
+                trace::EventData(trace::EventData::Instant{trace::EventScope::kThread}),
+                std::move(arguments)));
+  analyzer.AddRecord(MakeContextSwitch(210, 11, trace::ThreadState::kBlocked, 10));
+
+  EXPECT_EQ(2u, analyzer.scheduling_latency().count());
+  const auto& threads = analyzer.threads();
+  ASSERT_EQ(1u, threads.size());
+  const auto& stats = threads.at(10);
+  EXPECT_EQ(1u, stats.process_koid);
+  EXPECT_EQ(2u, stats.latency.count());
+  EXPECT_EQ(40u, stats.latency.max());
+  EXPECT_EQ(10u, stats.latency.Percentile(50));
+  EXPECT_EQ(40u, stats.latency.Percentile(99));
+}
+
+TEST(KernelTraceAnalyzer, Irqs) {
+  KernelTraceAnalyzer analyzer;
+  const trace::ProcessThread cpu0(0, kKernelPseudoCpuBase);
+  const trace::ProcessThread cpu1(0, kKernelPseudoCpuBase + 1);
+
+  auto irq_arguments = [](uint64_t irq) {
+    fbl::Vector<trace::Argument> arguments;
+    arguments.push_back(trace::Argument("irq #", trace::ArgumentValue::MakeUint64(irq)));
+    return arguments;
+  };
+
+  // Interrupts on different CPUs overlap.
+  analyzer.AddRecord(MakeEvent(100, cpu0, "kernel:irq", "irq",
+                               trace::EventData(trace::EventData::DurationBegin{}),
+                               irq_arguments(32)));
+  analyzer.AddRecord(MakeEvent(105, cpu1, "kernel:irq", "irq",
+                               trace::EventData(trace::EventData::DurationBegin{}),
+                               irq_arguments(33)));
+  analyzer.AddRecord(MakeEvent(110, cpu0, "kernel:irq", "irq",
+                               trace::EventData(trace::EventData::DurationEnd{}),
+                               irq_arguments(32)));
+  analyzer.AddRecord(MakeEvent(125, cpu1, "kernel:irq", "irq",
+                               trace::EventData(trace::EventData::DurationEnd{}),
+                               irq_arguments(33)));
+
+  EXPECT_EQ(2u, analyzer.irq_time().count());
+  EXPECT_EQ(30u, analyzer.irq_time().total());
+  EXPECT_EQ(20u, analyzer.irq_time().max());
+  ASSERT_EQ(2u, analyzer.irqs().size());
+  EXPECT_EQ(10u, analyzer.irqs().at(32).total());
+  EXPECT_EQ(20u, analyzer.irqs().at(33).total());
+}
+
+TEST(KernelTraceAnalyzer, InheritanceChains) {
+  KernelTraceAnalyzer analyzer;
+
+  analyzer.AddRecord(MakeEvent(100, trace::ProcessThread(1, 20), "kernel:sched", "inherit_prio",
+                               trace::EventData(trace::EventData::FlowBegin{7})));
+  analyzer.AddRecord(MakeEvent(110, trace::ProcessThread(1, 20), "kernel:sched", "inherit_prio",
+                               trace::EventData(trace::EventData::FlowStep{7})));
+  analyzer.AddRecord(MakeEvent(120, trace::ProcessThread(2, 30), "kernel:sched", "inherit_prio",
+                               trace::EventData(trace::EventData::FlowEnd{7})));
+  // A chain that is still open at the end of the trace is not reported.
+  analyzer.AddRecord(MakeEvent(130, trace::ProcessThread(1, 20), "kernel:sched", "inherit_prio",
+                               trace::EventData(trace::EventData::FlowBegin{8})));
+
+  const auto& chains = analyzer.inheritance_chains();
+  ASSERT_EQ(1u, chains.size());
+  EXPECT_EQ(100u, chains[0].begin);
+  EXPECT_EQ(120u, chains[0].end);
+  EXPECT_EQ((std::vector<zx_koid_t>{20, 30}), chains[0].threads);
+}
+
+TEST(KernelTraceAnalyzer, JsonReport) {
+  KernelTraceAnalyzer analyzer;
+  // One tick per microsecond.
+  analyzer.AddRecord(trace::Record(trace::Record::Initialization{1'000'000}));
+  analyzer.AddRecord(MakeContextSwitch(100, 10, trace::ThreadState::kRunning, 11));
+  analyzer.AddRecord(MakeContextSwitch(103, 11, trace::ThreadState::kBlocked, 10));
+
+  std::stringstream out;
+  analyzer.WriteJson(&out);
+
+  rapidjson::Document document;
+  document.Parse(out.str().c_str());
+  ASSERT_FALSE(document.HasParseError());
+  EXPECT_EQ(1'000'000u, document["ticks_per_second"].GetUint64());
+
+  const auto& latency = document["scheduling_latency"];
+  EXPECT_EQ(1u, latency["count"].GetUint64());
+  EXPECT_EQ(3000u, latency["max_ns"].GetUint64());
+  EXPECT_EQ(3000u, latency["p99_ns"].GetUint64());
+  ASSERT_EQ(1u, latency["threads"].Size());
+  EXPECT_EQ(10u, latency["threads"][0]["thread_koid"].GetUint64());
+
+  EXPECT_TRUE(document["lock_contention"]["mutexes"].Empty());
+  EXPECT_TRUE(document["irqs_disabled"]["irqs"].Empty());
+  EXPECT_TRUE(document["priority_inheritance_chains"].Empty());
+}
+
+}  // namespace
+}  // namespace ktrace_analyzer
@@ -0,0 +1,119 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <lib/syslog/cpp/macros.h>
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+
+#include "src/lib/fxl/command_line.h"
+#include "src/lib/fxl/log_settings_command_line.h"
+#include "src/performance/ktrace_analyzer/analyzer.h"
+
+namespace {
+
+const char kHelp[] = "help";
+const char kInputFile[] = "input-file";
+const char kOutputFile[] = "output-file";
+
+std::set<std::string> kKnownOptions = {
+    kHelp,
+    kInputFile,
+    kOutputFile,
+};
+
+void PrintHelpMessage() {
+  std::map<std::string, std::string> options = {
+      {"help", "Print this help message."},
+      {"input-file=[]",
+       "Read trace from the specified file. If no file is specified, the input "
+       "is read from stdin."},
+      {"output-file=[]",
+       "Write the report to the specified file. If no file is specified, the "
+       "report is written to stdout."},
+  };
+
+  std::cerr << "ktrace_analyzer [options]: Compute lock contention, scheduling latency, "
+               "interrupt and priority inheritance statistics from the kernel records of a "
+               "trace in fxt (Fuchsia trace format), and write them as a json report."
+            << std::endl;
+  for (const auto& option : options) {
+    std::cerr << "  --" << option.first << ": " << option.second << std::endl;
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  auto command_line = fxl::CommandLineFromArgcArgv(argc, argv);
+  if (!fxl::SetLogSettingsFromCommandLine(command_line)) {
+    return 1;
+  }
+
+  if (command_line.HasOption(kHelp)) {
+    PrintHelpMessage();
+    return 0;
+  }
+
+  bool invalid_options = false;
+  for (const auto& option : command_line.options()) {
+    if (kKnownOptions.count(option.name) == 0) {
+      FX_LOGS(ERROR) << "Unknown option: " << option.name;
+      invalid_options = true;
+    }
+  }
+
+  if (command_line.positional_args().size() > 0) {
+    FX_LOGS(ERROR) << "Unexpected positional arg";
+    invalid_options = true;
+  }
+
+  if (invalid_options) {
+    PrintHelpMessage();
+    return 1;
+  }
+
+  std::istream* in_stream = &std::cin;
+  std::unique_ptr<std::ifstream> input_file_stream;
+  if (command_line.HasOption(kInputFile)) {
+    std::string input_file_name;
+    command_line.GetOptionValue(kInputFile, &input_file_name);
+    input_file_stream = std::make_unique<std::ifstream>(input_file_name.c_str(),
+                                                        std::ios_base::in | std::ios_base::binary);
+    if (!input_file_stream->is_open()) {
+      FX_LOGS(ERROR) << "Error opening input file.";
+      return 1;
+    }
+    in_stream = input_file_stream.get();
+  }
+
+  std::ostream* out_stream = &std::cout;
+  std::unique_ptr<std::ofstream> output_file_stream;
+  if (command_line.HasOption(kOutputFile)) {
+    std::string output_file_name;
+    command_line.GetOptionValue(kOutputFile, &output_file_name);
+    output_file_stream = std::make_unique<std::ofstream>(
+        output_file_name.c_str(), std::ios_base::out | std::ios_base::trunc);
+    if (!output_file_stream->is_open()) {
+      FX_LOGS(ERROR) << "Error opening output file.";
+      return 1;
+    }
+    out_stream = output_file_stream.get();
+  }
+
+  auto analyzer = std::make_unique<ktrace_analyzer::KernelTraceAnalyzer>();
+  if (!analyzer->ReadTrace(in_stream)) {
+    return 1;
+  }
+  analyzer->WriteJson(out_stream);
+
+  if (out_stream->fail()) {
+    FX_LOGS(ERROR) << "Error writing report.";
+    return 1;
+  }
+  return 0;
+}
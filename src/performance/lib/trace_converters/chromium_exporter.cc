@@ -9,11 +9,17 @@
 #include <lib/syslog/cpp/macros.h>
 #include <lib/trace-engine/types.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include <utility>
 
 #include <third_party/modp_b64/modp_b64.h>
 #include <trace-reader/reader.h>
 
+#include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
 #include "src/lib/fxl/strings/string_printf.h"
 #include "src/lib/fxl/strings/utf_codecs.h"
@@ -69,10 +75,10 @@ std::string CleanString(fbl::String str) {
   while (char_index < len) {
     uint32_t code_point;
     if (!fxl::ReadUnicodeCharacter(data, len, &char_index, &code_point)) {
-      static bool logged_once = false;
-      if (!logged_once) {
+      // Records may be formatted on several threads at once.
+      static std::atomic<bool> logged_once = false;
+      if (!logged_once.exchange(true)) {
         FX_LOGS(WARNING) << "Invalid unicode present in trace";
-        logged_once = true;
       }
       code_point = kUnicodeReplacementCharacter;
     }
@@ -83,8 +89,359 @@ std::string CleanString(fbl::String str) {
   return result;
 }
 
+// Returns true if |record| is written to "traceEvents" using no exporter state other than the tick
+// scale, so that it can be formatted on a worker thread.
+bool IsFormattedInPool(const trace::Record& record) {
+  switch (record.type()) {
+    case trace::RecordType::kEvent:
+      return IsEventTypeSupported(record.GetEvent().type());
+    case trace::RecordType::kLog:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns true if exporting |record| may append to "traceEvents".
+bool WritesTraceEvent(const trace::Record& record) {
+  return IsFormattedInPool(record) || record.type() == trace::RecordType::kLargeRecord;
+}
+
+// Writes argument data. Assumes it is already within an
+// "args" key object.
+template <typename Writer>
+void WriteArgs(Writer& writer, const fbl::Vector<trace::Argument>& arguments) {
+  for (const auto& arg : arguments) {
+    switch (arg.value().type()) {
+      case trace::ArgumentType::kBool:
+        writer.Key(CleanString(arg.name()));
+        writer.Bool(arg.value().GetBool());
+        break;
+      case trace::ArgumentType::kInt32:
+        writer.Key(CleanString(arg.name()));
+        writer.Int(arg.value().GetInt32());
+        break;
+      case trace::ArgumentType::kUint32:
+        writer.Key(CleanString(arg.name()));
+        writer.Uint(arg.value().GetUint32());
+        break;
+      case trace::ArgumentType::kInt64:
+        writer.Key(CleanString(arg.name()));
+        writer.Int64(arg.value().GetInt64());
+        break;
+      case trace::ArgumentType::kUint64:
+        writer.Key(CleanString(arg.name()));
+        writer.Uint64(arg.value().GetUint64());
+        break;
+      case trace::ArgumentType::kDouble:
+        writer.Key(CleanString(arg.name()));
+        writer.Double(arg.value().GetDouble());
+        break;
+      case trace::ArgumentType::kString:
+        writer.Key(CleanString(arg.name()));
+        writer.String(CleanString(arg.value().GetString()));
+        break;
+      case trace::ArgumentType::kPointer:
+        writer.Key(CleanString(arg.name()));
+        writer.String(fxl::StringPrintf("0x%" PRIx64, arg.value().GetPointer()).c_str());
+        break;
+      case trace::ArgumentType::kKoid:
+        writer.Key(CleanString(arg.name()));
+        writer.String(fxl::StringPrintf("#%" PRIu64, arg.value().GetKoid()).c_str());
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+template <typename Writer>
+void WriteEvent(Writer& writer, double tick_scale, const trace::Record::Event& event) {
+  writer.StartObject();
+
+  writer.Key("cat");
+  writer.String(CleanString(event.category));
+  writer.Key("name");
+  writer.String(CleanString(event.name));
+  writer.Key("ts");
+  writer.Double(event.timestamp * tick_scale);
+  writer.Key("pid");
+  writer.Uint64(event.process_thread.process_koid());
+  writer.Key("tid");
+  writer.Uint64(event.process_thread.thread_koid());
+
+  switch (event.type()) {
+    case trace::EventType::kInstant:
+      writer.Key("ph");
+      writer.String("i");
+      writer.Key("s");
+      switch (event.data.GetInstant().scope) {
+        case trace::EventScope::kGlobal:
+          writer.String("g");
+          break;
+        case trace::EventScope::kProcess:
+          writer.String("p");
+          break;
+        case trace::EventScope::kThread:
+        default:
+          writer.String("t");
+          break;
+      }
+      break;
+    case trace::EventType::kCounter:
+      writer.Key("ph");
+      writer.String("C");
+      if (event.data.GetCounter().id) {
+        writer.Key("id");
+        writer.String(fxl::StringPrintf("0x%" PRIx64, event.data.GetCounter().id).c_str());
+      }
+      break;
+    case trace::EventType::kDurationBegin:
+      writer.Key("ph");
+      writer.String("B");
+      break;
+    case trace::EventType::kDurationEnd:
+      writer.Key("ph");
+      writer.String("E");
+      break;
+    case trace::EventType::kDurationComplete:
+      writer.Key("ph");
+      writer.String("X");
+      writer.Key("dur");
+      writer.Double((event.data.GetDurationComplete().end_time - event.timestamp) * tick_scale);
+      break;
+    case trace::EventType::kAsyncBegin:
+      writer.Key("ph");
+      writer.String("b");
+      writer.Key("id");
+      writer.Uint64(event.data.GetAsyncBegin().id);
+      break;
+    case trace::EventType::kAsyncInstant:
+      writer.Key("ph");
+      writer.String("n");
+      writer.Key("id");
+      writer.Uint64(event.data.GetAsyncInstant().id);
+      break;
+    case trace::EventType::kAsyncEnd:
+      writer.Key("ph");
+      writer.String("e");
+      writer.Key("id");
+      writer.Uint64(event.data.GetAsyncEnd().id);
+      break;
+    case trace::EventType::kFlowBegin:
+      writer.Key("ph");
+      writer.String("s");
+      writer.Key("id");
+      writer.String(std::to_string(event.data.GetFlowBegin().id));
+      break;
+    case trace::EventType::kFlowStep:
+      writer.Key("ph");
+      writer.String("t");
+      writer.Key("id");
+      writer.String(std::to_string(event.data.GetFlowStep().id));
+      break;
+    case trace::EventType::kFlowEnd:
+      writer.Key("ph");
+      writer.String("f");
+      writer.Key("bp");
+      writer.String("e");
+      writer.Key("id");
+      writer.String(std::to_string(event.data.GetFlowEnd().id));
+      break;
+    default:
+      break;
+  }
+
+  if (event.arguments.size() > 0) {
+    writer.Key("args");
+    writer.StartObject();
+    WriteArgs(writer, event.arguments);
+    writer.EndObject();
+  }
+
+  writer.EndObject();
+}
+
+template <typename Writer>
+void WriteLog(Writer& writer, double tick_scale, const trace::Record::Log& log) {
+  writer.StartObject();
+  writer.Key("name");
+  writer.String("log");
+  writer.Key("ph");
+  writer.String("i");
+  writer.Key("ts");
+  writer.Double(log.timestamp * tick_scale);
+  writer.Key("pid");
+  writer.Uint64(log.process_thread.process_koid());
+  writer.Key("tid");
+  writer.Uint64(log.process_thread.thread_koid());
+  writer.Key("s");
+  writer.String("g");
+  writer.Key("args");
+  writer.StartObject();
+  writer.Key("message");
+  writer.String(CleanString(log.message));
+  writer.EndObject();
+  writer.EndObject();
+}
+
 }  // namespace
 
+// Formats batches of records on worker threads.
+//
+// The exporting thread appends records to the current batch and hands full batches to the workers.
+// Each worker formats a whole batch into a private buffer, one JSON object per record. The
+// exporting thread then copies finished batches into the output in the order they were created,
+// waiting for the oldest one when too many are outstanding. That bounds memory use no matter how
+// large the trace is.
+class ChromiumExporter::FormatterPool {
+ public:
+  using OutputWriter = rapidjson::Writer<rapidjson::OStreamWrapper>;
+
+  explicit FormatterPool(size_t num_threads) : max_in_flight_(num_threads * kBatchesPerThread) {
+    for (size_t i = 0; i < num_threads; i++) {
+      threads_.emplace_back([this] { Run(); });
+    }
+  }
+
+  ~FormatterPool() {
+    FX_DCHECK(in_flight_.empty() && !current_);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    work_available_.notify_all();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  // Queues |record| to be formatted with |tick_scale|, then writes any batches that are ready.
+  void Add(trace::Record record, double tick_scale, OutputWriter& writer) {
+    if (current_ && current_->tick_scale != tick_scale) {
+      Submit();
+    }
+    if (!current_) {
+      current_ = std::make_unique<Batch>(tick_scale);
+      current_->records.reserve(kRecordsPerBatch);
+    }
+    current_->records.push_back(std::move(record));
+    if (current_->records.size() == kRecordsPerBatch) {
+      Submit();
+      WriteFormatted(writer, max_in_flight_);
+    }
+  }
+
+  // Formats everything queued so far and writes it to |writer|.
+  void Drain(OutputWriter& writer) {
+    Submit();
+    WriteFormatted(writer, 0);
+  }
+
+ private:
+  static constexpr size_t kRecordsPerBatch = 1024;
+  static constexpr size_t kBatchesPerThread = 4;
+
+  struct Batch {
+    explicit Batch(double tick_scale) : tick_scale(tick_scale) {}
+
+    const double tick_scale;
+    std::vector<trace::Record> records;
+
+    // The formatted records, back to back, and the offset at which each one ends.
+    rapidjson::StringBuffer json;
+    std::vector<size_t> ends;
+
+    // Set by the worker once |json| and |ends| are complete. Guarded by |mutex_|.
+    bool formatted = false;
+  };
+
+  void Submit() {
+    if (!current_) {
+      return;
+    }
+    Batch* batch = current_.get();
+    in_flight_.push_back(std::move(current_));
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      work_.push_back(batch);
+    }
+    work_available_.notify_one();
+  }
+
+  // Writes formatted batches from the front of |in_flight_|, waiting for more to finish while over
+  // |max_in_flight| are outstanding.
+  void WriteFormatted(OutputWriter& writer, size_t max_in_flight) {
+    while (!in_flight_.empty()) {
+      Batch* batch = in_flight_.front().get();
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (in_flight_.size() > max_in_flight) {
+          batch_formatted_.wait(lock, [batch] { return batch->formatted; });
+        } else if (!batch->formatted) {
+          return;
+        }
+      }
+
+      const char* json = batch->json.GetString();
+      size_t start = 0;
+      for (size_t end : batch->ends) {
+        writer.RawValue(json + start, end - start, rapidjson::kObjectType);
+        start = end;
+      }
+      in_flight_.pop_front();
+    }
+  }
+
+  void Run() {
+    rapidjson::Writer<rapidjson::StringBuffer> writer;
+    for (;;) {
+      Batch* batch;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        work_available_.wait(lock, [this] { return stopping_ || !work_.empty(); });
+        if (work_.empty()) {
+          return;
+        }
+        batch = work_.front();
+        work_.pop_front();
+      }
+
+      for (const auto& record : batch->records) {
+        // Each record is a separate JSON document as far as the writer is concerned.
+        writer.Reset(batch->json);
+        if (record.type() == trace::RecordType::kEvent) {
+          WriteEvent(writer, batch->tick_scale, record.GetEvent());
+        } else {
+          WriteLog(writer, batch->tick_scale, record.GetLog());
+        }
+        batch->ends.push_back(batch->json.GetSize());
+      }
+      batch->records.clear();
+
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        batch->formatted = true;
+      }
+      batch_formatted_.notify_all();
+    }
+  }
+
+  const size_t max_in_flight_;
+
+  // Only used by the exporting thread.
+  std::unique_ptr<Batch> current_;
+  std::deque<std::unique_ptr<Batch>> in_flight_;
+
+  std::mutex mutex_;
+  std::condition_variable work_available_;
+  std::condition_variable batch_formatted_;
+  std::deque<Batch*> work_;  // Guarded by |mutex_|.
+  bool stopping_ = false;    // Guarded by |mutex_|.
+
+  std::vector<std::thread> threads_;
+};
+
 ChromiumExporter::ChromiumExporter(std::unique_ptr<std::ostream> stream_out)
     : stream_out_(std::move(stream_out)), wrapper_(*stream_out_), writer_(wrapper_) {
   Start();
@@ -94,6 +451,14 @@ ChromiumExporter::ChromiumExporter(std::ostream& out) : wrapper_(out), writer_(w
   Start();
 }
 
+ChromiumExporter::ChromiumExporter(std::ostream& out, size_t num_threads)
+    : wrapper_(out), writer_(wrapper_) {
+  if (num_threads > 0) {
+    formatter_pool_ = std::make_unique<FormatterPool>(num_threads);
+  }
+  Start();
+}
+
 ChromiumExporter::~ChromiumExporter() { Stop(); }
 
 void ChromiumExporter::Start() {
@@ -105,6 +470,9 @@ void ChromiumExporter::Start() {
 }
 
 void ChromiumExporter::Stop() {
+  if (formatter_pool_) {
+    formatter_pool_->Drain(writer_);
+  }
   writer_.EndArray();
   writer_.Key("systemTraceEvents");
   writer_.StartObject();
@@ -172,7 +540,20 @@ void ChromiumExporter::Stop() {
   writer_.EndObject();  // Finishes StartObject() begun in Start()
 }
 
+void ChromiumExporter::ExportRecord(trace::Record&& record) {
+  if (formatter_pool_ && IsFormattedInPool(record)) {
+    formatter_pool_->Add(std::move(record), tick_scale_, writer_);
+    return;
+  }
+  ExportRecord(static_cast<const trace::Record&>(record));
+}
+
 void ChromiumExporter::ExportRecord(const trace::Record& record) {
+  // Anything written to "traceEvents" here must come after the records already queued.
+  if (formatter_pool_ && WritesTraceEvent(record)) {
+    formatter_pool_->Drain(writer_);
+  }
+
   switch (record.type()) {
     case trace::RecordType::kMetadata:
       ExportMetadata(record.GetMetadata());
@@ -228,109 +609,7 @@ void ChromiumExporter::ExportEvent(const trace::Record::Event& event) {
   if (!IsEventTypeSupported(event.type()))
     return;
 
-  writer_.StartObject();
-
-  writer_.Key("cat");
-  writer_.String(CleanString(event.category));
-  writer_.Key("name");
-  writer_.String(CleanString(event.name));
-  writer_.Key("ts");
-  writer_.Double(event.timestamp * tick_scale_);
-  writer_.Key("pid");
-  writer_.Uint64(event.process_thread.process_koid());
-  writer_.Key("tid");
-  writer_.Uint64(event.process_thread.thread_koid());
-
-  switch (event.type()) {
-    case trace::EventType::kInstant:
-      writer_.Key("ph");
-      writer_.String("i");
-      writer_.Key("s");
-      switch (event.data.GetInstant().scope) {
-        case trace::EventScope::kGlobal:
-          writer_.String("g");
-          break;
-        case trace::EventScope::kProcess:
-          writer_.String("p");
-          break;
-        case trace::EventScope::kThread:
-        default:
-          writer_.String("t");
-          break;
-      }
-      break;
-    case trace::EventType::kCounter:
-      writer_.Key("ph");
-      writer_.String("C");
-      if (event.data.GetCounter().id) {
-        writer_.Key("id");
-        writer_.String(fxl::StringPrintf("0x%" PRIx64, event.data.GetCounter().id).c_str());
-      }
-      break;
-    case trace::EventType::kDurationBegin:
-      writer_.Key("ph");
-      writer_.String("B");
-      break;
-    case trace::EventType::kDurationEnd:
-      writer_.Key("ph");
-      writer_.String("E");
-      break;
-    case trace::EventType::kDurationComplete:
-      writer_.Key("ph");
-      writer_.String("X");
-      writer_.Key("dur");
-      writer_.Double((event.data.GetDurationComplete().end_time - event.timestamp) * tick_scale_);
-      break;
-    case trace::EventType::kAsyncBegin:
-      writer_.Key("ph");
-      writer_.String("b");
-      writer_.Key("id");
-      writer_.Uint64(event.data.GetAsyncBegin().id);
-      break;
-    case trace::EventType::kAsyncInstant:
-      writer_.Key("ph");
-      writer_.String("n");
-      writer_.Key("id");
-      writer_.Uint64(event.data.GetAsyncInstant().id);
-      break;
-    case trace::EventType::kAsyncEnd:
-      writer_.Key("ph");
-      writer_.String("e");
-      writer_.Key("id");
-      writer_.Uint64(event.data.GetAsyncEnd().id);
-      break;
-    case trace::EventType::kFlowBegin:
-      writer_.Key("ph");
-      writer_.String("s");
-      writer_.Key("id");
-      writer_.String(std::to_string(event.data.GetFlowBegin().id));
-      break;
-    case trace::EventType::kFlowStep:
-      writer_.Key("ph");
-      writer_.String("t");
-      writer_.Key("id");
-      writer_.String(std::to_string(event.data.GetFlowStep().id));
-      break;
-    case trace::EventType::kFlowEnd:
-      writer_.Key("ph");
-      writer_.String("f");
-      writer_.Key("bp");
-      writer_.String("e");
-      writer_.Key("id");
-      writer_.String(std::to_string(event.data.GetFlowEnd().id));
-      break;
-    default:
-      break;
-  }
-
-  if (event.arguments.size() > 0) {
-    writer_.Key("args");
-    writer_.StartObject();
-    WriteArgs(event.arguments);
-    writer_.EndObject();
-  }
-
-  writer_.EndObject();
+  WriteEvent(writer_, tick_scale_, event);
 }
 
 void ChromiumExporter::ExportKernelObject(const trace::Record::KernelObject& kernel_object) {
@@ -399,25 +678,7 @@ void ChromiumExporter::ExportLastBranchBlob(const perfmon::LastBranchRecordBlob&
 }
 
 void ChromiumExporter::ExportLog(const trace::Record::Log& log) {
-  writer_.StartObject();
-  writer_.Key("name");
-  writer_.String("log");
-  writer_.Key("ph");
-  writer_.String("i");
-  writer_.Key("ts");
-  writer_.Double(log.timestamp * tick_scale_);
-  writer_.Key("pid");
-  writer_.Uint64(log.process_thread.process_koid());
-  writer_.Key("tid");
-  writer_.Uint64(log.process_thread.thread_koid());
-  writer_.Key("s");
-  writer_.String("g");
-  writer_.Key("args");
-  writer_.StartObject();
-  writer_.Key("message");
-  writer_.String(CleanString(log.message));
-  writer_.EndObject();
-  writer_.EndObject();
+  WriteLog(writer_, tick_scale_, log);
 }
 
 void ChromiumExporter::ExportMetadata(const trace::Record::Metadata& metadata) {
@@ -515,49 +776,4 @@ void ChromiumExporter::ExportFidlBlob(const trace::LargeRecordData::BlobEvent& b
   writer_.EndObject();
 }
 
-void ChromiumExporter::WriteArgs(const fbl::Vector<trace::Argument>& arguments) {
-  for (const auto& arg : arguments) {
-    switch (arg.value().type()) {
-      case trace::ArgumentType::kBool:
-        writer_.Key(CleanString(arg.name()));
-        writer_.Bool(arg.value().GetBool());
-        break;
-      case trace::ArgumentType::kInt32:
-        writer_.Key(CleanString(arg.name()));
-        writer_.Int(arg.value().GetInt32());
-        break;
-      case trace::ArgumentType::kUint32:
-        writer_.Key(CleanString(arg.name()));
-        writer_.Uint(arg.value().GetUint32());
-        break;
-      case trace::ArgumentType::kInt64:
-        writer_.Key(CleanString(arg.name()));
-        writer_.Int64(arg.value().GetInt64());
-        break;
-      case trace::ArgumentType::kUint64:
-        writer_.Key(CleanString(arg.name()));
-        writer_.Uint64(arg.value().GetUint64());
-        break;
-      case trace::ArgumentType::kDouble:
-        writer_.Key(CleanString(arg.name()));
-        writer_.Double(arg.value().GetDouble());
-        break;
-      case trace::ArgumentType::kString:
-        writer_.Key(CleanString(arg.name()));
-        writer_.String(CleanString(arg.value().GetString()));
-        break;
-      case trace::ArgumentType::kPointer:
-        writer_.Key(CleanString(arg.name()));
-        writer_.String(fxl::StringPrintf("0x%" PRIx64, arg.value().GetPointer()).c_str());
-        break;
-      case trace::ArgumentType::kKoid:
-        writer_.Key(CleanString(arg.name()));
-        writer_.String(fxl::StringPrintf("#%" PRIu64, arg.value().GetKoid()).c_str());
-        break;
-      default:
-        break;
-    }
-  }
-}
-
 }  // namespace tracing
@@ -23,11 +23,19 @@ class ChromiumExporter {
  public:
   explicit ChromiumExporter(std::unique_ptr<std::ostream> stream_out);
   explicit ChromiumExporter(std::ostream& out);
+
+  // Formats events and logs on |num_threads| worker threads, or on the calling thread if
+  // |num_threads| is zero. Records are still written in the order they are exported, so the output
+  // is identical either way. Only records exported by rvalue are handed to the workers.
+  ChromiumExporter(std::ostream& out, size_t num_threads);
   ~ChromiumExporter();
 
   void ExportRecord(const trace::Record& record);
+  void ExportRecord(trace::Record&& record);
 
  private:
+  class FormatterPool;
+
   void Start();
   void Stop();
   void ExportEvent(const trace::Record::Event& event);
@@ -39,10 +47,6 @@ class ChromiumExporter {
   void ExportBlob(const trace::LargeRecordData::Blob& blob);
   void ExportFidlBlob(const trace::LargeRecordData::BlobEvent& blob);
 
-  // Writes argument data. Assumes it is already within an
-  // "args" key object.
-  void WriteArgs(const fbl::Vector<trace::Argument>& arguments);
-
   std::unique_ptr<std::ostream> stream_out_;
   rapidjson::OStreamWrapper wrapper_;
   rapidjson::Writer<rapidjson::OStreamWrapper> writer_;
@@ -67,6 +71,9 @@ class ChromiumExporter {
   // so we can't emit them inline. Save them for later emission.
   // LastBranch records will go to the lastBranch section.
   std::vector<const perfmon::LastBranchRecordBlob*> last_branch_records_;
+
+  // Null unless the exporter was created with worker threads.
+  std::unique_ptr<FormatterPool> formatter_pool_;
 };
 
 }  // namespace tracing
@@ -122,6 +122,40 @@ TEST(ChromiumExporterTest, FidlBlobExported) {
             "\"events\":[]}}");
 }
 
+std::string ExportEvents(size_t num_threads) {
+  std::ostringstream out_stream;
+  {
+    tracing::ChromiumExporter exporter(out_stream, num_threads);
+    // Enough records for several batches, with a change of tick rate and an interleaved large
+    // record, both of which the worker threads must not reorder.
+    for (uint64_t i = 0; i < 5000; i++) {
+      if (i == 2500) {
+        exporter.ExportRecord(trace::Record(trace::Record::Initialization{1000}));
+      }
+      if (i == 3000) {
+        static const char blob[] = "blob";
+        trace::LargeRecordData::BlobEvent blob_event{
+            "fidl:blob", "BlobName", i, trace::ProcessThread(45, 46),
+            fbl::Vector<trace::Argument>(), blob, sizeof(blob),
+        };
+        exporter.ExportRecord(trace::Record(trace::LargeRecordData{std::move(blob_event)}));
+      }
+      fbl::Vector<trace::Argument> arguments;
+      arguments.push_back(trace::Argument("i", trace::ArgumentValue::MakeUint64(i)));
+      exporter.ExportRecord(trace::Record(trace::Record::Event{
+          i, trace::ProcessThread(45, 46), "cat", "name", std::move(arguments),
+          trace::EventData(trace::EventData::Instant{trace::EventScope::kThread})}));
+    }
+  }
+  return out_stream.str();
+}
+
+TEST(ChromiumExporterTest, WorkerThreadsPreserveOrder) {
+  const std::string serial = ExportEvents(0);
+  EXPECT_TRUE(serial == ExportEvents(1));
+  EXPECT_TRUE(serial == ExportEvents(4));
+}
+
 TEST(ChromiumExporterTest, EmptyTrace) {
   std::ostringstream out_stream;
 
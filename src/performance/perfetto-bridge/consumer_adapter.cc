@@ -14,6 +14,7 @@
 #include <zircon/status.h>
 
 #include <algorithm>
+#include <cstring>
 #include <functional>
 
 #include <rapidjson/document.h>
@@ -37,8 +38,11 @@ namespace {
 // The size of the consumer buffer.
 constexpr size_t kConsumerBufferSizeKb = 20ul * 1024ul;  // 20MB.
 
-// The delay between buffer utilization checks.
+// The delay between buffer utilization checks. The delay is shortened, down to
+// kConsumerStatsMinPollIntervalMs, while the buffer keeps filling past the read threshold
+// between checks, and lengthened back once producers slow down.
 constexpr int kConsumerStatsPollIntervalMs = 500;
+constexpr int kConsumerStatsMinPollIntervalMs = 50;
 
 // Sets the amount of buffer usage that will cause the buffer to be read mid-trace.
 constexpr float kConsumerUtilizationReadThreshold = 0.6f;
@@ -195,25 +199,8 @@ void ConsumerAdapter::OnTraceData(std::vector<perfetto::TracePacket> packets, bo
   FX_DCHECK(perfetto_task_runner_->RunsTasksOnCurrentThread());
 
   if (blob_write_context_) {
-    // Proto messages must be written as atomic blobs to prevent truncation mid-message
-    // if the output buffer is filled.
-    std::string proto_str;
-    for (auto& cur_packet : packets) {
-      auto [preamble_data, preamble_size] = cur_packet.GetProtoPreamble();
-      proto_str.assign(preamble_data, preamble_size);
-
-      for (auto& cur_slice : cur_packet.slices()) {
-        proto_str.append(reinterpret_cast<const char*>(cur_slice.start), cur_slice.size);
-      }
-
-      if (proto_str.size() > TRACE_MAX_BLOB_SIZE) {
-        FX_LOGS(WARNING) << "Dropping excessively long Perfetto message (size=" << proto_str.size()
-                         << " bytes)";
-      } else {
-        trace_context_write_blob_record(blob_write_context_, TRACE_BLOB_TYPE_PERFETTO,
-                                        &blob_name_ref_, proto_str.data(), proto_str.size());
-      }
-      proto_str.clear();
+    for (const auto& cur_packet : packets) {
+      WritePacket(cur_packet);
     }
   }
 
@@ -222,6 +209,41 @@ void ConsumerAdapter::OnTraceData(std::vector<perfetto::TracePacket> packets, bo
   }
 }
 
+void ConsumerAdapter::WritePacket(const perfetto::TracePacket& packet) {
+  FX_DCHECK(blob_write_context_);
+
+  // Proto messages must be written as atomic blobs to prevent truncation mid-message
+  // if the output buffer is filled. The blob is reserved up front so that the packet's
+  // slices can be copied straight into the trace buffer without being reassembled first.
+  auto [preamble_data, preamble_size] = packet.GetProtoPreamble();
+  const size_t packet_size = preamble_size + packet.size();
+
+  void* blob = nullptr;
+  if (packet_size > TRACE_MAX_BLOB_SIZE) {
+    FX_LOGS(WARNING) << "Dropping excessively long Perfetto message (size=" << packet_size
+                     << " bytes)";
+  } else {
+    blob = trace_context_begin_write_blob_record(blob_write_context_, TRACE_BLOB_TYPE_PERFETTO,
+                                                 &blob_name_ref_, packet_size);
+  }
+  if (!blob) {
+    drain_stats_.packets_dropped++;
+    drain_stats_.bytes_dropped += packet_size;
+    return;
+  }
+
+  auto* dest = static_cast<char*>(blob);
+  memcpy(dest, preamble_data, preamble_size);
+  dest += preamble_size;
+  for (const auto& cur_slice : packet.slices()) {
+    memcpy(dest, cur_slice.start, cur_slice.size);
+    dest += cur_slice.size;
+  }
+
+  drain_stats_.packets_written++;
+  drain_stats_.bytes_written += packet_size;
+}
+
 void ConsumerAdapter::OnTraceStateUpdate() {
   switch (trace_state()) {
     case TRACE_STARTED:
@@ -274,6 +296,9 @@ void ConsumerAdapter::OnStartTracing() {
   // Explicitly manage the lifetime of the Fuchsia tracing session.
   scoped_prolonged_trace_ = std::make_unique<ScopedProlongedTraceContext>();
 
+  drain_stats_ = {};
+  stats_poll_interval_ms_ = kConsumerStatsPollIntervalMs;
+
   ChangeState(State::ACTIVE);
   SchedulePerfettoGetStats();
 }
@@ -294,7 +319,16 @@ void ConsumerAdapter::SchedulePerfettoGetStats() {
           CallPerfettoGetTraceStats(false /* on_shutdown */);
         }
       },
-      kConsumerStatsPollIntervalMs);
+      stats_poll_interval_ms_);
+}
+
+void ConsumerAdapter::UpdatePollInterval(float utilization) {
+  if (utilization >= kConsumerUtilizationReadThreshold) {
+    stats_poll_interval_ms_ =
+        std::max(stats_poll_interval_ms_ / 2, kConsumerStatsMinPollIntervalMs);
+  } else if (utilization < kConsumerUtilizationReadThreshold / 2) {
+    stats_poll_interval_ms_ = std::min(stats_poll_interval_ms_ * 2, kConsumerStatsPollIntervalMs);
+  }
 }
 
 void ConsumerAdapter::CallPerfettoReadBuffers(bool on_shutdown) {
@@ -361,6 +395,14 @@ void ConsumerAdapter::OnTraceStats(bool success, const perfetto::TraceStats& sta
     const float utilization =
         static_cast<float>(buffer_used) / static_cast<float>(buffer_stats.buffer_size());
 
+    if (buffer_stats.bytes_overwritten() > drain_stats_.bytes_overwritten) {
+      FX_LOGS(WARNING) << "Perfetto consumer buffer overrun, "
+                       << buffer_stats.bytes_overwritten() - drain_stats_.bytes_overwritten
+                       << " bytes lost since the last check.";
+      drain_stats_.bytes_overwritten = buffer_stats.bytes_overwritten();
+    }
+    UpdatePollInterval(utilization);
+
     if (utilization >= kConsumerUtilizationReadThreshold) {
       CallPerfettoReadBuffers(false /* shutdown */);
     } else {
@@ -373,6 +415,15 @@ void ConsumerAdapter::OnTraceStats(bool success, const perfetto::TraceStats& sta
     if (success) {
       LogTraceStats(stats);
     }
+    FX_LOGS(INFO) << fxl::StringPrintf(
+        "Bridge stats: "
+        "packets_written: %lu (%lu bytes), "
+        "packets_dropped: %lu (%lu bytes)",
+        drain_stats_.packets_written, drain_stats_.bytes_written, drain_stats_.packets_dropped,
+        drain_stats_.bytes_dropped);
+    if (drain_stats_.packets_dropped > 0) {
+      FX_LOGS(WARNING) << "Perfetto packets were dropped; consider a larger Fuchsia trace buffer.";
+    }
 
     ShutdownTracing();
   }
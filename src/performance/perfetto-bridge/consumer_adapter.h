@@ -78,6 +78,13 @@ class ConsumerAdapter : public perfetto::Consumer {
   void CallPerfettoFlush();
   void CallPerfettoGetTraceStats(bool on_shutdown);
 
+  // Writes a packet directly into the Fuchsia trace buffer as a blob record.
+  void WritePacket(const perfetto::TracePacket& packet);
+
+  // Adjusts the stats polling interval based on how full the consumer buffer was at the last
+  // poll, draining more often while producers are outpacing the bridge.
+  void UpdatePollInterval(float utilization);
+
   // perfetto::Consumer implementation.
   void OnConnect() override;
   void OnDisconnect() override;
@@ -98,6 +105,20 @@ class ConsumerAdapter : public perfetto::Consumer {
   trace_context_t* blob_write_context_ = nullptr;
   trace_string_ref_t blob_name_ref_;
 
+  // Per-session counters, logged on shutdown. Only accessed on `perfetto_task_runner_`.
+  struct DrainStats {
+    uint64_t packets_written = 0;
+    uint64_t bytes_written = 0;
+    // Packets that were too large for a blob record, or didn't fit in the Fuchsia trace buffer.
+    // The latter are also counted in the provider's dropped records by trace_manager.
+    uint64_t packets_dropped = 0;
+    uint64_t bytes_dropped = 0;
+    // Perfetto data overwritten in the consumer buffer before the bridge read it.
+    uint64_t bytes_overwritten = 0;
+  };
+  DrainStats drain_stats_;
+  int stats_poll_interval_ms_ = 0;
+
   // Used for handling FXT events.
   trace::TraceObserver trace_observer_;
 
@@ -113,21 +113,30 @@ bool ConvertTrace(ConvertSettings settings) {
     }
   } else {
     if (settings.compressed_output) {
-      // TODO(bhamrick): The gzofstream class we're using here does not appear to support writing to
-      // stdout properly. In trying to use STDOUT_FILENO similar to the usage of STDIN_FILENO above,
-      // it seemed that the output would either be truncated to a multiple of 0x1000 bytes, or not
-      // be written at all.
-      FX_LOGS(ERROR) << "Compressed output on stdout is not supported. Please "
-                        "specify --output-file";
-      return false;
+      // A gzofstream attached to a file descriptor does not write the gzip trailer when destroyed,
+      // so it is closed explicitly below.
+      output_gz_file_stream =
+          std::make_unique<gzofstream>(STDOUT_FILENO, std::ios_base::out | std::ios_base::binary);
+      out_stream = static_cast<std::ostream*>(output_gz_file_stream.get());
     } else {
       out_stream = &std::cout;
     }
   }
 
-  tracing::FuchsiaTraceParser parser(out_stream);
-  if (!parser.ParseComplete(in_stream)) {
-    return false;
+  {
+    // The end of the JSON output is written when the parser is destroyed.
+    tracing::FuchsiaTraceParser parser(out_stream, settings.num_threads);
+    if (!parser.ParseComplete(in_stream)) {
+      return false;
+    }
+  }
+
+  if (output_gz_file_stream) {
+    output_gz_file_stream->close();
+    if (output_gz_file_stream->fail()) {
+      FX_LOGS(ERROR) << "Error writing compressed output.";
+      return false;
+    }
   }
 
   return true;
@@ -5,6 +5,7 @@
 #ifndef SRC_PERFORMANCE_TRACE2JSON_CONVERT_H_
 #define SRC_PERFORMANCE_TRACE2JSON_CONVERT_H_
 
+#include <cstddef>
 #include <string>
 
 struct ConvertSettings {
@@ -12,6 +13,9 @@ struct ConvertSettings {
   std::string output_file_name;
   bool compressed_input = false;
   bool compressed_output = false;
+  // Number of threads formatting events, in addition to the thread reading the trace. If zero,
+  // events are formatted on the reading thread. The output is the same either way.
+  size_t num_threads = 0;
 };
 
 bool ConvertTrace(ConvertSettings);
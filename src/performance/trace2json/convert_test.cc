@@ -107,6 +107,16 @@ TEST(ConvertTest, ExampleBenchmark) {
   ConvertAndCompare(settings, test_data_path + "example_benchmark_expected.json", kNoIgnores);
 }
 
+TEST(ConvertTest, ExampleBenchmarkWithWorkerThreads) {
+  // Formatting on worker threads must not change the output.
+  std::string test_data_path = GetTestDataPath();
+  ConvertSettings settings;
+  settings.input_file_name = test_data_path + "example_benchmark.fxt";
+  settings.output_file_name = test_data_path + "example_benchmark_threads_actual.json";
+  settings.num_threads = 4;
+  ConvertAndCompare(settings, test_data_path + "example_benchmark_expected.json", kNoIgnores);
+}
+
 TEST(ConvertTest, SimpleTraceCompressedOutput) {
   // simple_trace.fxt is a small hand-written trace file that exercises a few
   // basic event types (currently slice begin, slice end, slice complete, async
@@ -7,9 +7,11 @@
 #include <iostream>
 #include <map>
 #include <set>
+#include <thread>
 
 #include "src/lib/fxl/command_line.h"
 #include "src/lib/fxl/log_settings_command_line.h"
+#include "src/lib/fxl/strings/string_number_conversions.h"
 #include "src/performance/trace2json/convert.h"
 
 namespace {
@@ -19,9 +21,10 @@ const char kInputFile[] = "input-file";
 const char kOutputFile[] = "output-file";
 const char kCompressedInput[] = "compressed-input";
 const char kCompressedOutput[] = "compressed-output";
+const char kJobs[] = "jobs";
 
 std::set<std::string> kKnownOptions = {
-    kHelp, kInputFile, kOutputFile, kCompressedInput, kCompressedOutput,
+    kHelp, kInputFile, kOutputFile, kCompressedInput, kCompressedOutput, kJobs,
 };
 
 bool ParseBooleanOption(const fxl::CommandLine& command_line, const char* arg_name,
@@ -51,9 +54,10 @@ void PrintHelpMessage() {
        "Write the converted trace to the specified file. If no file is "
        "specified, the output is written to stdout."},
       {"compressed-input=[false]", "If true, the input is first gzip-decompressed."},
-      {"compressed-output=[false]",
-       "If true, the output is gzip-compressed. Writing compressed output to "
-       "stdout is not supported, so output-file must be specified."},
+      {"compressed-output=[false]", "If true, the output is gzip-compressed."},
+      {"jobs=[number of CPUs]",
+       "Format events on this many threads while the trace is being read. If "
+       "0, events are formatted on the reading thread."},
   };
 
   std::cerr
@@ -118,6 +122,18 @@ int main(int argc, char** argv) {
     PrintHelpMessage();
     return 1;
   }
+  settings.num_threads = std::thread::hardware_concurrency();
+  if (command_line.HasOption(kJobs)) {
+    std::string arg_value;
+    command_line.GetOptionValue(kJobs, &arg_value);
+    uint32_t num_threads;
+    if (!fxl::StringToNumberWithError(arg_value, &num_threads)) {
+      FX_LOGS(ERROR) << "Bad value for --" << kJobs << ", pass a number of threads";
+      PrintHelpMessage();
+      return 1;
+    }
+    settings.num_threads = num_threads;
+  }
 
   if (!ConvertTrace(settings)) {
     return 1;
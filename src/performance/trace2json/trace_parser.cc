@@ -8,9 +8,9 @@
 
 namespace tracing {
 
-FuchsiaTraceParser::FuchsiaTraceParser(std::ostream* out)
-    : exporter_(*out),
-      reader_([this](trace::Record record) { exporter_.ExportRecord(record); },
+FuchsiaTraceParser::FuchsiaTraceParser(std::ostream* out, size_t num_threads)
+    : exporter_(*out, num_threads),
+      reader_([this](trace::Record record) { exporter_.ExportRecord(std::move(record)); },
               [](fbl::String error) { FX_LOGS(ERROR) << error.c_str(); }) {}
 
 FuchsiaTraceParser::~FuchsiaTraceParser() = default;
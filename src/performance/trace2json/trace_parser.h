@@ -20,7 +20,8 @@ namespace tracing {
 
 class FuchsiaTraceParser {
  public:
-  explicit FuchsiaTraceParser(std::ostream* out);
+  // Events are formatted on |num_threads| worker threads, or on the calling thread if zero.
+  explicit FuchsiaTraceParser(std::ostream* out, size_t num_threads = 0);
   ~FuchsiaTraceParser();
 
   bool ParseComplete(std::istream*);
@@ -16,6 +16,7 @@ namespace tracing {
 namespace {
 
 constexpr char kCategories[] = "categories";
+constexpr char kSnapshotAlerts[] = "snapshot_alerts";
 
 }  // namespace
 
@@ -53,6 +54,22 @@ bool Config::ReadFrom(const std::string& config_file) {
     }
   }
 
+  auto snapshot_alerts_it = document.FindMember(kSnapshotAlerts);
+  if (snapshot_alerts_it != document.MemberEnd()) {
+    const auto& value = snapshot_alerts_it->value;
+    if (!value.IsArray()) {
+      FX_LOGS(ERROR) << "Expecting " << kSnapshotAlerts << " to be an array";
+      return false;
+    }
+    for (auto it = value.Begin(); it != value.End(); ++it) {
+      if (!it->IsString()) {
+        FX_LOGS(ERROR) << "Expecting " << kSnapshotAlerts << " elements to be strings";
+        return false;
+      }
+      snapshot_alerts_.insert(it->GetString());
+    }
+  }
+
   return true;
 }
 
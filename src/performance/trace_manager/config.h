@@ -8,6 +8,7 @@
 #include <fuchsia/sys/cpp/fidl.h>
 
 #include <map>
+#include <set>
 #include <string>
 
 namespace tracing {
@@ -33,9 +34,15 @@ class Config {
   // Well-known providers to start automatically.
   const std::map<std::string, fuchsia::sys::LaunchInfoPtr>& providers() const { return providers_; }
 
+  // Names of alerts which save a snapshot of a started trace, without
+  // ending it. This lets a circular trace act as a flight recorder, saving
+  // the events leading up to the alert.
+  const std::set<std::string>& snapshot_alerts() const { return snapshot_alerts_; }
+
  private:
   std::map<std::string, std::string> known_categories_;
   std::map<std::string, fuchsia::sys::LaunchInfoPtr> providers_;
+  std::set<std::string> snapshot_alerts_;
 };
 
 }  // namespace tracing
@@ -157,6 +157,90 @@ TEST_F(TraceManagerTest, Alerted) {
   VerifyCounts(1, 1);
 }
 
+// Listed in "snapshot_alerts" in the test's tracing.config.
+static constexpr char kSnapshotAlertName[] = "snapshot";
+
+// Tests that a snapshot alert saves the trace and resumes tracing.
+TEST_F(TraceManagerTest, SnapshotOnAlert) {
+  ConnectToControllerService();
+
+  FakeProvider* provider;
+  ASSERT_TRUE(AddFakeProvider(kProvider1Pid, kProvider1Name, &provider));
+
+  controller::TraceConfig config{GetDefaultTraceConfig()};
+  config.set_buffering_mode(controller::BufferingMode::CIRCULAR);
+  ASSERT_TRUE(InitializeSession(std::move(config)));
+
+  ASSERT_TRUE(StartSession());
+  VerifyCounts(1, 0);
+
+  provider->SendAlert(kSnapshotAlertName);
+  std::string received_alert_name;
+  controller()->WatchAlert(
+      [&received_alert_name](std::string alert_name) { received_alert_name = alert_name; });
+  RunLoopUntilIdle();
+  // The alert is still passed on to the controller.
+  EXPECT_EQ(kSnapshotAlertName, received_alert_name);
+  EXPECT_EQ(GetSessionState(), SessionState::kStopping);
+  VerifyCounts(1, 1);
+
+  // Once the provider has stopped and its buffer is saved, tracing restarts.
+  EXPECT_EQ(DrainDestination(), 0u);
+  MarkAllProvidersStopped();
+  RunLoopUntilIdle();
+  EXPECT_GT(DrainDestination(), 0u);
+  EXPECT_EQ(GetSessionState(), SessionState::kStarting);
+  VerifyCounts(2, 1);
+
+  MarkAllProvidersStarted();
+  RunLoopUntilIdle();
+  EXPECT_EQ(GetSessionState(), SessionState::kStarted);
+
+  ASSERT_TRUE(StopSession());
+  VerifyCounts(2, 2);
+
+  ASSERT_TRUE(TerminateSession());
+  VerifyCounts(2, 2);
+}
+
+// Tests that a stop request received while a snapshot is stopping the
+// providers is honored rather than undone by the snapshot's restart.
+TEST_F(TraceManagerTest, StopDuringSnapshot) {
+  ConnectToControllerService();
+
+  FakeProvider* provider;
+  ASSERT_TRUE(AddFakeProvider(kProvider1Pid, kProvider1Name, &provider));
+
+  controller::TraceConfig config{GetDefaultTraceConfig()};
+  config.set_buffering_mode(controller::BufferingMode::CIRCULAR);
+  ASSERT_TRUE(InitializeSession(std::move(config)));
+
+  ASSERT_TRUE(StartSession());
+  VerifyCounts(1, 0);
+
+  provider->SendAlert(kSnapshotAlertName);
+  RunLoopUntilIdle();
+  EXPECT_EQ(GetSessionState(), SessionState::kStopping);
+  VerifyCounts(1, 1);
+
+  // The stop doesn't complete until the providers have stopped.
+  BeginStopSession();
+  RunLoopUntilIdle();
+  EXPECT_FALSE(stop_completed());
+  EXPECT_EQ(GetSessionState(), SessionState::kStopping);
+
+  MarkAllProvidersStopped();
+  RunLoopUntilIdle();
+  EXPECT_TRUE(stop_completed());
+  EXPECT_GT(DrainDestination(), 0u);
+  // The snapshot did not restart tracing.
+  EXPECT_EQ(GetSessionState(), SessionState::kStopped);
+  VerifyCounts(1, 1);
+
+  ASSERT_TRUE(TerminateSession());
+  VerifyCounts(1, 1);
+}
+
 static constexpr size_t kMaxAlertQueueDepth = 16;
 
 // Tests alerts with a variety of sequences WRT |WatchAlert|.
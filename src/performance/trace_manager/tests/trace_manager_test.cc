@@ -366,6 +366,20 @@ void TraceManagerTest::MarkAllProvidersTerminated() {
   }
 }
 
+size_t TraceManagerTest::DrainDestination() {
+  size_t total = 0;
+  uint8_t buffer[4096];
+  for (;;) {
+    size_t actual;
+    zx_status_t status = destination_.read(0u, buffer, sizeof(buffer), &actual);
+    if (status != ZX_OK) {
+      EXPECT_EQ(status, ZX_ERR_SHOULD_WAIT);
+      return total;
+    }
+    total += actual;
+  }
+}
+
 void TraceManagerTest::VerifyCounts(int expected_start_count, int expected_stop_count) {
   SessionState state{GetSessionState()};
   for (const auto& p : fake_provider_bindings()) {
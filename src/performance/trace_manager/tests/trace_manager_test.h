@@ -139,6 +139,8 @@ class TraceManagerTest : public gtest::TestLoopFixture {
   bool FinishStartSession();
   void BeginStopSession(controller::StopOptions options = GetDefaultStopOptions());
   bool FinishStopSession();
+  // True once the stop begun by |BeginStopSession()| has been acked.
+  bool stop_completed() const { return stop_state_.stop_completed; }
 
   // Helpers to advance provider state.
   // These can only be called when all providers are in the immediately
@@ -152,6 +154,10 @@ class TraceManagerTest : public gtest::TestLoopFixture {
   // This is not intended to be called before |Initialize*|.
   void VerifyCounts(int expected_start_count, int expected_stop_count);
 
+  // Reads and discards everything written to the consumer's socket so far.
+  // Returns the number of bytes read.
+  size_t DrainDestination();
+
   // Publically accessible copies of test fixture methods.
   void QuitLoop() { gtest::TestLoopFixture::QuitLoop(); }
   void RunLoopUntilIdle() { gtest::TestLoopFixture::RunLoopUntilIdle(); }
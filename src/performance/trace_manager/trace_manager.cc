@@ -248,6 +248,16 @@ void TraceManager::StopTracing(controller::StopOptions options, StopTracingCallb
     return;
   }
 
+  if (session_->snapshot_in_progress()) {
+    // The snapshot would otherwise restart tracing once its results are written.
+    FX_LOGS(INFO) << "Stopping trace after the snapshot in progress";
+    session_->StopAfterSnapshot([stop_callback = std::move(stop_callback)]() {
+      FX_LOGS(INFO) << "Stopped trace";
+      stop_callback();
+    });
+    return;
+  }
+
   if (session_->state() != TraceSession::State::kInitialized &&
       session_->state() != TraceSession::State::kStarting &&
       session_->state() != TraceSession::State::kStarted) {
@@ -361,6 +371,10 @@ controller::SessionState TraceManager::TranslateSessionState(TraceSession::State
 }
 
 void TraceManager::OnAlert(const std::string& alert_name) {
+  if (config_.snapshot_alerts().count(alert_name) != 0) {
+    SnapshotSession(alert_name);
+  }
+
   if (watch_alert_callbacks_.empty()) {
     if (alerts_.size() == kMaxAlertQueueDepth) {
       // We're at our queue depth limit. Discard the oldest alert.
@@ -375,4 +389,19 @@ void TraceManager::OnAlert(const std::string& alert_name) {
   watch_alert_callbacks_.pop();
 }
 
+void TraceManager::SnapshotSession(const std::string& alert_name) {
+  if (!session_ || session_->state() != TraceSession::State::kStarted) {
+    // This includes alerts received while a previous snapshot is being saved.
+    FX_LOGS(WARNING) << "Ignoring snapshot alert " << alert_name << ", trace not started";
+    return;
+  }
+  if (session_->buffering_mode() == provider::BufferingMode::STREAMING) {
+    // Streaming traces are saved as they go, there's nothing to snapshot.
+    return;
+  }
+
+  FX_LOGS(INFO) << "Saving trace snapshot for alert " << alert_name;
+  session_->Snapshot([]() { FX_LOGS(INFO) << "Saved trace snapshot"; });
+}
+
 }  // namespace tracing
@@ -61,6 +61,7 @@ class TraceManager : public controller::Controller, public provider::Registry {
   controller::SessionState TranslateSessionState(TraceSession::State state);
 
   void OnAlert(const std::string& alert_name);
+  void SnapshotSession(const std::string& alert_name);
 
   TraceManagerApp* const app_;
 
@@ -170,11 +170,55 @@ void TraceSession::Stop(bool write_results, fit::closure callback) {
     force_clear_buffer_contents_ = true;
   }
 
+  // Clear out, must be respecified for each Start() request.
+  // This is done before the stop callback can run, as it may start tracing
+  // again (see |Snapshot()|).
+  additional_categories_.clear();
+
   session_stop_timeout_.PostDelayed(async_get_default_dispatcher(), stop_timeout_);
   CheckAllProvidersStopped();
+}
 
-  // Clear out, must be respecified for each Start() request.
-  additional_categories_.clear();
+void TraceSession::Snapshot(fit::closure callback) {
+  FX_DCHECK(state_ == State::kStarted);
+
+  snapshot_in_progress_ = true;
+  Stop(/*write_results=*/true,
+       [weak = weak_ptr_factory_.GetWeakPtr(), additional_categories = additional_categories_,
+        callback = std::move(callback)]() mutable {
+         if (!weak) {
+           callback();
+           return;
+         }
+         weak->snapshot_in_progress_ = false;
+         fit::closure stop_callback = std::move(weak->stop_after_snapshot_callback_);
+         weak->stop_after_snapshot_callback_ = nullptr;
+         if (stop_callback || weak->state_ != State::kStopped) {
+           // Tracing was stopped, or terminated, while the snapshot was saved.
+           if (stop_callback) {
+             stop_callback();
+           }
+           callback();
+           return;
+         }
+         // The buffers were just saved, so start over with empty ones.
+         weak->Start(controller::BufferDisposition::CLEAR_ALL, additional_categories,
+                     [callback = std::move(callback)](
+                         controller::Controller_StartTracing_Result result) { callback(); });
+       });
+}
+
+void TraceSession::StopAfterSnapshot(fit::closure callback) {
+  FX_DCHECK(snapshot_in_progress_);
+
+  if (stop_after_snapshot_callback_) {
+    callback = [first = std::move(stop_after_snapshot_callback_),
+                second = std::move(callback)]() mutable {
+      first();
+      second();
+    };
+  }
+  stop_after_snapshot_callback_ = std::move(callback);
 }
 
 // Called when a provider reports that it has started.
@@ -76,6 +76,8 @@ class TraceSession : public fxl::RefCountedThreadSafe<TraceSession> {
 
   const zx::socket& destination() const { return destination_; }
 
+  provider::BufferingMode buffering_mode() const { return buffering_mode_; }
+
   // For testing.
   State state() const { return state_; }
 
@@ -116,6 +118,23 @@ class TraceSession : public fxl::RefCountedThreadSafe<TraceSession> {
   // stop tracing and invoke |callback|.
   void Stop(bool write_results, fit::closure callback);
 
+  // Saves the current contents of the providers' buffers without ending the
+  // session, so a started session can act as a flight recorder: providers are
+  // stopped with |write_results| set and then immediately restarted, with
+  // cleared buffers and the same additional categories.
+  // Invokes |callback| when tracing has restarted, or if the session is
+  // terminated in the interim.
+  void Snapshot(fit::closure callback);
+
+  // True from |Snapshot()| until its providers have stopped.
+  bool snapshot_in_progress() const { return snapshot_in_progress_; }
+
+  // Handles a stop request received while |Snapshot()| is stopping the
+  // providers. The providers are not restarted and the session stays stopped.
+  // Invokes |callback| once they have stopped. The snapshot writes the
+  // results either way.
+  void StopAfterSnapshot(fit::closure callback);
+
   // Remove |provider|, it's dead Jim.
   void RemoveDeadProvider(TraceProviderBundle* provider);
 
@@ -187,6 +206,10 @@ class TraceSession : public fxl::RefCountedThreadSafe<TraceSession> {
   fit::closure stop_callback_;
   fit::closure terminate_callback_;
 
+  // See |snapshot_in_progress()| and |StopAfterSnapshot()|.
+  bool snapshot_in_progress_ = false;
+  fit::closure stop_after_snapshot_callback_;
+
   fit::closure abort_handler_;
   AlertCallback alert_callback_;
 
@@ -26,9 +26,10 @@ void ModulePool::ForEachModule(fit::function<void(ModuleProxy&)> func) {
   }
 }
 
-size_t ModulePool::Measure() {
+size_t ModulePool::Measure(Features* out_features) {
   size_t count = 0;
-  ForEachModule([&count](ModuleProxy& module) { count += module.Measure(); });
+  ForEachModule(
+      [&count, out_features](ModuleProxy& module) { count += module.Measure(out_features); });
   return count;
 }
 
@@ -38,6 +39,14 @@ size_t ModulePool::Accumulate() {
   return count;
 }
 
+size_t ModulePool::Accumulate(const Features& features) {
+  size_t count = 0;
+  for (const auto& feature_word : features) {
+    count += feature_word.module->Accumulate(feature_word.offset, feature_word.features);
+  }
+  return count;
+}
+
 size_t ModulePool::GetCoverage(size_t* out_num_features) {
   size_t num_pcs = 0;
   size_t num_features = 0;
@@ -33,8 +33,11 @@ class ModulePool final {
   ModuleProxy* Get(const std::string& id, size_t size);
 
   // These correspond to |ModuleProxy| methods, but are applied to all modules.
-  size_t Measure();
+  size_t Measure(Features* out_features = nullptr);
   size_t Accumulate();
+
+  // Records the |features| previously returned by |Measure| and returns how many of them are new.
+  size_t Accumulate(const Features& features);
   size_t GetCoverage(size_t* out_num_features);
   void Clear();
 
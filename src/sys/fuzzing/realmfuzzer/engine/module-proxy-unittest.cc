@@ -5,6 +5,7 @@
 #include "src/sys/fuzzing/realmfuzzer/engine/module-proxy.h"
 
 #include <random>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -197,6 +198,82 @@ TEST(ModuleProxyTest, Features) {
   EXPECT_EQ(total, 8U);
 }
 
+TEST(ModuleProxyTest, MeasureFeatures) {
+  ModuleProxy proxy({0, 0}, FakeModule::kNumPCs);
+  FakeModule module;
+  proxy.Add(module.counters(), module.num_pcs());
+
+  module[0] = 1;
+  module[1] = 2;
+  EXPECT_EQ(proxy.Accumulate(), 2U);
+
+  // Only new features are returned, and only for the offsets that have them.
+  module[1] = 3;
+  module[FakeModule::kNumPCs - 1] = 200;
+  Features features;
+  EXPECT_EQ(proxy.Measure(&features), 2U);
+  ASSERT_EQ(features.size(), 2U);
+  EXPECT_EQ(features[0].module, &proxy);
+  EXPECT_EQ(features[0].offset, 0U);
+  EXPECT_EQ(features[0].features, 1ULL << 10);
+  EXPECT_EQ(features[1].module, &proxy);
+  EXPECT_EQ(features[1].offset, FakeModule::kNumPCs / sizeof(uint64_t) - 1);
+  EXPECT_EQ(features[1].features, 1ULL << 63);
+
+  // Measuring doesn't record the features, but they can be recorded later.
+  EXPECT_EQ(proxy.Measure(), 2U);
+  memset(module.counters(), 0, module.num_pcs());
+  for (const auto& feature_word : features) {
+    EXPECT_EQ(proxy.Accumulate(feature_word.offset, feature_word.features), 1U);
+  }
+  for (const auto& feature_word : features) {
+    EXPECT_EQ(proxy.Accumulate(feature_word.offset, feature_word.features), 0U);
+  }
+  size_t num_features;
+  EXPECT_EQ(proxy.GetCoverage(&num_features), 3U);
+  EXPECT_EQ(num_features, 4U);
+}
+
+TEST(ModuleProxyTest, Sparse) {
+  // Use a size that isn't a multiple of a cache line, to exercise the partial last block.
+  constexpr size_t kNumU64s = 1001;
+  constexpr size_t kSize = kNumU64s * sizeof(uint64_t);
+  std::vector<uint64_t> u64s0(kNumU64s, 0);
+  std::vector<uint64_t> u64s1(kNumU64s, 0);
+  auto* counters0 = reinterpret_cast<uint8_t*>(u64s0.data());
+  auto* counters1 = reinterpret_cast<uint8_t*>(u64s1.data());
+  ModuleProxy proxy({0, 0}, kSize);
+  proxy.Add(counters0, kSize);
+  proxy.Add(counters1, kSize);
+
+  // Counters at the start, middle and end of the module.
+  counters0[0] = 1;
+  counters0[kSize / 2] = 1;
+  counters0[kSize - 1] = 1;
+  EXPECT_EQ(proxy.Accumulate(), 3U);
+
+  // Counters from different instances are summed.
+  counters1[kSize - 1] = 1;
+  EXPECT_EQ(proxy.Accumulate(), 1U);
+
+  // Counters that were set in a previous run don't affect later runs.
+  memset(counters0, 0, kSize);
+  memset(counters1, 0, kSize);
+  counters0[kSize - 1] = 2;
+  EXPECT_EQ(proxy.Measure(), 0U);
+  counters1[kSize - 2] = 128;
+  counters1[kSize - 1] = 254;
+  EXPECT_EQ(proxy.Measure(), 2U);
+
+  // Sums saturate at the highest feature.
+  memset(counters0, 0xff, kSize);
+  memset(counters1, 0xff, kSize);
+  EXPECT_EQ(proxy.Accumulate(), kSize);
+  size_t num_features;
+  EXPECT_EQ(proxy.GetCoverage(&num_features), kSize);
+  EXPECT_EQ(num_features, kSize + 4);
+}
+
 TEST(ModuleProxyTest, FromModule) {
   FakeModule fake;
   auto module = std::make_unique<Module>();
@@ -5,48 +5,110 @@
 #include "src/sys/fuzzing/realmfuzzer/engine/module-proxy.h"
 
 #include <lib/syslog/cpp/macros.h>
+#include <string.h>
 
 namespace fuzzing {
 namespace {
 
-// Convert counter values to "features" in the same manner as AFL, described here:
-// http://lcamtuf.coredump.cx/afl/technical_details.txt.
+// Counters are scanned a block at a time, with each block being the size of a cache line. Non-zero
+// blocks are then processed a vector at a time. The compiler lowers operations on these vector
+// types to the SIMD instructions available on the target, e.g. SSE or AVX2 on x64 and NEON on
+// arm64.
+constexpr size_t kBlockSize = 64;
+constexpr size_t kU64sPerBlock = kBlockSize / sizeof(uint64_t);
+constexpr size_t kVectorSize = 16;
+constexpr size_t kU64sPerVector = kVectorSize / sizeof(uint64_t);
+using U64Vector = uint64_t __attribute__((vector_size(kVectorSize)));
+using U8Vector = uint8_t __attribute__((vector_size(kVectorSize)));
+
+// High bit in each byte of a uint64_t. See |MeasureImpl|.
+constexpr uint64_t kHiBitsMask = 0x80'80'80'80'80'80'80'80ULL;
+
+// Counters are only guaranteed to be 64-bit aligned, so vectors are always loaded and stored
+// unaligned.
+U64Vector Load(const uint64_t* u64s) {
+  U64Vector vector;
+  memcpy(&vector, u64s, sizeof(vector));
+  return vector;
+}
+
+void Store(const U64Vector& vector, uint64_t* u64s) { memcpy(u64s, &vector, sizeof(vector)); }
+
+bool IsZero(const uint64_t* block) {
+  uint64_t any = 0;
+  for (size_t i = 0; i < kU64sPerBlock; ++i) {
+    any |= block[i];
+  }
+  return any == 0;
+}
+
+// Adds a block of |counters| to a block of |sums|.
 //
-// This implementation is based on the one used by libFuzzer. Do not try to optimize this further;
-// as written the compiler is able to effectively optimize it at -O2 and higher.
-uint8_t to_feature(uint8_t counter) {
-  uint8_t feature = 0;
-  if (counter >= 128) {
-    feature = 1 << 7;
-  } else if (counter >= 32) {
-    feature = 1 << 6;
-  } else if (counter >= 16) {
-    feature = 1 << 5;
-  } else if (counter >= 8) {
-    feature = 1 << 4;
-  } else if (counter >= 4) {
-    feature = 1 << 3;
-  } else if (counter >= 3) {
-    feature = 1 << 2;
-  } else if (counter >= 2) {
-    feature = 1 << 1;
-  } else if (counter >= 1) {
-    feature = 1 << 0;
+// Sums over 128 map to the same feature and don't need to be distinguish. This means we can get
+// the right features by simply adding 7-bits of each byte in parallel and ORing the high bits. This
+// avoids overflowing from one byte to the next.
+void AddBlock(const uint64_t* counters, uint64_t* sums) {
+  for (size_t i = 0; i < kU64sPerBlock; i += kU64sPerVector) {
+    auto counter = Load(&counters[i]);
+    auto sum = Load(&sums[i]);
+    auto hi_bits = (counter | sum) & kHiBitsMask;
+    Store(((sum & ~kHiBitsMask) + (counter & ~kHiBitsMask)) | hi_bits, &sums[i]);
   }
-  return feature;
 }
 
-// High bit in each byte of a uint64_t. See |MeasureImpl|.
-constexpr uint64_t kHiBitsMask = 0x80'80'80'80'80'80'80'80ULL;
+// Convert each byte of summed counter values to "features" in the same manner as AFL, described
+// here: http://lcamtuf.coredump.cx/afl/technical_details.txt.
+//
+// Each counter maps to a single bit representing the highest of the buckets [1], [2], [3], [4, 7],
+// [8, 15], [16, 31], [32, 127] and [128, 255] that it reaches. This is computed without branches
+// by first setting the bits of all the buckets the counter reaches and then keeping only the
+// highest one.
+U64Vector ToFeatures(const U64Vector& sums) {
+  auto bytes = reinterpret_cast<U8Vector>(sums);
+  auto reaches = [&bytes](uint8_t threshold, uint8_t bit) -> U8Vector {
+    return reinterpret_cast<U8Vector>(bytes >= threshold) & bit;
+  };
+  U8Vector buckets = reaches(1, 1 << 0) | reaches(2, 1 << 1) | reaches(3, 1 << 2) |
+                     reaches(4, 1 << 3) | reaches(8, 1 << 4) | reaches(16, 1 << 5) |
+                     reaches(32, 1 << 6) | reaches(128, 1 << 7);
+  return reinterpret_cast<U64Vector>(buckets ^ (buckets >> 1));
+}
+
+// Converts a block of |sums| to features and returns how many of those are not in the block of
+// |accumulated| features. If |accumulate| is true, also adds the features to |accumulated|. If
+// |out_new_features| is not null, the block of new features is stored to it.
+size_t MeasureBlock(const uint64_t* sums, uint64_t* accumulated, bool accumulate,
+                    uint64_t* out_new_features) {
+  size_t num_new_features = 0;
+  for (size_t i = 0; i < kU64sPerBlock; i += kU64sPerVector) {
+    auto features = ToFeatures(Load(&sums[i]));
+    auto previous = Load(&accumulated[i]);
+    auto new_features = features & ~previous;
+    for (size_t j = 0; j < kU64sPerVector; ++j) {
+      num_new_features += __builtin_popcountll(new_features[j]);
+    }
+    if (accumulate) {
+      Store(previous | features, &accumulated[i]);
+    }
+    if (out_new_features) {
+      Store(new_features, &out_new_features[i]);
+    }
+  }
+  return num_new_features;
+}
 
 }  // namespace
 
 ModuleProxy::ModuleProxy(const std::string& id, size_t size)
-    : id_(id), num_u64s_(size / sizeof(uint64_t)) {
+    : id_(id),
+      num_u64s_(size / sizeof(uint64_t)),
+      num_blocks_((num_u64s_ + kU64sPerBlock - 1) / kU64sPerBlock),
+      is_dirty_(num_blocks_, false) {
   // This method expects 64-bit alignment to simplify iteration.
   FX_CHECK(size % sizeof(uint64_t) == 0);
-  features_.reset(new uint64_t[num_u64s_]);
-  accumulated_.reset(new uint64_t[num_u64s_]);
+  features_.reset(new uint64_t[num_blocks_ * kU64sPerBlock]);
+  accumulated_.reset(new uint64_t[num_blocks_ * kU64sPerBlock]);
+  memset(features_.get(), 0, num_blocks_ * kBlockSize);
   Clear();
 }
 
@@ -63,37 +125,63 @@ void ModuleProxy::Remove(void* counters) {
       counters_.end());
 }
 
-size_t ModuleProxy::Measure() { return MeasureImpl(/* accumulate */ false); }
+size_t ModuleProxy::Measure(Features* out_features) {
+  return MeasureImpl(/* accumulate */ false, out_features);
+}
 
-size_t ModuleProxy::Accumulate() { return MeasureImpl(/* accumulate */ true); }
+size_t ModuleProxy::Accumulate() { return MeasureImpl(/* accumulate */ true, nullptr); }
 
-size_t ModuleProxy::MeasureImpl(bool accumulate) {
+size_t ModuleProxy::Accumulate(size_t offset, uint64_t features) {
+  FX_CHECK(offset < num_u64s_);
+  auto new_features = features & ~accumulated_[offset];
+  accumulated_[offset] |= features;
+  return __builtin_popcountll(new_features);
+}
+
+size_t ModuleProxy::MeasureImpl(bool accumulate, Features* out_features) {
   size_t num_new_features = 0;
-  memset(features_.get(), 0, size());
-  // First, sum all counters into the features array.
+  // Only the blocks that were dirtied by the previous call need to be reset.
+  for (auto block : dirty_) {
+    memset(&features_[block * kU64sPerBlock], 0, kBlockSize);
+    is_dirty_[block] = false;
+  }
+  dirty_.clear();
+  // First, sum all counters into the features array. Most counters are zero on any given run, so
+  // blocks of zeros are skipped early and the remaining blocks are recorded as dirty.
   for (auto* counters : counters_) {
-    for (size_t i = 0; i < num_u64s_; ++i) {
-      if (counters[i]) {
-        // Sums over 128 map to the same feature and don't need to be distinguish. This means we can
-        // get the right features by simply adding 7-bits of each byte in parallel and ORing the
-        // high bits. This avoids overflowing from one byte to the next.
-        uint64_t hi_bits = (counters[i] | features_[i]) & kHiBitsMask;
-        features_[i] = ((features_[i] & ~kHiBitsMask) + (counters[i] & ~kHiBitsMask)) | hi_bits;
+    for (size_t block = 0; block < num_blocks_; ++block) {
+      auto offset = block * kU64sPerBlock;
+      const uint64_t* counter_block = &counters[offset];
+      uint64_t last_block[kU64sPerBlock];
+      if (num_u64s_ - offset < kU64sPerBlock) {
+        memset(last_block, 0, sizeof(last_block));
+        memcpy(last_block, counter_block, (num_u64s_ - offset) * sizeof(uint64_t));
+        counter_block = last_block;
+      }
+      if (IsZero(counter_block)) {
+        continue;
+      }
+      if (!is_dirty_[block]) {
+        is_dirty_[block] = true;
+        dirty_.push_back(block);
       }
+      AddBlock(counter_block, &features_[offset]);
     }
   }
-  // Next, convert the summed counters to features.
-  for (size_t i = 0; i < num_u64s_; ++i) {
-    if (features_[i]) {
-      uint8_t* feature = reinterpret_cast<uint8_t*>(&features_[i]);
-      for (size_t j = 0; j < sizeof(uint64_t); ++j) {
-        feature[j] = static_cast<uint8_t>(to_feature(feature[j]));
-      }
-      num_new_features += __builtin_popcountll(~accumulated_[i] & features_[i]);
-      if (accumulate) {
-        accumulated_[i] |= features_[i];
+  // Next, convert the summed counters in the dirty blocks to features.
+  uint64_t new_features[kU64sPerBlock];
+  for (auto block : dirty_) {
+    auto offset = block * kU64sPerBlock;
+    auto num_block_features = MeasureBlock(&features_[offset], &accumulated_[offset], accumulate,
+                                           out_features ? new_features : nullptr);
+    if (out_features && num_block_features) {
+      for (size_t i = 0; i < kU64sPerBlock; ++i) {
+        if (new_features[i]) {
+          out_features->push_back({this, offset + i, new_features[i]});
+        }
       }
     }
+    num_new_features += num_block_features;
   }
   return num_new_features;
 }
@@ -118,6 +206,6 @@ size_t ModuleProxy::GetCoverage(size_t* out_num_features) {
   return num_pcs;
 }
 
-void ModuleProxy::Clear() { memset(accumulated_.get(), 0, size()); }
+void ModuleProxy::Clear() { memset(accumulated_.get(), 0, num_blocks_ * kBlockSize); }
 
 }  // namespace fuzzing
@@ -20,6 +20,17 @@
 
 namespace fuzzing {
 
+class ModuleProxy;
+
+// A compact representation of the features of a run. Each element holds the 64 features at a
+// given offset, in 64-bit words, into a |module|'s features. Offsets without features are omitted.
+struct FeatureWord {
+  ModuleProxy* module;
+  size_t offset;
+  uint64_t features;
+};
+using Features = std::vector<FeatureWord>;
+
 // This class in the fuzzer engine is analogous to |fuzzing::Module| in an instrumented process.
 // This association is one-to-many: The engine collects feedback from multiple processes which may
 // possibly even restart. As a result it maintains a single |ModuleProxy| for all instances of a
@@ -42,12 +53,19 @@ class ModuleProxy final {
   // features and returns the number of new features. This method does not record the features, and
   // so is useful for evaluating a set of inputs as compared to a base set of features, e.g. from a
   // seed corpus. For info on "features", see: http://lcamtuf.coredump.cx/afl/technical_details.txt.
-  size_t Measure();
+  //
+  // If |out_features| is not null, the new features are also appended to it. These can be recorded
+  // later using |Accumulate| without needing to run the input again.
+  size_t Measure(Features* out_features = nullptr);
 
   // Like |Measure|, but additionally records the new features, making the method useful for
   // incrementally growing a corpus.
   size_t Accumulate();
 
+  // Records the given |features| at |offset| and returns how many of them are new. |offset| should
+  // be from a |FeatureWord| for this module that was previously returned by |Measure|.
+  size_t Accumulate(size_t offset, uint64_t features);
+
   // Returns how many PCs have accumulated at least one feature. If |out_num_features| is not null,
   // sets it to how many features have been accumulated in total.
   size_t GetCoverage(size_t* out_num_features);
@@ -56,13 +74,22 @@ class ModuleProxy final {
   void Clear();
 
  private:
-  size_t MeasureImpl(bool accumulate);
+  size_t MeasureImpl(bool accumulate, Features* out_features);
 
   const std::string id_;
   const size_t num_u64s_;
 
+  // Counters are scanned a cache line-sized block at a time. The feature arrays below are padded
+  // to a whole number of blocks.
+  const size_t num_blocks_;
+
   std::vector<uint64_t*> counters_;
 
+  // Blocks with at least one non-zero counter in the most recent call to |MeasureImpl|. Only these
+  // blocks need to be converted to features, and later reset.
+  std::vector<size_t> dirty_;
+  std::vector<bool> is_dirty_;
+
   // TODO(fxbug.dev/84363): Smaller inputs that cover previously observed features are currently
   // discarded. To help minimize the corpus, this object could also track the smallest input size
   // for each feature, in order to save smaller inputs and prefer them in a subsequent (possibly
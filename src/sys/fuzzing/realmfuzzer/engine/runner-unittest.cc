@@ -4,7 +4,11 @@
 
 #include "src/sys/fuzzing/realmfuzzer/engine/runner.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "src/sys/fuzzing/common/options.h"
+#include "src/sys/fuzzing/common/testing/monitor.h"
 #include "src/sys/fuzzing/realmfuzzer/engine/runner-test.h"
 
 namespace fuzzing {
@@ -37,5 +41,110 @@ TEST_F(RealmFuzzerRunnerTest, MergeSeedError) {
 
 TEST_F(RealmFuzzerRunnerTest, Merge) { Merge(/* keep_errors= */ true); }
 
+TEST_F(RealmFuzzerRunnerTest, FuzzWithSharedCorpus) {
+  auto options = MakeOptions();
+  const size_t kNumRuns = 20;
+  options->set_runs(kNumRuns);
+  Configure(options);
+
+  Artifact artifact;
+  FUZZING_EXPECT_OK(runner()->Fuzz(), &artifact);
+  for (size_t i = 0; i < 3; ++i) {
+    FUZZING_EXPECT_OK(RunOne());
+  }
+  RunUntilIdle();
+
+  // Simulate another fuzzer instance sharing an input it found while fuzzing. The input should be
+  // tested in one of the following runs, and only be added to the corpus once.
+  Input shared("shared");
+  EXPECT_EQ(runner()->AddToCorpus(CorpusType::LIVE, shared.Duplicate()), ZX_OK);
+  std::vector<Input> inputs(kNumRuns - 3);
+  for (auto& input : inputs) {
+    FUZZING_EXPECT_OK(RunOne({{42, 1}}), &input);
+  }
+  RunUntilIdle();
+  EXPECT_EQ(artifact.fuzz_result(), FuzzResult::NO_ERRORS);
+  EXPECT_EQ(std::count(inputs.begin(), inputs.end(), shared), 1);
+
+  auto live_corpus = runner()->GetCorpus(CorpusType::LIVE);
+  EXPECT_EQ(std::count(live_corpus.begin(), live_corpus.end(), shared), 1);
+}
+
+TEST_F(RealmFuzzerRunnerTest, FuzzWithSharedCorpusDoesNotReportNew) {
+  auto options = MakeOptions();
+  const size_t kNumRuns = 10;
+  options->set_runs(kNumRuns);
+  Configure(options);
+
+  FakeMonitor monitor(executor());
+  runner()->AddMonitor(monitor.NewBinding());
+
+  Artifact artifact;
+  FUZZING_EXPECT_OK(runner()->Fuzz(), &artifact);
+  for (size_t i = 0; i < 3; ++i) {
+    FUZZING_EXPECT_OK(RunOne());
+  }
+  RunUntilIdle();
+
+  // The shared input adds coverage, but it was found by the peer that shared it.
+  Input shared("shared");
+  SetCoverage(shared, {{42, 2}});
+  EXPECT_EQ(runner()->AddToCorpus(CorpusType::LIVE, shared.Duplicate()), ZX_OK);
+  for (size_t i = 3; i < kNumRuns; ++i) {
+    FUZZING_EXPECT_OK(RunOne());
+  }
+  RunUntilIdle();
+  EXPECT_EQ(artifact.fuzz_result(), FuzzResult::NO_ERRORS);
+
+  FUZZING_EXPECT_OK(monitor.AwaitUpdate());
+  RunUntilIdle();
+  while (monitor.reason() != UpdateReason::DONE) {
+    EXPECT_NE(size_t(monitor.reason()), size_t(UpdateReason::NEW));
+    monitor.pop_front();
+    FUZZING_EXPECT_OK(monitor.AwaitUpdate());
+    RunUntilIdle();
+  }
+}
+
+TEST_F(RealmFuzzerRunnerTest, FuzzWithSharedCorpusReachesMaxInputSize) {
+  auto options = MakeOptions();
+  const size_t kNumRuns = 100;
+  const size_t kMaxInputSize = 2;
+  options->set_runs(kNumRuns);
+  options->set_max_input_size(kMaxInputSize);
+  options->set_mutation_depth(1);
+  Configure(options);
+
+  Artifact artifact;
+  FUZZING_EXPECT_OK(runner()->Fuzz(), &artifact);
+  for (size_t i = 0; i < 3; ++i) {
+    FUZZING_EXPECT_OK(RunOne());
+  }
+  RunUntilIdle();
+
+  // Share more short inputs than the runner has inputs to recycle, i.e. the mutation depth plus
+  // one, so that every recycled input is used to test one of them.
+  std::vector<Input> shared;
+  shared.emplace_back("a");
+  shared.emplace_back("b");
+  shared.emplace_back("c");
+  for (const auto& input : shared) {
+    EXPECT_EQ(runner()->AddToCorpus(CorpusType::LIVE, input.Duplicate()), ZX_OK);
+  }
+  std::vector<Input> inputs(kNumRuns - 3);
+  for (auto& input : inputs) {
+    FUZZING_EXPECT_OK(RunOne(), &input);
+  }
+  RunUntilIdle();
+  EXPECT_EQ(artifact.fuzz_result(), FuzzResult::NO_ERRORS);
+
+  // Mutations after the shared inputs are tested can still produce inputs of the maximum size.
+  auto last_shared = std::find(inputs.begin(), inputs.end(), shared.back());
+  ASSERT_NE(last_shared, inputs.end());
+  EXPECT_TRUE(std::any_of(last_shared, inputs.end(), [kMaxInputSize](const Input& input) {
+    return input.size() == kMaxInputSize;
+  }));
+}
+
 }  // namespace
 }  // namespace fuzzing
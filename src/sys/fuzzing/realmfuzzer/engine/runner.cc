@@ -10,6 +10,7 @@
 #include <zircon/status.h>
 #include <zircon/syscalls/exception.h>
 
+#include <algorithm>
 #include <deque>
 
 #include "src/lib/fxl/macros.h"
@@ -75,8 +76,16 @@ zx_status_t RealmFuzzerRunner::AddToCorpus(CorpusType corpus_type, Input input)
   switch (corpus_type) {
     case CorpusType::SEED:
       return seed_corpus_->Add(std::move(input));
-    case CorpusType::LIVE:
-      return live_corpus_->Add(std::move(input));
+    case CorpusType::LIVE: {
+      auto imported = importing_ ? input.Duplicate() : Input();
+      if (auto status = live_corpus_->Add(std::move(input)); status != ZX_OK) {
+        return status;
+      }
+      if (importing_) {
+        imported_.emplace_back(std::move(imported));
+      }
+      return ZX_OK;
+    }
     default:
       return ZX_ERR_INVALID_ARGS;
   }
@@ -325,39 +334,42 @@ ZxPromise<> RealmFuzzerRunner::Merge() {
       .or_else([this, collect_errors](const zx_status_t& status) {
         return CheckPrevious(status).and_then([this, collect_errors] {
           // Next, measure what coverage each element of the live corpus provides beyond that
-          // accumulated by the seed corpus. After this step the live corpus contains only valid,
-          // measured inputs.
+          // accumulated by the seed corpus. The new features of each valid input are recorded
+          // compactly, so that the inputs do not need to be run again below.
           auto unmeasured = live_corpus_;
           live_corpus_ = Corpus::MakePtr();
           live_corpus_->Configure(options_);
+          measured_.clear();
           return TestCorpusAsync(unmeasured, kMeasureCoverageAndKeepInputs, collect_errors);
         });
       })
+      .and_then([](const Artifact& artifact) -> ZxResult<> {
+        FX_LOGS(ERROR) << "Unexpected artifact while merging: '" << artifact.input().ToHex() << "'";
+        return fpromise::error(ZX_ERR_BAD_STATE);
+      })
       .or_else([this, collect_errors](const zx_status_t& status) {
-        return CheckPrevious(status).and_then([this, collect_errors] {
+        return CheckPrevious(status).and_then([this, collect_errors]() -> ZxResult<> {
           if (!collect_errors->empty()) {
             FX_LOGS(WARNING) << "Corpus contains input(s) that trigger error(s):";
             for (auto& input : *collect_errors) {
               FX_LOGS(WARNING) << "  '" << input.ToHex() << "'";
             }
           }
-          // Finally, accumulate the coverage from each element of the live corpus. The live corpus
-          // will be stably sorted by size, number of features measured above, and lexicographical
-          // order. Only elements that add coverage not accumulated by previous elements will be
-          // kept.
-          auto measured = live_corpus_;
-          live_corpus_ = Corpus::MakePtr();
-          live_corpus_->Configure(options_);
-          return TestCorpusAsync(measured, kAccumulateCoverageAndKeepInputs);
-        });
-      })
-      .and_then([](const Artifact& artifact) -> ZxResult<> {
-        FX_LOGS(ERROR) << "Previously successful input triggered an error: '"
-                       << artifact.input().ToHex() << "'";
-        return fpromise::error(ZX_ERR_BAD_STATE);
-      })
-      .or_else([this, collect_errors](const zx_status_t& status) {
-        return CheckPrevious(status).and_then([this, collect_errors]() -> ZxResult<> {
+          // Next, accumulate the recorded features of each measured input. The inputs are stably
+          // sorted by size, number of features measured above, and lexicographical order. Only
+          // elements that add coverage not accumulated by previous elements are kept. This greedily
+          // prefers smaller inputs, and produces the same corpus as running each input again would.
+          std::stable_sort(measured_.begin(), measured_.end(),
+                           [](const auto& a, const auto& b) { return a.first < b.first; });
+          for (auto& [input, features] : measured_) {
+            if (!pool_->Accumulate(features)) {
+              continue;
+            }
+            if (auto status = live_corpus_->Add(std::move(input)); status != ZX_OK) {
+              return fpromise::error(status);
+            }
+          }
+          measured_.clear();
           // As a final step, keep any inputs that triggered errors.
           for (auto& input : *collect_errors) {
             if (auto status = live_corpus_->Add(std::move(input)); status != ZX_OK) {
@@ -453,6 +465,10 @@ void RealmFuzzerRunner::StartWorkflow(Scope& scope) {
 }
 
 void RealmFuzzerRunner::FinishWorkflow() {
+  importing_ = false;
+  imported_.clear();
+  imported_in_flight_.clear();
+  measured_.clear();
   generated_receiver_.Clear();
   processed_receiver_.Clear();
   leak_receiver_.Clear();
@@ -509,15 +525,26 @@ ZxPromise<> RealmFuzzerRunner::GenerateInputs(size_t num_inputs, size_t backlog)
             return fpromise::ok();
           }
           auto input = recycle.take_value();
-          if (num_mutations >= mutation_depth) {
-            // Pick an input and mutate it |mutation_depth| times in a row.
-            mutagen_.reset_mutations();
-            live_corpus_->Pick(mutagen_.base_input());
-            live_corpus_->Pick(mutagen_.crossover());
-            num_mutations = 0;
+          if (!imported_.empty()) {
+            // Test inputs imported into the live corpus before any further mutations. They are
+            // copied so the recycled input keeps its capacity for later mutations.
+            auto& imported = imported_.front();
+            input.Clear();
+            input.Reserve(imported.size());
+            input.Write(imported.data(), imported.size());
+            imported_in_flight_.emplace_back(std::move(imported));
+            imported_.pop_front();
+          } else {
+            if (num_mutations >= mutation_depth) {
+              // Pick an input and mutate it |mutation_depth| times in a row.
+              mutagen_.reset_mutations();
+              live_corpus_->Pick(mutagen_.base_input());
+              live_corpus_->Pick(mutagen_.crossover());
+              num_mutations = 0;
+            }
+            mutagen_.Mutate(&input);
+            ++num_mutations;
           }
-          mutagen_.Mutate(&input);
-          ++num_mutations;
           auto status = generated_sender_.Send(std::move(input));
           num_sent++;
           if (status != ZX_OK) {
@@ -623,6 +650,9 @@ ZxPromise<Artifact> RealmFuzzerRunner::FuzzInputs(size_t backlog) {
       })
       .or_else([this, backlog, num_inputs](const zx_status_t& status) {
         live_corpus_->Add(seed_corpus_);
+        // From here on, inputs added to the live corpus are tested as they arrive. Those added
+        // earlier were already tested above.
+        importing_ = true;
         return CheckPrevious(status).and_then(
             [generate = ZxFuture<>(GenerateInputs(num_inputs, backlog)),
              test = ZxFuture<Artifact>(TestInputs(kAccumulateCoverageAndKeepInputs))](
@@ -952,17 +982,22 @@ void RealmFuzzerRunner::Analyze(Input& input, PostProcessing mode) {
       break;
     }
     case kMeasureCoverageAndKeepInputs: {
-      auto num_features = pool_->Measure();
+      Features features;
+      auto num_features = pool_->Measure(&features);
       if (num_features) {
         input.set_num_features(num_features);
-        if (auto status = live_corpus_->Add(std::move(input)); status != ZX_OK) {
-          FX_LOGS(WARNING) << "Failed to save input: " << zx_status_get_string(status);
-        }
+        measured_.emplace_back(std::move(input), std::move(features));
       }
       break;
     }
     case kAccumulateCoverageAndKeepInputs: {
-      if (pool_->Accumulate()) {
+      // Imported inputs are tested in the order they were generated. They are already in the live
+      // corpus, and their coverage was found by a peer, so it isn't reported as new.
+      auto imported = !imported_in_flight_.empty() && input == imported_in_flight_.front();
+      if (imported) {
+        imported_in_flight_.pop_front();
+      }
+      if (pool_->Accumulate() && !imported) {
         if (auto status = live_corpus_->Add(std::move(input)); status != ZX_OK) {
           FX_LOGS(WARNING) << "Failed to save input: " << zx_status_get_string(status);
         }
@@ -11,7 +11,9 @@
 #include <lib/zx/time.h>
 #include <stddef.h>
 
+#include <deque>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "src/lib/fxl/macros.h"
@@ -79,7 +81,7 @@ class RealmFuzzerRunner final : public Runner {
     kAccumulateCoverage,
 
     // Determine if any of the input's coverage is new. If so, record the coverage in the input and
-    // add it to the live corpus.
+    // save it and its new features to be merged into the live corpus. See |Merge|.
     kMeasureCoverageAndKeepInputs,
 
     // Determine if any of the input's coverage is new. If so, add it to the overall coverage and
@@ -206,6 +208,15 @@ class RealmFuzzerRunner final : public Runner {
   CorpusPtr live_corpus_;
   Mutagen mutagen_;
 
+  // Inputs added to the live corpus while fuzzing, e.g. by other fuzzer instances sharing the
+  // corpus. These are tested ahead of any further mutations so that their coverage is accumulated,
+  // keeping this instance from rediscovering features already found by its peers.
+  bool importing_ = false;
+  std::deque<Input> imported_;
+
+  // Imported inputs that have been generated but not yet analyzed.
+  std::deque<Input> imported_in_flight_;
+
   // Queue of generated inputs for a workflow that are consumed by |TestInputs|.
   AsyncSender<Input> generated_sender_;
   AsyncReceiver<Input> generated_receiver_;
@@ -220,6 +231,9 @@ class RealmFuzzerRunner final : public Runner {
 
   // Feedback collection and analysis variables.
   ModulePoolPtr pool_;
+
+  // Inputs measured while merging, along with the features each adds beyond the seed corpus.
+  std::vector<std::pair<Input, Features>> measured_;
   std::unordered_map<uint64_t, std::unique_ptr<ProcessProxy>> process_proxies_;
 
   // A list of futures that include running the target adapter and awaiting errors or completion
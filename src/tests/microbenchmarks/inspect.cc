@@ -6,9 +6,12 @@
 #include <lib/inspect/cpp/vmo/heap.h>
 #include <zircon/syscalls.h>
 
+#include <atomic>
 #include <cmath>
 #include <iostream>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 #include <fbl/ref_ptr.h>
 #include <fbl/string_printf.h>
@@ -178,6 +181,61 @@ bool TestMetricModify(perftest::RepeatState* state) {
   return true;
 }
 
+// Measure the time taken to add to a NumericProperty while other threads add to the same property.
+template <typename T>
+bool TestContendedMetricAdd(perftest::RepeatState* state, int background_threads) {
+  auto inspector = Inspector();
+  auto& root = inspector.GetRoot();
+  auto item = CreateMetric<T>(&root);
+
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < background_threads; ++i) {
+    threads.emplace_back([&stop, &item] {
+      while (!stop.load(std::memory_order_relaxed)) {
+        item.Add(1);
+      }
+    });
+  }
+
+  while (state->KeepRunning()) {
+    item.Add(1);
+  }
+
+  stop.store(true, std::memory_order_relaxed);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return true;
+}
+
+// Measure the time taken to create and destroy a child node while other threads do the same under
+// the same parent.
+bool TestContendedNodeLifecycle(perftest::RepeatState* state, int background_threads) {
+  auto inspector = Inspector();
+  auto& root = inspector.GetRoot();
+
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < background_threads; ++i) {
+    threads.emplace_back([&stop, &root] {
+      while (!stop.load(std::memory_order_relaxed)) {
+        auto node = root.CreateChild(kName);
+      }
+    });
+  }
+
+  while (state->KeepRunning()) {
+    auto node = root.CreateChild(kName);
+  }
+
+  stop.store(true, std::memory_order_relaxed);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return true;
+}
+
 template <typename T>
 bool TestArrayModify(perftest::RepeatState* state, int size) {
   auto inspector = Inspector(inspect::InspectSettings{.maximum_size = 1024 * 1024});
@@ -297,6 +355,18 @@ void RegisterTests() {
   perftest::RegisterTest("Inspect/UintMetric/Modify", TestMetricModify<uint64_t>);
   perftest::RegisterTest("Inspect/DoubleMetric/Lifecycle", TestMetricLifecycle<double>);
   perftest::RegisterTest("Inspect/DoubleMetric/Modify", TestMetricModify<double>);
+  for (int background_threads : {1, 3, 7}) {
+    const int threads = background_threads + 1;
+    perftest::RegisterTest(
+        fxl::StringPrintf("Inspect/IntMetric/Add/Contended/%dThreads", threads).c_str(),
+        TestContendedMetricAdd<int64_t>, background_threads);
+    perftest::RegisterTest(
+        fxl::StringPrintf("Inspect/DoubleMetric/Add/Contended/%dThreads", threads).c_str(),
+        TestContendedMetricAdd<double>, background_threads);
+    perftest::RegisterTest(
+        fxl::StringPrintf("Inspect/Node/Lifecycle/Contended/%dThreads", threads).c_str(),
+        TestContendedNodeLifecycle, background_threads);
+  }
   for (auto size : {32, 128, 240}) { /* stop at 240 to fit in block */
     perftest::RegisterTest(fxl::StringPrintf("Inspect/UintArray/Lifecycle/%d", size).c_str(),
                            TestArrayLifecycle<inspect::UintArray>, size);
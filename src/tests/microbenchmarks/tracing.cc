@@ -4,8 +4,11 @@
 
 #include <lib/trace/event.h>
 
+#include <atomic>
+#include <thread>
 #include <vector>
 
+#include <fbl/string_printf.h>
 #include <perftest/perftest.h>
 
 namespace {
@@ -48,11 +51,42 @@ bool BeginEndDurationEventTest() {
   return true;
 }
 
+// Measure the time taken by TRACE_INSTANT while |background_threads| other
+// threads emit instant events as fast as they can. With tracing enabled, this
+// shows how much traced threads slow each other down by contending on the
+// trace buffer.
+bool ContendedInstantEventTest(perftest::RepeatState* state, int background_threads) {
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < background_threads; ++i) {
+    threads.emplace_back([&stop] {
+      while (!stop.load(std::memory_order_relaxed)) {
+        TRACE_INSTANT("benchmark", "BackgroundInstantEvent", TRACE_SCOPE_THREAD);
+      }
+    });
+  }
+
+  while (state->KeepRunning()) {
+    TRACE_INSTANT("benchmark", "InstantEvent", TRACE_SCOPE_THREAD);
+  }
+
+  stop.store(true, std::memory_order_relaxed);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return true;
+}
+
 void RegisterTests() {
   perftest::RegisterSimpleTest<InstantEventTest>("Tracing/InstantEvent");
   perftest::RegisterSimpleTest<InstantEventArgsTest>("Tracing/InstantEventArgs");
   perftest::RegisterSimpleTest<ScopedDurationEventTest>("Tracing/ScopedDurationEvent");
   perftest::RegisterSimpleTest<BeginEndDurationEventTest>("Tracing/BeginEndDurationEvent");
+  for (int background_threads : {1, 3, 7}) {
+    auto name =
+        fbl::StringPrintf("Tracing/InstantEvent/Contended/%dThreads", background_threads + 1);
+    perftest::RegisterTest(name.c_str(), ContendedInstantEventTest, background_threads);
+  }
 }
 PERFTEST_CTOR(RegisterTests)
 
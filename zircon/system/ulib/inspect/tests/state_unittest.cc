@@ -1686,6 +1686,62 @@ TEST(State, MultithreadingTest) {
   CompareBlock(blocks.find(5)->block, MakeInlinedOrder0StringReferenceBlock("root"));
 }
 
+struct NumericThreadArgs {
+  DoubleProperty* property;
+  UintArray* array;
+};
+
+int NumericThread(void* input) {
+  auto* args = reinterpret_cast<NumericThreadArgs*>(input);
+  for (size_t i = 0; i < kThreadTimes; i++) {
+    args->property->Add(1.0);
+    args->array->Add(i % 4, 1);
+  }
+  return 0;
+}
+
+TEST(State, ConcurrentNumericUpdatesAreNotLost) {
+  auto state = InitState(4096);
+  ASSERT_TRUE(state != nullptr);
+
+  DoubleProperty property = state->CreateDoubleProperty("d", 0, 0);
+  UintArray array = state->CreateUintArray("a", 0, 4, ArrayBlockFormat::kDefault);
+  NumericThreadArgs args{.property = &property, .array = &array};
+
+  constexpr size_t kNumThreads = 4;
+  thrd_t threads[kNumThreads];
+  for (auto& thread : threads) {
+    ASSERT_EQ(thrd_success, thrd_create(&thread, NumericThread, &args));
+  }
+  for (auto& thread : threads) {
+    thrd_join(thread, nullptr);
+  }
+
+  fbl::WAVLTree<BlockIndex, std::unique_ptr<ScannedBlock>> blocks;
+  size_t free_blocks, allocated_blocks;
+  auto snapshot = SnapshotAndScan(state->GetVmo(), &blocks, &free_blocks, &allocated_blocks);
+  ASSERT_TRUE(snapshot);
+
+  // Two creations, then two updates per iteration of each thread.
+  CompareBlock(blocks.find(0)->block, MakeHeader(2 * 2 + kNumThreads * kThreadTimes * 2 * 2));
+  CompareBlock(blocks.find(2)->block,
+               MakeDoubleBlock(ValueBlockFields::Type::Make(BlockType::kDoubleValue) |
+                                   ValueBlockFields::NameIndex::Make(3),
+                               static_cast<double>(kNumThreads * kThreadTimes)));
+
+  // Each thread spread its increments evenly across the four slots.
+  uint64_t slots[4];
+  for (auto& slot : slots) {
+    slot = kNumThreads * kThreadTimes / 4;
+  }
+  auto array_block = blocks.begin();
+  while (array_block != blocks.end() && GetType(array_block->block) != BlockType::kArrayValue) {
+    ++array_block;
+  }
+  ASSERT_TRUE(array_block != blocks.end());
+  CompareArray(array_block->block, slots, 4);
+}
+
 TEST(State, OutOfOrderDeletion) {
   // Ensure that deleting properties after their parent does not cause a crash.
   auto state = State::CreateWithSize(4096);
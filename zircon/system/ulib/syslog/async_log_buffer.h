@@ -0,0 +1,115 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ZIRCON_SYSTEM_ULIB_SYSLOG_ASYNC_LOG_BUFFER_H_
+#define ZIRCON_SYSTEM_ULIB_SYSLOG_ASYNC_LOG_BUFFER_H_
+
+#include <lib/syslog/logger.h>
+#include <stdint.h>
+#include <zircon/types.h>
+
+#include <array>
+#include <atomic>
+
+namespace syslog {
+namespace internal {
+
+// A log record whose message has been formatted on the logging thread, waiting to be encoded and
+// written to the log socket.
+struct StagedRecord {
+  static constexpr size_t kMaxFileLength = 256;
+  static constexpr size_t kMaxMessageLength = 1024;
+
+  zx_time_t time;
+  zx_koid_t tid;
+  fx_log_severity_t severity;
+  uint32_t line;
+  bool has_tag;
+  bool has_file;
+  char tag[FX_LOG_MAX_TAG_LEN];
+  char file[kMaxFileLength];
+  char msg[kMaxMessageLength];
+};
+
+// Bounded queue of staged records with any number of producers and a single consumer. Producers
+// never block or allocate: |TryPush| fails instead when the queue is full.
+class AsyncLogBuffer {
+ public:
+  static constexpr size_t kCapacity = 256;
+  static_assert((kCapacity & (kCapacity - 1)) == 0, "kCapacity must be a power of two");
+
+  AsyncLogBuffer() {
+    for (size_t i = 0; i < kCapacity; i++) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  // Claims a free slot, calls |fill| with its record, then publishes it to the consumer. Returns
+  // false without calling |fill| if the queue is full.
+  template <typename Fill>
+  bool TryPush(Fill fill) {
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+      slot = &slots_[pos & (kCapacity - 1)];
+      size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    fill(&slot->record);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Calls |consume| on each published record, in order, until the queue is empty. Must only be
+  // called from the consumer thread.
+  template <typename Consume>
+  void Drain(Consume consume) {
+    for (;;) {
+      Slot* slot = &slots_[dequeue_pos_ & (kCapacity - 1)];
+      if (slot->sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) {
+        return;
+      }
+      consume(slot->record);
+      slot->sequence.store(dequeue_pos_ + kCapacity, std::memory_order_release);
+      dequeue_pos_++;
+    }
+  }
+
+  // Number of records claimed by producers so far, including any still being filled.
+  size_t pushed() const { return enqueue_pos_.load(std::memory_order_acquire); }
+
+  // Number of records consumed so far. Must only be called from the consumer thread.
+  size_t consumed() const { return dequeue_pos_; }
+
+  // Returns true if no record is ready for the consumer. Must only be called from the consumer
+  // thread.
+  bool empty() const {
+    const Slot& slot = slots_[dequeue_pos_ & (kCapacity - 1)];
+    return slot.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1;
+  }
+
+ private:
+  struct Slot {
+    std::atomic<size_t> sequence;
+    StagedRecord record;
+  };
+
+  std::array<Slot, kCapacity> slots_;
+  std::atomic<size_t> enqueue_pos_ = 0;
+  size_t dequeue_pos_ = 0;
+};
+
+}  // namespace internal
+}  // namespace syslog
+
+#endif  // ZIRCON_SYSTEM_ULIB_SYSLOG_ASYNC_LOG_BUFFER_H_
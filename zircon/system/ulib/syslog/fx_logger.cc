@@ -154,7 +154,8 @@ cpp17::optional<cpp17::string_view> ViewFromC(const char* c_str) {
 
 zx_status_t fx_logger::VLogWriteToSocket(fx_log_severity_t severity, const char* tag,
                                          const char* file, uint32_t line, const char* msg,
-                                         va_list args, bool perform_format) {
+                                         va_list args, bool perform_format, zx_time_t time,
+                                         zx_koid_t tid) {
 #ifndef SYSLOG_STATIC
   if (syslog_backend::HasStructuredBackend() && this->socket_.is_valid()) {
     std::unique_ptr<syslog_backend::LogBuffer> buf_ptr =
@@ -185,11 +186,8 @@ zx_status_t fx_logger::VLogWriteToSocket(fx_log_severity_t severity, const char*
 
     // TODO(fxbug.dev/72675): Pass file/line info regardless of severity in all cases.
     // This is currently only enabled for drivers.
-    if (file) {
-      file = syslog::internal::StripFile(file, severity);
-    }
     syslog_backend::BeginRecordWithSocket(&buffer, severity, file, line, fmt_string, nullptr,
-                                          this->socket_.get());
+                                          this->socket_.get(), time, tid);
     if (tag) {
       syslog_backend::WriteKeyValue(&buffer, "tag", tag);
     }
@@ -235,11 +233,9 @@ zx_status_t fx_logger::VLogWriteToSocket(fx_log_severity_t severity, const char*
 
     // TODO(fxbug.dev/72675): Pass file/line info regardless of severity in all cases.
     // This is currently only enabled for drivers.
-    if (file) {
-      file = syslog::internal::StripFile(file, severity);
-    }
+    const uint32_t dropped_logs = dropped_logs_.exchange(0);
     buf_ptr->BeginRecord(severity, ViewFromC(file), line, ViewFromC(fmt_string), cpp17::nullopt,
-                         false, this->socket_.borrow(), 0, pid_, GetCurrentThreadKoid());
+                         false, this->socket_.borrow(), dropped_logs, pid_, tid, zx::time(time));
     if (tag) {
       buf_ptr->WriteKeyValue("tag", tag);
     }
@@ -254,17 +250,17 @@ zx_status_t fx_logger::VLogWriteToSocket(fx_log_severity_t severity, const char*
     if (buf_ptr->FlushRecord()) {
       return ZX_OK;
     }
+    dropped_logs_.fetch_add(dropped_logs);
     ActivateFallback(-1);
     return ZX_ERR_ASYNC;
   }
 
 #endif
-  zx_time_t time = zx_clock_get_monotonic();
   fx_log_packet_t packet;
   memset(&packet, 0, sizeof(packet));
   constexpr size_t kDataSize = sizeof(packet.data);
   packet.metadata.pid = pid_;
-  packet.metadata.tid = GetCurrentThreadKoid();
+  packet.metadata.tid = tid;
   packet.metadata.time = time;
   packet.metadata.severity = severity;
   packet.metadata.dropped_logs = dropped_logs_.load();
@@ -299,8 +295,8 @@ zx_status_t fx_logger::VLogWriteToSocket(fx_log_severity_t severity, const char*
   // Write file and line
   constexpr size_t kMaxFileAndLineLength = 2048;
   if (file) {
-    int file_path_bytes = snprintf(packet.data + pos, kMaxFileAndLineLength, "[%s(%d)] ",
-                                   syslog::internal::StripFile(file, severity), line);
+    int file_path_bytes =
+        snprintf(packet.data + pos, kMaxFileAndLineLength, "[%s(%d)] ", file, line);
     if (file_path_bytes < 0) {
       return ZX_ERR_INVALID_ARGS;
     }
@@ -339,7 +335,7 @@ zx_status_t fx_logger::VLogWriteToSocket(fx_log_severity_t severity, const char*
   if (status == ZX_ERR_BAD_STATE || status == ZX_ERR_PEER_CLOSED) {
     ActivateFallback(-1);
     return VLogWriteToFd(logger_fd_.load(std::memory_order_relaxed), severity, tag, file, line,
-                         packet.data + msg_pos, args, false);
+                         packet.data + msg_pos, args, false, time, tid);
   }
   if (status != ZX_OK) {
     dropped_logs_.fetch_add(1);
@@ -349,8 +345,7 @@ zx_status_t fx_logger::VLogWriteToSocket(fx_log_severity_t severity, const char*
 
 zx_status_t fx_logger::VLogWriteToFd(int fd, fx_log_severity_t severity, const char* tag,
                                      const char* file, uint32_t line, const char* msg, va_list args,
-                                     bool perform_format) {
-  zx_time_t time = zx_clock_get_monotonic();
+                                     bool perform_format, zx_time_t time, zx_koid_t tid) {
   constexpr char kEllipsis[] = "...";
   constexpr size_t kEllipsisSize = sizeof(kEllipsis) - 1;
   constexpr size_t kMaxMessageSize = FX_LOG_MAX_DATAGRAM_LEN;
@@ -358,7 +353,7 @@ zx_status_t fx_logger::VLogWriteToFd(int fd, fx_log_severity_t severity, const c
   fbl::StringBuffer<kMaxMessageSize + kEllipsisSize + 1 /*\n*/> buf;
   buf.AppendPrintf("[%05ld.%06ld]", time / 1000000000UL, (time / 1000UL) % 1000000UL);
   buf.AppendPrintf("[%ld]", pid_);
-  buf.AppendPrintf("[%ld]", GetCurrentThreadKoid());
+  buf.AppendPrintf("[%ld]", tid);
 
   buf.Append("[");
   if (!tagstr_.empty()) {
@@ -400,7 +395,7 @@ zx_status_t fx_logger::VLogWriteToFd(int fd, fx_log_severity_t severity, const c
   buf.Append(": ");
 
   if (file) {
-    buf.AppendPrintf("[%s(%d)] ", syslog::internal::StripFile(file, severity), line);
+    buf.AppendPrintf("[%s(%d)] ", file, line);
   }
 
   if (!perform_format) {
@@ -430,16 +425,28 @@ zx_status_t fx_logger::VLogWrite(fx_log_severity_t severity, const char* tag, co
   if (GetSeverity() > severity) {
     return ZX_OK;
   }
+  if (file) {
+    file = syslog::internal::StripFile(file, severity);
+  }
 
+  const zx_time_t time = zx_clock_get_monotonic();
+  const zx_koid_t tid = GetCurrentThreadKoid();
   zx_status_t status;
   int fd = logger_fd_.load(std::memory_order_relaxed);
   if (fd != -1) {
-    status = VLogWriteToFd(fd, severity, tag, file, line, msg, args, perform_format);
+    status = VLogWriteToFd(fd, severity, tag, file, line, msg, args, perform_format, time, tid);
   } else if (socket_.is_valid()) {
-    status = VLogWriteToSocket(severity, tag, file, line, msg, args, perform_format);
+    if (async_buffer_) {
+      if (severity < FX_LOG_FATAL) {
+        return StageRecord(severity, tag, file, line, msg, args, perform_format, time, tid);
+      }
+      // Records staged before the fatal record must reach the socket before this process aborts.
+      WaitForStagedRecords();
+    }
+    status = VLogWriteToSocket(severity, tag, file, line, msg, args, perform_format, time, tid);
     if (status == ZX_ERR_ASYNC) {
       fd = logger_fd_.load(std::memory_order_relaxed);
-      status = VLogWriteToFd(fd, severity, tag, file, line, msg, args, perform_format);
+      status = VLogWriteToFd(fd, severity, tag, file, line, msg, args, perform_format, time, tid);
     }
   } else {
     return ZX_ERR_BAD_STATE;
@@ -450,6 +457,149 @@ zx_status_t fx_logger::VLogWrite(fx_log_severity_t severity, const char* tag, co
   return status;
 }
 
+zx_status_t fx_logger::SetAsync(bool async) {
+  if (async == (async_buffer_ != nullptr)) {
+    return ZX_OK;
+  }
+
+  if (!async) {
+    {
+      fbl::AutoLock lock(&flusher_mutex_);
+      stop_flusher_ = true;
+      flusher_cv_.Signal();
+    }
+    thrd_join(flusher_thread_, nullptr);
+    async_buffer_.reset();
+    return ZX_OK;
+  }
+
+  async_buffer_ = std::make_unique<syslog::internal::AsyncLogBuffer>();
+  {
+    fbl::AutoLock lock(&flusher_mutex_);
+    stop_flusher_ = false;
+    flushed_records_ = 0;
+  }
+  auto flush = [](void* logger) {
+    static_cast<fx_logger*>(logger)->FlushStagedRecords();
+    return 0;
+  };
+  if (thrd_create_with_name(&flusher_thread_, flush, this, "fx_logger-flusher") != thrd_success) {
+    async_buffer_.reset();
+    return ZX_ERR_NO_RESOURCES;
+  }
+  return ZX_OK;
+}
+
+zx_status_t fx_logger::StageRecord(fx_log_severity_t severity, const char* tag, const char* file,
+                                   uint32_t line, const char* msg, va_list args,
+                                   bool perform_format, zx_time_t time, zx_koid_t tid) {
+  using syslog::internal::StagedRecord;
+
+  zx_status_t status = ZX_OK;
+  bool staged = async_buffer_->TryPush([&](StagedRecord* record) {
+    record->time = time;
+    record->tid = tid;
+    record->severity = severity;
+    record->line = line;
+    record->has_tag = tag != nullptr;
+    if (tag) {
+      snprintf(record->tag, sizeof(record->tag), "%s", tag);
+    }
+    record->has_file = file != nullptr;
+    if (file) {
+      snprintf(record->file, sizeof(record->file), "%s", file);
+    }
+
+    int count = perform_format ? vsnprintf(record->msg, sizeof(record->msg), msg, args)
+                               : snprintf(record->msg, sizeof(record->msg), "%s", msg);
+    if (count < 0) {
+      // The slot is already claimed, so it's written with an empty message.
+      record->msg[0] = 0;
+      status = ZX_ERR_INVALID_ARGS;
+    } else if (static_cast<size_t>(count) >= sizeof(record->msg)) {
+      // truncated
+      constexpr char kEllipsis[] = "...";
+      memcpy(record->msg + sizeof(record->msg) - sizeof(kEllipsis), kEllipsis, sizeof(kEllipsis));
+    }
+  });
+  if (!staged) {
+    dropped_logs_.fetch_add(1);
+    return ZX_ERR_SHOULD_WAIT;
+  }
+
+  // The fence orders publishing the record before reading |flusher_waiting_|, pairing with the
+  // fence in |FlushStagedRecords|, so the flusher can't go to sleep without seeing the record.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (flusher_waiting_.load(std::memory_order_relaxed)) {
+    fbl::AutoLock lock(&flusher_mutex_);
+    flusher_cv_.Signal();
+  }
+  return status;
+}
+
+void fx_logger::WriteStagedRecord(const syslog::internal::StagedRecord& record) {
+  int fd = logger_fd_.load(std::memory_order_relaxed);
+  if (fd == -1 && socket_.is_valid()) {
+    // The log socket is a datagram socket, so each record is still written separately. Only the
+    // writes move off the logging threads.
+    zx_status_t status = WriteStagedRecordTo(-1, &record);
+    if (status != ZX_ERR_ASYNC) {
+      return;
+    }
+    fd = logger_fd_.load(std::memory_order_relaxed);
+  }
+  if (fd != -1) {
+    WriteStagedRecordTo(fd, &record);
+  }
+}
+
+zx_status_t fx_logger::WriteStagedRecordTo(int fd, const syslog::internal::StagedRecord* record,
+                                           ...) {
+  const char* tag = record->has_tag ? record->tag : nullptr;
+  const char* file = record->has_file ? record->file : nullptr;
+
+  va_list args;
+  va_start(args, record);
+  zx_status_t status =
+      fd == -1 ? VLogWriteToSocket(record->severity, tag, file, record->line, record->msg, args,
+                                   false, record->time, record->tid)
+               : VLogWriteToFd(fd, record->severity, tag, file, record->line, record->msg, args,
+                               false, record->time, record->tid);
+  va_end(args);
+  return status;
+}
+
+void fx_logger::WaitForStagedRecords() {
+  const size_t staged = async_buffer_->pushed();
+  fbl::AutoLock lock(&flusher_mutex_);
+  flusher_cv_.Signal();
+  while (flushed_records_ < staged) {
+    flushed_cv_.Wait(&flusher_mutex_);
+  }
+}
+
+void fx_logger::FlushStagedRecords() {
+  auto write = [this](const syslog::internal::StagedRecord& record) { WriteStagedRecord(record); };
+  for (;;) {
+    async_buffer_->Drain(write);
+
+    fbl::AutoLock lock(&flusher_mutex_);
+    flushed_records_ = async_buffer_->consumed();
+    flushed_cv_.Broadcast();
+    if (stop_flusher_) {
+      break;
+    }
+    flusher_waiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (async_buffer_->empty()) {
+      flusher_cv_.Wait(&flusher_mutex_);
+    }
+    flusher_waiting_.store(false, std::memory_order_relaxed);
+  }
+  // Records staged before asynchronous mode was disabled are still written.
+  async_buffer_->Drain(write);
+}
+
 // This function is not thread safe
 zx_status_t fx_logger::SetTags(const char* const* tags, size_t ntags) {
   if (ntags > FX_LOG_MAX_TAGS) {
@@ -9,16 +9,21 @@
 #include <lib/zx/process.h>
 #include <lib/zx/socket.h>
 #include <lib/zx/thread.h>
+#include <threads.h>
 #include <zircon/status.h>
 
 #include <atomic>
+#include <memory>
 
 #include <fbl/auto_lock.h>
+#include <fbl/condition_variable.h>
 #include <fbl/mutex.h>
 #include <fbl/string.h>
 #include <fbl/unique_fd.h>
 #include <fbl/vector.h>
 
+#include "zircon/system/ulib/syslog/async_log_buffer.h"
+
 struct fx_logger {
  public:
   // If tags or ntags are out of bound, this constructor will not fail but it
@@ -40,7 +45,7 @@ struct fx_logger {
     }
   }
 
-  ~fx_logger() = default;
+  ~fx_logger() { SetAsync(false); }
 
   template <typename Callback>
   void GetTags(const Callback& callback) {
@@ -73,6 +78,10 @@ struct fx_logger {
 
   void ActivateFallback(int fallback_fd);
 
+  // Enables or disables staging records for a background thread to write to the log socket.
+  // Disabling writes all staged records before returning. Not thread safe.
+  zx_status_t SetAsync(bool async);
+
   zx_status_t Reconfigure(const fx_logger_config_t* config, bool is_structured);
 
   zx_status_t GetLogConnectionStatus();
@@ -87,10 +96,30 @@ struct fx_logger {
                         uint32_t line, const char* msg, va_list args, bool perform_format);
 
   zx_status_t VLogWriteToSocket(fx_log_severity_t severity, const char* tag, const char* file,
-                                uint32_t line, const char* msg, va_list args, bool perform_format);
+                                uint32_t line, const char* msg, va_list args, bool perform_format,
+                                zx_time_t time, zx_koid_t tid);
 
   zx_status_t VLogWriteToFd(int fd, fx_log_severity_t severity, const char* tag, const char* file,
-                            uint32_t line, const char* msg, va_list args, bool perform_format);
+                            uint32_t line, const char* msg, va_list args, bool perform_format,
+                            zx_time_t time, zx_koid_t tid);
+
+  // Formats a record into |async_buffer_| for the flusher thread to write.
+  zx_status_t StageRecord(fx_log_severity_t severity, const char* tag, const char* file,
+                          uint32_t line, const char* msg, va_list args, bool perform_format,
+                          zx_time_t time, zx_koid_t tid);
+
+  // Writes a record staged by |StageRecord|. Called from the flusher thread.
+  void WriteStagedRecord(const syslog::internal::StagedRecord& record);
+
+  // Writes |record| to the log socket, or to |fd| if it isn't -1. The message is already
+  // formatted; this is variadic only so the writers get a started, empty |va_list|.
+  zx_status_t WriteStagedRecordTo(int fd, const syslog::internal::StagedRecord* record, ...);
+
+  // Blocks until the flusher thread has written every record staged so far.
+  void WaitForStagedRecords();
+
+  // Body of the flusher thread.
+  void FlushStagedRecords();
 
   zx_status_t SetTags(const char* const* tags, size_t ntags);
 
@@ -113,6 +142,19 @@ struct fx_logger {
 
   fbl::Mutex logger_mutex_;
 
+  // Set while asynchronous mode is enabled. Records are staged here without taking any lock and
+  // written to |socket_| by |flusher_thread_|.
+  std::unique_ptr<syslog::internal::AsyncLogBuffer> async_buffer_;
+  thrd_t flusher_thread_;
+  // True while the flusher thread is waiting for records to be staged.
+  std::atomic<bool> flusher_waiting_ = false;
+  fbl::Mutex flusher_mutex_;
+  fbl::ConditionVariable flusher_cv_;
+  bool stop_flusher_ __TA_GUARDED(flusher_mutex_) = false;
+  // Number of staged records written so far, signalled through |flushed_cv_|.
+  size_t flushed_records_ __TA_GUARDED(flusher_mutex_) = 0;
+  fbl::ConditionVariable flushed_cv_;
+
   // True if structured logging was requested by the user,
   // false otherwise. Note that this may be false,
   // and we could still be using structured logs
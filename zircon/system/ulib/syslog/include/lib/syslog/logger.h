@@ -134,6 +134,22 @@ void fx_logger_set_connection(fx_logger_t* logger, zx_handle_t handle);
 // This function is thread unsafe.
 void fx_logger_activate_fallback(fx_logger_t* logger, int fallback_fd);
 
+// Enables or disables asynchronous writes to the log socket.
+//
+// While enabled, each message is formatted on the calling thread into a
+// bounded staging buffer, without taking locks or allocating, and a
+// background thread writes staged messages to the log socket. Messages are
+// dropped if the staging buffer is full; dropped messages are counted and
+// reported with the next message written. Messages longer than 1024 bytes are
+// truncated. FATAL messages are written synchronously, after every message
+// staged before them. Disabling asynchronous writes waits for staged messages
+// to be written.
+//
+// Returns ZX_ERR_NO_RESOURCES if the background thread can't be started.
+//
+// This function is thread unsafe.
+zx_status_t fx_logger_set_async(fx_logger_t* logger, bool async);
+
 // Reconfigures the given logger with the specified configuration.
 // If |log_sink_channel| and |log_sink_socket| are invalid in |config|, this
 // function doesn't change the currently used file descriptor or channel.
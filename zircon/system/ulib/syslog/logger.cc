@@ -106,6 +106,11 @@ void fx_logger_activate_fallback(fx_logger_t* logger, int fallback_fd) {
   logger->ActivateFallback(fallback_fd);
 }
 
+SYSLOG_EXPORT
+zx_status_t fx_logger_set_async(fx_logger_t* logger, bool async) {
+  return logger->SetAsync(async);
+}
+
 SYSLOG_EXPORT
 zx_status_t fx_logger_reconfigure(fx_logger_t* logger, const fx_logger_config_t* config) {
   if (!config) {
@@ -7,6 +7,7 @@
 #include <lib/syslog/global.h>
 #include <lib/syslog/wire_format.h>
 #include <lib/zx/socket.h>
+#include <lib/zx/thread.h>
 #include <poll.h>
 #include <string.h>
 #include <unistd.h>
@@ -356,3 +357,47 @@ TEST(SyslogSocketTests, TestLogReconfiguration) {
   FX_LOG(INFO, NULL, "Hi");
   output_compare_helper(local, FX_LOG_INFO, "Hi", tags, line);
 }
+
+TEST(SyslogSocketTests, TestLogAsync) {
+  zx::socket local, remote;
+  EXPECT_OK(zx::socket::create(ZX_SOCKET_DATAGRAM, &local, &remote));
+  ASSERT_OK(init_helper(remote.release()));
+  ASSERT_OK(fx_logger_set_async(fx_log_get_logger(), true));
+
+  constexpr int kNumMessages = 10;
+  int lines[kNumMessages];
+  for (int i = 0; i < kNumMessages; i++) {
+    lines[i] = __LINE__ + 1;
+    FX_LOGF(INFO, "tag", "message %d", i);
+  }
+  // Disabling asynchronous mode writes every staged message.
+  ASSERT_OK(fx_logger_set_async(fx_log_get_logger(), false));
+
+  const char* tags[] = {"tag"};
+  for (int i = 0; i < kNumMessages; i++) {
+    output_compare_helper(local, FX_LOG_INFO, fbl::StringPrintf("message %d", i).c_str(), tags,
+                          lines[i]);
+  }
+}
+
+TEST(SyslogSocketTests, TestLogAsyncKeepsTimeAndThread) {
+  zx::socket local, remote;
+  EXPECT_OK(zx::socket::create(ZX_SOCKET_DATAGRAM, &local, &remote));
+  ASSERT_OK(init_helper(remote.release()));
+  ASSERT_OK(fx_logger_set_async(fx_log_get_logger(), true));
+
+  zx_info_handle_basic_t info;
+  ASSERT_OK(zx::thread::self()->get_info(ZX_INFO_HANDLE_BASIC, &info, sizeof(info), nullptr,
+                                         nullptr));
+  const zx_time_t before = zx_clock_get_monotonic();
+  FX_LOG(INFO, NULL, "Hi");
+  const zx_time_t after = zx_clock_get_monotonic();
+  // The record is written by the flusher thread, later than it was logged.
+  ASSERT_OK(fx_logger_set_async(fx_log_get_logger(), false));
+
+  fx_log_packet_t packet;
+  ASSERT_OK(local.read(0, &packet, sizeof(packet), nullptr));
+  EXPECT_EQ(info.koid, packet.metadata.tid);
+  EXPECT_GE(packet.metadata.time, before);
+  EXPECT_LE(packet.metadata.time, after);
+}
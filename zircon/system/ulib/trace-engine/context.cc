@@ -71,12 +71,42 @@
 // Note that the handler is free to save buffers at whatever rate it can
 // manage. The protocol allows for records to be dropped if buffers can't be
 // saved fast enough.
+//
+// Notes on per-thread chunks
+// --------------------------
+//
+// Allocating every record by bumping one shared offset makes all traced
+// threads contend on one cache line. Instead, each thread allocates a chunk
+// of the current rolling buffer using the shared offset, then allocates its
+// small records from that chunk without touching any shared state, other than
+// reading |rolling_chunk_epoch_|, which changes rarely.
+// The buffer-full and buffer-switch logic above applies unchanged to chunks.
+//
+// The unused tail of a chunk always holds a padding record, which readers
+// skip. The padding is rewritten after each record is allocated, so the
+// buffer remains a valid sequence of records if tracing stops at any point.
+// Padding doesn't need a record type of its own: it's a blob record with no
+// name and no data, which any FXT reader can parse, sized to span the tail.
+//
+// In oneshot mode the buffer never switches, so a chunk that would overrun
+// its end is shrunk to the space that's left rather than marking the buffer
+// full early. In circular and streaming modes a chunk that doesn't fit
+// switches buffers just like an individual record, so up to one chunk at the
+// end of each buffer is left unused; the buffer is recycled or saved anyway.
+//
+// A thread must not write to a chunk after the buffer it is in has been
+// switched away from: in circular mode the buffer is about to be reused, and
+// in streaming mode it is about to be saved. So every switch increments
+// |rolling_chunk_epoch_|, and chunks from an earlier epoch are abandoned.
+// This has the same small race as the shared offset: a thread that has
+// already checked the epoch may still write its record just after a switch.
 
 #include <assert.h>
 #include <inttypes.h>
 #include <lib/trace-engine/fields.h>
 #include <lib/trace-engine/handler.h>
 
+#include <algorithm>
 #include <atomic>
 #include <mutex>
 
@@ -88,6 +118,34 @@ namespace {
 // The next context generation number.
 std::atomic<uint32_t> g_next_generation{1u};
 
+// The calling thread's chunk of the rolling buffer.
+// See "Notes on per-thread chunks" above.
+struct RollingChunk {
+  // The generation of the context that the chunk belongs to.
+  // Generation zero is never used, so a zero-initialized chunk is never valid.
+  uint32_t generation;
+  // The context's |rolling_chunk_epoch_| when the chunk was allocated.
+  uint32_t epoch;
+  // The next record to be allocated, and the end of the chunk.
+  uint8_t* next;
+  uint8_t* end;
+};
+thread_local RollingChunk tls_rolling_chunk{};
+
+// Covers [ptr, end) with a padding record, if it's not empty.
+// Padding is an ordinary blob record with no name and no data, whose record
+// size spans the whole range. Readers that predate chunks see an empty blob;
+// trace-reader drops such blobs without reporting them.
+void WritePadding(uint8_t* ptr, uint8_t* end) {
+  if (ptr == end)
+    return;
+  *reinterpret_cast<uint64_t*>(ptr) =
+      RecordFields::Type::Make(ToUnderlyingType(RecordType::kBlob)) |
+      RecordFields::RecordSize::Make(BytesToWords(end - ptr)) |
+      BlobRecordFields::NameStringRef::Make(TRACE_ENCODED_STRING_REF_EMPTY) |
+      BlobRecordFields::BlobSize::Make(0) | BlobRecordFields::BlobType::Make(TRACE_BLOB_TYPE_DATA);
+}
+
 }  // namespace
 }  // namespace trace
 
@@ -109,6 +167,69 @@ trace_context::trace_context(void* buffer, size_t buffer_num_bytes,
 trace_context::~trace_context() = default;
 
 uint64_t* trace_context::AllocRecord(size_t num_bytes) {
+  ZX_DEBUG_ASSERT((num_bytes & 7) == 0);
+  if (unlikely(num_bytes > rolling_chunk_size_ / kMaxChunkedRecordFraction))
+    return AllocRollingRecord(num_bytes);
+
+  trace::RollingChunk& chunk = trace::tls_rolling_chunk;
+  if (likely(chunk.generation == generation_ &&
+             chunk.epoch == rolling_chunk_epoch_.load(std::memory_order_relaxed) &&
+             static_cast<size_t>(chunk.end - chunk.next) >= num_bytes)) {
+    uint8_t* ptr = chunk.next;
+    chunk.next += num_bytes;
+    trace::WritePadding(chunk.next, chunk.end);
+    return reinterpret_cast<uint64_t*>(ptr);  // success!
+  }
+
+  return AllocRecordFromNewChunk(num_bytes);
+}
+
+uint64_t* trace_context::AllocRecordFromNewChunk(size_t num_bytes) {
+  // Read the epoch before allocating. If the buffer switches in between, the
+  // new chunk is abandoned early rather than used after the switch.
+  uint32_t epoch = rolling_chunk_epoch_.load(std::memory_order_relaxed);
+  size_t chunk_size = rolling_chunk_size_;
+  auto ptr = reinterpret_cast<uint8_t*>(
+      buffering_mode_ == TRACE_BUFFERING_MODE_ONESHOT ? AllocOneshotChunk(num_bytes, &chunk_size)
+                                                      : AllocRollingRecord(chunk_size));
+  if (unlikely(!ptr)) {
+    // The record is dropped, and has already been counted as such.
+    // The current chunk, if any, is left as is: a smaller record may still
+    // fit in it.
+    return nullptr;
+  }
+
+  // Any previous chunk already ends in padding, so it can simply be dropped.
+  trace::tls_rolling_chunk = {
+      .generation = generation_,
+      .epoch = epoch,
+      .next = ptr + num_bytes,
+      .end = ptr + chunk_size,
+  };
+  trace::WritePadding(ptr + num_bytes, ptr + chunk_size);
+  return reinterpret_cast<uint64_t*>(ptr);
+}
+
+uint64_t* trace_context::AllocOneshotChunk(size_t min_bytes, size_t* out_chunk_size) {
+  ZX_DEBUG_ASSERT(buffering_mode_ == TRACE_BUFFERING_MODE_ONESHOT);
+  // The oneshot buffer never wraps, so the offset is the whole value.
+  uint64_t offset = rolling_buffer_current_.load(std::memory_order_relaxed);
+  size_t chunk_size;
+  do {
+    ZX_DEBUG_ASSERT(GetWrappedCount(offset) == 0);
+    if (offset + min_bytes > rolling_buffer_size_) {
+      // Not even the record fits: let the usual path mark the buffer full.
+      return AllocRollingRecord(min_bytes);
+    }
+    chunk_size = std::min(rolling_chunk_size_, rolling_buffer_size_ - offset);
+  } while (!rolling_buffer_current_.compare_exchange_weak(
+      offset, offset + chunk_size, std::memory_order_relaxed, std::memory_order_relaxed));
+
+  *out_chunk_size = chunk_size;
+  return reinterpret_cast<uint64_t*>(rolling_buffer_start_[0] + offset);
+}
+
+uint64_t* trace_context::AllocRollingRecord(size_t num_bytes) {
   ZX_DEBUG_ASSERT((num_bytes & 7) == 0);
   if (unlikely(num_bytes > TRACE_ENCODED_INLINE_LARGE_RECORD_MAX_SIZE))
     return nullptr;
@@ -364,6 +485,10 @@ void trace_context::ComputeBufferSizes() {
     default:
       __UNREACHABLE;
   }
+
+  size_t rolling_chunk_size =
+      std::min(rolling_buffer_size_ / kRollingChunksPerBuffer, kMaxRollingChunkSize) & ~7ul;
+  rolling_chunk_size_ = rolling_chunk_size >= kMinRollingChunkSize ? rolling_chunk_size : 0u;
 }
 
 void trace_context::ResetDurableBufferPointers() {
@@ -372,6 +497,7 @@ void trace_context::ResetDurableBufferPointers() {
 }
 
 void trace_context::ResetRollingBufferPointers() {
+  RetireRollingChunks();
   rolling_buffer_current_.store(0);
   rolling_buffer_full_mark_[0].store(0);
   rolling_buffer_full_mark_[1].store(0);
@@ -530,6 +656,10 @@ void trace_context::SwitchRollingBufferLocked(uint32_t prev_wrapped_count,
   rolling_buffer_full_mark_[next_buffer].store(0, std::memory_order_relaxed);
   header_->rolling_data_end[next_buffer] = 0;
 
+  // Threads must not write to chunks of the previous buffer after it is
+  // switched away from.
+  RetireRollingChunks();
+
   // Do this last: After this tracing resumes in the new buffer.
   uint64_t new_offset_plus_counter = MakeOffsetPlusCounter(0, new_wrapped_count);
   rolling_buffer_current_.store(new_offset_plus_counter, std::memory_order_relaxed);
@@ -544,6 +674,7 @@ void trace_context::MarkTracingArtificiallyStopped() {
   // buffer is full. AllocRecord, on seeing the buffer is full, will
   // then check |tracing_artificially_stopped_|.
   tracing_artificially_stopped_ = true;
+  RetireRollingChunks();
   SnapToEnd(CurrentWrappedCount());
 }
 
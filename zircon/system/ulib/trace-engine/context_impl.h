@@ -12,6 +12,7 @@
 
 #include <lib/trace-engine/buffer_internal.h>
 #include <lib/trace-engine/context.h>
+#include <lib/trace-engine/fields.h>
 #include <lib/trace-engine/handler.h>
 #include <lib/zx/event.h>
 
@@ -90,6 +91,9 @@ struct trace_context {
   void ClearRollingBuffers();
   void UpdateBufferHeaderAfterStopped();
 
+  // Allocates a record from the rolling buffer(s). Small records come from a
+  // chunk owned by the calling thread, so that threads only contend on
+  // |rolling_buffer_current_| when they need a new chunk.
   uint64_t* AllocRecord(size_t num_bytes);
   uint64_t* AllocDurableRecord(size_t num_bytes);
   bool AllocThreadIndex(trace_thread_index_t* out_index);
@@ -180,6 +184,22 @@ struct trace_context {
   // buffer size alignment constraints.
 #define GET_DURABLE_BUFFER_SIZE(size) ((size) / 16)
 
+  // Each thread allocates small records from its own chunk of the current
+  // rolling buffer. A chunk is this fraction of the rolling buffer, bounded
+  // by |kMaxRollingChunkSize| so that chunks abandoned at a buffer switch
+  // don't waste much space. If the rolling buffer is too small for chunks of
+  // at least |kMinRollingChunkSize|, records are allocated individually.
+  static constexpr size_t kRollingChunksPerBuffer = 64;
+  static constexpr size_t kMinRollingChunkSize = 256;
+  static constexpr size_t kMaxRollingChunkSize = 4096;
+
+  // Records larger than this fraction of a chunk are allocated individually
+  // rather than end a partially used chunk.
+  static constexpr size_t kMaxChunkedRecordFraction = 4;
+
+  // The unused space of a chunk is covered by a single padding record.
+  static_assert(kMaxRollingChunkSize <= trace::RecordFields::kMaxRecordSizeBytes, "");
+
   // Ensure the smallest buffer is still large enough to hold
   // |kMinDurableBufferSize|.
   static_assert(GET_DURABLE_BUFFER_SIZE(kMinPhysicalBufferSize - sizeof(trace_buffer_header)) >=
@@ -221,6 +241,18 @@ struct trace_context {
 
   void ComputeBufferSizes();
 
+  uint64_t* AllocRollingRecord(size_t num_bytes);
+
+  uint64_t* AllocRecordFromNewChunk(size_t num_bytes);
+
+  // Allocates a chunk of the oneshot buffer that holds at least |min_bytes|.
+  // Near the end of the buffer the chunk is shrunk to the space that's left,
+  // which is returned in |out_chunk_size|.
+  uint64_t* AllocOneshotChunk(size_t min_bytes, size_t* out_chunk_size);
+
+  // Invalidates every thread's rolling buffer chunk.
+  void RetireRollingChunks() { rolling_chunk_epoch_.fetch_add(1u, std::memory_order_relaxed); }
+
   void MarkDurableBufferFull(uint64_t last_offset);
 
   void MarkOneshotBufferFull(uint64_t last_offset);
@@ -278,6 +310,10 @@ struct trace_context {
   // The size of both rolling buffers.
   size_t rolling_buffer_size_;
 
+  // The size of each thread's rolling buffer chunk, or zero if records are
+  // never allocated from chunks.
+  size_t rolling_chunk_size_;
+
   // Current allocation pointer for durable records.
   // This only used in circular and streaming modes.
   // Starts at |durable_buffer_start| and grows from there.
@@ -313,8 +349,16 @@ struct trace_context {
   // This will only be set in oneshot and streaming modes.
   std::atomic<uint64_t> rolling_buffer_full_mark_[2];
 
+  // Incremented whenever existing rolling buffer chunks must no longer be
+  // written to: when the rolling buffer switches, when its pointers are
+  // reset, and when tracing is artificially stopped. Threads compare this
+  // against the epoch of their chunk before every allocation. It is rarely
+  // written, so it's kept apart from |rolling_buffer_current_| to avoid
+  // sharing that cache line.
+  alignas(64) std::atomic<uint32_t> rolling_chunk_epoch_{0};
+
   // A count of the number of records that have been dropped.
-  std::atomic<uint64_t> num_records_dropped_{0};
+  alignas(64) std::atomic<uint64_t> num_records_dropped_{0};
 
   // A count of the number of records that have been dropped.
   std::atomic<uint64_t> num_records_dropped_after_buffer_switch_{0};
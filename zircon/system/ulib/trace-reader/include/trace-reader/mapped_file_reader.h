@@ -0,0 +1,162 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TRACE_READER_MAPPED_FILE_READER_H_
+#define TRACE_READER_MAPPED_FILE_READER_H_
+
+#include <lib/trace-engine/types.h>
+#include <stdint.h>
+
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <trace-reader/reader.h>
+
+namespace trace {
+
+// Index of the records in an fxt trace, used to find the records with
+// timestamps in a given range without decoding the whole trace.
+//
+// Records are grouped into blocks of consecutive records which belong to one
+// provider. Each block remembers the range of timestamps of the events, logs
+// and context switches within it. Since records may refer to strings and
+// threads defined anywhere earlier in the trace, the index also remembers the
+// location of every record which changes the state of a |TraceReader|, so that
+// state can be rebuilt before decoding a block.
+//
+// Building an index only walks record headers in place, so the cost is
+// proportional to the number of records rather than the size of the trace.
+class TraceIndex {
+ public:
+  // Blocks are split after this many records so time range queries don't need
+  // to decode much more than they return.
+  static constexpr size_t kMaxRecordsPerBlock = 4096;
+
+  // Identifies the trace an index was built from, so index files saved for
+  // another trace, or for an earlier version of the same file, are ignored.
+  // Besides the size and modification time of the file, it holds hashes of
+  // the first and last |kFingerprintHashedWords| words of the trace.
+  struct Fingerprint {
+    uint64_t size_bytes;
+    int64_t mtime;
+    uint64_t head_hash;
+    uint64_t tail_hash;
+
+    bool operator==(const Fingerprint& other) const {
+      return size_bytes == other.size_bytes && mtime == other.mtime &&
+             head_hash == other.head_hash && tail_hash == other.tail_hash;
+    }
+  };
+  static constexpr size_t kFingerprintHashedWords = 512;
+
+  // Computes the fingerprint of a trace file of |size_bytes| bytes, last
+  // modified at |mtime|, whose complete words are |words|.
+  static Fingerprint ComputeFingerprint(const uint64_t* words, uint64_t size_bytes, int64_t mtime);
+
+  struct Block {
+    ProviderId provider_id;
+    // Offsets, in words, of the first record and one past the last record.
+    uint64_t begin_word;
+    uint64_t end_word;
+    // Range of record timestamps within the block, inclusive.
+    trace_ticks_t min_timestamp;
+    trace_ticks_t max_timestamp;
+  };
+
+  // Builds the index of the trace in |words|. Indexing stops at the first
+  // record which doesn't fit in |words|, and at the first record of size 0.
+  static TraceIndex Build(const uint64_t* words, size_t num_words);
+
+  // Saves the index to a sidecar file next to the trace. The fingerprint of
+  // the trace is recorded so stale index files can be detected when loading
+  // them.
+  bool WriteToFile(const char* file_path, const Fingerprint& trace) const;
+
+  // Loads an index saved by |WriteToFile| for the trace in |words|. Returns
+  // std::nullopt if the file can't be read, was written for a trace with a
+  // different fingerprint, or refers to records that don't lie within the
+  // first |num_words| words of the trace.
+  static std::optional<TraceIndex> ReadFromFile(const char* file_path, const Fingerprint& trace,
+                                                const uint64_t* words, size_t num_words);
+
+  // Offsets, in words, of metadata, initialization, string and thread records,
+  // in increasing order.
+  const std::vector<uint64_t>& state_records() const { return state_records_; }
+
+  // Blocks holding timestamped records, in increasing order of offset.
+  const std::vector<Block>& blocks() const { return blocks_; }
+
+  // Offset, in words, one past the last complete record in the trace.
+  uint64_t end_word() const { return end_word_; }
+
+ private:
+  std::vector<uint64_t> state_records_;
+  std::vector<Block> blocks_;
+  uint64_t end_word_ = 0u;
+};
+
+// Reads records from a file, in fxt file format, by mapping the whole file
+// into memory. Records are decoded directly from the mapping, so reading
+// doesn't copy the trace, and traces larger than memory are paged in and out
+// by the kernel as they're read.
+class MappedFileReader : public TraceReader {
+ public:
+  static bool Create(const char* file_path, RecordConsumer record_consumer,
+                     ErrorHandler error_handler, std::unique_ptr<MappedFileReader>* out_reader);
+
+  ~MappedFileReader();
+
+  // Reads every record in the file.
+  void ReadFile();
+
+  // Uses the index saved in |index_path| if it matches this trace, otherwise
+  // builds a new index and tries to save it there. Returns the index in use.
+  const TraceIndex& LoadOrBuildIndex(const char* index_path);
+
+  // Returns the index of this trace, building it on first use.
+  const TraceIndex& index();
+
+  // Reads the records with timestamps in [|begin|, |end|]. Strings, threads
+  // and providers defined earlier in the trace are replayed first, without
+  // being passed to the record consumer, so references to them resolve. Other
+  // records without a timestamp are passed to the record consumer if they're
+  // interleaved with records in range.
+  void ReadTimeRange(trace_ticks_t begin, trace_ticks_t end);
+
+  // Size of the file in bytes.
+  uint64_t file_size() const { return file_size_; }
+
+  // Fingerprint of the file, which identifies the index files saved for it.
+  const TraceIndex::Fingerprint& fingerprint() const { return fingerprint_; }
+
+ private:
+  MappedFileReader(const uint64_t* words, uint64_t file_size, int64_t mtime,
+                   RecordConsumer record_consumer, ErrorHandler error_handler);
+
+  // Trailing bytes which don't fill a word can't hold a record and are ignored.
+  uint64_t num_words() const { return file_size_ / sizeof(uint64_t); }
+
+  void ConsumeRecord(Record record);
+  bool ReadWords(uint64_t begin_word, uint64_t end_word);
+
+  const uint64_t* const words_;
+  uint64_t const file_size_;
+  TraceIndex::Fingerprint const fingerprint_;
+  RecordConsumer const record_consumer_;
+
+  std::optional<TraceIndex> index_;
+
+  // Records read while this is set only update the reader's state.
+  bool replaying_ = false;
+  // Timestamped records outside this range aren't passed to the consumer.
+  std::optional<std::pair<trace_ticks_t, trace_ticks_t>> time_range_;
+
+  DISALLOW_COPY_ASSIGN_AND_MOVE(MappedFileReader);
+};
+
+}  // namespace trace
+
+#endif  // TRACE_READER_MAPPED_FILE_READER_H_
@@ -0,0 +1,395 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <fcntl.h>
+#include <lib/trace-engine/fields.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include <fbl/string_printf.h>
+#include <trace-reader/mapped_file_reader.h>
+
+namespace trace {
+namespace {
+
+// "fxtindex" in little-endian order.
+constexpr uint64_t kIndexMagic = 0x7865646e69747866;
+constexpr uint64_t kIndexVersion = 2u;
+constexpr size_t kIndexHeaderWords = 9u;
+constexpr size_t kIndexBlockWords = 5u;
+
+size_t RecordSizeWords(RecordHeader header) {
+  if (RecordFields::Type::Get<RecordType>(header) == RecordType::kLargeRecord) {
+    return LargeBlobFields::RecordSize::Get<size_t>(header);
+  }
+  return RecordFields::RecordSize::Get<size_t>(header);
+}
+
+std::optional<trace_ticks_t> GetTimestamp(const Record& record) {
+  switch (record.type()) {
+    case RecordType::kEvent:
+      return record.GetEvent().timestamp;
+    case RecordType::kContextSwitch:
+      return record.GetContextSwitch().timestamp;
+    case RecordType::kLog:
+      return record.GetLog().timestamp;
+    default:
+      return std::nullopt;
+  }
+}
+
+// FNV-1a, a word at a time.
+uint64_t HashWords(const uint64_t* words, size_t num_words) {
+  uint64_t hash = 0xcbf29ce484222325;
+  for (size_t i = 0; i < num_words; ++i) {
+    hash = (hash ^ words[i]) * 0x100000001b3;
+  }
+  return hash;
+}
+
+bool WriteIndexWords(FILE* f, const uint64_t* words, size_t num_words) {
+  return fwrite(words, sizeof(uint64_t), num_words, f) == num_words;
+}
+
+bool ReadIndexWords(FILE* f, uint64_t* words, size_t num_words) {
+  return fread(words, sizeof(uint64_t), num_words, f) == num_words;
+}
+
+}  // namespace
+
+// static
+TraceIndex::Fingerprint TraceIndex::ComputeFingerprint(const uint64_t* words,
+                                                       uint64_t size_bytes, int64_t mtime) {
+  const size_t num_words = size_bytes / sizeof(uint64_t);
+  const size_t hashed_words = std::min(num_words, kFingerprintHashedWords);
+  return Fingerprint{
+      .size_bytes = size_bytes,
+      .mtime = mtime,
+      .head_hash = HashWords(words, hashed_words),
+      .tail_hash = HashWords(words + num_words - hashed_words, hashed_words),
+  };
+}
+
+// static
+TraceIndex TraceIndex::Build(const uint64_t* words, size_t num_words) {
+  TraceIndex index;
+
+  ProviderId provider_id = 0u;
+  std::optional<Block> block;
+  size_t block_records = 0u;
+  auto close_block = [&](uint64_t end_word) {
+    // Blocks without timestamped records never match a time range, and the
+    // state records within them are found through |state_records_|.
+    if (block && block->min_timestamp <= block->max_timestamp) {
+      block->end_word = end_word;
+      index.blocks_.push_back(*block);
+    }
+    block.reset();
+  };
+
+  uint64_t offset = 0u;
+  while (offset < num_words) {
+    const RecordHeader header = words[offset];
+    const size_t size = RecordSizeWords(header);
+    if (size == 0u || size > num_words - offset) {
+      break;
+    }
+
+    const auto type = RecordFields::Type::Get<RecordType>(header);
+    if (type == RecordType::kMetadata) {
+      switch (MetadataRecordFields::MetadataType::Get<MetadataType>(header)) {
+        case MetadataType::kProviderInfo:
+          close_block(offset);
+          provider_id = ProviderInfoMetadataRecordFields::Id::Get<ProviderId>(header);
+          break;
+        case MetadataType::kProviderSection:
+          close_block(offset);
+          provider_id = ProviderSectionMetadataRecordFields::Id::Get<ProviderId>(header);
+          break;
+        default:
+          break;
+      }
+    }
+
+    if (!block) {
+      block = Block{provider_id, offset, offset, std::numeric_limits<trace_ticks_t>::max(), 0u};
+      block_records = 0u;
+    }
+
+    switch (type) {
+      case RecordType::kMetadata:
+      case RecordType::kInitialization:
+      case RecordType::kString:
+      case RecordType::kThread:
+        index.state_records_.push_back(offset);
+        break;
+      case RecordType::kEvent:
+      case RecordType::kContextSwitch:
+      case RecordType::kLog:
+        // The timestamp immediately follows the header of these records.
+        if (size > 1u) {
+          const trace_ticks_t timestamp = words[offset + 1];
+          block->min_timestamp = std::min(block->min_timestamp, timestamp);
+          block->max_timestamp = std::max(block->max_timestamp, timestamp);
+        }
+        break;
+      default:
+        break;
+    }
+
+    offset += size;
+    if (++block_records == kMaxRecordsPerBlock) {
+      close_block(offset);
+    }
+  }
+  close_block(offset);
+  index.end_word_ = offset;
+
+  return index;
+}
+
+bool TraceIndex::WriteToFile(const char* file_path, const Fingerprint& trace) const {
+  FILE* f = fopen(file_path, "wb");
+  if (f == nullptr) {
+    return false;
+  }
+
+  const uint64_t header[kIndexHeaderWords] = {
+      kIndexMagic,
+      kIndexVersion,
+      trace.size_bytes,
+      static_cast<uint64_t>(trace.mtime),
+      trace.head_hash,
+      trace.tail_hash,
+      end_word_,
+      state_records_.size(),
+      blocks_.size(),
+  };
+  bool ok = WriteIndexWords(f, header, kIndexHeaderWords) &&
+            WriteIndexWords(f, state_records_.data(), state_records_.size());
+  for (const Block& block : blocks_) {
+    if (!ok) {
+      break;
+    }
+    const uint64_t words[kIndexBlockWords] = {block.provider_id, block.begin_word, block.end_word,
+                                              block.min_timestamp, block.max_timestamp};
+    ok = WriteIndexWords(f, words, kIndexBlockWords);
+  }
+
+  return fclose(f) == 0 && ok;
+}
+
+// static
+std::optional<TraceIndex> TraceIndex::ReadFromFile(const char* file_path, const Fingerprint& trace,
+                                                   const uint64_t* words, size_t num_words) {
+  FILE* f = fopen(file_path, "rb");
+  if (f == nullptr) {
+    return std::nullopt;
+  }
+
+  uint64_t header[kIndexHeaderWords];
+  bool ok = ReadIndexWords(f, header, kIndexHeaderWords) && header[0] == kIndexMagic &&
+            header[1] == kIndexVersion &&
+            Fingerprint{header[2], static_cast<int64_t>(header[3]), header[4], header[5]} ==
+                trace;
+  const uint64_t end_word = ok ? header[6] : 0u;
+  const uint64_t num_state_records = ok ? header[7] : 0u;
+  const uint64_t num_blocks = ok ? header[8] : 0u;
+  ok = ok && end_word <= num_words && num_state_records <= end_word && num_blocks <= end_word;
+
+  TraceIndex index;
+  if (ok) {
+    index.end_word_ = end_word;
+    index.state_records_.resize(num_state_records);
+    ok = ReadIndexWords(f, index.state_records_.data(), index.state_records_.size());
+  }
+
+  // Every state record is replayed without further checks, so each one must
+  // be a whole record within the indexed part of the trace.
+  uint64_t next_offset = 0u;
+  for (size_t i = 0u; ok && i < index.state_records_.size(); ++i) {
+    const uint64_t offset = index.state_records_[i];
+    ok = offset >= next_offset && offset < end_word;
+    if (ok) {
+      const size_t size = RecordSizeWords(words[offset]);
+      ok = size != 0u && size <= end_word - offset;
+      next_offset = offset + size;
+    }
+  }
+
+  uint64_t next_block_word = 0u;
+  if (ok) {
+    index.blocks_.reserve(num_blocks);
+  }
+  for (uint64_t i = 0u; ok && i < num_blocks; ++i) {
+    uint64_t block[kIndexBlockWords];
+    ok = ReadIndexWords(f, block, kIndexBlockWords) && block[1] >= next_block_word &&
+         block[1] < block[2] && block[2] <= end_word;
+    if (ok) {
+      index.blocks_.push_back(
+          Block{static_cast<ProviderId>(block[0]), block[1], block[2], block[3], block[4]});
+      next_block_word = block[2];
+    }
+  }
+
+  fclose(f);
+  if (!ok) {
+    return std::nullopt;
+  }
+  return index;
+}
+
+// static
+bool MappedFileReader::Create(const char* file_path, RecordConsumer record_consumer,
+                              ErrorHandler error_handler,
+                              std::unique_ptr<MappedFileReader>* out_reader) {
+  ZX_DEBUG_ASSERT(out_reader != nullptr);
+
+  int fd = open(file_path, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return false;
+  }
+
+  const uint64_t file_size = static_cast<uint64_t>(st.st_size);
+  const uint64_t* words = nullptr;
+  if (file_size > 0u) {
+    void* addr = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+      close(fd);
+      return false;
+    }
+    words = static_cast<const uint64_t*>(addr);
+  }
+  // The mapping keeps the file contents available after the descriptor is closed.
+  close(fd);
+
+  out_reader->reset(new MappedFileReader(words, file_size, static_cast<int64_t>(st.st_mtime),
+                                         std::move(record_consumer), std::move(error_handler)));
+  return true;
+}
+
+MappedFileReader::MappedFileReader(const uint64_t* words, uint64_t file_size, int64_t mtime,
+                                   RecordConsumer record_consumer, ErrorHandler error_handler)
+    : TraceReader([this](Record record) { ConsumeRecord(std::move(record)); },
+                  std::move(error_handler)),
+      words_(words),
+      file_size_(file_size),
+      fingerprint_(TraceIndex::ComputeFingerprint(words, file_size, mtime)),
+      record_consumer_(std::move(record_consumer)) {}
+
+MappedFileReader::~MappedFileReader() {
+  if (words_ != nullptr) {
+    munmap(const_cast<uint64_t*>(words_), file_size_);
+  }
+}
+
+void MappedFileReader::ReadFile() {
+  trace::Chunk chunk(words_, num_words());
+  if (!ReadRecords(chunk)) {
+    ReportError("Trace stream is corrupted");
+    return;
+  }
+  if (chunk.remaining_words() != 0u) {
+    ReportError("Trace file is truncated");
+  }
+}
+
+const TraceIndex& MappedFileReader::LoadOrBuildIndex(const char* index_path) {
+  std::optional loaded = TraceIndex::ReadFromFile(index_path, fingerprint_, words_, num_words());
+  if (loaded) {
+    index_ = std::move(loaded);
+    return *index_;
+  }
+
+  const TraceIndex& built = index();
+  if (!built.WriteToFile(index_path, fingerprint_)) {
+    ReportError(fbl::StringPrintf("Failed to write trace index to %s", index_path));
+  }
+  return built;
+}
+
+const TraceIndex& MappedFileReader::index() {
+  if (!index_) {
+    index_ = TraceIndex::Build(words_, num_words());
+  }
+  return *index_;
+}
+
+void MappedFileReader::ReadTimeRange(trace_ticks_t begin, trace_ticks_t end) {
+  const TraceIndex& trace_index = index();
+  const std::vector<uint64_t>& state_records = trace_index.state_records();
+
+  time_range_.emplace(begin, end);
+  size_t next_state_record = 0u;
+  for (const TraceIndex::Block& block : trace_index.blocks()) {
+    if (block.max_timestamp < begin || block.min_timestamp > end) {
+      continue;
+    }
+
+    // Bring the provider, string and thread tables up to date with the start
+    // of the block, skipping any state records already read with an earlier
+    // block.
+    replaying_ = true;
+    for (; next_state_record < state_records.size() &&
+           state_records[next_state_record] < block.begin_word;
+         ++next_state_record) {
+      const uint64_t offset = state_records[next_state_record];
+      if (!ReadWords(offset, offset + RecordSizeWords(words_[offset]))) {
+        break;
+      }
+    }
+    replaying_ = false;
+
+    if (!ReadWords(block.begin_word, block.end_word)) {
+      break;
+    }
+    while (next_state_record < state_records.size() &&
+           state_records[next_state_record] < block.end_word) {
+      ++next_state_record;
+    }
+  }
+  replaying_ = false;
+  time_range_.reset();
+}
+
+void MappedFileReader::ConsumeRecord(Record record) {
+  if (replaying_) {
+    return;
+  }
+  if (time_range_) {
+    std::optional timestamp = GetTimestamp(record);
+    if (timestamp && (*timestamp < time_range_->first || *timestamp > time_range_->second)) {
+      return;
+    }
+  }
+  record_consumer_(std::move(record));
+}
+
+bool MappedFileReader::ReadWords(uint64_t begin_word, uint64_t end_word) {
+  if (begin_word > end_word || end_word > num_words()) {
+    ReportError("Trace index refers to records outside the trace");
+    return false;
+  }
+
+  trace::Chunk chunk(words_ + begin_word, end_word - begin_word);
+  if (!ReadRecords(chunk)) {
+    ReportError("Trace stream is corrupted");
+    return false;
+  }
+  return true;
+}
+
+}  // namespace trace
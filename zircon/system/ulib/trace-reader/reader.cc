@@ -411,6 +411,11 @@ bool TraceReader::ReadBlobRecord(Chunk& record, RecordHeader header, void** out_
   auto blob_type = BlobRecordFields::BlobType::Get<trace_blob_type_t>(header);
   auto name_ref = BlobRecordFields::NameStringRef::Get<trace_encoded_string_ref_t>(header);
   auto blob_size = BlobRecordFields::BlobSize::Get<size_t>(header);
+  if (blob_size == 0 && name_ref == TRACE_ENCODED_STRING_REF_EMPTY) {
+    // A blob without a name or data carries nothing. The trace engine uses
+    // these to pad the unused tail of a thread's buffer chunk.
+    return true;
+  }
   fbl::String name;
   if (!DecodeStringRef(record, name_ref, &name))
     return false;
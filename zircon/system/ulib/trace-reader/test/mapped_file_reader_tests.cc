@@ -0,0 +1,242 @@
+// Copyright 2022 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <lib/trace-engine/fields.h>
+#include <lib/trace-engine/types.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <fbl/vector.h>
+#include <trace-reader/mapped_file_reader.h>
+#include <zxtest/zxtest.h>
+
+#include "reader_tests.h"
+
+namespace trace {
+namespace {
+
+const char kTestInputFile[] = "/tmp/trace-reader-mapped-test.fxt";
+const char kTestIndexFile[] = "/tmp/trace-reader-mapped-test.fxt.index";
+
+constexpr ProviderId kProviderId = 1;
+constexpr trace_string_index_t kStringIndex = 1;
+constexpr trace_thread_index_t kThreadIndex = 1;
+constexpr zx_koid_t kProcessKoid = 42;
+constexpr zx_koid_t kThreadKoid = 43;
+constexpr size_t kNumEvents = TraceIndex::kMaxRecordsPerBlock * 3;
+
+// Returns a trace of |kNumEvents| instant events, with timestamps 0 through
+// |kNumEvents| - 1, which refer to a string and a thread defined at the start.
+std::vector<uint64_t> MakeTestTrace() {
+  std::vector<uint64_t> words;
+  words.push_back(
+      RecordFields::Type::Make(ToUnderlyingType(RecordType::kMetadata)) |
+      RecordFields::RecordSize::Make(1) |
+      MetadataRecordFields::MetadataType::Make(ToUnderlyingType(MetadataType::kProviderInfo)) |
+      ProviderInfoMetadataRecordFields::Id::Make(kProviderId));
+  words.push_back(RecordFields::Type::Make(ToUnderlyingType(RecordType::kString)) |
+                  RecordFields::RecordSize::Make(2) |
+                  StringRecordFields::StringIndex::Make(kStringIndex) |
+                  StringRecordFields::StringLength::Make(4));
+  words.push_back(test::ToWord("name\0\0\0"));
+  words.push_back(RecordFields::Type::Make(ToUnderlyingType(RecordType::kThread)) |
+                  RecordFields::RecordSize::Make(3) |
+                  ThreadRecordFields::ThreadIndex::Make(kThreadIndex));
+  words.push_back(kProcessKoid);
+  words.push_back(kThreadKoid);
+  for (size_t i = 0; i < kNumEvents; ++i) {
+    words.push_back(RecordFields::Type::Make(ToUnderlyingType(RecordType::kEvent)) |
+                    RecordFields::RecordSize::Make(3) |
+                    EventRecordFields::EventType::Make(ToUnderlyingType(EventType::kInstant)) |
+                    EventRecordFields::ThreadRef::Make(kThreadIndex) |
+                    EventRecordFields::CategoryStringRef::Make(kStringIndex) |
+                    EventRecordFields::NameStringRef::Make(kStringIndex));
+    words.push_back(i);
+    words.push_back(ToUnderlyingType(EventScope::kThread));
+  }
+  return words;
+}
+
+void WriteWords(const char* file_path, const std::vector<uint64_t>& words) {
+  FILE* f = fopen(file_path, "wb");
+  ASSERT_NOT_NULL(f);
+  ASSERT_EQ(fwrite(words.data(), sizeof(uint64_t), words.size(), f), words.size());
+  ASSERT_EQ(fclose(f), 0);
+}
+
+void WriteTestTrace(const char* file_path) { WriteWords(file_path, MakeTestTrace()); }
+
+std::vector<uint64_t> ReadWords(const char* file_path) {
+  std::vector<uint64_t> words;
+  FILE* f = fopen(file_path, "rb");
+  if (f == nullptr) {
+    return words;
+  }
+  uint64_t word;
+  while (fread(&word, sizeof(word), 1, f) == 1) {
+    words.push_back(word);
+  }
+  fclose(f);
+  return words;
+}
+
+TEST(TraceMappedFileReader, ReadFile) {
+  ASSERT_NO_FATAL_FAILURE(WriteTestTrace(kTestInputFile));
+
+  std::unique_ptr<trace::MappedFileReader> reader;
+  fbl::Vector<trace::Record> records;
+  fbl::String error;
+  ASSERT_TRUE(trace::MappedFileReader::Create(kTestInputFile, test::MakeRecordConsumer(&records),
+                                              test::MakeErrorHandler(&error), &reader));
+
+  reader->ReadFile();
+  EXPECT_TRUE(error.empty(), "%s", error.c_str());
+  ASSERT_EQ(records.size(), kNumEvents + 3);
+  EXPECT_EQ(records[0].type(), RecordType::kMetadata);
+  EXPECT_EQ(records[1].type(), RecordType::kString);
+  EXPECT_EQ(records[2].type(), RecordType::kThread);
+  EXPECT_EQ(records[kNumEvents + 2].GetEvent().timestamp, kNumEvents - 1);
+  EXPECT_EQ(reader->current_provider_id(), kProviderId);
+}
+
+TEST(TraceMappedFileReader, ReadTimeRange) {
+  ASSERT_NO_FATAL_FAILURE(WriteTestTrace(kTestInputFile));
+
+  std::unique_ptr<trace::MappedFileReader> reader;
+  fbl::Vector<trace::Record> records;
+  fbl::String error;
+  ASSERT_TRUE(trace::MappedFileReader::Create(kTestInputFile, test::MakeRecordConsumer(&records),
+                                              test::MakeErrorHandler(&error), &reader));
+
+  const TraceIndex& index = reader->index();
+  ASSERT_EQ(index.blocks().size(), 4u);
+  EXPECT_EQ(index.state_records().size(), 3u);
+  for (const TraceIndex::Block& block : index.blocks()) {
+    EXPECT_EQ(block.provider_id, kProviderId);
+  }
+
+  // The range lies within the third block, so the string and thread records are
+  // only replayed.
+  constexpr trace_ticks_t kBegin = kNumEvents - 10;
+  constexpr trace_ticks_t kEnd = kNumEvents - 6;
+  reader->ReadTimeRange(kBegin, kEnd);
+  EXPECT_TRUE(error.empty(), "%s", error.c_str());
+  ASSERT_EQ(records.size(), kEnd - kBegin + 1);
+  for (size_t i = 0; i < records.size(); ++i) {
+    const trace::Record::Event& event = records[i].GetEvent();
+    EXPECT_EQ(event.timestamp, kBegin + i);
+    EXPECT_STREQ(event.name.c_str(), "name");
+    EXPECT_EQ(event.process_thread.process_koid(), kProcessKoid);
+    EXPECT_EQ(event.process_thread.thread_koid(), kThreadKoid);
+  }
+  EXPECT_EQ(reader->current_provider_id(), kProviderId);
+}
+
+TEST(TraceMappedFileReader, IndexFile) {
+  const std::vector<uint64_t> words = MakeTestTrace();
+  ASSERT_NO_FATAL_FAILURE(WriteWords(kTestInputFile, words));
+  remove(kTestIndexFile);
+
+  std::unique_ptr<trace::MappedFileReader> reader;
+  fbl::Vector<trace::Record> records;
+  fbl::String error;
+  ASSERT_TRUE(trace::MappedFileReader::Create(kTestInputFile, test::MakeRecordConsumer(&records),
+                                              test::MakeErrorHandler(&error), &reader));
+
+  const TraceIndex& built = reader->LoadOrBuildIndex(kTestIndexFile);
+  EXPECT_TRUE(error.empty(), "%s", error.c_str());
+
+  std::optional<TraceIndex> loaded =
+      TraceIndex::ReadFromFile(kTestIndexFile, reader->fingerprint(), words.data(), words.size());
+  ASSERT_TRUE(loaded.has_value());
+  EXPECT_EQ(loaded->end_word(), built.end_word());
+  EXPECT_TRUE(loaded->state_records() == built.state_records());
+  ASSERT_EQ(loaded->blocks().size(), built.blocks().size());
+  for (size_t i = 0; i < built.blocks().size(); ++i) {
+    EXPECT_EQ(loaded->blocks()[i].begin_word, built.blocks()[i].begin_word);
+    EXPECT_EQ(loaded->blocks()[i].end_word, built.blocks()[i].end_word);
+    EXPECT_EQ(loaded->blocks()[i].min_timestamp, built.blocks()[i].min_timestamp);
+    EXPECT_EQ(loaded->blocks()[i].max_timestamp, built.blocks()[i].max_timestamp);
+  }
+
+  // An index written for a different trace is ignored.
+  TraceIndex::Fingerprint other = reader->fingerprint();
+  other.size_bytes += 8;
+  EXPECT_FALSE(
+      TraceIndex::ReadFromFile(kTestIndexFile, other, words.data(), words.size()).has_value());
+}
+
+TEST(TraceMappedFileReader, StaleIndexFileOfSameSize) {
+  std::vector<uint64_t> words = MakeTestTrace();
+  ASSERT_NO_FATAL_FAILURE(WriteWords(kTestInputFile, words));
+  remove(kTestIndexFile);
+
+  fbl::Vector<trace::Record> records;
+  fbl::String error;
+  {
+    std::unique_ptr<trace::MappedFileReader> reader;
+    ASSERT_TRUE(trace::MappedFileReader::Create(kTestInputFile, test::MakeRecordConsumer(&records),
+                                                test::MakeErrorHandler(&error), &reader));
+    reader->LoadOrBuildIndex(kTestIndexFile);
+  }
+
+  // Rewrite the trace in place, possibly within the same second, with the
+  // last event moved out of its block's timestamp range.
+  words[words.size() - 2] = kNumEvents * 2;
+  ASSERT_NO_FATAL_FAILURE(WriteWords(kTestInputFile, words));
+
+  std::unique_ptr<trace::MappedFileReader> reader;
+  ASSERT_TRUE(trace::MappedFileReader::Create(kTestInputFile, test::MakeRecordConsumer(&records),
+                                              test::MakeErrorHandler(&error), &reader));
+  EXPECT_FALSE(
+      TraceIndex::ReadFromFile(kTestIndexFile, reader->fingerprint(), words.data(), words.size())
+          .has_value());
+
+  // The index is rebuilt, so the moved event is found.
+  reader->LoadOrBuildIndex(kTestIndexFile);
+  reader->ReadTimeRange(kNumEvents * 2, kNumEvents * 2);
+  EXPECT_TRUE(error.empty(), "%s", error.c_str());
+  ASSERT_EQ(records.size(), 1u);
+  EXPECT_EQ(records[0].GetEvent().timestamp, kNumEvents * 2);
+}
+
+TEST(TraceMappedFileReader, IndexFileWithBadStateRecord) {
+  const std::vector<uint64_t> words = MakeTestTrace();
+  ASSERT_NO_FATAL_FAILURE(WriteWords(kTestInputFile, words));
+  remove(kTestIndexFile);
+
+  std::unique_ptr<trace::MappedFileReader> reader;
+  fbl::Vector<trace::Record> records;
+  fbl::String error;
+  ASSERT_TRUE(trace::MappedFileReader::Create(kTestInputFile, test::MakeRecordConsumer(&records),
+                                              test::MakeErrorHandler(&error), &reader));
+  const TraceIndex& built = reader->LoadOrBuildIndex(kTestIndexFile);
+  const std::vector<uint64_t> state_records = built.state_records();
+  const uint64_t end_word = built.end_word();
+  const std::vector<uint64_t> index_words = ReadWords(kTestIndexFile);
+  auto saved = std::search(index_words.begin(), index_words.end(), state_records.begin(),
+                           state_records.end());
+  ASSERT_TRUE(saved != index_words.end());
+  const size_t last_state_record = (saved - index_words.begin()) + state_records.size() - 1;
+
+  // The last state record is moved past the end of the trace, and then onto
+  // the last word of an event, which doesn't start a record.
+  for (uint64_t bad_offset : {end_word, end_word - 1}) {
+    std::vector<uint64_t> corrupted = index_words;
+    corrupted[last_state_record] = bad_offset;
+    ASSERT_NO_FATAL_FAILURE(WriteWords(kTestIndexFile, corrupted));
+    EXPECT_FALSE(
+        TraceIndex::ReadFromFile(kTestIndexFile, reader->fingerprint(), words.data(), words.size())
+            .has_value());
+  }
+}
+
+}  // namespace
+}  // namespace trace
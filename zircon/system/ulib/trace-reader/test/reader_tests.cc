@@ -4,6 +4,7 @@
 
 #include "reader_tests.h"
 
+#include <lib/trace-engine/fields.h>
 #include <stdint.h>
 
 #include <iterator>
@@ -143,6 +144,37 @@ TEST(TraceReader, InitialState) {
   EXPECT_TRUE(error.empty());
 }
 
+TEST(TraceReader, SkipsPadding) {
+  const uint64_t kData[] = {
+      // Padding: an empty, unnamed blob record spanning three words, two of
+      // which hold stale data.
+      RecordFields::Type::Make(ToUnderlyingType(RecordType::kBlob)) |
+          RecordFields::RecordSize::Make(3) |
+          BlobRecordFields::NameStringRef::Make(TRACE_ENCODED_STRING_REF_EMPTY) |
+          BlobRecordFields::BlobSize::Make(0) |
+          BlobRecordFields::BlobType::Make(TRACE_BLOB_TYPE_DATA),
+      0xdeadbeef,
+      UINT64_MAX,
+      // Provider info record, with an empty name.
+      RecordFields::Type::Make(ToUnderlyingType(RecordType::kMetadata)) |
+          RecordFields::RecordSize::Make(1) |
+          MetadataRecordFields::MetadataType::Make(ToUnderlyingType(MetadataType::kProviderInfo)) |
+          ProviderInfoMetadataRecordFields::Id::Make(7),
+  };
+
+  fbl::Vector<trace::Record> records;
+  fbl::String error;
+  trace::TraceReader reader(test::MakeRecordConsumer(&records), test::MakeErrorHandler(&error));
+
+  trace::Chunk chunk(kData, std::size(kData));
+  EXPECT_TRUE(reader.ReadRecords(chunk));
+  EXPECT_EQ(0u, chunk.remaining_words());
+  ASSERT_EQ(1u, records.size());
+  EXPECT_EQ(MetadataType::kProviderInfo, records[0].GetMetadata().type());
+  EXPECT_EQ(7u, reader.current_provider_id());
+  EXPECT_TRUE(error.empty());
+}
+
 // NOTE: Most of the reader is covered by the libtrace tests.
 
 }  // namespace
@@ -8,9 +8,12 @@
 #include <lib/zx/event.h>
 #include <threads.h>
 
+#include <algorithm>
 #include <atomic>
 #include <iterator>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include <fbl/string.h>
 #include <fbl/string_printf.h>
@@ -28,6 +31,13 @@ using trace_site_atomic_state_t = std::atomic<trace_site_state_t>;
 constexpr trace_site_state_t kSiteStateDisabled = 1u;
 // constexpr trace_site_state_t kSiteStateEnabled = 2u;  // Only used by disabled test.
 constexpr trace_site_state_t kSiteStateFlagsMask = 3u;
+// Threads allocate small records from chunks of at most 1/64th of a rolling
+// buffer, once the rolling buffer is big enough for chunks of 256 bytes.
+constexpr size_t kRollingChunksPerBuffer = 64u;
+
+// Big enough that records are allocated from per-thread chunks.
+constexpr size_t kChunkedBufferSize = 131072u;
+constexpr size_t kNumWriterThreads = 4u;
 
 trace_site_state_t get_site_state(trace_site_t& site) {
   auto state_ptr = reinterpret_cast<trace_site_atomic_state_t*>(&site.state);
@@ -50,6 +60,43 @@ void RunThread(fit::closure closure) {
   ZX_ASSERT(result == thrd_success);
 }
 
+int RunSharedClosure(void* arg) {
+  (*static_cast<fit::closure*>(arg))();
+  return 0;
+}
+
+// Runs |closure| on |kNumWriterThreads| threads at once, and waits for them all.
+void RunWriterThreads(fit::closure closure) {
+  thrd_t threads[kNumWriterThreads];
+  for (auto& thread : threads) {
+    int result = thrd_create(&thread, RunSharedClosure, &closure);
+    ZX_ASSERT(result == thrd_success);
+  }
+  for (auto& thread : threads) {
+    int result = thrd_join(thread, nullptr);
+    ZX_ASSERT(result == thrd_success);
+  }
+}
+
+// Writes |count| instant events, each with one argument named |arg_name|.
+void WriteInstants(size_t count, const char* arg_name) {
+  for (size_t i = 0; i < count; ++i) {
+    TRACE_INSTANT("+enabled", "name", TRACE_SCOPE_GLOBAL, arg_name, TA_INT32(1));
+  }
+}
+
+// Returns the name of the one argument of each event in |records|, in order.
+std::vector<std::string> GetEventArgNames(const fbl::Vector<trace::Record>& records) {
+  std::vector<std::string> names;
+  for (const auto& record : records) {
+    if (record.type() != trace::RecordType::kEvent)
+      continue;
+    const auto& arguments = record.GetEvent().arguments;
+    names.emplace_back(arguments.size() == 1 ? arguments[0].name().c_str() : "");
+  }
+  return names;
+}
+
 TEST(EngineTests, TestNormalShutdown) {
   BEGIN_TRACE_TEST;
 
@@ -763,6 +810,160 @@ Event(ts: <>, pt: <>, category: \"+enabled\", name: \"name\", Instant(scope: glo
   END_TRACE_TEST;
 }
 
+TEST(EngineTests, TestOneshotModeChunked) {
+  BEGIN_TRACE_TEST_ETC(kNoAttachToThread, TRACE_BUFFERING_MODE_ONESHOT, kChunkedBufferSize);
+
+  fixture_initialize_and_start_tracing();
+
+  // Between them the threads write far more than fits.
+  RunWriterThreads([] { WriteInstants(kChunkedBufferSize / 8, "k1"); });
+
+  trace_buffer_header header;
+  fixture_snapshot_buffer_header(&header);
+  EXPECT_EQ(header.wrapped_count, 0);
+  EXPECT_NE(header.num_records_dropped, 0);
+  // Chunks at the end of the buffer are shrunk to the space that's left, so
+  // the buffer fills up to within about a record of its end, not a chunk.
+  EXPECT_LE(header.rolling_data_end[0], header.rolling_buffer_size);
+  EXPECT_LT(header.rolling_buffer_size - header.rolling_data_end[0],
+            header.rolling_buffer_size / kRollingChunksPerBuffer / 4);
+
+  fixture_stop_and_terminate_tracing();
+
+  // Reading fails on any error, so this also checks the padding in the
+  // unused tails of the chunks.
+  fbl::Vector<trace::Record> records;
+  ASSERT_TRUE(fixture_read_records(&records));
+  std::vector<std::string> names = GetEventArgNames(records);
+  EXPECT_GT(names.size(), 0);
+  EXPECT_TRUE(std::all_of(names.begin(), names.end(), [](auto& name) { return name == "k1"; }));
+
+  END_TRACE_TEST;
+}
+
+TEST(EngineTests, TestCircularModeChunked) {
+  BEGIN_TRACE_TEST_ETC(kNoAttachToThread, TRACE_BUFFERING_MODE_CIRCULAR, kChunkedBufferSize);
+
+  fixture_initialize_and_start_tracing();
+
+  // Fill the buffers with one kind of record, then write enough of another
+  // kind to recycle both buffers several times over. Only the second kind
+  // should remain.
+  RunWriterThreads([] { WriteInstants(kChunkedBufferSize / 8, "k1"); });
+  RunWriterThreads([] { WriteInstants(kChunkedBufferSize / 8, "k2"); });
+
+  trace_buffer_header header;
+  fixture_snapshot_buffer_header(&header);
+  EXPECT_GE(header.wrapped_count, 2);
+  // At most one chunk at the end of each buffer is left unused.
+  for (auto data_end : header.rolling_data_end) {
+    EXPECT_LE(data_end, header.rolling_buffer_size);
+    EXPECT_LE(header.rolling_buffer_size - data_end,
+              header.rolling_buffer_size / kRollingChunksPerBuffer);
+  }
+
+  fixture_stop_and_terminate_tracing();
+
+  // Reading fails on any error, so this also checks the padding left
+  // behind in chunks abandoned at each buffer switch.
+  fbl::Vector<trace::Record> records;
+  ASSERT_TRUE(fixture_read_records(&records));
+  std::vector<std::string> names = GetEventArgNames(records);
+  EXPECT_GT(names.size(), 0);
+  EXPECT_TRUE(std::all_of(names.begin(), names.end(), [](auto& name) { return name == "k2"; }));
+
+  END_TRACE_TEST;
+}
+
+TEST(EngineTests, TestStreamingModeChunked) {
+  BEGIN_TRACE_TEST_ETC(kNoAttachToThread, TRACE_BUFFERING_MODE_STREAMING, kChunkedBufferSize);
+
+  fixture_initialize_and_start_tracing();
+
+  // Both buffers should fill since there's no one to save them.
+  RunWriterThreads([] { WriteInstants(kChunkedBufferSize / 8, "k1"); });
+
+  EXPECT_TRUE(fixture_wait_buffer_full_notification());
+  EXPECT_EQ(fixture_get_buffer_full_wrapped_count(), 0);
+  fixture_reset_buffer_full_notification();
+
+  trace_buffer_header header;
+  fixture_snapshot_buffer_header(&header);
+  EXPECT_EQ(header.wrapped_count, 1);
+  // At most one chunk at the end of each buffer is left unused.
+  for (auto data_end : header.rolling_data_end) {
+    EXPECT_LE(data_end, header.rolling_buffer_size);
+    EXPECT_LE(header.rolling_buffer_size - data_end,
+              header.rolling_buffer_size / kRollingChunksPerBuffer);
+  }
+
+  // Save the older buffer, and fill it with a different kind of record.
+  trace_engine_mark_buffer_saved(0, 0);
+  RunWriterThreads([] { WriteInstants(kChunkedBufferSize / 8, "k2"); });
+
+  EXPECT_TRUE(fixture_wait_buffer_full_notification());
+  EXPECT_EQ(fixture_get_buffer_full_wrapped_count(), 1);
+
+  fixture_snapshot_buffer_header(&header);
+  EXPECT_EQ(header.wrapped_count, 2);
+  EXPECT_NE(header.rolling_data_end[0], 0);
+
+  fixture_stop_and_terminate_tracing();
+
+  // Buffer 1 holds the older records, and is read first.
+  fbl::Vector<trace::Record> records;
+  ASSERT_TRUE(fixture_read_records(&records));
+  std::vector<std::string> names = GetEventArgNames(records);
+  auto first_k2 = std::find(names.begin(), names.end(), "k2");
+  EXPECT_TRUE(first_k2 != names.begin());
+  EXPECT_TRUE(first_k2 != names.end());
+  EXPECT_TRUE(std::all_of(names.begin(), first_k2, [](auto& name) { return name == "k1"; }));
+  EXPECT_TRUE(std::all_of(first_k2, names.end(), [](auto& name) { return name == "k2"; }));
+
+  END_TRACE_TEST;
+}
+
+// A thread's chunk must be abandoned when the buffer it's in is switched
+// away from, even though the chunk still has room.
+TEST(EngineTests, TestCircularModeChunkRetiredAtSwitch) {
+  BEGIN_TRACE_TEST_ETC(kNoAttachToThread, TRACE_BUFFERING_MODE_CIRCULAR, kChunkedBufferSize);
+
+  fixture_initialize_and_start_tracing();
+
+  // This thread allocates a chunk at the start of buffer 0.
+  WriteInstants(4, "k1");
+
+  // Another thread writes until the engine switches to buffer 1.
+  RunThread([] {
+    auto context = trace::TraceProlongedContext::Acquire();
+    for (;;) {
+      TRACE_INSTANT("+enabled", "name", TRACE_SCOPE_GLOBAL, "k2", TA_INT32(2));
+
+      trace_buffer_header header;
+      trace_context_snapshot_buffer_header_internal(context.get(), &header);
+      if (header.wrapped_count > 0) {
+        break;
+      }
+    }
+  });
+
+  // This record must go after the other thread's last records in buffer 1,
+  // not into this thread's old chunk in buffer 0.
+  WriteInstants(1, "k3");
+
+  fixture_stop_and_terminate_tracing();
+
+  fbl::Vector<trace::Record> records;
+  ASSERT_TRUE(fixture_read_records(&records));
+  std::vector<std::string> names = GetEventArgNames(records);
+  ASSERT_GT(names.size(), 0);
+  EXPECT_STREQ(names.back().c_str(), "k3");
+  EXPECT_EQ(std::count(names.begin(), names.end(), "k3"), 1);
+  EXPECT_TRUE(std::find(names.begin(), names.end(), "k1") != names.end());
+
+  END_TRACE_TEST;
+}
+
 // This test exercises fxbug.dev/22904 where a buffer becomes full and immediately
 // thereafter tracing is stopped. This causes the "please save buffer"
 // processing to run when tracing is not active.